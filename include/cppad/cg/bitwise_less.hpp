@@ -0,0 +1,41 @@
+#ifndef CPPAD_CG_BITWISE_LESS_INCLUDED
+#define CPPAD_CG_BITWISE_LESS_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Orders values by their bit representation.
+ * It can be used to create maps of constant values where different
+ * values which compare equal (e.g. -0.0 and 0.0) are kept and where NaN
+ * can also be used as a key.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+struct BitwiseLess {
+
+    inline bool operator()(const Base& l,
+                           const Base& r) const {
+        return memcmp(&l, &r, sizeof(Base)) < 0;
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
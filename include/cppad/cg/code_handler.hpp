@@ -166,6 +166,11 @@ protected:
      * used to track evaluation times and print out messages
      */
     JobTimer* _jobTimer;
+    /**
+     * rewrites operations before the source code is generated
+     * (not owned by the handler; nullptr means no rewrites)
+     */
+    const GraphSimplifier<Base>* _simplifier;
     /**
      * Auxiliary index declaration (might not be used)
      */
@@ -240,6 +245,18 @@ public:
 
     inline void setJobTimer(JobTimer* jobTimer);
 
+    inline const GraphSimplifier<Base>* getGraphSimplifier() const;
+
+    /**
+     * Defines the algebraic simplifications applied to the operation graph
+     * at the beginning of generateCode().
+     * Operation nodes are modified in place.
+     *
+     * @param simplifier the simplifier (it must remain valid while this
+     *                   handler is used) or nullptr to disable rewrites
+     */
+    inline void setGraphSimplifier(const GraphSimplifier<Base>* simplifier);
+
     /**
      * Determines whether or not the dependent variables will be set to zero
      * before executing the operation graph
@@ -401,6 +418,32 @@ public:
 
     size_t getTemporarySparseArraySize() const;
 
+    /**
+     * Provides the number of operations used by the dependent variables
+     * in the last call to generateCode() (including the operations
+     * which were not assigned to temporary variables).
+     * Operations inside loops are only counted once.
+     */
+    size_t getOperationCount() const;
+
+    /**
+     * Determines the number of operations used by the dependent variables
+     * without generating any source code.
+     * When a graph simplifier is defined, it is applied to determine the
+     * number of operations but the original graph is restored afterwards.
+     * The result is the same value provided by getOperationCount() after
+     * generating source code for these dependent variables.
+     *
+     * @param dependent The dependent variables
+     * @return the number of operations
+     */
+    size_t countOperations(ArrayView<CGB>& dependent);
+
+    inline size_t countOperations(std::vector<CGB>& dependent) {
+        ArrayView<CGB> deps(dependent);
+        return countOperations(deps);
+    }
+
     /**************************************************************************
      *                       Reusing handler and nodes
      *************************************************************************/
@@ -42,7 +42,8 @@ CodeHandler<Base>::CodeHandler(size_t varCount) :
         _minTemporaryVarID(0),
         _zeroDependents(false),
         _verbose(false),
-        _jobTimer(nullptr) {
+        _jobTimer(nullptr),
+        _simplifier(nullptr) {
     _codeBlocks.reserve(varCount);
     //_variableOrder.reserve(1 + varCount / 3);
     _scopedVariableOrder[0].reserve(1 + varCount / 3);
@@ -125,6 +126,16 @@ inline void CodeHandler<Base>::setJobTimer(JobTimer* jobTimer) {
     _jobTimer = jobTimer;
 }
 
+template<class Base>
+inline const GraphSimplifier<Base>* CodeHandler<Base>::getGraphSimplifier() const {
+    return _simplifier;
+}
+
+template<class Base>
+inline void CodeHandler<Base>::setGraphSimplifier(const GraphSimplifier<Base>* simplifier) {
+    _simplifier = simplifier;
+}
+
 template<class Base>
 inline bool CodeHandler<Base>::isZeroDependents() const {
     return _zeroDependents;
@@ -279,6 +290,10 @@ void CodeHandler<Base>::generateCode(std::ostream& out,
         beginTime = steady_clock::now();
     }
 
+    if (_simplifier != nullptr) {
+        _simplifier->simplify(*this, dependent);
+    }
+
     _lang = &lang;
     _idCount = 1;
     _idArrayCount = 1;
@@ -486,6 +501,79 @@ size_t CodeHandler<Base>::getTemporarySparseArraySize() const {
     return _idSparseArrayCount - 1;
 }
 
+template<class Base>
+size_t CodeHandler<Base>::getOperationCount() const {
+    size_t nNodes = std::min(_codeBlocks.size(), _totalUseCount.size());
+
+    size_t count = 0;
+    for (size_t i = 0; i < nNodes; i++) {
+        const Node& node = *_codeBlocks[i];
+        CGOpCode op = node.getOperationType();
+        if (_totalUseCount[node] > 0 && op != CGOpCode::Inv && op != CGOpCode::Alias) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+template<class Base>
+size_t CodeHandler<Base>::countOperations(ArrayView<CGB>& dependent) {
+    /**
+     * the simplifier modifies the graph: keep the original operations so
+     * that they can be restored after counting
+     */
+    size_t nOrigNodes = _codeBlocks.size();
+    std::vector<std::pair<CGOpCode, std::vector<Arg> > > original;
+    if (_simplifier != nullptr) {
+        original.reserve(nOrigNodes);
+        for (const Node* node : _codeBlocks) {
+            original.emplace_back(node->getOperationType(), node->getArguments());
+        }
+        _simplifier->simplify(*this, dependent);
+    }
+
+    std::vector<bool> visited(_codeBlocks.size(), false);
+    std::vector<Node*> stack; // avoids recursion in deep graphs
+
+    for (size_t i = 0; i < dependent.size(); i++) {
+        Node* node = dependent[i].getOperationNode();
+        if (node != nullptr)
+            stack.push_back(node);
+    }
+
+    size_t count = 0;
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+
+        size_t pos = node->getHandlerPosition();
+        if (pos >= visited.size() || _codeBlocks[pos] != node || visited[pos])
+            continue; // already visited or not managed by this handler
+        visited[pos] = true;
+
+        CGOpCode op = node->getOperationType();
+        if (op != CGOpCode::Inv && op != CGOpCode::Alias) {
+            count++;
+        }
+
+        for (const Arg& a : node->getArguments()) {
+            if (a.getOperation() != nullptr)
+                stack.push_back(a.getOperation());
+        }
+    }
+
+    if (_simplifier != nullptr) {
+        // restore the original graph
+        for (size_t i = 0; i < nOrigNodes; i++) {
+            _codeBlocks[i]->setOperation(original[i].first, original[i].second);
+        }
+        deleteManagedNodes(nOrigNodes, _codeBlocks.size());
+    }
+
+    return count;
+}
+
 template<class Base>
 void CodeHandler<Base>::reset() {
     for (Node* n : _codeBlocks) {
@@ -112,8 +112,15 @@ inline CG<Base> CodeHandler<Base>::collectVariableAddSub(const SourceCodePath& p
 
     auto initCommonOp = expression.getOperationType();
     if (initCommonOp != CGOpCode::Add &&
-        initCommonOp != CGOpCode::Sub) {
-        throw CGException("Invalid path! It must start with either an addition or subtraction.");
+        initCommonOp != CGOpCode::Sub &&
+        initCommonOp != CGOpCode::Fma) {
+        throw CGException("Invalid path! It must start with either an addition, a subtraction, or a fused multiply-add.");
+    }
+
+    if (initCommonOp == CGOpCode::Fma && pathLeft[0].argIndex != 2 && pathRight[0].argIndex != 2) {
+        // fma(a, b, c) with the variable in a and b
+        throw CGException("Failed to combine multiple occurrences of a variable into one expression."
+                          " Unable to combine the factors of a multiplication.");
     }
 
     if(pathLeft.back().node == nullptr || pathRight.back().node == nullptr)
@@ -150,6 +157,10 @@ inline CG<Base> CodeHandler<Base>::collectVariableAddSub(const SourceCodePath& p
         CG<Base> c = 1;
         if (initCommonOp == CGOpCode::Sub && j == 1) {
             c = -1;
+        } else if (initCommonOp == CGOpCode::Fma && p[0].argIndex != 2) {
+            // fma(a, b, c) = a * b + c
+            const auto& pArgs = expression.getArguments();
+            c = CG<Base>((p[0].argIndex == 0) ? pArgs[1] : pArgs[0]);
         }
 
         for (size_t i = 1; i < p.size() - 1; ++i) { // the last node is what we want to extract
@@ -181,6 +192,13 @@ inline CG<Base> CodeHandler<Base>::collectVariableAddSub(const SourceCodePath& p
                 CPPADCG_ASSERT_UNKNOWN(p[i].argIndex == 0);
                 c /= CG<Base>(node->getArguments()[1]);
 
+            } else if (op == CGOpCode::Fma) {
+                // fma(a, b, c) = a * b + c
+                if (p[i].argIndex != 2) {
+                    const auto& pArgs = node->getArguments();
+                    c *= (p[i].argIndex == 0) ? pArgs[1] : pArgs[0];
+                }
+
             } else if (op == CGOpCode::Alias) {
                 continue;
 
@@ -258,6 +276,7 @@ inline bool CodeHandler<Base>::isCollectableVariableAddSub(const SourceCodePath&
             if (op != CGOpCode::Add &&
                 op != CGOpCode::Sub &&
                 op != CGOpCode::Mul &&
+                op != CGOpCode::Fma &&
                 op != CGOpCode::UnMinus &&
                 op != CGOpCode::Alias) {
 
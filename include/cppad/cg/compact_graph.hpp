@@ -0,0 +1,480 @@
+#ifndef CPPAD_CG_COMPACT_GRAPH_INCLUDED
+#define CPPAD_CG_COMPACT_GRAPH_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A compact copy of the operation graph used by a set of dependent
+ * variables.
+ *
+ * Nodes are identified by 32 bit indexes in topological order (the
+ * independent variables come first) and all their data is kept in
+ * parallel arrays: the operation type (1 byte), the start of the
+ * arguments in a shared argument pool and the start of the additional
+ * information in a shared information pool (also with 32 bit elements).
+ * Arguments are 32 bit indexes of other nodes or of values in a table of
+ * unique constants (marked with PARAMETER_FLAG).
+ * A typical node with two arguments requires about 20 bytes while an
+ * OperationNode requires well over 100 bytes.
+ * Only the operations used by the dependent variables are kept and alias
+ * chains are resolved, so the same operations always result in the same
+ * arrays (it is used to determine whether or not the sources of a model
+ * must be generated again, see ModelCSourceGen::getSourcesFingerprint()).
+ *
+ * The original graph can be recreated in any code handler with rebuild()
+ * (atomic functions must also be registered in that handler).
+ * Graphs with loops are not supported.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class CompactGraph {
+public:
+    typedef CG<Base> CGB;
+    typedef OperationNode<Base> Node;
+    typedef Argument<Base> Arg;
+    /**
+     * The bit used in arguments and dependents to identify constants
+     */
+    static const uint32_t PARAMETER_FLAG = 0x80000000u;
+private:
+    /**
+     * the number of independent variables (the first nodes)
+     */
+    uint32_t nIndep_;
+    /**
+     * the operation type of each node
+     */
+    std::vector<uint8_t> op_;
+    /**
+     * the position of the first argument of each node in args_
+     * (with an additional element for the end)
+     */
+    std::vector<uint32_t> argStart_;
+    /**
+     * the position of the first information element of each node in
+     * info_ (with an additional element for the end)
+     */
+    std::vector<uint32_t> infoStart_;
+    /**
+     * the arguments of all nodes
+     */
+    std::vector<uint32_t> args_;
+    /**
+     * the additional information of all nodes (for print operations it
+     * contains the positions of the texts in strings_)
+     */
+    std::vector<uint32_t> info_;
+    /**
+     * unique constant values
+     */
+    std::vector<Base> constants_;
+    /**
+     * the texts of the print operations
+     */
+    std::vector<std::string> strings_;
+    /**
+     * the dependent variables (node or constant indexes)
+     */
+    std::vector<uint32_t> dep_;
+public:
+
+    inline CompactGraph() :
+        nIndep_(0) {
+        argStart_.push_back(0);
+        infoStart_.push_back(0);
+    }
+
+    /**
+     * Creates a compact copy of the operations used by dependent variables.
+     *
+     * @param indep the independent variables (all of them must be
+     *              variables created by the same code handler)
+     * @param dep the dependent variables
+     */
+    inline CompactGraph(const std::vector<CGB>& indep,
+                        const std::vector<CGB>& dep) :
+        CompactGraph() {
+        build(indep, dep);
+    }
+
+    /**
+     * Replaces the contents of this object with a compact copy of the
+     * operations used by dependent variables.
+     *
+     * @param indep the independent variables (all of them must be
+     *              variables created by the same code handler)
+     * @param dep the dependent variables
+     * @throws CGException if the graph uses loops, variables
+     *                     which are not independents, or it is too large
+     */
+    inline void build(const std::vector<CGB>& indep,
+                      const std::vector<CGB>& dep) {
+        clear();
+
+        CodeHandler<Base>* handler = nullptr;
+        for (const CGB& v : indep) {
+            Node* n = v.getOperationNode();
+            if (n == nullptr || n->getOperationType() != CGOpCode::Inv)
+                throw CGException("Compact graph: all independents must be variables");
+            handler = n->getCodeHandler();
+        }
+        for (const CGB& v : dep) {
+            if (v.getOperationNode() != nullptr)
+                handler = v.getOperationNode()->getCodeHandler();
+        }
+
+        CPPADCG_ASSERT_KNOWN(indep.size() < PARAMETER_FLAG, "Compact graph: too many independent variables")
+        nIndep_ = uint32_t(indep.size());
+
+        const uint32_t unvisited = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> ids(handler != nullptr ? handler->getManagedNodesCount() : 0, unvisited);
+        std::map<Base, uint32_t, BitwiseLess<Base>> constantIds;
+
+        for (const CGB& v : indep) {
+            const Node& n = *v.getOperationNode();
+            ids[position(n, handler)] = uint32_t(op_.size());
+            addNode(n, 0);
+        }
+
+        /**
+         * depth-first post-order visit (without recursion)
+         */
+        std::vector<std::pair<const Node*, size_t> > stack;
+
+        dep_.resize(dep.size());
+        for (size_t i = 0; i < dep.size(); i++) {
+            if (dep[i].isParameter()) {
+                dep_[i] = internConstant(dep[i].getValue(), constantIds);
+                continue;
+            }
+
+            const Node* root = resolveAlias(*dep[i].getOperationNode());
+            if (root == nullptr) {
+                // alias of a constant
+                dep_[i] = internConstant(*aliasConstant(*dep[i].getOperationNode()), constantIds);
+                continue;
+            }
+
+            if (ids[position(*root, handler)] == unvisited) {
+                checkNode(*root);
+                stack.emplace_back(root, 0);
+
+                while (!stack.empty()) {
+                    const Node& node = *stack.back().first;
+                    size_t& a = stack.back().second;
+                    const std::vector<Arg>& args = node.getArguments();
+
+                    // find the next argument which was not visited yet
+                    const Node* next = nullptr;
+                    for (; a < args.size(); a++) {
+                        const Node* argNode = args[a].getOperation();
+                        if (argNode != nullptr) {
+                            argNode = resolveAlias(*argNode);
+                            if (argNode != nullptr && ids[position(*argNode, handler)] == unvisited) {
+                                next = argNode;
+                                break;
+                            }
+                        }
+                    }
+
+                    if (next != nullptr) {
+                        checkNode(*next);
+                        stack.emplace_back(next, 0);
+                        continue;
+                    }
+
+                    // all arguments were added
+                    CPPADCG_ASSERT_KNOWN(op_.size() < PARAMETER_FLAG, "Compact graph: too many nodes")
+                    ids[node.getHandlerPosition()] = uint32_t(op_.size());
+
+                    for (const Arg& arg : args) {
+                        const Node* argNode = arg.getOperation();
+                        if (argNode == nullptr) {
+                            args_.push_back(internConstant(*arg.getParameter(), constantIds));
+                        } else {
+                            const Node* r = resolveAlias(*argNode);
+                            if (r == nullptr)
+                                args_.push_back(internConstant(*aliasConstant(*argNode), constantIds));
+                            else
+                                args_.push_back(ids[r->getHandlerPosition()]);
+                        }
+                    }
+                    CPPADCG_ASSERT_KNOWN(args_.size() < std::numeric_limits<uint32_t>::max(), "Compact graph: too many arguments")
+
+                    addNode(node, args.size());
+
+                    stack.pop_back();
+                }
+            }
+
+            dep_[i] = ids[position(*root, handler)];
+        }
+    }
+
+    /**
+     * Creates the operations of this graph in a code handler.
+     *
+     * @param handler the code handler where the operations are created
+     * @param indep the new independent variables (they are created with
+     *              makeVariables())
+     * @return the new dependent variables
+     */
+    inline std::vector<CGB> rebuild(CodeHandler<Base>& handler,
+                                    std::vector<CGB>& indep) const {
+        indep.resize(nIndep_);
+        handler.makeVariables(indep);
+
+        std::vector<Node*> nodes(op_.size(), nullptr);
+        for (uint32_t j = 0; j < nIndep_; j++) {
+            nodes[j] = indep[j].getOperationNode();
+        }
+
+        std::vector<size_t> info;
+        std::vector<Arg> args;
+        for (size_t id = nIndep_; id < op_.size(); id++) {
+            args.clear();
+            for (uint32_t a = argStart_[id]; a < argStart_[id + 1]; a++) {
+                uint32_t arg = args_[a];
+                if (arg & PARAMETER_FLAG)
+                    args.push_back(Arg(constants_[arg & ~PARAMETER_FLAG]));
+                else
+                    args.push_back(Arg(*nodes[arg]));
+            }
+
+            if (CGOpCode(op_[id]) == CGOpCode::Pri) {
+                const uint32_t* texts = &info_[infoStart_[id]];
+                nodes[id] = handler.makePrintNode(strings_[texts[0]], args[0], strings_[texts[1]]);
+            } else {
+                info.assign(info_.begin() + infoStart_[id], info_.begin() + infoStart_[id + 1]);
+                nodes[id] = handler.makeNode(CGOpCode(op_[id]), info, args);
+            }
+        }
+
+        std::vector<CGB> dep;
+        dep.reserve(dep_.size());
+        for (uint32_t d : dep_) {
+            if (d & PARAMETER_FLAG)
+                dep.push_back(CGB(constants_[d & ~PARAMETER_FLAG]));
+            else
+                dep.push_back(CGB(*nodes[d]));
+        }
+
+        return dep;
+    }
+
+    inline void clear() {
+        nIndep_ = 0;
+        op_.clear();
+        argStart_.assign(1, 0);
+        infoStart_.assign(1, 0);
+        args_.clear();
+        info_.clear();
+        constants_.clear();
+        strings_.clear();
+        dep_.clear();
+    }
+
+    /**
+     * @return the number of nodes (including the independent variables)
+     */
+    inline size_t getNodeCount() const {
+        return op_.size();
+    }
+
+    inline size_t getIndependentCount() const {
+        return nIndep_;
+    }
+
+    inline CGOpCode getOperationType(uint32_t id) const {
+        return CGOpCode(op_[id]);
+    }
+
+    /**
+     * @return the arguments of a node (node or constant indexes)
+     */
+    inline ArrayView<const uint32_t> getArguments(uint32_t id) const {
+        return ArrayView<const uint32_t>(args_.data() + argStart_[id], argStart_[id + 1] - argStart_[id]);
+    }
+
+    /**
+     * @return the additional information of a node (for print operations
+     *         the positions of the texts, see getString())
+     */
+    inline ArrayView<const uint32_t> getInfo(uint32_t id) const {
+        return ArrayView<const uint32_t>(info_.data() + infoStart_[id], infoStart_[id + 1] - infoStart_[id]);
+    }
+
+    /**
+     * @return a text used by a print operation
+     */
+    inline const std::string& getString(uint32_t pos) const {
+        return strings_[pos];
+    }
+
+    /**
+     * @return the dependent variables (node or constant indexes)
+     */
+    inline const std::vector<uint32_t>& getDependents() const {
+        return dep_;
+    }
+
+    /**
+     * @return whether or not an argument or dependent refers to a constant
+     */
+    static inline bool isParameter(uint32_t arg) {
+        return (arg & PARAMETER_FLAG) != 0;
+    }
+
+    /**
+     * @param arg an argument or dependent which refers to a constant
+     */
+    inline const Base& getParameter(uint32_t arg) const {
+        CPPADCG_ASSERT_UNKNOWN(isParameter(arg));
+        return constants_[arg & ~PARAMETER_FLAG];
+    }
+
+    /**
+     * @return the unique constant values
+     */
+    inline const std::vector<Base>& getConstants() const {
+        return constants_;
+    }
+
+    /**
+     * @return the number of bytes used by the graph data
+     */
+    inline size_t getMemoryUsage() const {
+        return op_.capacity() * sizeof(uint8_t) +
+                argStart_.capacity() * sizeof(uint32_t) +
+                infoStart_.capacity() * sizeof(uint32_t) +
+                args_.capacity() * sizeof(uint32_t) +
+                info_.capacity() * sizeof(uint32_t) +
+                constants_.capacity() * sizeof(Base) +
+                strings_.capacity() * sizeof(std::string) +
+                dep_.capacity() * sizeof(uint32_t);
+    }
+
+    /**
+     * Releases unused reserved memory
+     */
+    inline void shrinkToFit() {
+        op_.shrink_to_fit();
+        argStart_.shrink_to_fit();
+        infoStart_.shrink_to_fit();
+        args_.shrink_to_fit();
+        info_.shrink_to_fit();
+        constants_.shrink_to_fit();
+        strings_.shrink_to_fit();
+        dep_.shrink_to_fit();
+    }
+
+private:
+
+    inline void addNode(const Node& node,
+                        size_t nArgs) {
+        CPPADCG_ASSERT_UNKNOWN(size_t(node.getOperationType()) <= std::numeric_limits<uint8_t>::max());
+        CPPADCG_ASSERT_UNKNOWN(args_.size() == argStart_.back() + nArgs);
+
+        op_.push_back(uint8_t(node.getOperationType()));
+        argStart_.push_back(uint32_t(args_.size()));
+
+        if (node.getOperationType() == CGOpCode::Pri) {
+            const auto& print = static_cast<const PrintOperationNode<Base>&> (node);
+            info_.push_back(uint32_t(strings_.size()));
+            strings_.push_back(print.getBeforeString());
+            info_.push_back(uint32_t(strings_.size()));
+            strings_.push_back(print.getAfterString());
+        } else {
+            for (size_t i : node.getInfo()) {
+                if (i > std::numeric_limits<uint32_t>::max())
+                    throw CGException("Compact graph: the information of an operation does not fit in 32 bits");
+                info_.push_back(uint32_t(i));
+            }
+        }
+        if (info_.size() >= std::numeric_limits<uint32_t>::max())
+            throw CGException("Compact graph: too much information");
+        infoStart_.push_back(uint32_t(info_.size()));
+    }
+
+    inline uint32_t internConstant(const Base& value,
+                                   std::map<Base, uint32_t, BitwiseLess<Base>>& constantIds) {
+        auto it = constantIds.find(value);
+        if (it != constantIds.end())
+            return it->second | PARAMETER_FLAG;
+
+        CPPADCG_ASSERT_KNOWN(constants_.size() < PARAMETER_FLAG, "Compact graph: too many constants")
+        uint32_t id = uint32_t(constants_.size());
+        constants_.push_back(value);
+        constantIds[value] = id;
+        return id | PARAMETER_FLAG;
+    }
+
+    /**
+     * @return the node referenced by a chain of aliases (or nullptr if the
+     *         chain ends in a constant)
+     */
+    static inline const Node* resolveAlias(const Node& node) {
+        const Node* n = &node;
+        while (n->getOperationType() == CGOpCode::Alias) {
+            const Arg& a = n->getArguments()[0];
+            if (a.getOperation() == nullptr)
+                return nullptr;
+            n = a.getOperation();
+        }
+        return n;
+    }
+
+    /**
+     * @return the constant at the end of a chain of aliases
+     */
+    static inline const Base* aliasConstant(const Node& node) {
+        const Node* n = &node;
+        while (n->getArguments()[0].getOperation() != nullptr) {
+            n = n->getArguments()[0].getOperation();
+        }
+        return n->getArguments()[0].getParameter();
+    }
+
+    /**
+     * @return the position of a node in its code handler
+     */
+    static inline size_t position(const Node& node,
+                                  const CodeHandler<Base>* handler) {
+        if (node.getCodeHandler() != handler)
+            throw CGException("Compact graph: all variables must belong to the same code handler");
+        size_t p = node.getHandlerPosition();
+        if (p >= handler->getManagedNodesCount())
+            throw CGException("Compact graph: an operation node is not managed by its code handler");
+        return p;
+    }
+
+    static inline void checkNode(const Node& node) {
+        CGOpCode op = node.getOperationType();
+        if (op != CGOpCode::Pri && Node::CUSTOM_NODE_CLASS.find(op) != Node::CUSTOM_NODE_CLASS.end())
+            throw CGException("Compact graph: operations with loops are not supported");
+        if (op == CGOpCode::Inv)
+            throw CGException("Compact graph: an independent variable was not provided");
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
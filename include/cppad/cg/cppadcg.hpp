@@ -21,7 +21,11 @@
 #include <algorithm>
 #include <array>
 #include <assert.h>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <errno.h>
 #include <fstream>
 #include <iomanip>
@@ -30,6 +34,7 @@
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <valarray>
 #include <vector>
 #include <deque>
@@ -44,6 +49,11 @@
 #include <string.h>
 #include <chrono>
 #include <thread>
+#include <type_traits>
+
+// ---------------------------------------------------------------------------
+// CppADCodeGen configuration (created by CMake)
+#include <cppad/cg/configure.hpp>
 
 // ---------------------------------------------------------------------------
 // operating system detection
@@ -78,6 +88,7 @@
 #include <cppad/cg/smart_containers.hpp>
 #include <cppad/cg/ostream_config_restore.hpp>
 #include <cppad/cg/array_view.hpp>
+#include <cppad/cg/bitwise_less.hpp>
 
 // ---------------------------------------------------------------------------
 // indexes
@@ -127,6 +138,8 @@
 #include <cppad/cg/code_handler_impl.hpp>
 #include <cppad/cg/code_handler_vector.hpp>
 #include <cppad/cg/code_handler_loops.hpp>
+#include <cppad/cg/graph_simplifier.hpp>
+#include <cppad/cg/compact_graph.hpp>
 
 // ---------------------------------------------------------------------------
 #include <cppad/cg/base_double.hpp>
@@ -179,6 +192,9 @@
 // ---------------------------------------------------------------------------
 // C source code generation
 #include <cppad/cg/lang/c/lang_c_atomic_fun.hpp>
+#include <cppad/cg/lang/c/lang_c_code_writer.hpp>
+#include <cppad/cg/lang/c/language_c_function_split.hpp>
+#include <cppad/cg/lang/c/lang_c_constant_pool.hpp>
 #include <cppad/cg/lang/c/language_c.hpp>
 #include <cppad/cg/lang/c/language_c_arrays.hpp>
 #include <cppad/cg/lang/c/language_c_index_patterns.hpp>
@@ -188,17 +204,21 @@
 #include <cppad/cg/lang/c/lang_c_default_var_name_gen.hpp>
 #include <cppad/cg/lang/c/lang_c_default_hessian_var_name_gen.hpp>
 #include <cppad/cg/lang/c/lang_c_default_reverse2_var_name_gen.hpp>
+#include <cppad/cg/lang/c/lang_c_multi_dep_var_name_gen.hpp>
 #include <cppad/cg/lang/c/lang_c_custom_var_name_gen.hpp>
 #include <cppad/cg/lang/c/lang_c_util.hpp>
 
 //
 #include <cppad/cg/model/threadpool/multi_threading_type.hpp>
 #include <cppad/cg/model/threadpool/thread_pool_schedule_strategy.hpp>
+#include <cppad/cg/model/threadpool/thread_pool_affinity.hpp>
 #include <cppad/cg/model/external_function_wrapper.hpp>
 #include <cppad/cg/model/atomic_external_function_wrapper.hpp>
 #include <cppad/cg/model/generic_model_external_function_wrapper.hpp>
 #include <cppad/cg/model/model_library_processor.hpp>
 #include <cppad/cg/model/model_library.hpp>
+#include <cppad/cg/model/sparsity_view.hpp>
+#include <cppad/cg/model/thread_pool_job_profile.hpp>
 #include <cppad/cg/model/generic_model.hpp>
 #include <cppad/cg/model/functor_generic_model.hpp>
 #include <cppad/cg/model/functor_model_library.hpp>
@@ -209,6 +229,7 @@
 #include <cppad/cg/model/dynamic_lib/ar_archiver.hpp>
 
 // compiler
+#include <cppad/cg/model/build_manifest.hpp>
 #include <cppad/cg/model/compiler/c_compiler.hpp>
 #include <cppad/cg/model/compiler/abstract_c_compiler.hpp>
 #include <cppad/cg/model/compiler/gcc_compiler.hpp>
@@ -219,6 +240,7 @@
 #include <cppad/cg/model/threadpool/pthread_pool_h.hpp>
 #include <cppad/cg/model/threadpool/openmp_c.hpp>
 #include <cppad/cg/model/threadpool/openmp_h.hpp>
+#include <cppad/cg/model/cppad_parallel_section.hpp>
 #include <cppad/cg/model/model_c_source_gen.hpp>
 #include <cppad/cg/model/model_c_source_gen_impl.hpp>
 #include <cppad/cg/model/model_library_c_source_gen.hpp>
@@ -230,6 +252,7 @@
 #include <cppad/cg/model/model_c_source_gen_rev2.hpp>
 #include <cppad/cg/model/model_c_source_gen_jac.hpp>
 #include <cppad/cg/model/model_c_source_gen_hes.hpp>
+#include <cppad/cg/model/model_c_source_gen_fused.hpp>
 #include <cppad/cg/model/patterns/model_c_source_gen_loops.hpp>
 #include <cppad/cg/model/patterns/model_c_source_gen_loops_for0.hpp>
 #include <cppad/cg/model/patterns/model_c_source_gen_loops_for1.hpp>
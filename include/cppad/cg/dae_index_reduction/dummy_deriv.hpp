@@ -20,8 +20,12 @@
 #include <Eigen/LU>
 #include <Eigen/QR>
 
+#include <atomic>
+#include <exception>
+
 #include <cppad/cg/dae_index_reduction/pantelides.hpp>
 #include <cppad/cg/dae_index_reduction/dummy_deriv_util.hpp>
+#include <cppad/cg/dae_index_reduction/structural_analysis.hpp>
 
 namespace CppAD {
 namespace cg {
@@ -36,6 +40,7 @@ class DummyDerivatives : public DaeIndexReduction<Base> {
     typedef Eigen::Matrix<Base, Eigen::Dynamic, 1> VectorB;
     typedef Eigen::Matrix<std::complex<Base>, Eigen::Dynamic, 1> VectorCB;
     typedef Eigen::Matrix<Base, Eigen::Dynamic, Eigen::Dynamic> MatrixB;
+    typedef Eigen::SparseMatrix<Base> SparseMatrixB;
 protected:
     /**
      * Method used to identify the structural index
@@ -61,7 +66,7 @@ protected:
      * Jacobian sparsity pattern of the reduced system
      * (in the original variable order)
      */
-    std::vector<bool> jacSparsity_;
+    std::vector<std::set<size_t> > jacSparsity_;
     // the initial index of time derivatives
     size_t diffVarStart_;
     // the initial index of the differentiated equations
@@ -97,6 +102,11 @@ protected:
      * Avoid using these variables as dummy derivatives
      */
     std::set<std::string> avoidAsDummy_;
+    /**
+     * Maximum number of threads used to select the dummy derivatives of
+     * independent blocks of equations
+     */
+    size_t threadCount_;
 public:
 
     /**
@@ -124,7 +134,8 @@ public:
             reduceEquations_(true),
             generateSemiExplicitDae_(false),
             reorder_(true),
-            avoidConvertAlg2DifVars_(true) {
+            avoidConvertAlg2DifVars_(true),
+            threadCount_(1) {
 
         for (Vnode<Base>* jj : idxIdentify.getGraph().variables()) {
             if (jj->antiDerivative() != nullptr) {
@@ -235,6 +246,27 @@ public:
         return avoidAsDummy_;
     }
 
+    /**
+     * Defines the maximum number of threads used to select the dummy
+     * derivatives of independent blocks of equations.
+     * Threads are only used when the verbosity level is None.
+     * By default a single thread is used.
+     *
+     * @param threadCount the maximum number of threads (1 disables
+     *                    multithreading)
+     */
+    inline void setThreadCount(size_t threadCount) {
+        threadCount_ = std::max<size_t>(1, threadCount);
+    }
+
+    /**
+     * The maximum number of threads used to select the dummy derivatives
+     * of independent blocks of equations.
+     */
+    inline size_t getThreadCount() const {
+        return threadCount_;
+    }
+
     virtual inline std::unique_ptr<ADFun<CG<Base>>> reduceIndex(std::vector<DaeVarInfo>& newVarInfo,
                                                                 std::vector<DaeEquationInfo>& newEqInfo) override {
 
@@ -330,8 +362,6 @@ protected:
         }
 
 
-        MatrixB workJac;
-
         while (true) {
 
             if (this->verbosity_ >= Verbosity::High) {
@@ -347,7 +377,7 @@ protected:
             }
 
             // Exploit the current equations for elimination of candidates
-            selectDummyDerivatives(eqs, vars, workJac);
+            selectDummyDerivatives(eqs, vars);
 
             /**
              * Consider all of the current equations that are
@@ -1320,17 +1350,20 @@ protected:
         auto& vnodes = graph.variables();
         auto& enodes = graph.equations();
 
-        jacSparsity_ = jacobianReverseSparsity<vector<bool>, CGBase>(*reducedFun_); // in the original variable order
+        jacSparsity_ = jacobianReverseSparsitySet<vector<std::set<size_t> >, CGBase>(*reducedFun_); // in the original variable order
+
+        // tape index -> is a time derivative of interest
+        vector<bool> derivTape(n, false);
+        for (size_t j = diffVarStart_; j < vnodes.size(); j++) {
+            CPPADCG_ASSERT_UNKNOWN(vnodes[j]->antiDerivative() != nullptr);
+            derivTape[vnodes[j]->tapeIndex()] = true;
+        }
 
         vector<size_t> row, col;
-        row.reserve((vnodes.size() - diffVarStart_) * (m - diffEqStart_));
-        col.reserve(row.capacity());
 
         for (size_t i = diffEqStart_; i < m; i++) {
-            for (size_t j = diffVarStart_; j < vnodes.size(); j++) {
-                CPPADCG_ASSERT_UNKNOWN(vnodes[j]->antiDerivative() != nullptr);
-                size_t t = vnodes[j]->tapeIndex();
-                if (jacSparsity_[i * n + t]) {
+            for (size_t t : jacSparsity_[i]) {
+                if (derivTape[t]) {
                     row.push_back(i);
                     col.push_back(t);
                 }
@@ -1350,13 +1383,15 @@ protected:
         // resize and zero matrix
         jacobian_.resize(m - diffEqStart_, vnodes.size() - diffVarStart_);
 
-        map<size_t, Vnode<Base>*> origIndex2var;
-        for (size_t j = diffVarStart_; j< vnodes.size(); j++) {
+        vector<Vnode<Base>*> origIndex2var(n, nullptr);
+        for (size_t j = diffVarStart_; j < vnodes.size(); j++) {
             Vnode<Base>* jj = vnodes[j];
             origIndex2var[jj->tapeIndex()] = jj;
         }
 
         // normalize values
+        vector<Eigen::Triplet<Base> > triplets;
+        triplets.reserve(jac.size());
         for (size_t e = 0; e < jac.size(); e++) {
             Enode<Base>* eqOrig = enodes[row[e]]->originalEquation();
             Vnode<Base>* vOrig = origIndex2var[col[e]]->originalVariable(graph.getOrigTimeDependentCount());
@@ -1368,8 +1403,9 @@ protected:
             size_t i = row[e]; // same order
             size_t j = origIndex2var[col[e]]->index(); // different order than in model/tape
 
-            jacobian_.coeffRef(i - diffEqStart_, j - diffVarStart_) = normVal;
+            triplets.push_back(Eigen::Triplet<Base>(i - diffEqStart_, j - diffVarStart_, normVal));
         }
+        jacobian_.setFromTriplets(triplets.begin(), triplets.end());
 
         jacobian_.makeCompressed();
 
@@ -1380,8 +1416,7 @@ protected:
     }
 
     inline void selectDummyDerivatives(const std::vector<Enode<Base>* >& eqs,
-                                       const std::vector<Vnode<Base>* >& vars,
-                                       MatrixB& work) {
+                                       const std::vector<Vnode<Base>* >& vars) {
 
         if (eqs.size() == vars.size()) {
             dummyD_.insert(dummyD_.end(), vars.begin(), vars.end());
@@ -1400,22 +1435,313 @@ protected:
         }
 
         /**
-         * Determine the columns/variables that must be removed
+         * Structure of the Jacobian sub-matrix (only the nonzeros)
          */
-        std::set<size_t> excludeCols;
-        std::set<size_t> avoidCols;
+        const size_t none = StructuralAnalysis::unassigned();
+        std::vector<size_t> col2Var(jacobian_.cols(), none);
         for (size_t j = 0; j < vars.size(); j++) {
-            Vnode<Base>* jj = vars[j];
-            bool notZero = false;
+            col2Var[vars[j]->index() - diffVarStart_] = j;
+        }
+
+        std::vector<size_t> rowStart(1, 0);
+        std::vector<size_t> cols;
+        rowStart.reserve(eqs.size() + 1);
+        for (Enode<Base>* ii : eqs) {
+            typedef typename Eigen::SparseMatrix<Base, Eigen::RowMajor>::InnerIterator InnerIterator;
+            for (InnerIterator it(jacobian_, ii->index() - diffEqStart_); it; ++it) {
+                size_t j = col2Var[it.col()];
+                if (j != none && it.value() != Base(0.0)) {
+                    cols.push_back(j);
+                }
+            }
+            rowStart.push_back(cols.size());
+        }
+
+        StructuralAnalysis structure(vars.size(), std::move(rowStart), std::move(cols));
+
+        if (structure.match() < eqs.size()) {
+            throw CGException("Failed to select dummy derivatives! "
+                              "The Jacobian of the differentiated equations is structurally singular.");
+        }
+
+        /**
+         * Split the system into blocks:
+         *  - the equations which only use the variables assigned to them
+         *    form a square system, all of its variables must be dummy
+         *    derivatives (one block for each diagonal block of the BLT
+         *    decomposition),
+         *  - the remaining equations have more variables than equations
+         *    (one block for each independent group of equations).
+         */
+        std::vector<size_t> underEqs, underVars;
+        structure.underdeterminedPart(underEqs, underVars);
+
+        std::vector<std::vector<Enode<Base>*> > blockEqs;
+        std::vector<std::vector<Vnode<Base>*> > blockVars;
+        std::vector<bool> blockSquare;
+
+        if (underEqs.size() < eqs.size()) {
+            std::vector<size_t> squareEqs, squareVars;
+            size_t u = 0;
             for (size_t i = 0; i < eqs.size(); i++) {
-                Enode<Base>* ii = eqs[i];
-                Base val = jacobian_.coeff(ii->index() - diffEqStart_, jj->index() - diffVarStart_);
-                if (val != Base(0.0)) {
-                    notZero = true;
+                if (u < underEqs.size() && underEqs[u] == i) {
+                    u++;
+                } else {
+                    squareEqs.push_back(i);
+                    squareVars.push_back(structure.getEquationAssignment()[i]);
+                }
+            }
+
+            StructuralAnalysis square = structure.subsystem(squareEqs, squareVars);
+            square.match();
+
+            for (const std::vector<size_t>& block : square.bltDecomposition()) {
+                blockEqs.emplace_back();
+                blockVars.emplace_back();
+                blockSquare.push_back(true);
+                for (size_t i : block) {
+                    blockEqs.back().push_back(eqs[squareEqs[i]]);
+                    blockVars.back().push_back(vars[squareVars[square.getEquationAssignment()[i]]]);
+                }
+            }
+        }
+
+        if (!underEqs.empty()) {
+            StructuralAnalysis under = structure.subsystem(underEqs, underVars);
+
+            std::vector<std::vector<size_t> > compEqs, compVars;
+            under.connectedComponents(compEqs, compVars);
+
+            for (size_t c = 0; c < compEqs.size(); c++) {
+                blockEqs.emplace_back();
+                blockVars.emplace_back();
+                blockSquare.push_back(false);
+                for (size_t i : compEqs[c])
+                    blockEqs.back().push_back(eqs[underEqs[i]]);
+                for (size_t j : compVars[c])
+                    blockVars.back().push_back(vars[underVars[j]]);
+            }
+        }
+
+        size_t nBlocks = blockEqs.size();
+
+        // the position of each variable (column) in its block
+        std::fill(col2Var.begin(), col2Var.end(), none);
+        for (const std::vector<Vnode<Base>*>& bVars : blockVars) {
+            for (size_t j = 0; j < bVars.size(); j++)
+                col2Var[bVars[j]->index() - diffVarStart_] = j;
+        }
+
+        if (this->verbosity_ >= Verbosity::High) {
+            log() << "# independent blocks: " << nBlocks << "\n";
+        }
+
+        std::vector<std::vector<Vnode<Base>*> > blockDummies(nBlocks);
+
+        auto selectBlock = [&](size_t b) {
+            if (blockSquare[b]) {
+                blockDummies[b] = selectSquareBlockDummyDerivatives(blockEqs[b], blockVars[b], col2Var);
+            } else {
+                blockDummies[b] = selectBlockDummyDerivatives(blockEqs[b], blockVars[b], col2Var);
+            }
+        };
+
+        size_t nThreads = std::min(threadCount_, nBlocks);
+        if (nThreads <= 1 || this->verbosity_ != Verbosity::None) {
+            for (size_t b = 0; b < nBlocks; b++) {
+                selectBlock(b);
+            }
+        } else {
+            /**
+             * the blocks are independent: each one is processed by the
+             * first available thread
+             */
+            std::atomic<size_t> nextBlock(0);
+            std::vector<std::exception_ptr> errors(nBlocks);
+
+            auto worker = [&]() {
+                for (size_t b = nextBlock++; b < nBlocks; b = nextBlock++) {
+                    try {
+                        selectBlock(b);
+                    } catch (...) {
+                        errors[b] = std::current_exception();
+                    }
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(nThreads - 1);
+            for (size_t t = 1; t < nThreads; t++)
+                threads.push_back(std::thread(worker));
+            worker();
+            for (std::thread& t : threads)
+                t.join();
+
+            for (const std::exception_ptr& e : errors) {
+                if (e != nullptr)
+                    std::rethrow_exception(e);
+            }
+        }
+
+        // keep a deterministic order
+        for (const std::vector<Vnode<Base>*>& newDummies : blockDummies) {
+            dummyD_.insert(dummyD_.end(), newDummies.begin(), newDummies.end());
+        }
+    }
+
+    /**
+     * Determines the position of a Jacobian column in a block.
+     *
+     * @param vars the variables of the block
+     * @param col2Var the position of each Jacobian column in its block
+     * @param col the Jacobian column
+     * @return the position in vars or StructuralAnalysis::unassigned() if
+     *         the column belongs to another block
+     */
+    inline size_t blockVariable(const std::vector<Vnode<Base>* >& vars,
+                                const std::vector<size_t>& col2Var,
+                                size_t col) const {
+        size_t j = col2Var[col];
+        if (j < vars.size() && vars[j]->index() - diffVarStart_ == col)
+            return j;
+        return StructuralAnalysis::unassigned();
+    }
+
+    /**
+     * Creates a sparse matrix with the normalized Jacobian of a block.
+     *
+     * @param eqs the equations of the block (the rows)
+     * @param vars the variables of the block
+     * @param col2Var the position of each Jacobian column in its block
+     * @param var2Col the column of each variable in the new matrix
+     *                (StructuralAnalysis::unassigned() to ignore it)
+     * @param nCols the number of columns of the new matrix
+     */
+    inline SparseMatrixB blockJacobian(const std::vector<Enode<Base>* >& eqs,
+                                       const std::vector<Vnode<Base>* >& vars,
+                                       const std::vector<size_t>& col2Var,
+                                       const std::vector<size_t>& var2Col,
+                                       size_t nCols) const {
+        typedef typename Eigen::SparseMatrix<Base, Eigen::RowMajor>::InnerIterator InnerIterator;
+
+        std::vector<Eigen::Triplet<Base> > triplets;
+        for (size_t i = 0; i < eqs.size(); i++) {
+            for (InnerIterator it(jacobian_, eqs[i]->index() - diffEqStart_); it; ++it) {
+                size_t j = blockVariable(vars, col2Var, it.col());
+                if (j != StructuralAnalysis::unassigned() && var2Col[j] != StructuralAnalysis::unassigned() &&
+                    it.value() != Base(0.0)) {
+                    triplets.push_back(Eigen::Triplet<Base>(i, var2Col[j], it.value()));
+                }
+            }
+        }
+
+        SparseMatrixB mat(eqs.size(), nCols);
+        mat.setFromTriplets(triplets.begin(), triplets.end());
+        return mat;
+    }
+
+    /**
+     * Selects the dummy derivatives for a diagonal block of the BLT
+     * decomposition of the square part of the system: all of its
+     * variables must be dummy derivatives, so it is only verified that
+     * the block is not singular.
+     * It can be called concurrently for different blocks.
+     *
+     * @param eqs the equations of the block
+     * @param vars the variables assigned to the equations of the block
+     * @param col2Var the position of each Jacobian column in its block
+     * @return the new dummy derivatives
+     */
+    inline std::vector<Vnode<Base>*> selectSquareBlockDummyDerivatives(const std::vector<Enode<Base>* >& eqs,
+                                                                       const std::vector<Vnode<Base>* >& vars,
+                                                                       const std::vector<size_t>& col2Var) const {
+        CPPADCG_ASSERT_UNKNOWN(eqs.size() == vars.size());
+
+        if (eqs.size() > 1) {
+            // a single equation always uses its (nonzero) variable
+            std::vector<size_t> var2Col(vars.size());
+            for (size_t j = 0; j < vars.size(); j++)
+                var2Col[j] = j;
+
+            SparseMatrixB work = blockJacobian(eqs, vars, col2Var, var2Col, vars.size());
+
+            if (this->verbosity_ >= Verbosity::High)
+                log() << "square subset Jac:\n" << MatrixB(work) << "\n";
+
+            Eigen::SparseQR<SparseMatrixB, Eigen::COLAMDOrdering<int> > qr(work);
+
+            if (qr.info() != Eigen::Success) {
+                throw CGException("Failed to select dummy derivatives! "
+                                  "QR decomposition of a submatrix of the Jacobian failed!");
+            } else if (qr.rank() < work.rows()) {
+                throw CGException("Failed to select dummy derivatives! "
+                                  "The resulting system is probably singular for the provided data.");
+            }
+        }
+
+        if (this->verbosity_ >= Verbosity::Low) {
+            for (Vnode<Base>* it : vars) {
+                if (avoidAsDummy_.find(it->name()) != avoidAsDummy_.end()) {
+                    log() << "Must use variables defined to be avoided by the user!\n";
                     break;
                 }
             }
-            if (!notZero) {
+        }
+
+        if (this->verbosity_ >= Verbosity::High) {
+            log() << "## new dummy derivatives: ";
+            for (Vnode<Base>* it : vars)
+                log() << *it << "; ";
+            log() << " \n\n";
+        }
+
+        return vars;
+    }
+
+    /**
+     * Selects dummy derivatives for a block of equations with more
+     * variables than equations which does not share variables with any
+     * other block.
+     * It can be called concurrently for different blocks.
+     *
+     * @param eqs the equations of the block
+     * @param vars the candidate variables of the block
+     * @param col2Var the position of each Jacobian column in its block
+     * @return the new dummy derivatives
+     */
+    inline std::vector<Vnode<Base>*> selectBlockDummyDerivatives(const std::vector<Enode<Base>* >& eqs,
+                                                                 const std::vector<Vnode<Base>* >& vars,
+                                                                 const std::vector<size_t>& col2Var) const {
+
+        if (eqs.size() == vars.size()) {
+            if (this->verbosity_ >= Verbosity::High) {
+                log() << "## new dummy derivatives: ";
+                for (Vnode<Base>* it : vars)
+                    log() << *it << "; ";
+                log() << " \n\n";
+            }
+            return vars;
+        }
+
+        /**
+         * Determine the columns/variables that must be removed
+         */
+        typedef typename Eigen::SparseMatrix<Base, Eigen::RowMajor>::InnerIterator InnerIterator;
+
+        std::vector<Base> colNorm(vars.size(), Base(0.0));
+        for (Enode<Base>* ii : eqs) {
+            for (InnerIterator it(jacobian_, ii->index() - diffEqStart_); it; ++it) {
+                size_t j = blockVariable(vars, col2Var, it.col());
+                if (j != StructuralAnalysis::unassigned()) {
+                    colNorm[j] += it.value() * it.value();
+                }
+            }
+        }
+
+        std::set<size_t> excludeCols;
+        std::set<size_t> avoidCols;
+        for (size_t j = 0; j < vars.size(); j++) {
+            if (colNorm[j] == Base(0.0)) {
                 // all zeros: must not choose this column/variable
                 excludeCols.insert(j);
             } else if (avoidAsDummy_.find(vars[j]->name()) != avoidAsDummy_.end()) {
@@ -1434,33 +1760,38 @@ protected:
 
         std::vector<Vnode<Base>* > varsLocal;
 
-        Eigen::ColPivHouseholderQR<MatrixB> qr;
+        SparseMatrixB work;
+        /**
+         * The columns are provided by decreasing norm and are not reordered
+         * by the factorization, therefore the first linearly independent
+         * columns are the ones with the largest norm (similar to a QR
+         * decomposition with column pivoting)
+         */
+        Eigen::SparseQR<SparseMatrixB, Eigen::NaturalOrdering<int> > qr;
 
         auto orderColumns = [&]() {
-            varsLocal.reserve(vars.size() - excludeCols.size());
+            std::vector<size_t> candidates;
+            candidates.reserve(vars.size() - excludeCols.size());
             for (size_t j = 0; j < vars.size(); j++) {
                 if (excludeCols.find(j) == excludeCols.end()) {
-                    varsLocal.push_back(vars[j]);
+                    candidates.push_back(j);
                 }
             }
-
-
-            work.setZero(eqs.size(), varsLocal.size());
-
-            // determine the rows that only contain a single nonzero (a single column)
-            for (size_t i = 0; i < eqs.size(); i++) {
-                Enode<Base>* ii = eqs[i];
-                for (size_t j = 0; j < varsLocal.size(); j++) {
-                    const Vnode<Base>* jj = varsLocal[j];
-                    Base val = jacobian_.coeff(ii->index() - diffEqStart_, jj->index() - diffVarStart_);
-                    if (val != Base(0.0)) {
-                        work(i, j) = val;
-                    }
-                }
+            std::stable_sort(candidates.begin(), candidates.end(), [&colNorm](size_t j1, size_t j2) {
+                return colNorm[j1] > colNorm[j2];
+            });
+
+            varsLocal.reserve(candidates.size());
+            std::vector<size_t> var2Local(vars.size(), StructuralAnalysis::unassigned());
+            for (size_t j : candidates) {
+                var2Local[j] = varsLocal.size();
+                varsLocal.push_back(vars[j]);
             }
 
+            work = blockJacobian(eqs, vars, col2Var, var2Local, varsLocal.size());
+
             if (this->verbosity_ >= Verbosity::High)
-                log() << "subset Jac:\n" << work << "\n";
+                log() << "subset Jac:\n" << MatrixB(work) << "\n";
 
             qr.compute(work);
 
@@ -1472,25 +1803,11 @@ protected:
                                   "The resulting system is probably singular for the provided data.");
             }
 
-            typedef typename Eigen::ColPivHouseholderQR<MatrixB>::PermutationType PermutationMatrix;
-            typedef typename PermutationMatrix::IndicesType Indices;
-
-            const PermutationMatrix& p = qr.colsPermutation();
-            const Indices& indices = p.indices();
-
             if (this->verbosity_ >= Verbosity::High) {
-                log() << "## matrix Q:\n";
-                MatrixB q = qr.matrixQ();
-                log() << q << "\n";
                 log() << "## matrix R:\n";
-                MatrixB r = qr.matrixR().template triangularView<Eigen::Upper>();
+                MatrixB r = MatrixB(qr.matrixR()).template triangularView<Eigen::Upper>();
                 log() << r << "\n";
-                log() << "## matrix P: " << indices.transpose() << "\n";
-            }
-
-            if (indices.size() < work.rows()) {
-                throw CGException("Failed to select dummy derivatives! "
-                                  "The resulting system is probably singular for the provided data.");
+                log() << "## matrix P: " << qr.colsPermutation().indices().transpose() << "\n";
             }
         };
 
@@ -1545,7 +1862,7 @@ protected:
             }
 
         } else {
-            // use order provided by the householder column pivoting
+            // use the order of the independent columns
             for (int i = 0; i < work.rows(); i++) {
                 newDummies.push_back(varsLocal[indices(i)]);
             }
@@ -1563,7 +1880,7 @@ protected:
         }
 #endif
 
-        dummyD_.insert(dummyD_.end(), newDummies.begin(), newDummies.end());
+        return newDummies;
     }
 
     inline static void printModel(std::ostream& out,
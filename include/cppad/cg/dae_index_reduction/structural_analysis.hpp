@@ -0,0 +1,514 @@
+#ifndef CPPAD_CG_STRUCTURAL_ANALYSIS_INCLUDED
+#define CPPAD_CG_STRUCTURAL_ANALYSIS_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Structural analysis of large sparse systems of equations.
+ * The incidence matrix (equations -> variables) is kept in a compressed
+ * sparse row (CSR) format so that systems with a very large number of
+ * equations can be analysed in (almost) linear time:
+ *  - maximum matching of equations to variables (Hopcroft-Karp),
+ *  - the underdetermined part of the system (Dulmage-Mendelsohn),
+ *  - block lower triangular (BLT) decomposition (Tarjan's strongly
+ *    connected components),
+ *  - independent (connected) components.
+ *
+ * All algorithms are iterative (no recursion) in order to support very
+ * long augmenting paths and very deep dependency chains.
+ */
+class StructuralAnalysis {
+protected:
+    // number of equations
+    size_t nEq_;
+    // number of variables
+    size_t nVar_;
+    // the position in cols_ of the first variable of each equation (size nEq_ + 1)
+    std::vector<size_t> rowStart_;
+    // variables used by each equation
+    std::vector<size_t> cols_;
+    // the variable assigned to each equation
+    std::vector<size_t> eq2Var_;
+    // the equation assigned to each variable
+    std::vector<size_t> var2Eq_;
+public:
+
+    /**
+     * Creates a new structural analysis using the CSR format
+     *
+     * @param nVar the number of variables
+     * @param rowStart the position in cols of the first variable of each
+     *                 equation (the last element is the size of cols)
+     * @param cols the variables used by each equation
+     */
+    inline StructuralAnalysis(size_t nVar,
+                              std::vector<size_t> rowStart,
+                              std::vector<size_t> cols) :
+        nEq_(rowStart.empty() ? 0 : rowStart.size() - 1),
+        nVar_(nVar),
+        rowStart_(std::move(rowStart)),
+        cols_(std::move(cols)) {
+        if (rowStart_.empty())
+            rowStart_.push_back(0);
+
+        CPPADCG_ASSERT_KNOWN(rowStart_.back() == cols_.size(), "Invalid CSR structure");
+        for (size_t j : cols_) {
+            CPPADCG_ASSERT_KNOWN(j < nVar_, "Invalid variable index");
+        }
+    }
+
+    /**
+     * Creates a new structural analysis
+     *
+     * @param nVar the number of variables
+     * @param eqVars the variables used by each equation
+     */
+    template<class VectorSet>
+    inline StructuralAnalysis(size_t nVar,
+                              const VectorSet& eqVars) :
+        nEq_(eqVars.size()),
+        nVar_(nVar) {
+        rowStart_.reserve(nEq_ + 1);
+        rowStart_.push_back(0);
+        for (size_t i = 0; i < nEq_; i++) {
+            for (size_t j : eqVars[i]) {
+                CPPADCG_ASSERT_KNOWN(j < nVar_, "Invalid variable index");
+                cols_.push_back(j);
+            }
+            rowStart_.push_back(cols_.size());
+        }
+    }
+
+    inline size_t getEquationCount() const {
+        return nEq_;
+    }
+
+    inline size_t getVariableCount() const {
+        return nVar_;
+    }
+
+    /**
+     * The value used for equations/variables without an assignment
+     */
+    static inline size_t unassigned() {
+        return (std::numeric_limits<size_t>::max)();
+    }
+
+    /**
+     * Determines a maximum matching between equations and variables
+     * using the Hopcroft-Karp algorithm.
+     *
+     * @return the number of assigned equations
+     */
+    inline size_t match() {
+        const size_t none = unassigned();
+
+        eq2Var_.assign(nEq_, none);
+        var2Eq_.assign(nVar_, none);
+
+        size_t matched = 0;
+
+        // cheap initial assignment
+        for (size_t i = 0; i < nEq_; i++) {
+            for (size_t k = rowStart_[i]; k < rowStart_[i + 1]; k++) {
+                size_t j = cols_[k];
+                if (var2Eq_[j] == none) {
+                    eq2Var_[i] = j;
+                    var2Eq_[j] = i;
+                    matched++;
+                    break;
+                }
+            }
+        }
+
+        std::vector<size_t> dist(nEq_);
+        std::vector<size_t> next(nEq_);
+        std::vector<size_t> queue;
+        std::vector<size_t> stack;
+        queue.reserve(nEq_);
+
+        while (matched < nEq_) {
+            /**
+             * breadth first search from all unassigned equations
+             */
+            queue.clear();
+            for (size_t i = 0; i < nEq_; i++) {
+                if (eq2Var_[i] == none) {
+                    dist[i] = 0;
+                    queue.push_back(i);
+                } else {
+                    dist[i] = none;
+                }
+            }
+
+            bool found = false;
+            for (size_t q = 0; q < queue.size(); q++) {
+                size_t i = queue[q];
+                for (size_t k = rowStart_[i]; k < rowStart_[i + 1]; k++) {
+                    size_t i2 = var2Eq_[cols_[k]];
+                    if (i2 == none) {
+                        found = true;
+                    } else if (dist[i2] == none) {
+                        dist[i2] = dist[i] + 1;
+                        queue.push_back(i2);
+                    }
+                }
+            }
+
+            if (!found)
+                break; // maximum matching
+
+            /**
+             * depth first search for vertex disjoint augmenting paths
+             */
+            for (size_t i = 0; i < nEq_; i++)
+                next[i] = rowStart_[i];
+
+            size_t augmented = 0;
+            for (size_t root = 0; root < nEq_; root++) {
+                if (eq2Var_[root] != none)
+                    continue;
+
+                stack.clear();
+                stack.push_back(root);
+
+                while (!stack.empty()) {
+                    size_t i = stack.back();
+                    if (next[i] == rowStart_[i + 1]) {
+                        // dead end
+                        dist[i] = none;
+                        stack.pop_back();
+                        continue;
+                    }
+
+                    size_t j = cols_[next[i]];
+                    size_t i2 = var2Eq_[j];
+                    if (i2 == none) {
+                        // augment the matching along the path
+                        for (size_t s = stack.size(); s-- > 0;) {
+                            size_t e = stack[s];
+                            size_t v = cols_[next[e]];
+                            eq2Var_[e] = v;
+                            var2Eq_[v] = e;
+                        }
+                        augmented++;
+                        break;
+                    } else if (dist[i2] != none && dist[i2] == dist[i] + 1) {
+                        stack.push_back(i2);
+                    } else {
+                        next[i]++;
+                    }
+                }
+            }
+
+            if (augmented == 0)
+                break;
+
+            matched += augmented;
+        }
+
+        return matched;
+    }
+
+    /**
+     * The variable assigned to each equation by match()
+     * (unassigned() for equations without a variable)
+     */
+    inline const std::vector<size_t>& getEquationAssignment() const {
+        return eq2Var_;
+    }
+
+    /**
+     * The equation assigned to each variable by match()
+     * (unassigned() for variables without an equation)
+     */
+    inline const std::vector<size_t>& getVariableAssignment() const {
+        return var2Eq_;
+    }
+
+    /**
+     * Creates the structure of a subsystem.
+     *
+     * @param eqs the equations of the subsystem
+     * @param vars the variables of the subsystem (the other variables are
+     *             ignored)
+     * @return the structure of the subsystem, where the equations and
+     *         variables are identified by their positions in eqs and vars
+     */
+    inline StructuralAnalysis subsystem(const std::vector<size_t>& eqs,
+                                        const std::vector<size_t>& vars) const {
+        const size_t none = unassigned();
+
+        std::vector<size_t> var2Local(nVar_, none);
+        for (size_t j = 0; j < vars.size(); j++) {
+            CPPADCG_ASSERT_KNOWN(vars[j] < nVar_, "Invalid variable index");
+            var2Local[vars[j]] = j;
+        }
+
+        std::vector<size_t> rowStart(1, 0);
+        std::vector<size_t> cols;
+        rowStart.reserve(eqs.size() + 1);
+        for (size_t i : eqs) {
+            CPPADCG_ASSERT_KNOWN(i < nEq_, "Invalid equation index");
+            for (size_t k = rowStart_[i]; k < rowStart_[i + 1]; k++) {
+                size_t j = var2Local[cols_[k]];
+                if (j != none)
+                    cols.push_back(j);
+            }
+            rowStart.push_back(cols.size());
+        }
+
+        return StructuralAnalysis(vars.size(), std::move(rowStart), std::move(cols));
+    }
+
+    /**
+     * Determines the equations and variables which can be reached from the
+     * variables without an assigned equation through alternating paths
+     * (the underdetermined part of the Dulmage-Mendelsohn decomposition).
+     * The remaining equations only use the variables assigned to them and
+     * form a square system.
+     * Variables which are not used by any equation are ignored.
+     *
+     * @param eqs the equations of the underdetermined part (output)
+     * @param vars the variables of the underdetermined part (output)
+     */
+    inline void underdeterminedPart(std::vector<size_t>& eqs,
+                                    std::vector<size_t>& vars) const {
+        CPPADCG_ASSERT_KNOWN(eq2Var_.size() == nEq_, "match() must be called first");
+
+        const size_t none = unassigned();
+
+        // the equations using each variable (transposed structure)
+        std::vector<size_t> colStart(nVar_ + 1, 0);
+        for (size_t j : cols_)
+            colStart[j + 1]++;
+        for (size_t j = 0; j < nVar_; j++)
+            colStart[j + 1] += colStart[j];
+
+        std::vector<size_t> rows(cols_.size());
+        std::vector<size_t> next(colStart.begin(), colStart.end() - 1);
+        for (size_t i = 0; i < nEq_; i++) {
+            for (size_t k = rowStart_[i]; k < rowStart_[i + 1]; k++)
+                rows[next[cols_[k]]++] = i;
+        }
+
+        std::vector<bool> eqUsed(nEq_, false);
+        std::vector<bool> varUsed(nVar_, false);
+        std::vector<size_t> queue;
+
+        for (size_t j = 0; j < nVar_; j++) {
+            if (var2Eq_[j] == none && colStart[j] != colStart[j + 1]) {
+                varUsed[j] = true;
+                queue.push_back(j);
+            }
+        }
+
+        for (size_t q = 0; q < queue.size(); q++) {
+            size_t j = queue[q];
+            for (size_t k = colStart[j]; k < colStart[j + 1]; k++) {
+                size_t i = rows[k];
+                if (eqUsed[i])
+                    continue;
+                eqUsed[i] = true;
+
+                size_t v = eq2Var_[i];
+                if (v != none && !varUsed[v]) {
+                    varUsed[v] = true;
+                    queue.push_back(v);
+                }
+            }
+        }
+
+        eqs.clear();
+        vars.clear();
+        for (size_t i = 0; i < nEq_; i++) {
+            if (eqUsed[i])
+                eqs.push_back(i);
+        }
+        for (size_t j = 0; j < nVar_; j++) {
+            if (varUsed[j])
+                vars.push_back(j);
+        }
+    }
+
+    /**
+     * Determines the block lower triangular decomposition of the system
+     * using the assignment from match() and Tarjan's algorithm for
+     * strongly connected components.
+     *
+     * @return the equations in each block, sorted in the order in which
+     *         the blocks must be solved
+     */
+    inline std::vector<std::vector<size_t> > bltDecomposition() const {
+        CPPADCG_ASSERT_KNOWN(eq2Var_.size() == nEq_, "match() must be called first");
+
+        const size_t none = unassigned();
+
+        std::vector<std::vector<size_t> > blocks;
+
+        std::vector<size_t> index(nEq_, none);
+        std::vector<size_t> low(nEq_, 0);
+        std::vector<bool> onStack(nEq_, false);
+        std::vector<size_t> sccStack;
+        std::vector<std::pair<size_t, size_t> > call; // (equation, position in cols_)
+        size_t counter = 0;
+
+        for (size_t root = 0; root < nEq_; root++) {
+            if (index[root] != none)
+                continue;
+
+            index[root] = low[root] = counter++;
+            sccStack.push_back(root);
+            onStack[root] = true;
+            call.push_back(std::make_pair(root, rowStart_[root]));
+
+            while (!call.empty()) {
+                size_t v = call.back().first;
+                size_t& pos = call.back().second;
+
+                if (pos < rowStart_[v + 1]) {
+                    // equation v depends on the equation used to determine variable j
+                    size_t j = cols_[pos++];
+                    size_t w = var2Eq_[j];
+                    if (w == none || w == v)
+                        continue;
+
+                    if (index[w] == none) {
+                        index[w] = low[w] = counter++;
+                        sccStack.push_back(w);
+                        onStack[w] = true;
+                        call.push_back(std::make_pair(w, rowStart_[w]));
+                    } else if (onStack[w]) {
+                        low[v] = std::min(low[v], index[w]);
+                    }
+                } else {
+                    if (low[v] == index[v]) {
+                        // v is the root of a strongly connected component
+                        blocks.push_back(std::vector<size_t>());
+                        std::vector<size_t>& block = blocks.back();
+                        size_t w;
+                        do {
+                            w = sccStack.back();
+                            sccStack.pop_back();
+                            onStack[w] = false;
+                            block.push_back(w);
+                        } while (w != v);
+                        std::sort(block.begin(), block.end());
+                    }
+
+                    call.pop_back();
+                    if (!call.empty()) {
+                        size_t u = call.back().first;
+                        low[u] = std::min(low[u], low[v]);
+                    }
+                }
+            }
+        }
+
+        return blocks;
+    }
+
+    /**
+     * Determines the groups of equations and variables which are
+     * independent from each other (connected components of the bipartite
+     * graph).
+     * Variables which are not used by any equation are ignored.
+     *
+     * @param eqs the equations in each component (output)
+     * @param vars the variables in each component (output)
+     */
+    inline void connectedComponents(std::vector<std::vector<size_t> >& eqs,
+                                    std::vector<std::vector<size_t> >& vars) const {
+        const size_t none = unassigned();
+
+        // union-find over the variables
+        std::vector<size_t> parent(nVar_);
+        for (size_t j = 0; j < nVar_; j++)
+            parent[j] = j;
+
+        auto find = [&parent](size_t j) {
+            while (parent[j] != j) {
+                parent[j] = parent[parent[j]];
+                j = parent[j];
+            }
+            return j;
+        };
+
+        for (size_t i = 0; i < nEq_; i++) {
+            if (rowStart_[i] == rowStart_[i + 1])
+                continue;
+            size_t r = find(cols_[rowStart_[i]]);
+            for (size_t k = rowStart_[i] + 1; k < rowStart_[i + 1]; k++) {
+                size_t r2 = find(cols_[k]);
+                if (r2 != r) {
+                    parent[std::max(r, r2)] = std::min(r, r2);
+                    r = std::min(r, r2);
+                }
+            }
+        }
+
+        eqs.clear();
+        vars.clear();
+
+        std::vector<size_t> root2Comp(nVar_, none);
+        std::vector<bool> used(nVar_, false);
+
+        for (size_t i = 0; i < nEq_; i++) {
+            size_t c;
+            if (rowStart_[i] == rowStart_[i + 1]) {
+                // an equation without variables
+                c = eqs.size();
+                eqs.resize(c + 1);
+                vars.resize(c + 1);
+            } else {
+                size_t r = find(cols_[rowStart_[i]]);
+                if (root2Comp[r] == none) {
+                    root2Comp[r] = eqs.size();
+                    eqs.resize(eqs.size() + 1);
+                    vars.resize(vars.size() + 1);
+                }
+                c = root2Comp[r];
+
+                for (size_t k = rowStart_[i]; k < rowStart_[i + 1]; k++) {
+                    size_t j = cols_[k];
+                    if (!used[j]) {
+                        used[j] = true;
+                        vars[c].push_back(j);
+                    }
+                }
+            }
+            eqs[c].push_back(i);
+        }
+
+        for (std::vector<size_t>& v : vars) {
+            std::sort(v.begin(), v.end());
+        }
+    }
+
+    inline virtual ~StructuralAnalysis() {
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -71,6 +71,9 @@ class BidirGraph;
 template<class Base>
 class ScopePathElement;
 
+template<class Base>
+class GraphSimplifier;
+
 /***************************************************************************
  * Nodes
  **************************************************************************/
@@ -272,10 +275,15 @@ enum class Verbosity {
 };
 
 /**
- * Automatic Differentiation modes used to determine the Jacobian
+ * Automatic Differentiation modes used to determine the Jacobian.
+ * Automatic uses a heuristic based on the Jacobian dimensions while
+ * Cheapest creates the operation graph for each mode and selects the one
+ * with the fewest operations.
+ * Bidirectional uses the reverse mode for the densest rows and the
+ * forward mode for the remaining elements (sparse Jacobian only).
  */
 enum class JacobianADMode {
-    Forward, Reverse, Automatic
+    Forward, Reverse, Automatic, Cheapest, Bidirectional
 };
 
 /**
@@ -432,6 +432,9 @@ protected:
             case CGOpCode::Exp: //  exp(variable)
                 return thisOps.evalExp(node);
 
+            case CGOpCode::Fma: //  fma(a, b, c)
+                return thisOps.evalFma(node);
+
             case CGOpCode::Inv: //                             independent variable
                 return thisOps.evalIndependent(node);
 
@@ -592,6 +595,32 @@ protected:
         return exp(evalArg(args, 0));
     }
 
+    inline ActiveOut evalFma(const NodeIn& node) {
+        const std::vector<ArgIn>& args = node.getArguments();
+        CPPADCG_ASSERT_KNOWN(args.size() == 3, "Invalid number of arguments for fma()");
+        return fusedMultiplyAdd(evalArg(args, 0), evalArg(args, 1), evalArg(args, 2),
+                                std::is_floating_point<ActiveOut>());
+    }
+
+    /**
+     * Determines a * b + c with a single rounding (std::fma) for
+     * floating-point types.
+     */
+    template<class T>
+    static inline T fusedMultiplyAdd(const T& a, const T& b, const T& c,
+                                     std::true_type) {
+        return std::fma(a, b, c);
+    }
+
+    /**
+     * Determines a * b + c for types without a fused multiply-add operation.
+     */
+    template<class T>
+    static inline T fusedMultiplyAdd(const T& a, const T& b, const T& c,
+                                     std::false_type) {
+        return a * b + c;
+    }
+
     inline ActiveOut evalIndependent(const NodeIn& node) {
         size_t index = this->handler_.getIndependentVariableIndex(node);
         return this->indep_[index];
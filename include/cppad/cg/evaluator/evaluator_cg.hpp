@@ -168,6 +168,37 @@ protected:
 
     }
 
+    /**
+     * Keeps fma() as a single operation so that there is only one rounding.
+     *
+     * @note overrides the default evalFma() even though this method
+     *        is not virtual (hides a method in EvaluatorOperations)
+     */
+    inline ActiveOut evalFma(const NodeIn& node) {
+        const std::vector<ArgIn>& args = node.getArguments();
+        CPPADCG_ASSERT_KNOWN(args.size() == 3, "Invalid number of arguments for fma()");
+        ActiveOut a = this->evalArg(args, 0);
+        ActiveOut b = this->evalArg(args, 1);
+        ActiveOut c = this->evalArg(args, 2);
+        std::is_floating_point<ScalarOut> fp;
+
+        if (a.isParameter() && b.isParameter() && c.isParameter()) {
+            return ActiveOut(Super::fusedMultiplyAdd(a.getValue(), b.getValue(), c.getValue(), fp));
+        }
+
+        CodeHandler<ScalarOut>* handler = outHandler_;
+        for (const ActiveOut* v : {&a, &b, &c}) {
+            if (handler == nullptr)
+                handler = v->getCodeHandler();
+        }
+
+        ActiveOut result(*handler->makeNode(CGOpCode::Fma, {a.argument(), b.argument(), c.argument()}));
+        if (a.isValueDefined() && b.isValueDefined() && c.isValueDefined()) {
+            result.setValue(Super::fusedMultiplyAdd(a.getValue(), b.getValue(), c.getValue(), fp));
+        }
+        return result;
+    }
+
     /**
      * @note overrides the default evalArrayElement() even though this method
      *        is not virtual (hides a method in EvaluatorOperations)
@@ -109,10 +109,23 @@ inline VectorSet hessianSparsitySet(ADFun<Base>& fun,
                                     size_t i,
                                     bool transpose = false);
 
+template<class VectorSet, class Base>
+inline std::vector<VectorSet> hessianSparsitySet(ADFun<Base>& fun,
+                                                 const std::vector<std::set<size_t> >& groups,
+                                                 bool transpose = false);
+
+template<class Base>
+inline std::vector<std::map<size_t, std::set<size_t> > > hessianSparsityByEquation(ADFun<Base>& fun,
+                                                                                    const std::set<size_t>& vars = std::set<size_t>());
+
 /***********************************************************************
  * Sparsity conversion
  **********************************************************************/
 
+template<class VectorBool, class VectorSet>
+inline VectorBool sparsitySetToBool(const VectorSet& sparsity,
+                                    size_t nCols);
+
 template<class VectorBool, class VectorSize>
 inline void generateSparsityIndexes(const VectorBool& sparsity,
                                     size_t m,
@@ -18,33 +18,6 @@
 namespace CppAD {
 namespace cg {
 
-template<class VectorBool, class Base>
-inline VectorBool jacobianForwardSparsity(ADFun<Base>& fun) {
-    size_t n = fun.Domain();
-
-    VectorBool r(n * n);
-    for (size_t j = 0; j < n; j++) {
-        for (size_t k = 0; k < n; k++)
-            r[j * n + k] = false;
-        r[j * n + j] = true;
-    }
-    return fun.ForSparseJac(n, r);
-
-}
-
-template<class VectorBool, class Base>
-inline VectorBool jacobianReverseSparsity(ADFun<Base>& fun) {
-    size_t m = fun.Range();
-
-    VectorBool s(m * m);
-    for (size_t i = 0; i < m; i++) {
-        for (size_t k = 0; k < m; k++)
-            s[i * m + k] = false;
-        s[i * m + i] = true;
-    }
-    return fun.RevSparseJac(m, s);
-}
-
 template<class VectorSet, class Base>
 inline VectorSet jacobianForwardSparsitySet(ADFun<Base>& fun) {
     size_t n = fun.Domain();
@@ -67,6 +40,53 @@ inline VectorSet jacobianReverseSparsitySet(ADFun<Base>& fun) {
     return fun.RevSparseJac(m, s_s);
 }
 
+/**
+ * Converts a sparsity pattern stored with a set of column indexes per row
+ * into a (row-major) vector of booleans.
+ *
+ * @param sparsity the column indexes of each row
+ * @param nCols the number of columns
+ */
+template<class VectorBool, class VectorSet>
+inline VectorBool sparsitySetToBool(const VectorSet& sparsity,
+                                    size_t nCols) {
+    size_t m = sparsity.size();
+
+    VectorBool b(m * nCols);
+    for (size_t k = 0; k < m * nCols; k++)
+        b[k] = false;
+
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j : sparsity[i])
+            b[i * nCols + j] = true;
+    }
+    return b;
+}
+
+/**
+ * Determines the Jacobian sparsity using a forward mode sweep.
+ * The sweep uses sets (an n*n boolean identity would be required
+ * otherwise); only the result is dense.
+ */
+template<class VectorBool, class Base>
+inline VectorBool jacobianForwardSparsity(ADFun<Base>& fun) {
+    typedef std::vector<std::set<size_t> > VectorSet;
+
+    return sparsitySetToBool<VectorBool>(jacobianForwardSparsitySet<VectorSet, Base>(fun), fun.Domain());
+}
+
+/**
+ * Determines the Jacobian sparsity using a reverse mode sweep.
+ * The sweep uses sets (an m*m boolean identity would be required
+ * otherwise); only the result is dense.
+ */
+template<class VectorBool, class Base>
+inline VectorBool jacobianReverseSparsity(ADFun<Base>& fun) {
+    typedef std::vector<std::set<size_t> > VectorSet;
+
+    return sparsitySetToBool<VectorBool>(jacobianReverseSparsitySet<VectorSet, Base>(fun), fun.Domain());
+}
+
 /**
  * Determines the Jacobian sparsity for a model
  * 
@@ -124,36 +144,6 @@ inline bool estimateBestJacobianADMode(const std::vector<size_t>& jacRows,
     return workForward <= workReverse;
 }
 
-/**
- * Determines the sum of the hessian sparsities for all the dependent 
- * variables in a model
- * 
- * @param fun The model
- * @return The sum of the hessian sparsities
- */
-template<class VectorBool, class Base>
-inline VectorBool hessianSparsity(ADFun<Base>& fun,
-                                  bool transpose = false) {
-    size_t m = fun.Range();
-    size_t n = fun.Domain();
-
-    /**
-     * Determine the sparsity pattern p for Hessian of w^T F
-     */
-    VectorBool r(n * n); // identity matrix
-    for (size_t j = 0; j < n; j++) {
-        for (size_t k = 0; k < n; k++)
-            r[j * n + k] = false;
-        r[j * n + j] = true;
-    }
-    fun.ForSparseJac(n, r);
-
-    VectorBool s(m);
-    for (size_t i = 0; i < m; i++)
-        s[i] = true;
-    return fun.RevSparseHes(n, s, transpose);
-}
-
 template<class VectorSet, class Base>
 inline VectorSet hessianSparsitySet(ADFun<Base>& fun,
                                     const std::set<size_t>& w,
@@ -185,9 +175,45 @@ inline VectorSet hessianSparsitySet(ADFun<Base>& fun, bool transpose = false) {
     return hessianSparsitySet<VectorSet, Base>(fun, w, transpose);
 }
 
+template<class VectorSet, class Base>
+inline VectorSet hessianSparsitySet(ADFun<Base>& fun,
+                                    size_t i,
+                                    bool transpose = false) {
+    size_t n = fun.Domain();
+
+    VectorSet r(n); // identity matrix
+    for (size_t j = 0; j < n; j++)
+        r[j].insert(j);
+    fun.ForSparseJac(n, r);
+
+    VectorSet s(1);
+    s[0].insert(i);
+
+    return fun.RevSparseHes(n, s, transpose);
+}
+
+/**
+ * Determines the sum of the hessian sparsities for all the dependent 
+ * variables in a model.
+ * The sweeps use sets (an n*n boolean identity would be required
+ * otherwise); only the result is dense.
+ * 
+ * @param fun The model
+ * @return The sum of the hessian sparsities
+ */
+template<class VectorBool, class Base>
+inline VectorBool hessianSparsity(ADFun<Base>& fun,
+                                  bool transpose = false) {
+    typedef std::vector<std::set<size_t> > VectorSet;
+
+    return sparsitySetToBool<VectorBool>(hessianSparsitySet<VectorSet, Base>(fun, transpose), fun.Domain());
+}
+
 /**
  * Determines the hessian sparsity for a given dependent variable/equation
- * in a model
+ * in a model.
+ * The sweeps use sets (an n*n boolean identity would be required
+ * otherwise); only the result is dense.
  * 
  * @param fun The model
  * @param i The dependent variable/equation index
@@ -197,42 +223,140 @@ template<class VectorBool, class Base>
 inline VectorBool hessianSparsity(ADFun<Base>& fun,
                                   size_t i,
                                   bool transpose = false) {
-    size_t m = fun.Range();
+    typedef std::vector<std::set<size_t> > VectorSet;
+
+    return sparsitySetToBool<VectorBool>(hessianSparsitySet<VectorSet, Base>(fun, i, transpose), fun.Domain());
+}
+
+/**
+ * Determines the hessian sparsity of the sum of each group of dependent
+ * variables/equations.
+ * A single forward Jacobian sparsity sweep is shared by all the groups
+ * (one reverse Hessian sparsity sweep per group).
+ * 
+ * @param fun The model
+ * @param groups The dependent variable/equation indexes of each group
+ * @return The hessian sparsity of each group
+ */
+template<class VectorSet, class Base>
+inline std::vector<VectorSet> hessianSparsitySet(ADFun<Base>& fun,
+                                                 const std::vector<std::set<size_t> >& groups,
+                                                 bool transpose = false) {
     size_t n = fun.Domain();
 
-    /**
-     * Determine the sparsity pattern p for Hessian of w^T F
-     */
-    VectorBool r(n * n); // identity matrix
-    for (size_t j = 0; j < n; j++) {
-        for (size_t k = 0; k < n; k++)
-            r[j * n + k] = false;
-        r[j * n + j] = true;
-    }
+    VectorSet r(n); // identity matrix
+    for (size_t j = 0; j < n; j++)
+        r[j].insert(j);
     fun.ForSparseJac(n, r);
 
-    VectorBool s(m);
-    for (size_t ii = 0; ii < m; ii++)
-        s[ii] = false;
-    s[i] = true;
-    return fun.RevSparseHes(n, s, transpose);
+    std::vector<VectorSet> hess(groups.size());
+
+    VectorSet s(1);
+    for (size_t g = 0; g < groups.size(); g++) {
+        s[0] = groups[g];
+        hess[g] = fun.RevSparseHes(n, s, transpose);
+    }
+
+    return hess;
 }
 
-template<class VectorSet, class Base>
-inline VectorSet hessianSparsitySet(ADFun<Base>& fun,
-                                    size_t i,
-                                    bool transpose = false) {
+/**
+ * Determines the hessian sparsity of each dependent variable/equation.
+ * A single forward Jacobian sparsity sweep is used and equations which
+ * do not share independent variables are combined in the same reverse
+ * Hessian sparsity sweep (greedy coloring of the Jacobian rows).
+ * Only the non-empty rows are stored so that the memory does not grow
+ * with the number of equations times the number of variables.
+ * The forward Jacobian sparsity of the identity matrix remains stored in
+ * the model and can be reused by further calls to RevSparseHes().
+ * 
+ * @param fun The model
+ * @param vars The independent variables of interest (rows and columns
+ *             with other variables are ignored); all when empty
+ * @return The non-empty rows of the hessian sparsity of each equation
+ *         (row index to column indexes)
+ */
+template<class Base>
+inline std::vector<std::map<size_t, std::set<size_t> > > hessianSparsityByEquation(ADFun<Base>& fun,
+                                                                                    const std::set<size_t>& vars = std::set<size_t>()) {
+    typedef std::vector<std::set<size_t> > VectorSet;
+
+    size_t m = fun.Range();
     size_t n = fun.Domain();
 
     VectorSet r(n); // identity matrix
     for (size_t j = 0; j < n; j++)
         r[j].insert(j);
-    fun.ForSparseJac(n, r);
+    VectorSet jac = fun.ForSparseJac(n, r);
+
+    /**
+     * coloring
+     */
+    std::vector<std::set<size_t> > colorEqs;
+    std::vector<std::map<size_t, size_t> > colorVar2Eq;
+    for (size_t i = 0; i < m; i++) {
+        std::set<size_t> row;
+        if (vars.empty()) {
+            row.swap(jac[i]);
+        } else {
+            std::set_intersection(jac[i].begin(), jac[i].end(), vars.begin(), vars.end(),
+                                  std::inserter(row, row.end()));
+        }
+        if (row.empty())
+            continue;
+
+        size_t c = 0;
+        for (; c < colorEqs.size(); c++) {
+            const std::map<size_t, size_t>& used = colorVar2Eq[c];
+            bool shared = false;
+            for (size_t j : row) {
+                if (used.find(j) != used.end()) {
+                    shared = true;
+                    break;
+                }
+            }
+            if (!shared)
+                break;
+        }
+        if (c == colorEqs.size()) {
+            colorEqs.resize(c + 1);
+            colorVar2Eq.resize(c + 1);
+        }
+
+        colorEqs[c].insert(i);
+        for (size_t j : row)
+            colorVar2Eq[c][j] = i;
+    }
+
+    /**
+     * a reverse sweep for each color
+     */
+    std::vector<std::map<size_t, std::set<size_t> > > hess(m);
 
     VectorSet s(1);
-    s[0].insert(i);
+    for (size_t c = 0; c < colorEqs.size(); c++) {
+        s[0] = colorEqs[c];
+        VectorSet hc = fun.RevSparseHes(n, s, false);
+
+        for (const auto& it : colorVar2Eq[c]) {
+            size_t j = it.first;
+            std::set<size_t>& hrow = hc[j];
+            if (hrow.empty())
+                continue;
+
+            if (vars.empty()) {
+                hess[it.second][j].swap(hrow);
+            } else {
+                std::set<size_t> row;
+                std::set_intersection(hrow.begin(), hrow.end(), vars.begin(), vars.end(),
+                                      std::inserter(row, row.end()));
+                if (!row.empty())
+                    hess[it.second][j].swap(row);
+            }
+        }
+    }
 
-    return fun.RevSparseHes(n, s, transpose);
+    return hess;
 }
 
 template<class VectorBool, class VectorSize>
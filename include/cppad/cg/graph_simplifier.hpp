@@ -0,0 +1,652 @@
+#ifndef CPPAD_CG_GRAPH_SIMPLIFIER_INCLUDED
+#define CPPAD_CG_GRAPH_SIMPLIFIER_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Defines which changes to the floating point results are acceptable when
+ * operations are rewritten (from the most to the least strict).
+ */
+enum class FloatingPointStrictness {
+    /**
+     * Only rewrites which are also performed by compilers without any
+     * fast-math option (e.g. pow(x, 2) -> x * x, x / 4 -> x * 0.25).
+     */
+    Strict,
+    /**
+     * Also allows the contraction of multiplications and additions into
+     * fused multiply-add operations, which are computed with a single
+     * rounding (like -ffp-contract=fast).
+     */
+    Contract,
+    /**
+     * Also allows rewrites which assume real number arithmetic such as
+     * reciprocals, the reassociation of additions and multiplications,
+     * and pow() with integer and half-integer exponents (like -ffast-math).
+     */
+    Relaxed
+};
+
+/**
+ * Algebraic simplification and strength reduction of the operations in a
+ * CodeHandler graph.
+ * The operation nodes are changed in place before the source code is
+ * generated (see CodeHandler::setGraphSimplifier()).
+ * The rewrites which are applied depend on the floating point strictness
+ * and on the enabled transformations:
+ *  - pow() lowering: pow(x, 2) -> x * x, pow(x, -1) -> 1 / x and, if
+ *    relaxed, integer exponents through multiplications and half-integer
+ *    exponents with sqrt();
+ *  - reciprocals: division by a power of two -> multiplication and, if
+ *    relaxed, division by any constant or several divisions by the same
+ *    variable -> multiplication by a reciprocal;
+ *  - fused multiply-add (requires at least Contract): a * b + c ->
+ *    fma(a, b, c) when the product is not used elsewhere;
+ *  - reassociation (requires Relaxed): chains of additions or
+ *    multiplications are rebalanced to reduce the dependency chain length
+ *    (more instruction level parallelism).
+ *
+ * @warning fma() is only faster if the generated code is compiled for a
+ *          processor with fused multiply-add instructions (e.g. -mfma or
+ *          -march=native), otherwise a slow software version is used.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class GraphSimplifier {
+public:
+    typedef OperationNode<Base> Node;
+    typedef Argument<Base> Arg;
+    typedef CG<Base> CGB;
+protected:
+    /**
+     * the acceptable changes to the floating point results
+     */
+    FloatingPointStrictness strictness_;
+    /**
+     * whether or not to replace pow() with simpler operations
+     */
+    bool lowerPow_;
+    /**
+     * whether or not to replace divisions with multiplications by a reciprocal
+     */
+    bool reciprocal_;
+    /**
+     * whether or not to create fused multiply-add operations
+     */
+    bool fma_;
+    /**
+     * whether or not to rebalance chains of additions and multiplications
+     */
+    bool reassociate_;
+    /**
+     * maximum (absolute) integer exponent of pow() replaced by multiplications
+     */
+    size_t maxPowExponent_;
+public:
+
+    /**
+     * @param strictness the acceptable changes to the floating point results
+     */
+    inline explicit GraphSimplifier(FloatingPointStrictness strictness = FloatingPointStrictness::Strict) :
+        strictness_(strictness),
+        lowerPow_(true),
+        reciprocal_(true),
+        fma_(true),
+        reassociate_(true),
+        maxPowExponent_(8) {
+    }
+
+    inline virtual ~GraphSimplifier() = default;
+
+    inline FloatingPointStrictness getFloatingPointStrictness() const {
+        return strictness_;
+    }
+
+    inline void setFloatingPointStrictness(FloatingPointStrictness strictness) {
+        strictness_ = strictness;
+    }
+
+    inline bool isLowerPow() const {
+        return lowerPow_;
+    }
+
+    inline void setLowerPow(bool lowerPow) {
+        lowerPow_ = lowerPow;
+    }
+
+    inline bool isReciprocal() const {
+        return reciprocal_;
+    }
+
+    inline void setReciprocal(bool reciprocal) {
+        reciprocal_ = reciprocal;
+    }
+
+    /**
+     * Whether or not fused multiply-add operations can be created (only
+     * used with FloatingPointStrictness::Contract or Relaxed).
+     */
+    inline bool isFma() const {
+        return fma_;
+    }
+
+    inline void setFma(bool fma) {
+        fma_ = fma;
+    }
+
+    /**
+     * Whether or not chains of additions and multiplications can be
+     * rebalanced (only used with FloatingPointStrictness::Relaxed).
+     */
+    inline bool isReassociate() const {
+        return reassociate_;
+    }
+
+    inline void setReassociate(bool reassociate) {
+        reassociate_ = reassociate;
+    }
+
+    inline size_t getMaxPowExponent() const {
+        return maxPowExponent_;
+    }
+
+    /**
+     * Defines the largest (absolute) integer exponent of pow() which is
+     * replaced by multiplications when relaxed.
+     */
+    inline void setMaxPowExponent(size_t maxExponent) {
+        maxPowExponent_ = maxExponent;
+    }
+
+    /**
+     * Rewrites the operations used by the dependent variables.
+     * Operation nodes might be changed or created but the dependent
+     * variables always keep the same nodes.
+     *
+     * @param handler the handler which owns the operation nodes
+     * @param dependent the dependent variables
+     * @return the number of rewritten operations
+     */
+    inline size_t simplify(CodeHandler<Base>& handler,
+                           ArrayView<CGB>& dependent) const {
+        Rewriter r(*this, handler, dependent);
+        return r.run();
+    }
+
+    inline size_t simplify(CodeHandler<Base>& handler,
+                           std::vector<CGB>& dependent) const {
+        ArrayView<CGB> deps(dependent);
+        return simplify(handler, deps);
+    }
+
+protected:
+
+    /**
+     * Holds the data used while rewriting a graph.
+     */
+    class Rewriter {
+    private:
+        const GraphSimplifier& options_;
+        CodeHandler<Base>& handler_;
+        ArrayView<CGB>& dependent_;
+        /**
+         * the visit ID of each node (by handler position)
+         */
+        std::vector<size_t> visit_;
+        size_t visitId_;
+        /**
+         * the number of times each node is used (by handler position)
+         */
+        std::vector<size_t> uses_;
+        /**
+         * the value which should be used instead of a node
+         */
+        std::vector<Arg> replace_;
+        /**
+         * divisions grouped by denominator (handler position)
+         */
+        std::map<size_t, std::vector<Node*> > divisions_;
+        size_t changes_;
+    public:
+
+        inline Rewriter(const GraphSimplifier& options,
+                        CodeHandler<Base>& handler,
+                        ArrayView<CGB>& dependent) :
+            options_(options),
+            handler_(handler),
+            dependent_(dependent),
+            visitId_(0),
+            changes_(0) {
+        }
+
+        inline size_t run() {
+            FloatingPointStrictness strictness = options_.strictness_;
+            bool relaxed = strictness == FloatingPointStrictness::Relaxed;
+
+            /**
+             * local rewrites
+             */
+            startVisit();
+            replace_.resize(handler_.getManagedNodesCount());
+            for (size_t i = 0; i < dependent_.size(); i++) {
+                Node* node = dependent_[i].getOperationNode();
+                if (node != nullptr)
+                    lower(*node);
+            }
+            replace_.clear();
+
+            /**
+             * several divisions by the same variable
+             */
+            if (relaxed && options_.reciprocal_) {
+                countUses();
+                shareReciprocals();
+            }
+
+            /**
+             * rebalance chains
+             */
+            if (relaxed && options_.reassociate_) {
+                countUses();
+                startVisit();
+                for (size_t i = 0; i < dependent_.size(); i++) {
+                    Node* node = dependent_[i].getOperationNode();
+                    if (node != nullptr)
+                        reassociate(*node);
+                }
+            }
+
+            /**
+             * contraction
+             */
+            if (strictness != FloatingPointStrictness::Strict && options_.fma_) {
+                countUses();
+                startVisit();
+                for (size_t i = 0; i < dependent_.size(); i++) {
+                    Node* node = dependent_[i].getOperationNode();
+                    if (node != nullptr)
+                        contract(*node);
+                }
+            }
+
+            return changes_;
+        }
+
+    private:
+
+        inline void startVisit() {
+            visitId_++;
+            visit_.resize(handler_.getManagedNodesCount(), 0);
+        }
+
+        inline bool visit(const Node& node) {
+            size_t p = node.getHandlerPosition();
+            if (p >= visit_.size())
+                visit_.resize(handler_.getManagedNodesCount(), 0);
+            if (visit_[p] == visitId_)
+                return false;
+            visit_[p] = visitId_;
+            return true;
+        }
+
+        inline size_t uses(const Node& node) const {
+            size_t p = node.getHandlerPosition();
+            return p < uses_.size() ? uses_[p] : 0;
+        }
+
+        inline Node* makeNode(CGOpCode op,
+                              std::vector<Arg>&& args) {
+            return handler_.makeNode(op, std::move(args));
+        }
+
+        static inline bool isSimpleOperation(const Node& node) {
+            return Node::CUSTOM_NODE_CLASS.find(node.getOperationType()) == Node::CUSTOM_NODE_CLASS.end();
+        }
+
+        /**********************************************************************
+         * local rewrites
+         *********************************************************************/
+
+        /**
+         * @return the value which should be used instead of the node
+         */
+        inline Arg lower(Node& node) {
+            size_t p = node.getHandlerPosition();
+            if (!visit(node)) {
+                return p < replace_.size() ? replace_[p] : Arg(node);
+            }
+            if (p >= replace_.size())
+                replace_.resize(handler_.getManagedNodesCount());
+            replace_[p] = Arg(node);
+
+            std::vector<Arg>& args = node.getArguments();
+            bool substitute = isSimpleOperation(node);
+            for (size_t a = 0; a < args.size(); a++) {
+                Node* arg = args[a].getOperation();
+                if (arg != nullptr) {
+                    Arg r = lower(*arg);
+                    if (substitute && r.getOperation() != nullptr && r.getOperation() != arg)
+                        args[a] = r;
+                }
+            }
+
+            switch (node.getOperationType()) {
+                case CGOpCode::UnMinus:
+                {
+                    Node* arg = args[0].getOperation();
+                    if (arg != nullptr && arg->getOperationType() == CGOpCode::UnMinus) {
+                        replace_[p] = arg->getArguments()[0]; // -(-x) = x
+                        changes_++;
+                    }
+                    break;
+                }
+                case CGOpCode::Pow:
+                    if (options_.lowerPow_ && args[1].getParameter() != nullptr)
+                        lowerPow(node);
+                    break;
+                case CGOpCode::Div:
+                    if (options_.reciprocal_ && args[1].getParameter() != nullptr)
+                        lowerDiv(node);
+                    break;
+                default:
+                    break;
+            }
+
+            return replace_[p];
+        }
+
+        inline void lowerPow(Node& node) {
+            using std::floor;
+            using std::abs;
+
+            Arg x = node.getArguments()[0];
+            const Base e = *node.getArguments()[1].getParameter();
+            size_t p = node.getHandlerPosition();
+
+            if (e == Base(1)) {
+                replace_[p] = x;
+            } else if (e == Base(2)) {
+                node.setOperation(CGOpCode::Mul, {x, x});
+            } else if (e == Base(-1)) {
+                node.setOperation(CGOpCode::Div, {Arg(Base(1)), x});
+            } else if (options_.strictness_ != FloatingPointStrictness::Relaxed) {
+                return;
+            } else if (e == Base(0.5)) {
+                node.setOperation(CGOpCode::Sqrt, {x});
+            } else if (e == Base(-0.5)) {
+                node.setOperation(CGOpCode::Div, {Arg(Base(1)), Arg(*makeNode(CGOpCode::Sqrt, {x}))});
+            } else if (e != Base(0) && abs(e) <= Base(options_.maxPowExponent_) && floor(e) == e) {
+                size_t n = size_t(abs(e));
+                if (e > 0) {
+                    integerPower(node, x, n);
+                } else {
+                    node.setOperation(CGOpCode::Div, {Arg(Base(1)), integerPower(x, n)});
+                }
+            } else if (abs(e) <= Base(options_.maxPowExponent_) && floor(e + Base(0.5)) == e + Base(0.5)) {
+                // x^(n + 1/2) = x^n * sqrt(x)
+                size_t n = size_t(floor(abs(e)));
+                Arg s(*makeNode(CGOpCode::Sqrt, {x}));
+                if (e > 0) {
+                    node.setOperation(CGOpCode::Mul, {integerPower(x, n), s});
+                } else {
+                    Arg d(*makeNode(CGOpCode::Mul, {integerPower(x, n), s}));
+                    node.setOperation(CGOpCode::Div, {Arg(Base(1)), d});
+                }
+            } else {
+                return;
+            }
+
+            changes_++;
+        }
+
+        /**
+         * Creates the operations for x^n using repeated squaring.
+         */
+        inline Arg integerPower(const Arg& x,
+                                size_t n) {
+            CPPADCG_ASSERT_UNKNOWN(n > 0);
+            if (n == 1)
+                return x;
+
+            Node* node = makeNode(CGOpCode::Mul, {});
+            integerPower(*node, x, n);
+            return Arg(*node);
+        }
+
+        /**
+         * Changes a node into the last multiplication of x^n (n > 1).
+         */
+        inline void integerPower(Node& node,
+                                 const Arg& x,
+                                 size_t n) {
+            CPPADCG_ASSERT_UNKNOWN(n > 1);
+            if (n % 2 == 0) {
+                Arg h = integerPower(x, n / 2);
+                node.setOperation(CGOpCode::Mul, {h, h});
+            } else {
+                node.setOperation(CGOpCode::Mul, {integerPower(x, n - 1), x});
+            }
+        }
+
+        inline void lowerDiv(Node& node) {
+            using std::frexp;
+            using std::abs;
+
+            const Base c = *node.getArguments()[1].getParameter();
+            if (c == Base(0) || !std::isfinite(c))
+                return;
+
+            Base r = Base(1) / c;
+            int exp;
+            bool exact = abs(frexp(c, &exp)) == Base(0.5) && std::isnormal(r);
+
+            if (exact || options_.strictness_ == FloatingPointStrictness::Relaxed) {
+                Arg x = node.getArguments()[0];
+                node.setOperation(CGOpCode::Mul, {x, Arg(r)});
+                changes_++;
+            }
+        }
+
+        /**********************************************************************
+         * usage
+         *********************************************************************/
+
+        inline void countUses() {
+            uses_.assign(handler_.getManagedNodesCount(), 0);
+            divisions_.clear();
+            startVisit();
+
+            for (size_t i = 0; i < dependent_.size(); i++) {
+                Node* node = dependent_[i].getOperationNode();
+                if (node != nullptr) {
+                    uses_[node->getHandlerPosition()]++;
+                    countUses(*node);
+                }
+            }
+        }
+
+        inline void countUses(Node& node) {
+            if (!visit(node))
+                return;
+
+            for (const Arg& a : node.getArguments()) {
+                Node* arg = a.getOperation();
+                if (arg != nullptr) {
+                    uses_[arg->getHandlerPosition()]++;
+                    countUses(*arg);
+                }
+            }
+
+            if (node.getOperationType() == CGOpCode::Div) {
+                Node* den = node.getArguments()[1].getOperation();
+                const Base* num = node.getArguments()[0].getParameter();
+                if (den != nullptr && (num == nullptr || *num != Base(1)))
+                    divisions_[den->getHandlerPosition()].push_back(&node);
+            }
+        }
+
+        /**********************************************************************
+         * reciprocals
+         *********************************************************************/
+
+        inline void shareReciprocals() {
+            for (auto& it : divisions_) {
+                std::vector<Node*>& divs = it.second;
+                if (divs.size() < 2)
+                    continue;
+
+                Node* den = handler_.getManagedNodes()[it.first];
+                Arg r(*makeNode(CGOpCode::Div, {Arg(Base(1)), Arg(*den)}));
+                for (Node* d : divs) {
+                    Arg x = d->getArguments()[0];
+                    d->setOperation(CGOpCode::Mul, {x, r});
+                    changes_++;
+                }
+            }
+            divisions_.clear();
+        }
+
+        /**********************************************************************
+         * reassociation
+         *********************************************************************/
+
+        inline void reassociate(Node& node) {
+            if (!visit(node))
+                return;
+
+            CGOpCode op = node.getOperationType();
+            if (op == CGOpCode::Add || op == CGOpCode::Mul) {
+                std::vector<Arg> leaves;
+                size_t depth = collectLeaves(node, op, leaves);
+
+                size_t minDepth = 0;
+                while ((size_t(1) << minDepth) < leaves.size())
+                    minDepth++;
+
+                if (leaves.size() > 2 && depth > minDepth) {
+                    size_t mid = leaves.size() / 2;
+                    node.setOperation(op, {balance(op, leaves, 0, mid), balance(op, leaves, mid, leaves.size())});
+                    changes_++;
+                }
+
+                for (const Arg& a : leaves) {
+                    if (a.getOperation() != nullptr)
+                        reassociate(*a.getOperation());
+                }
+
+            } else {
+                for (const Arg& a : node.getArguments()) {
+                    if (a.getOperation() != nullptr)
+                        reassociate(*a.getOperation());
+                }
+            }
+        }
+
+        /**
+         * Determines the operands of a chain of additions or multiplications
+         * whose intermediate results are not used anywhere else.
+         *
+         * @return the depth of the chain
+         */
+        inline size_t collectLeaves(const Node& node,
+                                    CGOpCode op,
+                                    std::vector<Arg>& leaves) const {
+            size_t depth = 0;
+            for (const Arg& a : node.getArguments()) {
+                const Node* arg = a.getOperation();
+                if (arg != nullptr && arg->getOperationType() == op && uses(*arg) == 1) {
+                    depth = std::max(depth, collectLeaves(*arg, op, leaves));
+                } else {
+                    leaves.push_back(a);
+                }
+            }
+            return depth + 1;
+        }
+
+        inline Arg balance(CGOpCode op,
+                           const std::vector<Arg>& leaves,
+                           size_t begin,
+                           size_t end) {
+            if (end - begin == 1)
+                return leaves[begin];
+
+            size_t mid = begin + (end - begin) / 2;
+            return Arg(*makeNode(op, {balance(op, leaves, begin, mid), balance(op, leaves, mid, end)}));
+        }
+
+        /**********************************************************************
+         * contraction
+         *********************************************************************/
+
+        inline void contract(Node& node) {
+            if (!visit(node))
+                return;
+
+            for (const Arg& a : node.getArguments()) {
+                if (a.getOperation() != nullptr)
+                    contract(*a.getOperation());
+            }
+
+            CGOpCode op = node.getOperationType();
+            if (op != CGOpCode::Add && op != CGOpCode::Sub)
+                return;
+
+            const std::vector<Arg>& args = node.getArguments();
+            Arg left = args[0];
+            Arg right = args[1];
+
+            if (isFusable(left)) {
+                // a * b + c  or  a * b - c
+                const std::vector<Arg>& m = left.getOperation()->getArguments();
+                Arg c = op == CGOpCode::Add ? right : negate(right);
+                node.setOperation(CGOpCode::Fma, {m[0], m[1], c});
+                changes_++;
+
+            } else if (isFusable(right)) {
+                // c + a * b  or  c - a * b
+                const std::vector<Arg>& m = right.getOperation()->getArguments();
+                Arg a = op == CGOpCode::Add ? m[0] : negate(m[0]);
+                node.setOperation(CGOpCode::Fma, {a, m[1], left});
+                changes_++;
+            }
+        }
+
+        inline bool isFusable(const Arg& arg) const {
+            const Node* n = arg.getOperation();
+            return n != nullptr && n->getOperationType() == CGOpCode::Mul && uses(*n) == 1;
+        }
+
+        inline Arg negate(const Arg& arg) {
+            if (arg.getParameter() != nullptr) {
+                return Arg(-*arg.getParameter());
+            }
+
+            Node* n = arg.getOperation();
+            if (n->getOperationType() == CGOpCode::UnMinus) {
+                return n->getArguments()[0];
+            }
+            return Arg(*makeNode(CGOpCode::UnMinus, {arg}));
+        }
+    };
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,387 @@
+#ifndef CPPAD_CG_LANG_C_CODE_WRITER_INCLUDED
+#define CPPAD_CG_LANG_C_CODE_WRITER_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A stream buffer which saves the written characters in a list of
+ * fixed size blocks.
+ * Unlike std::stringbuf, previously written data is never copied when the
+ * buffer grows and the memory can be reused after a reset.
+ *
+ * @author Joao Leal
+ */
+class LangCCodeStreambuf : public std::streambuf {
+private:
+    typedef std::streambuf::char_type char_type;
+    typedef std::streambuf::int_type int_type;
+private:
+    // the size of each block
+    const size_t blockSize_;
+    // all allocated blocks
+    std::vector<std::unique_ptr<char_type[]> > blocks_;
+    // the index of the block currently being written to
+    size_t current_;
+public:
+
+    explicit inline LangCCodeStreambuf(size_t blockSize = 64 * 1024) :
+        blockSize_(blockSize),
+        current_(0) {
+        CPPADCG_ASSERT_KNOWN(blockSize_ > 0, "Invalid block size");
+    }
+
+    LangCCodeStreambuf(const LangCCodeStreambuf&) = delete;
+    LangCCodeStreambuf& operator=(const LangCCodeStreambuf&) = delete;
+
+    /**
+     * Provides the number of characters written so far.
+     */
+    inline size_t size() const {
+        if (blocks_.empty())
+            return 0;
+        return current_ * blockSize_ + size_t(pptr() - pbase());
+    }
+
+    /**
+     * Discards all the written characters (allocated memory is kept).
+     */
+    inline void reset() {
+        current_ = 0;
+        if (!blocks_.empty())
+            setp(blocks_[0].get(), blocks_[0].get() + blockSize_);
+    }
+
+    /**
+     * Writes all the characters to another stream without creating an
+     * intermediate string.
+     */
+    inline void writeTo(std::ostream& out) const {
+        for (size_t b = 0; b < current_; b++) {
+            out.write(blocks_[b].get(), blockSize_);
+        }
+        if (!blocks_.empty())
+            out.write(pbase(), pptr() - pbase());
+    }
+
+    /**
+     * Appends all the characters to a string.
+     */
+    inline void appendTo(std::string& s) const {
+        s.reserve(s.size() + size());
+        for (size_t b = 0; b < current_; b++) {
+            s.append(blocks_[b].get(), blockSize_);
+        }
+        if (!blocks_.empty())
+            s.append(pbase(), pptr() - pbase());
+    }
+
+protected:
+
+    virtual int_type overflow(int_type c) override {
+        if (traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+
+        nextBlock();
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+        return c;
+    }
+
+    virtual std::streamsize xsputn(const char_type* s,
+                                   std::streamsize n) override {
+        std::streamsize written = 0;
+        while (written < n) {
+            std::streamsize available = epptr() - pptr();
+            if (available == 0) {
+                nextBlock();
+                available = epptr() - pptr();
+            }
+            std::streamsize count = std::min(available, n - written);
+            traits_type::copy(pptr(), s + written, size_t(count));
+            pbump(int(count));
+            written += count;
+        }
+        return written;
+    }
+
+private:
+
+    inline void nextBlock() {
+        if (!blocks_.empty() && pptr() == epptr())
+            current_++;
+
+        if (current_ == blocks_.size())
+            blocks_.emplace_back(new char_type[blockSize_]);
+
+        setp(blocks_[current_].get(), blocks_[current_].get() + blockSize_);
+    }
+};
+
+/**
+ * Output stream used to write generated source code.
+ * It provides the same str() methods as std::ostringstream but saves
+ * the data using a LangCCodeStreambuf.
+ *
+ * @author Joao Leal
+ */
+class LangCCodeWriter : public std::ostream {
+private:
+    LangCCodeStreambuf buf_;
+public:
+
+    inline LangCCodeWriter() :
+        std::ostream(nullptr) {
+        rdbuf(&buf_);
+    }
+
+    LangCCodeWriter(const LangCCodeWriter&) = delete;
+    LangCCodeWriter& operator=(const LangCCodeWriter&) = delete;
+
+    /**
+     * Creates a string with all the written characters.
+     */
+    inline std::string str() const {
+        std::string s;
+        buf_.appendTo(s);
+        return s;
+    }
+
+    /**
+     * Replaces the current contents.
+     */
+    inline void str(const std::string& s) {
+        buf_.reset();
+        std::ostream::clear();
+        if (!s.empty())
+            write(s.data(), s.size());
+    }
+
+    inline size_t size() const {
+        return buf_.size();
+    }
+
+    inline void writeTo(std::ostream& out) const {
+        buf_.writeTo(out);
+    }
+
+    inline void appendTo(std::string& s) const {
+        buf_.appendTo(s);
+    }
+};
+
+inline int printFloatingPoint(char* buf, size_t bufSize, int digits, double value) {
+    return std::snprintf(buf, bufSize, "%.*g", digits, value);
+}
+
+inline int printFloatingPoint(char* buf, size_t bufSize, int digits, float value) {
+    return std::snprintf(buf, bufSize, "%.*g", digits, double(value));
+}
+
+inline int printFloatingPoint(char* buf, size_t bufSize, int digits, long double value) {
+    return std::snprintf(buf, bufSize, "%.*Lg", digits, value);
+}
+
+inline bool isSameFloatingPoint(const char* buf, double value) {
+    return std::strtod(buf, nullptr) == value;
+}
+
+inline bool isSameFloatingPoint(const char* buf, float value) {
+    return std::strtof(buf, nullptr) == value;
+}
+
+inline bool isSameFloatingPoint(const char* buf, long double value) {
+    return std::strtold(buf, nullptr) == value;
+}
+
+/**
+ * Prints a decimal number defined by an integer and the number of
+ * digits after the decimal point.
+ *
+ * @return the number of characters printed
+ */
+inline size_t printDecimal(bool negative,
+                           unsigned long long mantissa,
+                           int decimals,
+                           char* buf) {
+    char digitsBuf[32];
+    int n = 0;
+    do {
+        digitsBuf[n++] = char('0' + mantissa % 10);
+        mantissa /= 10;
+    } while (mantissa > 0);
+
+    size_t pos = 0;
+    if (negative)
+        buf[pos++] = '-';
+
+    if (n <= decimals) {
+        buf[pos++] = '0';
+        buf[pos++] = '.';
+        for (int i = n; i < decimals; i++)
+            buf[pos++] = '0';
+    }
+    while (n > 0) {
+        buf[pos++] = digitsBuf[--n];
+        if (n == decimals && n > 0)
+            buf[pos++] = '.';
+    }
+    buf[pos] = '\0';
+    return pos;
+}
+
+/**
+ * Prints floating point values into a character array using the
+ * smallest number of significant digits, up to maxPrecision, which
+ * recovers the exact same value.
+ * The result is the same as the one from std::ostream with
+ * std::setprecision(maxPrecision) when maxPrecision is not larger than
+ * std::numeric_limits<T>::digits10.
+ * Values with a short decimal representation (the most common in models)
+ * are printed without any call to the C library.
+ *
+ * @param value the value to print
+ * @param maxPrecision the maximum number of significant digits
+ * @param buf where the number is printed
+ * @param bufSize the size of buf (at least 32)
+ * @return the number of characters printed
+ */
+template<class T>
+inline size_t printShortestFloatingPoint(T value,
+                                         size_t maxPrecision,
+                                         char* buf,
+                                         size_t bufSize) {
+    CPPADCG_ASSERT_UNKNOWN(bufSize >= 32);
+
+    // more digits than max_digits10 do not provide any information
+    int maxDigits = int(std::min<size_t>(maxPrecision, std::numeric_limits<T>::max_digits10));
+    if (maxDigits <= 0)
+        maxDigits = 1;
+    int digits = std::min(maxDigits, int(std::numeric_limits<T>::digits10));
+
+    if (value == T(0)) {
+        return printDecimal(std::signbit(value), 0, 0, buf);
+    }
+
+    /**
+     * short decimal values which do not require an exponent
+     */
+    if (std::numeric_limits<T>::digits <= std::numeric_limits<double>::digits) {
+        static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                       1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20};
+        double v = std::abs(double(value));
+        double limit = pow10[digits];
+
+        if (v >= 1e-4 && v < limit) {
+            for (int decimals = 0; decimals <= digits + 4; decimals++) {
+                double t = v * pow10[decimals];
+                if (t >= limit)
+                    break;
+                if (t == std::trunc(t)) {
+                    unsigned long long mantissa = static_cast<unsigned long long> (t);
+                    while (decimals > 0 && mantissa % 10 == 0) {
+                        mantissa /= 10;
+                        decimals--;
+                    }
+                    size_t n = printDecimal(value < 0, mantissa, decimals, buf);
+                    if (maxDigits <= int(std::numeric_limits<T>::digits10) || isSameFloatingPoint(buf, value))
+                        return n;
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * generic values
+     */
+    int n = printFloatingPoint(buf, bufSize, digits, value);
+    if (std::isfinite(value)) {
+        while (digits < maxDigits && !isSameFloatingPoint(buf, value)) {
+            digits++;
+            n = printFloatingPoint(buf, bufSize, digits, value);
+        }
+    }
+
+    CPPADCG_ASSERT_UNKNOWN(n > 0 && size_t(n) < bufSize);
+    return size_t(n);
+}
+
+/**
+ * Appends a non-negative integer to a string (without using streams).
+ */
+inline void appendDecimal(std::string& s,
+                          size_t value) {
+    char digitsBuf[32];
+    size_t n = 0;
+    do {
+        digitsBuf[n++] = char('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    while (n > 0)
+        s += digitsBuf[--n];
+}
+
+/**
+ * Creates the names for the elements of an array (e.g. "x[2]") only once.
+ * Subsequent requests for the same element return the same string.
+ *
+ * @author Joao Leal
+ */
+class LangCArrayNameTable {
+private:
+    // the text before the index (e.g. "x[")
+    std::string prefix_;
+    // the text after the index (e.g. "]")
+    std::string suffix_;
+    // names already created
+    std::vector<std::string> names_;
+public:
+
+    inline LangCArrayNameTable(const std::string& prefix,
+                               const std::string& suffix) :
+        prefix_(prefix),
+        suffix_(suffix) {
+    }
+
+    inline const std::string& operator[](size_t index) {
+        if (index >= names_.size())
+            names_.resize(index + 1);
+
+        std::string& name = names_[index];
+        if (name.empty()) {
+            name.reserve(prefix_.size() + suffix_.size() + 8);
+            name = prefix_;
+            appendDecimal(name, index);
+            name += suffix_;
+        }
+        return name;
+    }
+
+    /**
+     * Releases the memory used by the names
+     */
+    inline void clear() {
+        std::vector<std::string>().swap(names_);
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,296 @@
+#ifndef CPPAD_CG_LANG_C_CONSTANT_POOL_INCLUDED
+#define CPPAD_CG_LANG_C_CONSTANT_POOL_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include <mutex>
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A table of unique constant values shared by all the generated C
+ * functions of a model.
+ * While the functions are generated, every constant whose literal is long
+ * enough is printed as a reference to a candidate of this table
+ * (see LanguageC::setConstantPool()) and its uses are counted.
+ * Once all the functions are generated, createTable() selects the
+ * constants used at least getMinUses() times in all those functions and
+ * resolveReferences() replaces each reference either with its position in
+ * the table or with the literal.
+ * The array itself must be defined in its own source file with
+ * LanguageC::printConstantPool().
+ * Candidates can be added by several threads (e.g. while the sources of the
+ * second-order reverse mode are generated in parallel) since the table
+ * only depends on the values and on their total number of uses.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class LangCConstantPool {
+private:
+    /**
+     * a constant which may be added to the table
+     */
+    struct Candidate {
+        // the literal used when the value is not in the table
+        std::string literal;
+        // the number of times the value was printed
+        size_t uses;
+        // the position in the table (or unassigned())
+        size_t position;
+    };
+private:
+    /**
+     * the name of the array with the constant values
+     */
+    std::string name_;
+    /**
+     * constants used fewer times than this in all the functions are
+     * printed as literals
+     */
+    size_t minUses_;
+    /**
+     * constants whose literal is not longer than this are always printed
+     * as literals
+     */
+    size_t maxInlineLength_;
+    /**
+     * the constants which may be added to the table (in the order they
+     * were first printed)
+     */
+    std::vector<Candidate> candidates_;
+    /**
+     * the position of each value in candidates_
+     */
+    std::map<Base, size_t, BitwiseLess<Base> > index_;
+    /**
+     * the candidates in the table (sorted by their bit representation)
+     */
+    std::vector<size_t> table_;
+    /**
+     * the values in the table
+     */
+    std::vector<Base> values_;
+    /**
+     * protects the candidates added by different threads
+     */
+    mutable std::mutex mutex_;
+public:
+
+    /**
+     * @param name the name of the array with the constant values
+     * @param minUses constants used fewer times than this in all the
+     *                functions are printed as literals
+     * @param maxInlineLength constants whose literal has at most this
+     *                        number of characters (e.g. 0, 1., 0.5) are
+     *                        always printed as literals
+     */
+    inline LangCConstantPool(const std::string& name,
+                             size_t minUses = 2,
+                             size_t maxInlineLength = 4) :
+        name_(name),
+        minUses_(minUses),
+        maxInlineLength_(maxInlineLength) {
+    }
+
+    LangCConstantPool(const LangCConstantPool& orig) = delete;
+    LangCConstantPool& operator=(const LangCConstantPool& rhs) = delete;
+
+    inline const std::string& getName() const {
+        return name_;
+    }
+
+    inline size_t getMinUses() const {
+        return minUses_;
+    }
+
+    inline void setMinUses(size_t minUses) {
+        minUses_ = minUses;
+    }
+
+    inline size_t getMaxInlineLength() const {
+        return maxInlineLength_;
+    }
+
+    inline void setMaxInlineLength(size_t maxInlineLength) {
+        maxInlineLength_ = maxInlineLength;
+    }
+
+    /**
+     * The value used for candidates which are not in the table
+     */
+    static inline size_t unassigned() {
+        return (std::numeric_limits<size_t>::max)();
+    }
+
+    /**
+     * Registers a new use of a constant which may be added to the table.
+     *
+     * @param value the constant value
+     * @param literal the literal used when the value is not in the table
+     * @param length the number of characters in literal
+     * @return the identifier of the candidate used in the references
+     *         resolved by resolveReferences()
+     */
+    inline size_t addCandidate(const Base& value,
+                               const char* literal,
+                               size_t length) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = index_.find(value);
+        if (it != index_.end()) {
+            candidates_[it->second].uses++;
+            return it->second;
+        }
+
+        size_t id = candidates_.size();
+        candidates_.push_back(Candidate{std::string(literal, length), 1, unassigned()});
+        index_[value] = id;
+        return id;
+    }
+
+    /**
+     * The number of times a candidate value was printed.
+     */
+    inline size_t getUses(const Base& value) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = index_.find(value);
+        if (it == index_.end())
+            return 0;
+        return candidates_[it->second].uses;
+    }
+
+    /**
+     * Selects the values in the table after all the functions which use
+     * it were generated.
+     * The values are sorted by their bit representation so that the table
+     * does not depend on the order in which the functions were generated.
+     */
+    inline void createTable() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        table_.clear();
+        values_.clear();
+        for (const auto& it : index_) {
+            Candidate& c = candidates_[it.second];
+            if (c.uses >= minUses_) {
+                c.position = values_.size();
+                table_.push_back(it.second);
+                values_.push_back(it.first);
+            } else {
+                c.position = unassigned();
+            }
+        }
+    }
+
+    /**
+     * Replaces the references to candidates in a source file (created
+     * before createTable()) with references to the table or with literals.
+     *
+     * @param source the source code
+     */
+    inline void resolveReferences(std::string& source) const {
+        const std::string ref = name_ + "[";
+
+        size_t pos = source.find(ref);
+        if (pos == std::string::npos)
+            return;
+
+        std::string resolved;
+        resolved.reserve(source.size());
+        size_t last = 0;
+
+        while (pos != std::string::npos) {
+            size_t start = pos + ref.size();
+            size_t end = start;
+            size_t id = 0;
+            while (end < source.size() && source[end] >= '0' && source[end] <= '9') {
+                id = id * 10 + (source[end] - '0');
+                end++;
+            }
+
+            bool partOfName = pos > 0 && (std::isalnum(static_cast<unsigned char>(source[pos - 1])) || source[pos - 1] == '_');
+            if (end == start || end == source.size() || source[end] != ']' || partOfName) {
+                // not a reference (e.g. a declaration)
+                pos = source.find(ref, start);
+                continue;
+            }
+
+            CPPADCG_ASSERT_KNOWN(id < candidates_.size(), "Invalid reference to a table of constants")
+            const Candidate& c = candidates_[id];
+
+            resolved.append(source, last, pos - last);
+            if (c.position != unassigned()) {
+                resolved += ref;
+                resolved += std::to_string(c.position);
+                resolved += ']';
+            } else {
+                resolved += c.literal;
+            }
+
+            last = end + 1;
+            pos = source.find(ref, last);
+        }
+
+        resolved.append(source, last, std::string::npos);
+        source.swap(resolved);
+    }
+
+    /**
+     * @return the values in the table (determined by createTable())
+     */
+    inline const std::vector<Base>& getValues() const {
+        return values_;
+    }
+
+    /**
+     * @param pos the position in the table
+     * @return the literal of a value in the table
+     */
+    inline const std::string& getLiteral(size_t pos) const {
+        return candidates_[table_[pos]].literal;
+    }
+
+    inline size_t size() const {
+        return values_.size();
+    }
+
+    inline bool empty() const {
+        return values_.empty();
+    }
+
+    /**
+     * @return the number of values which may be added to the table
+     */
+    inline size_t getCandidateCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return candidates_.size();
+    }
+
+    inline void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        candidates_.clear();
+        index_.clear();
+        table_.clear();
+        values_.clear();
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
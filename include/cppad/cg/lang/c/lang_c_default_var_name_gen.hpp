@@ -46,6 +46,10 @@ protected:
     size_t _maxTemporaryArrayID;
     // the highest ID used for the temporary sparse array variables
     size_t _maxTemporarySparseArrayID;
+    // names of the temporary array elements (these are requested very often)
+    LangCArrayNameTable _tmpArrayNames;
+    // names of the temporary sparse array elements
+    LangCArrayNameTable _tmpSparseArrayNames;
 public:
 
     inline LangCDefaultVariableNameGenerator(const std::string& depName = "y",
@@ -61,7 +65,9 @@ public:
         _minTemporaryID(0), // not really required (but it avoids warnings)
         _maxTemporaryID(0), // not really required (but it avoids warnings)
         _maxTemporaryArrayID(0), // not really required (but it avoids warnings)
-        _maxTemporarySparseArrayID(0) { // not really required (but it avoids warnings)
+        _maxTemporarySparseArrayID(0), // not really required (but it avoids warnings)
+        _tmpArrayNames("&" + tmpArrayName + "[", "]"),
+        _tmpSparseArrayNames("&" + tmpSparseArrayName + "[", "]") {
 
         this->_independent.push_back(FuncArgument(_indepName));
         this->_dependent.push_back(FuncArgument(_depName));
@@ -87,60 +93,57 @@ public:
     }
 
     inline virtual std::string generateDependent(size_t index) override {
-        _ss.clear();
-        _ss.str("");
-
-        _ss << _depName << "[" << index << "]";
-
-        return _ss.str();
+        std::string name;
+        name.reserve(_depName.size() + 10);
+        name += _depName;
+        name += '[';
+        appendDecimal(name, index);
+        name += ']';
+
+        return name;
     }
 
     inline virtual std::string generateIndependent(const OperationNode<Base>& independent,
                                                    size_t id) override {
-        _ss.clear();
-        _ss.str("");
-
-        _ss << _indepName << "[" << (id - 1) << "]";
-
-        return _ss.str();
+        std::string name;
+        name.reserve(_indepName.size() + 10);
+        name += _indepName;
+        name += '[';
+        appendDecimal(name, id - 1);
+        name += ']';
+
+        return name;
     }
 
     inline virtual std::string generateTemporary(const OperationNode<Base>& variable,
                                                  size_t id) override {
-        _ss.clear();
-        _ss.str("");
+        std::string name;
+        name.reserve(_tmpName.size() + 10);
+        name += _tmpName;
 
         if (this->_temporary[0].array) {
-            _ss << _tmpName << "[" << (id - this->_minTemporaryID) << "]";
+            name += '[';
+            appendDecimal(name, id - this->_minTemporaryID);
+            name += ']';
         } else {
-            _ss << _tmpName << id;
+            appendDecimal(name, id);
         }
 
-        return _ss.str();
+        return name;
     }
 
     virtual std::string generateTemporaryArray(const OperationNode<Base>& variable,
                                                size_t id) override {
-        _ss.clear();
-        _ss.str("");
-
         CPPADCG_ASSERT_UNKNOWN(variable.getOperationType() == CGOpCode::ArrayCreation);
 
-        _ss << "&" << _tmpArrayName << "[" << (id - 1) << "]";
-
-        return _ss.str();
+        return _tmpArrayNames[id - 1];
     }
 
     virtual std::string generateTemporarySparseArray(const OperationNode<Base>& variable,
                                                      size_t id) override {
-        _ss.clear();
-        _ss.str("");
-
         CPPADCG_ASSERT_UNKNOWN(variable.getOperationType() == CGOpCode::SparseArrayCreation);
 
-        _ss << "&" << _tmpSparseArrayName << "[" << (id - 1) << "]";
-
-        return _ss.str();
+        return _tmpSparseArrayNames[id - 1];
     }
 
     virtual std::string generateIndexedDependent(const OperationNode<Base>& var,
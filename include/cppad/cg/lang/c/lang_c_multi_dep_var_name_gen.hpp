@@ -0,0 +1,88 @@
+#ifndef CPPAD_CG_LANG_C_MULTI_DEP_VAR_NAME_GEN_INCLUDED
+#define CPPAD_CG_LANG_C_MULTI_DEP_VAR_NAME_GEN_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Creates variables names for the source code where the dependent
+ * variables are split into several output arrays (e.g. the model values
+ * and the Jacobian values of a single function).
+ * The dependent variables provided to the code handler are the
+ * concatenation of all the arrays.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class LangCMultiDepVariableNameGenerator : public LangCDefaultVariableNameGenerator<Base> {
+protected:
+    // array names of the dependent variables
+    std::vector<std::string> _depNames;
+    // the index of the first dependent variable of each array
+    std::vector<size_t> _depStart;
+public:
+
+    /**
+     * @param depNames the name of each dependent array
+     * @param depSizes the number of elements in each dependent array
+     */
+    inline LangCMultiDepVariableNameGenerator(const std::vector<std::string>& depNames,
+                                              const std::vector<size_t>& depSizes,
+                                              const std::string& indepName = "x",
+                                              const std::string& tmpName = "v",
+                                              const std::string& tmpArrayName = "array",
+                                              const std::string& tmpSparseArrayName = "sarray") :
+        LangCDefaultVariableNameGenerator<Base>(depNames.at(0), indepName, tmpName, tmpArrayName, tmpSparseArrayName),
+        _depNames(depNames),
+        _depStart(depSizes.size() + 1, 0) {
+        CPPADCG_ASSERT_KNOWN(depNames.size() == depSizes.size(), "Invalid number of dependent array sizes");
+
+        for (size_t a = 1; a < _depNames.size(); a++) {
+            this->_dependent.push_back(FuncArgument(_depNames[a]));
+        }
+        for (size_t a = 0; a < depSizes.size(); a++) {
+            _depStart[a + 1] = _depStart[a] + depSizes[a];
+        }
+    }
+
+    inline virtual std::string generateDependent(size_t index) override {
+        CPPADCG_ASSERT_KNOWN(index < _depStart.back(), "Invalid dependent variable index");
+
+        // the last array starting at or before the index (skips empty arrays)
+        size_t a = std::upper_bound(_depStart.begin(), _depStart.end(), index) - _depStart.begin() - 1;
+
+        std::string name;
+        name.reserve(_depNames[a].size() + 10);
+        name += _depNames[a];
+        name += '[';
+        appendDecimal(name, index - _depStart[a]);
+        name += ']';
+
+        return name;
+    }
+
+    virtual std::string generateIndexedDependent(const OperationNode<Base>& var,
+                                                 size_t id,
+                                                 const IndexPattern& ip) override {
+        throw CGException("Loops are not supported with multiple dependent arrays");
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
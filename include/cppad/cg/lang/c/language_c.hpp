@@ -37,6 +37,8 @@ public:
 public:
     static const std::string U_INDEX_TYPE;
     static const std::string ATOMICFUN_STRUCT_DEFINITION;
+    static const std::string ATOMIC_DIRECT_FORWARD;
+    static const std::string ATOMIC_DIRECT_REVERSE;
 protected:
     static const std::string _C_COMP_OP_LT;
     static const std::string _C_COMP_OP_LE;
@@ -53,6 +55,33 @@ protected:
 private:
     class AtomicFuncArray; //forward declaration
 protected:
+    /**
+     * A contiguous array with one element per iteration of a vectorized
+     * loop which holds values of an independent/dependent array
+     */
+    struct PackedLoopArray {
+        // the name of the contiguous array
+        std::string name;
+        // the strided element of the independent/dependent array
+        std::string element;
+        // the operation used to copy the values to the dependent array
+        // (empty for values read by the loop)
+        std::string assignOp;
+    };
+    /**
+     * Variables which must be private to each iteration of a loop
+     * marked for vectorization
+     */
+    struct VectorizedLoop {
+        // index variables assigned inside the loop
+        std::vector<std::string> privateIndexes;
+        // temporary variables declared inside the loop body
+        std::vector<std::string> localTemporaries;
+        // loop indexed values copied to/from contiguous arrays
+        std::vector<PackedLoopArray> packedArrays;
+        // the packed array element used by each loop indexed node
+        std::map<const Node*, std::string> packedElements;
+    };
     // the type name of the Base class (e.g. "double")
     const std::string _baseTypeName;
     // spaces for 1 level indentation
@@ -68,7 +97,7 @@ protected:
     // variable name used for the atomic functions array
     std::string _atomicArgName;
     // output stream for the generated source code
-    std::ostringstream _code;
+    LangCCodeWriter _code;
     // creates the variable names
     VariableNameGenerator<Base>* _nameGen;
     // auxiliary string stream
@@ -96,6 +125,26 @@ protected:
     size_t _maxAssigmentsPerFunction;
     //
     std::map<std::string, std::string>* _sources;
+    // cost model used to determine where functions are split (not owned)
+    const FunctionSplitCostModel* _splitModel;
+    // where to save information on the split functions (not owned)
+    std::map<std::string, std::vector<FunctionSplitInfo> >* _splitReport;
+    // whether or not to generate loops which can be vectorized by the compiler
+    bool _vectorizeLoops;
+    // loops with independent iterations (LoopStart node -> loop private variables)
+    std::map<const Node*, VectorizedLoop> _vectorizedLoops;
+    // whether or not to use contiguous arrays for the values indexed by vectorized loops
+    bool _packLoopArrays;
+    // the maximum number of elements in the packed arrays of a single loop
+    size_t _maxPackedLoopElements;
+    // the vectorized loop being printed (nullptr if none)
+    const VectorizedLoop* _currentVectorizedLoop;
+    // atomic functions which can be called directly (without LangCAtomicFun)
+    std::set<std::string> _directAtomicFuncs;
+    // atomic functions called directly in the current function
+    std::set<std::string> _directAtomicFuncsUsed;
+    // temporary variables declared inside the body of vectorized loops
+    std::set<const Node*> _vectorizedLoopTmps;
     // the values in the temporary array
     std::vector<const Arg*> _tmpArrayValues;
     // the values in the temporary sparse array
@@ -107,6 +156,12 @@ protected:
     std::vector<const LoopStartOperationNode<Base>*> _currentLoops;
     // the maximum precision used to print values
     size_t _parameterPrecision;
+    // table of constants shared by several functions (not owned)
+    LangCConstantPool<Base>* _constantPool;
+    // whether or not the constant pool is used in the current function
+    bool _useConstantPool;
+    // header included by new source files instead of the common declarations (empty if not used)
+    std::string _sharedHeader;
 private:
     std::vector<std::string> funcArgDcl_;
     std::vector<std::string> localFuncArgDcl_;
@@ -137,7 +192,15 @@ public:
         _ignoreZeroDepAssign(false),
         _maxAssigmentsPerFunction(0),
         _sources(nullptr),
-        _parameterPrecision(std::numeric_limits<Base>::digits10) {
+        _splitModel(nullptr),
+        _splitReport(nullptr),
+        _vectorizeLoops(false),
+        _packLoopArrays(false),
+        _maxPackedLoopElements(16384),
+        _currentVectorizedLoop(nullptr),
+        _parameterPrecision(std::numeric_limits<Base>::digits10),
+        _constantPool(nullptr),
+        _useConstantPool(false) {
     }
 
     inline virtual ~LanguageC() {
@@ -220,12 +283,211 @@ public:
         _parameterPrecision = p;
     }
 
+    /**
+     * Defines a table of constants shared by several generated functions.
+     * Floating point constants whose literal is longer than
+     * LangCConstantPool::getMaxInlineLength() are printed as references to
+     * the table, which must be resolved with
+     * LangCConstantPool::resolveReferences() once all the functions using
+     * the table are generated (and LangCConstantPool::createTable() is
+     * called).
+     * The table is only used when a function is created (see
+     * setGenerateFunction()) and it must be defined in its own source
+     * file with printConstantPool().
+     *
+     * @param pool the table of constants (nullptr to always print
+     *             literals)
+     */
+    virtual void setConstantPool(LangCConstantPool<Base>* pool) {
+        _constantPool = pool;
+    }
+
+    inline LangCConstantPool<Base>* getConstantPool() const {
+        return _constantPool;
+    }
+
+    /**
+     * Prints the definition of the array with the values of a table of
+     * constants.
+     *
+     * @param out the output stream
+     * @param pool the table of constants (it must not be empty)
+     */
+    virtual void printConstantPool(std::ostream& out,
+                                   const LangCConstantPool<Base>& pool) const {
+        size_t size = pool.size();
+        CPPADCG_ASSERT_KNOWN(size > 0, "Empty constant pools cannot be printed")
+
+        out << "const " << _baseTypeName << " " << pool.getName() << "[" << size << "] = {\n";
+        for (size_t k = 0; k < size; k++) {
+            out << _spaces << pool.getLiteral(k) << (k + 1 < size ? ",\n" : "\n");
+        }
+        out << "};\n";
+    }
+
     virtual void setMaxAssigmentsPerFunction(size_t maxAssigmentsPerFunction,
                                              std::map<std::string, std::string>* sources) {
         _maxAssigmentsPerFunction = maxAssigmentsPerFunction;
         _sources = sources;
     }
 
+    /**
+     * Defines a compilation cost model used to automatically determine
+     * where large functions are split.
+     * The maximum number of assignments per function (see
+     * setMaxAssigmentsPerFunction()) remains an upper bound for each
+     * function, however functions are split at locations which minimize
+     * the estimated compilation time and the number of values that
+     * must be saved in the temporary array.
+     *
+     * @param model the cost model (not owned); nullptr to split only
+     *              based on the number of assignments
+     * @param report where information on the created functions is saved
+     *               using the function name as key (not owned; optional)
+     */
+    virtual void setFunctionSplitCostModel(const FunctionSplitCostModel* model,
+                                           std::map<std::string, std::vector<FunctionSplitInfo> >* report = nullptr) {
+        _splitModel = model;
+        _splitReport = report;
+    }
+
+    inline const FunctionSplitCostModel* getFunctionSplitCostModel() const {
+        return _splitModel;
+    }
+
+    /**
+     * Defines whether or not loops whose iterations are independent are
+     * generated so that they can be vectorized by the compiler.
+     * These loops are preceded by a <tt>#pragma omp simd</tt> directive,
+     * index variables computed inside them are declared private, and
+     * temporary variables only used by a single iteration are declared
+     * inside the loop body (instead of in the shared temporary array).
+     * The directive is only honored when the source is compiled with
+     * OpenMP SIMD support (e.g. <tt>-fopenmp-simd</tt>); otherwise it is
+     * ignored.
+     *
+     * @param vectorize whether or not to vectorize loops
+     */
+    virtual void setVectorizeLoops(bool vectorize) {
+        _vectorizeLoops = vectorize;
+    }
+
+    inline bool isVectorizeLoops() const {
+        return _vectorizeLoops;
+    }
+
+    /**
+     * Defines whether or not the independent and dependent values accessed
+     * with strided or indirect index patterns inside vectorized loops (see
+     * setVectorizeLoops()) are packed into contiguous arrays with one
+     * element per iteration (structure of arrays).
+     * The values read by the loop are copied before it and the values it
+     * determines are copied to the dependent arrays after it, so that the
+     * vectorized loop body only uses unit-stride accesses.
+     *
+     * @param pack whether or not to pack loop arrays
+     * @param maxElements the maximum number of elements in all the packed
+     *                    arrays of a loop (they are placed on the stack)
+     */
+    virtual void setPackLoopArrays(bool pack,
+                                   size_t maxElements = 16384) {
+        _packLoopArrays = pack;
+        _maxPackedLoopElements = maxElements;
+    }
+
+    inline bool isPackLoopArrays() const {
+        return _packLoopArrays;
+    }
+
+    /**
+     * Defines the atomic functions which are implemented by C functions
+     * that can be called directly by the generated code, for instance,
+     * other models compiled into the same library.
+     * Calls to these atomic functions use the functions
+     * <tt>[name]_direct_forward</tt> and <tt>[name]_direct_reverse</tt>
+     * (see directAtomicForwardDeclaration() and
+     * directAtomicReverseDeclaration()) instead of the function pointers
+     * in LangCAtomicFun.
+     *
+     * @param names the names of the atomic functions
+     */
+    virtual void setDirectAtomicFunctions(const std::set<std::string>& names) {
+        _directAtomicFuncs = names;
+    }
+
+    inline const std::set<std::string>& getDirectAtomicFunctions() const {
+        return _directAtomicFuncs;
+    }
+
+    /**
+     * Defines a header file with the declarations common to all generated
+     * source files (see printFileStart()).
+     * The source files created by this object will only include this
+     * header instead of repeating those declarations.
+     *
+     * @param fileName the header file name (empty to print the
+     *                 declarations in each file)
+     */
+    inline void setSharedHeader(const std::string& fileName) {
+        _sharedHeader = fileName;
+    }
+
+    inline const std::string& getSharedHeader() const {
+        return _sharedHeader;
+    }
+
+    /**
+     * Prints the beginning of a source file: the standard includes and the
+     * structures used to call atomic functions or, when a shared header is
+     * used, only the include of that header.
+     * The include is the first line of the file so that a precompiled
+     * header can be used.
+     *
+     * @param out the output stream
+     * @param sharedHeader the file name of the header with the common
+     *                     declarations (empty if it is not used)
+     */
+    static inline void printFileStart(std::ostream& out,
+                                      const std::string& sharedHeader = "") {
+        if (sharedHeader.empty()) {
+            out << "#include <math.h>\n"
+                    "#include <stdio.h>\n"
+                    "#include <stdlib.h>\n"
+                    "\n"
+                    << ATOMICFUN_STRUCT_DEFINITION << "\n"
+                    "\n";
+        } else {
+            out << "#include \"" << sharedHeader << "\"\n"
+                    "\n";
+        }
+    }
+
+    /**
+     * Provides the declaration of the C function used to call the forward
+     * mode of an atomic function without LangCAtomicFun.
+     * It has the same arguments as LangCAtomicFun::forward except for the
+     * first one which is the LangCAtomicFun itself.
+     *
+     * @param atomicName the atomic function name
+     */
+    static inline std::string directAtomicForwardDeclaration(const std::string& atomicName) {
+        return "int " + atomicName + "_" + ATOMIC_DIRECT_FORWARD + "(struct LangCAtomicFun atomicFun, "
+                "int atomicIndex, int q, int p, const Array tx[], Array* ty)";
+    }
+
+    /**
+     * Provides the declaration of the C function used to call the reverse
+     * mode of an atomic function without LangCAtomicFun.
+     * It has the same arguments as LangCAtomicFun::reverse except for the
+     * first one which is the LangCAtomicFun itself.
+     *
+     * @param atomicName the atomic function name
+     */
+    static inline std::string directAtomicReverseDeclaration(const std::string& atomicName) {
+        return "int " + atomicName + "_" + ATOMIC_DIRECT_REVERSE + "(struct LangCAtomicFun atomicFun, "
+                "int atomicIndex, int p, const Array tx[], Array* px, const Array py[])";
+    }
+
     inline std::string generateTemporaryVariableDeclaration(bool isWrapperFunction,
                                                             bool zeroArrayDependents,
                                                             const std::vector<int>& atomicMaxForward,
@@ -467,6 +729,7 @@ public:
     CPPAD_CG_C_LANG_FUNCNAME(tanh)
     CPPAD_CG_C_LANG_FUNCNAME(tan)
     CPPAD_CG_C_LANG_FUNCNAME(pow)
+    CPPAD_CG_C_LANG_FUNCNAME(fma)
 
 #if CPPAD_USE_CPLUSPLUS_2011
     CPPAD_CG_C_LANG_FUNCNAME(erf)
@@ -486,7 +749,7 @@ public:
      * @param arguments function arguments
      * @param arguments2 additional function arguments
      */
-    static inline void printFunctionDeclaration(std::ostringstream& out,
+    static inline void printFunctionDeclaration(std::ostream& out,
                                                 const std::string& returnType,
                                                 const std::string& functionName,
                                                 const std::vector<std::string>& arguments,
@@ -511,7 +774,7 @@ public:
         out << ")";
     }
 
-    static inline void printIndexCondExpr(std::ostringstream& out,
+    static inline void printIndexCondExpr(std::ostream& out,
                                           const std::vector<size_t>& info,
                                           const std::string& index) {
         CPPADCG_ASSERT_KNOWN(info.size() > 1 && info.size() % 2 == 0, "Invalid number of information elements for an index condition expression operation");
@@ -628,6 +891,11 @@ protected:
         auxArrayName_ = "";
         _currentLoops.clear();
         _atomicFuncArrays.clear();
+        _vectorizedLoops.clear();
+        _vectorizedLoopTmps.clear();
+        _currentVectorizedLoop = nullptr;
+        _directAtomicFuncsUsed.clear();
+        _useConstantPool = _constantPool != nullptr && createFunction;
 
         // save some info
         _info = info.get();
@@ -735,6 +1003,17 @@ protected:
             localFuncNames.reserve(variableOrder.size() / _maxAssigmentsPerFunction);
         }
 
+        // locations where new functions start (determined by the cost model)
+        std::vector<FunctionSplitInfo> splits;
+        if (multiFunction && _splitModel != nullptr) {
+            FunctionSplitPlanner<Base> planner(*_splitModel, info->varId, _maxAssigmentsPerFunction);
+            splits = planner.plan(variableOrder);
+            if (_splitReport != nullptr) {
+                (*_splitReport)[_functionName] = splits;
+            }
+        }
+        size_t nextSplit = 1;
+
         /**
          * non-constant variables
          */
@@ -754,6 +1033,11 @@ protected:
                 }
             }
 
+            if (_vectorizeLoops) {
+                // rename the temporary variables which become local to vectorized loops
+                findVectorizableLoops(variableOrder);
+            }
+
             /**
              * Source code generation magic!
              */
@@ -778,7 +1062,13 @@ protected:
                 Node* it = variableOrder[i];
 
                 // check if a new function should start
-                if (assignCount >= _maxAssigmentsPerFunction && multiFunction && _currentLoops.empty()) {
+                if (!splits.empty()) {
+                    if (nextSplit < splits.size() && i >= splits[nextSplit].begin && _currentLoops.empty()) {
+                        while (nextSplit < splits.size() && i >= splits[nextSplit].begin) nextSplit++;
+                        assignCount = 0;
+                        saveLocalFunction(localFuncNames, localFuncNames.empty() && info->zeroDependents);
+                    }
+                } else if (assignCount >= _maxAssigmentsPerFunction && multiFunction && _currentLoops.empty()) {
                     assignCount = 0;
                     saveLocalFunction(localFuncNames, localFuncNames.empty() && info->zeroDependents);
                 }
@@ -812,7 +1102,8 @@ protected:
             CPPADCG_ASSERT_KNOWN(tmpArg[0].array,
                                  "The temporary variables must be saved in an array in order to generate multiple functions");
 
-            _code << ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+            printFileStart(_code, _sharedHeader);
+            _code << generateConstantPoolDeclaration();
             // forward declarations
             std::string localFuncArgDcl2 = implode(localFuncArgDcl_, ", ");
             for (size_t i = 0; i < localFuncNames.size(); i++) {
@@ -875,9 +1166,9 @@ protected:
          */
         if (createFunction) {
             if (localFuncNames.empty()) {
-                _ss << "#include <math.h>\n"
-                        "#include <stdio.h>\n\n"
-                    << ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+                printFileStart(_ss, _sharedHeader);
+                printDirectAtomicDeclarations(_ss);
+                _ss << generateConstantPoolDeclaration();
                 printFunctionDeclaration(_ss, "void", _functionName, funcArgDcl_);
                 _ss << " {\n";
                 _nameGen->customFunctionVariableDeclarations(_ss);
@@ -887,23 +1178,27 @@ protected:
                                                             info->atomicFunctionsMaxForward,
                                                             info->atomicFunctionsMaxReverse) << "\n";
                 _nameGen->prepareCustomFunctionVariables(_ss);
-                _ss << _code.str();
+                _code.writeTo(_ss);
                 _nameGen->finalizeCustomFunctionVariables(_ss);
                 _ss << "}\n\n";
 
-                out << _ss.str();
-
                 if (_sources != nullptr) {
-                    (*_sources)[_functionName + ".c"] = _ss.str();
+                    std::string& source = (*_sources)[_functionName + ".c"];
+                    source = _ss.str();
+                    out << source;
+                } else {
+                    out << _ss.str();
                 }
             } else {
                 _nameGen->finalizeCustomFunctionVariables(_code);
                 _code << "}\n\n";
 
-                (*_sources)[_functionName + ".c"] = _code.str();
+                std::string& source = (*_sources)[_functionName + ".c"];
+                source.clear();
+                _code.appendTo(source);
             }
         } else {
-            out << _code.str();
+            _code.writeTo(out);
         }
     }
 
@@ -958,12 +1253,14 @@ protected:
     inline virtual void printAssignmentStart(Node& node,
                                              const std::string& varName,
                                              bool isDep) {
-        if (!isDep) {
+        if (!isDep && _vectorizedLoopTmps.find(&node) == _vectorizedLoopTmps.end()) {
             _temporary[getVariableID(node)] = &node;
         }
 
         _code << _indentation << varName << " ";
-        if (isDep) {
+        if (isDep && isPackedLoopElement(node)) {
+            _code << "="; // copied to the dependent array after the loop
+        } else if (isDep) {
             CGOpCode op = node.getOperationType();
             if (op == CGOpCode::DependentMultiAssign || (op == CGOpCode::LoopIndexedDep && node.getInfo()[1] == 1)) {
                 _code << "+=";
@@ -994,9 +1291,9 @@ protected:
         std::string funcName = _ss.str();
         _ss.str("");
 
-        _ss << "#include <math.h>\n"
-                "#include <stdio.h>\n\n"
-                << ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+        printFileStart(_ss, _sharedHeader);
+        printDirectAtomicDeclarations(_ss);
+        _ss << generateConstantPoolDeclaration();
         printFunctionDeclaration(_ss, "void", funcName, localFuncArgDcl_);
         _ss << " {\n";
         _nameGen->customFunctionVariableDeclarations(_ss);
@@ -1020,7 +1317,7 @@ protected:
         createIndexDeclaration();
 
         _nameGen->prepareCustomFunctionVariables(_ss);
-        _ss << _code.str();
+        _code.writeTo(_ss);
         _nameGen->finalizeCustomFunctionVariables(_ss);
         _ss << "}\n\n";
 
@@ -1110,6 +1407,12 @@ protected:
 
     inline const std::string& createVariableName(Node& var) {
         CGOpCode op = var.getOperationType();
+        if (_currentVectorizedLoop != nullptr &&
+                (op == CGOpCode::LoopIndexedDep || (op == CGOpCode::LoopIndexedIndep && !requiresVariableName(var)))) {
+            auto it = _currentVectorizedLoop->packedElements.find(&var);
+            if (it != _currentVectorizedLoop->packedElements.end())
+                return it->second;
+        }
         CPPADCG_ASSERT_UNKNOWN(getVariableID(var) > 0);
         CPPADCG_ASSERT_UNKNOWN(op != CGOpCode::AtomicForward);
         CPPADCG_ASSERT_UNKNOWN(op != CGOpCode::AtomicReverse);
@@ -1271,6 +1574,9 @@ protected:
             case CGOpCode::Pow:
                 printPowFunction(node);
                 break;
+            case CGOpCode::Fma:
+                printFmaFunction(node);
+                break;
             case CGOpCode::Pri:
                 printPrintOperation(node);
                 break;
@@ -1432,6 +1738,18 @@ protected:
         _code << ")";
     }
 
+    virtual void printFmaFunction(Node& op) {
+        CPPADCG_ASSERT_KNOWN(op.getArguments().size() == 3, "Invalid number of arguments for fma() function");
+
+        _code << fmaFuncName() << "(";
+        print(op.getArguments()[0]);
+        _code << ", ";
+        print(op.getArguments()[1]);
+        _code << ", ";
+        print(op.getArguments()[2]);
+        _code << ")";
+    }
+
     virtual void printSignFunction(Node& op) {
         CPPADCG_ASSERT_KNOWN(op.getArguments().size() == 1, "Invalid number of arguments for sign() function");
         CPPADCG_ASSERT_UNKNOWN(op.getArguments()[0].getOperation() != nullptr);
@@ -1699,6 +2017,21 @@ protected:
 
     virtual void printArrayElementOp(Node& op);
 
+    /**
+     * Prints the declarations of the C functions used to call atomic
+     * functions directly in the current function.
+     */
+    inline void printDirectAtomicDeclarations(std::ostream& out) const {
+        if (_directAtomicFuncsUsed.empty())
+            return;
+
+        for (const std::string& name : _directAtomicFuncsUsed) {
+            out << directAtomicForwardDeclaration(name) << ";\n";
+            out << directAtomicReverseDeclaration(name) << ";\n";
+        }
+        out << "\n";
+    }
+
     virtual void printAtomicForwardOp(Node& atomicFor) {
         CPPADCG_ASSERT_KNOWN(atomicFor.getInfo().size() == 3, "Invalid number of information elements for atomic forward operation");
         int q = atomicFor.getInfo()[1];
@@ -1729,10 +2062,16 @@ protected:
         printArrayStructInit(_ATOMIC_TY, *ty[p]); // also does indentation
         _ss.str("");
 
-        _code << _indentation << "atomicFun.forward(atomicFun.libModel, "
-                << atomicIndex << ", " << q << ", " << p << ", "
+        const std::string& atomicName = _info->atomicFunctionId2Name.at(id);
+        if (_directAtomicFuncs.find(atomicName) != _directAtomicFuncs.end()) {
+            _directAtomicFuncsUsed.insert(atomicName);
+            _code << _indentation << atomicName << "_" << ATOMIC_DIRECT_FORWARD << "(atomicFun, ";
+        } else {
+            _code << _indentation << "atomicFun.forward(atomicFun.libModel, ";
+        }
+        _code << atomicIndex << ", " << q << ", " << p << ", "
                 << _ATOMIC_TX << ", &" << _ATOMIC_TY << "); // "
-                << _info->atomicFunctionId2Name.at(id)
+                << atomicName
                 << "\n";
 
         /**
@@ -1777,10 +2116,16 @@ protected:
         printArrayStructInit(_ATOMIC_PX, *px[0]); // also does indentation
         _ss.str("");
 
-        _code << _indentation << "atomicFun.reverse(atomicFun.libModel, "
-                << atomicIndex << ", " << p << ", "
+        const std::string& atomicName = _info->atomicFunctionId2Name.at(id);
+        if (_directAtomicFuncs.find(atomicName) != _directAtomicFuncs.end()) {
+            _directAtomicFuncsUsed.insert(atomicName);
+            _code << _indentation << atomicName << "_" << ATOMIC_DIRECT_REVERSE << "(atomicFun, ";
+        } else {
+            _code << _indentation << "atomicFun.reverse(atomicFun.libModel, ";
+        }
+        _code << atomicIndex << ", " << p << ", "
                 << _ATOMIC_TX << ", &" << _ATOMIC_PX << ", " << _ATOMIC_PY << "); // "
-                << _info->atomicFunctionId2Name.at(id)
+                << atomicName
                 << "\n";
 
         /**
@@ -1828,11 +2173,38 @@ protected:
             iterationCount = oss.str();
         }
 
+        auto itVec = _vectorizedLoops.find(&node);
+        if (itVec != _vectorizedLoops.end()) {
+            const VectorizedLoop& vLoop = itVec->second;
+            _currentVectorizedLoop = &vLoop;
+
+            if (!vLoop.packedArrays.empty()) {
+                _code << _spaces << "{\n";
+                _code << _spaces << _baseTypeName << " ";
+                for (size_t a = 0; a < vLoop.packedArrays.size(); a++) {
+                    if (a > 0) _code << ", ";
+                    _code << vLoop.packedArrays[a].name << "[" << iterationCount << "]";
+                }
+                _code << ";\n";
+                printPackedLoopCopy(vLoop, jj, iterationCount, false);
+            }
+
+            _code << _spaces << "#pragma omp simd";
+            if (!vLoop.privateIndexes.empty()) {
+                _code << " private(" << implode(vLoop.privateIndexes, ", ") << ")";
+            }
+            _code << "\n";
+        }
+
         _code << _spaces << "for("
                 << jj << " = 0; "
                 << jj << " < " << iterationCount << "; "
                 << jj << "++) {\n";
         _indentation += _spaces;
+
+        if (itVec != _vectorizedLoops.end() && !itVec->second.localTemporaries.empty()) {
+            _code << _indentation << _baseTypeName << " " << implode(itVec->second.localTemporaries, ", ") << ";\n";
+        }
     }
 
     virtual void printLoopEnd(Node& node) {
@@ -1842,9 +2214,54 @@ protected:
 
         _code << _indentation << "}\n";
 
+        if (_currentVectorizedLoop != nullptr) {
+            const VectorizedLoop& vLoop = *_currentVectorizedLoop;
+            if (!vLoop.packedArrays.empty()) {
+                const LoopStartOperationNode<Base>& lnode = *_currentLoops.back();
+                std::ostringstream iterationCount;
+                iterationCount << lnode.getIterationCount();
+                printPackedLoopCopy(vLoop, *lnode.getIndex().getName(), iterationCount.str(), true);
+                _code << _indentation << "}\n";
+            }
+            _currentVectorizedLoop = nullptr;
+        }
+
         _currentLoops.pop_back();
     }
 
+    /**
+     * Prints a loop which copies values between the packed arrays of a
+     * vectorized loop and the independent/dependent arrays.
+     *
+     * @param toDependents whether to copy the values determined by the
+     *                     loop (after it) or the values it reads (before it)
+     */
+    inline void printPackedLoopCopy(const VectorizedLoop& vLoop,
+                                    const std::string& jj,
+                                    const std::string& iterationCount,
+                                    bool toDependents) {
+        bool empty = true;
+        for (const PackedLoopArray& a : vLoop.packedArrays) {
+            if (a.assignOp.empty() == toDependents)
+                continue;
+            if (empty) {
+                _code << _spaces << "for(" << jj << " = 0; " << jj << " < " << iterationCount << "; " << jj << "++) {\n";
+                empty = false;
+            }
+            if (toDependents)
+                _code << _spaces << _spaces << a.element << " " << a.assignOp << " " << a.name << "[" << jj << "];\n";
+            else
+                _code << _spaces << _spaces << a.name << "[" << jj << "] = " << a.element << ";\n";
+        }
+        if (!empty)
+            _code << _spaces << "}\n";
+    }
+
+    inline bool isPackedLoopElement(const Node& node) const {
+        return _currentVectorizedLoop != nullptr &&
+                _currentVectorizedLoop->packedElements.find(&node) != _currentVectorizedLoop->packedElements.end();
+    }
+
 
     virtual size_t printLoopIndexDeps(const std::vector<Node*>& variableOrder,
                                       size_t pos);
@@ -1854,10 +2271,59 @@ protected:
 
     virtual void printLoopIndexedDep(Node& node);
 
+    /**
+     * Determines which loops have independent iterations and can be
+     * vectorized, and renames the temporary variables which are local
+     * to a single iteration of those loops.
+     *
+     * @param variableOrder the order of the variables in the source code
+     */
+    virtual void findVectorizableLoops(const std::vector<Node*>& variableOrder);
+
+    /**
+     * Determines the loop indexed values of a vectorized loop which are
+     * packed into contiguous arrays (see setPackLoopArrays()).
+     */
+    virtual void findPackedLoopArrays(const std::vector<Node*>& variableOrder,
+                                      const std::map<const Node*, size_t>& position,
+                                      size_t start,
+                                      size_t end,
+                                      VectorizedLoop& loop);
+
+    virtual bool isVectorizableLoop(const std::vector<Node*>& variableOrder,
+                                    const std::map<const Node*, size_t>& position,
+                                    size_t start,
+                                    size_t end,
+                                    VectorizedLoop& loop,
+                                    std::vector<Node*>& localTmps);
+
+    /**
+     * Determines the dependent variable elements assigned by a loop
+     * indexed dependent operation in every iteration.
+     *
+     * @return false if the elements could not be determined or if they
+     *         are also assigned by another iteration/operation
+     */
+    inline bool addLoopAssignedElements(const LoopStartOperationNode<Base>& loopStart,
+                                        const Node& node,
+                                        std::set<long>& assigned) const;
+
+    static inline bool evaluateIndexPattern(const IndexPattern& ip,
+                                            size_t x,
+                                            long& y);
+
     virtual void printLoopIndexedIndep(Node& node) {
         CPPADCG_ASSERT_KNOWN(node.getOperationType() == CGOpCode::LoopIndexedIndep, "Invalid node type");
         CPPADCG_ASSERT_KNOWN(node.getInfo().size() == 1, "Invalid number of information elements for loop indexed independent operation");
 
+        if (_currentVectorizedLoop != nullptr) {
+            auto it = _currentVectorizedLoop->packedElements.find(&node);
+            if (it != _currentVectorizedLoop->packedElements.end()) {
+                _code << it->second;
+                return;
+            }
+        }
+
         // CGLoopIndexedIndepOp
         size_t pos = node.getInfo()[1];
         const IndexPattern* ip = _info->loopIndependentIndexPatterns[pos];
@@ -1992,6 +2458,57 @@ protected:
     }
 
     virtual void printParameter(const Base& value) {
+        printParameter(value, std::is_floating_point<Base>());
+    }
+
+    /**
+     * @return the declaration of the table of constants used by the
+     *         current function (or an empty string if there is none)
+     */
+    inline std::string generateConstantPoolDeclaration() const {
+        if (!_useConstantPool)
+            return "";
+        return "extern const " + _baseTypeName + " " + _constantPool->getName() + "[];\n\n";
+    }
+
+    /**
+     * Creates the literal of a floating point constant.
+     *
+     * @param value the constant value
+     * @param number where the literal is saved
+     * @return the number of characters in the literal
+     */
+    inline size_t formatFloatingPoint(const Base& value,
+                                      char (&number)[64]) const {
+        // make sure all digits of floating point values are printed
+        // (without creating a new stream for each value)
+        size_t n = printShortestFloatingPoint(value, _parameterPrecision, number, sizeof(number) - 1);
+
+        if (std::abs(value) > Base(0) && value != Base(1) && value != Base(-1)) {
+            if (std::find(number, number + n, '.') == number + n && std::find(number, number + n, 'e') == number + n) {
+                // also make sure there is always a '.' after the number in
+                // order to avoid integer overflows
+                number[n++] = '.';
+            }
+        }
+        return n;
+    }
+
+    inline void printParameter(const Base& value,
+                               std::true_type) {
+        char number[64];
+        size_t n = formatFloatingPoint(value, number);
+
+        if (_useConstantPool && n > _constantPool->getMaxInlineLength()) {
+            // resolved once all the functions using the table are generated
+            _code << _constantPool->getName() << '[' << _constantPool->addCandidate(value, number, n) << ']';
+        } else {
+            _code.write(number, n);
+        }
+    }
+
+    inline void printParameter(const Base& value,
+                               std::false_type) {
         // make sure all digits of floating point values are printed
         std::ostringstream os;
         os << std::setprecision(_parameterPrecision) << value;
@@ -2040,7 +2557,7 @@ protected:
     }
 
     static bool isFunction(enum CGOpCode op) {
-        return isUnaryFunction(op) || op == CGOpCode::Pow;
+        return isUnaryFunction(op) || op == CGOpCode::Pow || op == CGOpCode::Fma;
     }
 
     static bool isUnaryFunction(enum CGOpCode op) {
@@ -2131,6 +2648,12 @@ const std::string LanguageC<Base>::_ATOMIC_PX = "apx";
 template<class Base>
 const std::string LanguageC<Base>::_ATOMIC_PY = "apy";
 
+template<class Base>
+const std::string LanguageC<Base>::ATOMIC_DIRECT_FORWARD = "direct_forward";
+
+template<class Base>
+const std::string LanguageC<Base>::ATOMIC_DIRECT_REVERSE = "direct_reverse";
+
 template<class Base>
 const std::string LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION = "typedef struct Array {\n"
 "    void* data;\n"
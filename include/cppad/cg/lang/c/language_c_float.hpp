@@ -101,6 +101,12 @@ inline const std::string& LanguageC<float>::tanFuncName() {
     return name;
 }
 
+template<>
+inline const std::string& LanguageC<float>::fmaFuncName() {
+    static const std::string name("fmaf"); // C99
+    return name;
+}
+
 #if CPPAD_USE_CPLUSPLUS_2011
 template<>
 inline const std::string& LanguageC<float>::erfFuncName() {
@@ -0,0 +1,456 @@
+#ifndef CPPAD_CG_LANGUAGE_C_FUNCTION_SPLIT_INCLUDED
+#define CPPAD_CG_LANGUAGE_C_FUNCTION_SPLIT_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Estimates the time required by a C compiler to compile a generated
+ * function with a given number of assignments:
+ *
+ *   t(n) = perFunction + perAssignment * n^exponent
+ *
+ * Optimizing compilers such as GCC have a super-linear compilation time
+ * in the size of a function (exponent > 1).
+ * Values which must cross a function boundary are saved in the temporary
+ * array (spilled) and are penalized with spillWeight (in seconds).
+ *
+ * @author Joao Leal
+ */
+class FunctionSplitCostModel {
+private:
+    /**
+     * fixed cost of compiling an additional function/source file [s]
+     */
+    double _perFunction;
+    /**
+     * cost coefficient for the assignments [s]
+     */
+    double _perAssignment;
+    /**
+     * the super-linear exponent of the number of assignments
+     */
+    double _exponent;
+    /**
+     * penalty for each value which crosses a function boundary [s]
+     */
+    double _spillWeight;
+public:
+
+    /**
+     * Creates a cost model (the default values are typical for GCC
+     * with -O2)
+     */
+    inline FunctionSplitCostModel(double perFunction = 0.05,
+                                  double perAssignment = 4e-6,
+                                  double exponent = 1.25,
+                                  double spillWeight = 2e-5) :
+        _perFunction(perFunction),
+        _perAssignment(perAssignment),
+        _exponent(exponent),
+        _spillWeight(spillWeight) {
+        CPPADCG_ASSERT_KNOWN(perFunction >= 0 && perAssignment >= 0 && spillWeight >= 0,
+                             "Cost model coefficients cannot be negative");
+        CPPADCG_ASSERT_KNOWN(exponent >= 1, "The cost model exponent must be greater or equal to 1");
+    }
+
+    inline double getPerFunction() const {
+        return _perFunction;
+    }
+
+    inline double getPerAssignment() const {
+        return _perAssignment;
+    }
+
+    inline double getExponent() const {
+        return _exponent;
+    }
+
+    inline double getSpillWeight() const {
+        return _spillWeight;
+    }
+
+    inline void setSpillWeight(double spillWeight) {
+        CPPADCG_ASSERT_KNOWN(spillWeight >= 0, "The spill weight cannot be negative");
+        _spillWeight = spillWeight;
+    }
+
+    /**
+     * Provides the estimated compilation time of a function
+     *
+     * @param assignments the number of assignments in the function
+     * @return the estimated compilation time [s]
+     */
+    inline double estimateCompileTime(size_t assignments) const {
+        return _perFunction + _perAssignment * std::pow(double(assignments), _exponent);
+    }
+
+    /**
+     * Calibrates a cost model to a specific compiler using measured
+     * compilation times.
+     * The exponent is determined by a search in [1, 2] and the remaining
+     * coefficients by linear least squares.
+     *
+     * @param assignments the number of assignments in each measured function
+     * @param times the measured compilation time of each function [s]
+     * @param spillWeight the penalty for each value crossing a function
+     *                    boundary [s]
+     * @return the calibrated cost model
+     */
+    static inline FunctionSplitCostModel calibrate(const std::vector<size_t>& assignments,
+                                                   const std::vector<double>& times,
+                                                   double spillWeight = 2e-5) {
+        CPPADCG_ASSERT_KNOWN(assignments.size() == times.size(), "Invalid number of compilation times");
+        CPPADCG_ASSERT_KNOWN(assignments.size() >= 3, "At least three measurements are required for calibration");
+
+        const size_t m = assignments.size();
+        double bestRes = std::numeric_limits<double>::max();
+        FunctionSplitCostModel best(0, 0, 1, spillWeight);
+
+        for (size_t e = 0; e <= 100; e++) {
+            double a = 1.0 + e / 100.0;
+
+            // linear least squares for t = c0 + c1 * n^a
+            double sx = 0, sy = 0, sxx = 0, sxy = 0;
+            for (size_t k = 0; k < m; k++) {
+                double x = std::pow(double(assignments[k]), a);
+                sx += x;
+                sy += times[k];
+                sxx += x * x;
+                sxy += x * times[k];
+            }
+            double det = m * sxx - sx * sx;
+            if (det <= 0)
+                continue;
+
+            double c1 = std::max(0.0, (m * sxy - sx * sy) / det);
+            double c0 = std::max(0.0, (sy - c1 * sx) / m);
+
+            double res = 0;
+            for (size_t k = 0; k < m; k++) {
+                double r = c0 + c1 * std::pow(double(assignments[k]), a) - times[k];
+                res += r * r;
+            }
+
+            if (res < bestRes) {
+                bestRes = res;
+                best = FunctionSplitCostModel(c0, c1, a, spillWeight);
+            }
+        }
+
+        return best;
+    }
+
+    inline virtual ~FunctionSplitCostModel() {
+    }
+};
+
+/**
+ * Information on a function created by splitting a larger function
+ */
+class FunctionSplitInfo {
+public:
+    /**
+     * the first position in the variable order of this function
+     */
+    size_t begin;
+    /**
+     * one past the last position in the variable order of this function
+     */
+    size_t end;
+    /**
+     * the estimated number of assignments
+     */
+    size_t assignments;
+    /**
+     * estimated compilation time [s]
+     */
+    double compileTime;
+    /**
+     * number of values defined in a previous function which are used in
+     * this function (read from the temporary array)
+     */
+    size_t spilledIn;
+    /**
+     * number of values defined in this function or before which are used
+     * by the following functions (saved in the temporary array)
+     */
+    size_t spilledOut;
+public:
+
+    inline FunctionSplitInfo(size_t b = 0,
+                             size_t e = 0) :
+        begin(b),
+        end(e),
+        assignments(0),
+        compileTime(0),
+        spilledIn(0),
+        spilledOut(0) {
+    }
+};
+
+/**
+ * Determines where a function with a large number of assignments should
+ * be split so that the estimated compilation time and the number of
+ * values which cross function boundaries is minimal.
+ * Splits are never placed inside loops or conditional blocks.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class FunctionSplitPlanner {
+public:
+    typedef OperationNode<Base> Node;
+    typedef Argument<Base> Arg;
+private:
+    /**
+     * the maximum number of candidate split locations considered inside
+     * the range of a single function
+     */
+    static const size_t CANDIDATES_PER_FUNCTION = 32;
+private:
+    const FunctionSplitCostModel& _model;
+    const CodeHandlerVector<Base, size_t>& _varId;
+    /**
+     * upper bound for the number of assignments in a function
+     */
+    const size_t _maxAssignments;
+    /**
+     * maps variables to their position in the variable order
+     */
+    std::map<const Node*, size_t> _position;
+public:
+
+    inline FunctionSplitPlanner(const FunctionSplitCostModel& model,
+                                const CodeHandlerVector<Base, size_t>& varId,
+                                size_t maxAssignments) :
+        _model(model),
+        _varId(varId),
+        _maxAssignments(maxAssignments) {
+        CPPADCG_ASSERT_KNOWN(maxAssignments > 0, "Invalid maximum number of assignments per function");
+    }
+
+    /**
+     * Determines the functions to be created.
+     *
+     * @param variableOrder the variable assignment order
+     * @return the functions to be created (a single element if no split
+     *         is required)
+     */
+    inline std::vector<FunctionSplitInfo> plan(const std::vector<Node*>& variableOrder) {
+        const size_t n = variableOrder.size();
+
+        /**
+         * number of assignments before each position
+         */
+        std::vector<size_t> assign(n + 1, 0);
+        for (size_t i = 0; i < n; i++) {
+            CGOpCode op = variableOrder[i]->getOperationType();
+            bool printed = op != CGOpCode::DependentRefRhs && op != CGOpCode::TmpDcl;
+            assign[i + 1] = assign[i] + (printed ? 1 : 0);
+        }
+
+        std::vector<size_t> live = determineLiveValues(variableOrder);
+
+        if (assign[n] <= _maxAssignments) {
+            return createInfo({0, n}, assign, live);
+        }
+
+        /**
+         * candidate split locations (thinned to the lowest live count
+         * inside blocks of assignments)
+         */
+        size_t blockSize = std::max<size_t>(1, _maxAssignments / CANDIDATES_PER_FUNCTION);
+
+        std::vector<size_t> candidates;
+        candidates.reserve(assign[n] / blockSize + 2);
+        candidates.push_back(0);
+
+        size_t lastBlock = std::numeric_limits<size_t>::max();
+        int depth = 0;
+        for (size_t i = 1; i < n; i++) {
+            depth += scopeChange(*variableOrder[i - 1]);
+            if (depth != 0)
+                continue;
+            if (variableOrder[i]->getOperationType() == CGOpCode::LoopIndexedDep &&
+                variableOrder[i - 1]->getOperationType() == CGOpCode::LoopIndexedDep)
+                continue; // consecutive dependents are printed together
+
+            size_t block = assign[i] / blockSize;
+            if (block != lastBlock) {
+                candidates.push_back(i);
+                lastBlock = block;
+            } else if (live[i] <= live[candidates.back()]) {
+                candidates.back() = i;
+            }
+        }
+        candidates.push_back(n);
+
+        /**
+         * determine the best partition using dynamic programming
+         */
+        const size_t nc = candidates.size();
+        std::vector<double> best(nc, std::numeric_limits<double>::max());
+        std::vector<size_t> previous(nc, 0);
+        best[0] = 0;
+
+        for (size_t j = 1; j < nc; j++) {
+            size_t cj = candidates[j];
+            double spill = (cj < n) ? _model.getSpillWeight() * live[cj] : 0.0;
+
+            for (size_t k = j; k > 0; k--) {
+                size_t ck = candidates[k - 1];
+                size_t a = assign[cj] - assign[ck];
+                if (a > _maxAssignments && k != j)
+                    break; // the previous candidate must always be considered (even if too large)
+
+                double cost = best[k - 1] + _model.estimateCompileTime(a) + spill;
+                if (cost < best[j]) {
+                    best[j] = cost;
+                    previous[j] = k - 1;
+                }
+            }
+        }
+
+        std::vector<size_t> bounds;
+        for (size_t j = nc - 1; j > 0; j = previous[j]) {
+            bounds.push_back(candidates[j]);
+        }
+        bounds.push_back(0);
+        std::reverse(bounds.begin(), bounds.end());
+
+        return createInfo(bounds, assign, live);
+    }
+
+private:
+
+    inline std::vector<FunctionSplitInfo> createInfo(const std::vector<size_t>& bounds,
+                                                     const std::vector<size_t>& assign,
+                                                     const std::vector<size_t>& live) const {
+        const size_t n = assign.size() - 1;
+
+        std::vector<FunctionSplitInfo> info(bounds.size() - 1);
+        for (size_t f = 0; f < info.size(); f++) {
+            FunctionSplitInfo& fi = info[f];
+            fi.begin = bounds[f];
+            fi.end = bounds[f + 1];
+            fi.assignments = assign[fi.end] - assign[fi.begin];
+            fi.compileTime = _model.estimateCompileTime(fi.assignments);
+            fi.spilledIn = (fi.begin > 0) ? live[fi.begin] : 0;
+            fi.spilledOut = (fi.end < n) ? live[fi.end] : 0;
+        }
+        return info;
+    }
+
+    /**
+     * Determines the number of values which are alive (defined before
+     * and used at or after) at each position of the variable order.
+     */
+    inline std::vector<size_t> determineLiveValues(const std::vector<Node*>& variableOrder) {
+        const size_t n = variableOrder.size();
+
+        _position.clear();
+        for (size_t i = 0; i < n; i++) {
+            _position[variableOrder[i]] = i;
+        }
+
+        std::vector<size_t> lastUse(n, 0);
+        std::set<const Node*> visited;
+        for (size_t i = 0; i < n; i++) {
+            visited.clear();
+            for (const Arg& a : variableOrder[i]->getArguments()) {
+                if (a.getOperation() != nullptr) {
+                    markUsage(*a.getOperation(), i, lastUse, visited);
+                }
+            }
+        }
+
+        std::vector<long> delta(n + 1, 0);
+        for (size_t d = 0; d < n; d++) {
+            if (lastUse[d] > d && isSpillCandidate(*variableOrder[d])) {
+                delta[d + 1]++;
+                delta[lastUse[d] + 1]--;
+            }
+        }
+
+        std::vector<size_t> live(n + 1, 0);
+        long count = 0;
+        for (size_t i = 0; i <= n; i++) {
+            count += delta[i];
+            live[i] = count;
+        }
+        return live;
+    }
+
+    inline void markUsage(const Node& node,
+                          size_t i,
+                          std::vector<size_t>& lastUse,
+                          std::set<const Node*>& visited) {
+        if (!visited.insert(&node).second)
+            return;
+
+        auto it = _position.find(&node);
+        if (it != _position.end()) {
+            // a variable
+            if (lastUse[it->second] < i)
+                lastUse[it->second] = i;
+        } else {
+            // an expression printed inline
+            for (const Arg& a : node.getArguments()) {
+                if (a.getOperation() != nullptr) {
+                    markUsage(*a.getOperation(), i, lastUse, visited);
+                }
+            }
+        }
+    }
+
+    inline bool isSpillCandidate(const Node& node) const {
+        switch (node.getOperationType()) {
+            case CGOpCode::Inv:
+            case CGOpCode::Index:
+            case CGOpCode::IndexAssign:
+            case CGOpCode::IndexDeclaration:
+            case CGOpCode::LoopStart:
+            case CGOpCode::LoopEnd:
+            case CGOpCode::StartIf:
+            case CGOpCode::ElseIf:
+            case CGOpCode::Else:
+            case CGOpCode::EndIf:
+                return false;
+            default:
+                return _varId[node] != 0;
+        }
+    }
+
+    static inline int scopeChange(const Node& node) {
+        switch (node.getOperationType()) {
+            case CGOpCode::LoopStart:
+            case CGOpCode::StartIf:
+                return 1;
+            case CGOpCode::LoopEnd:
+            case CGOpCode::EndIf:
+                return -1;
+            default:
+                return 0;
+        }
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -172,6 +172,329 @@ inline size_t LanguageC<Base>::printLoopIndexedDepsUsingLoop(const std::vector<O
 }
 
 
+template<class Base>
+void LanguageC<Base>::findVectorizableLoops(const std::vector<OperationNode<Base>*>& variableOrder) {
+    _vectorizedLoops.clear();
+    _vectorizedLoopTmps.clear();
+
+    const size_t vSize = variableOrder.size();
+
+    std::map<const OperationNode<Base>*, size_t> position;
+    for (size_t i = 0; i < vSize; i++)
+        position[variableOrder[i]] = i;
+
+    const std::string& tmpName = _nameGen->getTemporary()[0].name;
+
+    for (size_t i = 0; i < vSize; i++) {
+        if (variableOrder[i]->getOperationType() != CGOpCode::LoopStart)
+            continue;
+
+        // only the innermost loops are considered
+        size_t end = i + 1;
+        while (end < vSize &&
+                variableOrder[end]->getOperationType() != CGOpCode::LoopEnd &&
+                variableOrder[end]->getOperationType() != CGOpCode::LoopStart) {
+            end++;
+        }
+        if (end == vSize || variableOrder[end]->getOperationType() != CGOpCode::LoopEnd)
+            continue;
+
+        VectorizedLoop loop;
+        std::vector<OperationNode<Base>*> localTmps;
+        if (!isVectorizableLoop(variableOrder, position, i, end, loop, localTmps))
+            continue;
+
+        // temporaries used only inside a single iteration are declared in the loop body
+        std::set<size_t> ids;
+        for (OperationNode<Base>* node : localTmps) {
+            size_t id = getVariableID(*node);
+            std::ostringstream name;
+            name << tmpName << "_" << id;
+            node->setName(name.str());
+            if (ids.insert(id).second) {
+                loop.localTemporaries.push_back(name.str());
+            }
+            _vectorizedLoopTmps.insert(node);
+        }
+
+        if (_packLoopArrays) {
+            findPackedLoopArrays(variableOrder, position, i, end, loop);
+        }
+
+        _vectorizedLoops[variableOrder[i]] = loop;
+    }
+}
+
+template<class Base>
+void LanguageC<Base>::findPackedLoopArrays(const std::vector<OperationNode<Base>*>& variableOrder,
+                                           const std::map<const OperationNode<Base>*, size_t>& position,
+                                           size_t start,
+                                           size_t end,
+                                           VectorizedLoop& loop) {
+    const LoopStartOperationNode<Base>& lnode = static_cast<const LoopStartOperationNode<Base>&> (*variableOrder[start]);
+    const size_t nIterations = lnode.getIterationCount();
+    if (nIterations < 2)
+        return;
+
+    const std::string& jj = *lnode.getIndex().getName();
+    const std::string& tmpName = _nameGen->getTemporary()[0].name;
+    size_t maxArrays = _maxPackedLoopElements / nIterations;
+
+    // only accesses which depend exclusively on the loop index are packed
+    auto usesLoopIndexOnly = [&](const OperationNode<Base>& node, size_t indexArg) {
+        const std::vector<Argument<Base> >& args = node.getArguments();
+        if (args.size() != indexArg + 1 || args[indexArg].getOperation() == nullptr ||
+                args[indexArg].getOperation()->getOperationType() != CGOpCode::Index)
+            return false;
+        const IndexOperationNode<Base>& iop = static_cast<const IndexOperationNode<Base>&> (*args[indexArg].getOperation());
+        return &iop.getIndex() == &lnode.getIndex();
+    };
+
+    // contiguous (or constant) accesses do not benefit from packing
+    auto isUnitStride = [](const IndexPattern& ip) {
+        if (ip.getType() != IndexPatternType::Linear)
+            return false;
+        const LinearIndexPattern& lip = static_cast<const LinearIndexPattern&> (ip);
+        return lip.getLinearSlopeDx() == 1 && (lip.getLinearSlopeDy() == 1 || lip.getLinearSlopeDy() == 0);
+    };
+
+    std::map<std::string, std::string> readArrays; // strided element -> packed element
+
+    auto pack = [&](const OperationNode<Base>& node,
+                    const std::string& element,
+                    const std::string& assignOp) {
+        if (assignOp.empty()) {
+            auto it = readArrays.find(element);
+            if (it != readArrays.end()) {
+                loop.packedElements[&node] = it->second;
+                return;
+            }
+        }
+        if (loop.packedArrays.size() >= maxArrays)
+            return;
+
+        PackedLoopArray a;
+        std::ostringstream name;
+        name << tmpName << "_soa" << loop.packedArrays.size();
+        a.name = name.str();
+        a.element = element;
+        a.assignOp = assignOp;
+        loop.packedArrays.push_back(a);
+
+        std::string packed = a.name + "[" + jj + "]";
+        loop.packedElements[&node] = packed;
+        if (assignOp.empty())
+            readArrays[element] = packed;
+    };
+
+    std::set<const OperationNode<Base>*> visited;
+    std::vector<const OperationNode<Base>*> stack;
+
+    for (size_t i = start + 1; i < end; i++) {
+        const OperationNode<Base>& node = *variableOrder[i];
+
+        if (node.getOperationType() == CGOpCode::LoopIndexedDep) {
+            const IndexPattern& ip = *_info->loopDependentIndexPatterns[node.getInfo()[0]];
+            if (usesLoopIndexOnly(node, 1) && !isUnitStride(ip)) {
+                std::string element = _nameGen->generateIndexedDependent(node, getVariableID(node), ip);
+                pack(node, element, node.getInfo()[1] == 1 ? "+=" : _depAssignOperation);
+            }
+        }
+
+        // values read by the loop body
+        stack.push_back(&node);
+        while (!stack.empty()) {
+            const OperationNode<Base>* n = stack.back();
+            stack.pop_back();
+            if (!visited.insert(n).second)
+                continue;
+
+            if (n->getOperationType() == CGOpCode::LoopIndexedIndep) {
+                const IndexPattern& ip = *_info->loopIndependentIndexPatterns[n->getInfo()[1]];
+                if (usesLoopIndexOnly(*n, 0) && !isUnitStride(ip)) {
+                    pack(*n, _nameGen->generateIndexedIndependent(*n, getVariableID(*n), ip), "");
+                }
+                continue;
+            }
+
+            if (n == &node || position.find(n) == position.end()) {
+                // an expression printed inline
+                for (const Argument<Base>& a : n->getArguments()) {
+                    if (a.getOperation() != nullptr)
+                        stack.push_back(a.getOperation());
+                }
+            }
+        }
+    }
+}
+
+template<class Base>
+bool LanguageC<Base>::isVectorizableLoop(const std::vector<OperationNode<Base>*>& variableOrder,
+                                         const std::map<const OperationNode<Base>*, size_t>& position,
+                                         size_t start,
+                                         size_t end,
+                                         VectorizedLoop& loop,
+                                         std::vector<OperationNode<Base>*>& localTmps) {
+    const LoopStartOperationNode<Base>& lnode = static_cast<const LoopStartOperationNode<Base>&> (*variableOrder[start]);
+    if (lnode.getIterationCountNode() != nullptr)
+        return false; // the number of iterations is only known at runtime
+
+    std::set<long> assigned;
+    std::set<const OperationNode<Base>*> tmps;
+
+    for (size_t i = start + 1; i < end; i++) {
+        OperationNode<Base>& node = *variableOrder[i];
+        CGOpCode op = node.getOperationType();
+
+        switch (op) {
+            case CGOpCode::LoopIndexedTmp: // values carried across iterations
+            case CGOpCode::TmpDcl:
+            case CGOpCode::ArrayCreation: // shared arrays
+            case CGOpCode::SparseArrayCreation:
+            case CGOpCode::ArrayElement:
+            case CGOpCode::AtomicForward:
+            case CGOpCode::AtomicReverse:
+            case CGOpCode::DependentMultiAssign:
+            case CGOpCode::Pri:
+            case CGOpCode::StartIf:
+            case CGOpCode::ElseIf:
+            case CGOpCode::Else:
+            case CGOpCode::EndIf:
+            case CGOpCode::CondResult:
+                return false;
+
+            case CGOpCode::IndexAssign:
+            {
+                const IndexAssignOperationNode<Base>& inode = static_cast<const IndexAssignOperationNode<Base>&> (node);
+                const std::string& index = *inode.getIndex().getName();
+                if (std::find(loop.privateIndexes.begin(), loop.privateIndexes.end(), index) == loop.privateIndexes.end())
+                    loop.privateIndexes.push_back(index);
+                continue;
+            }
+            case CGOpCode::LoopIndexedDep:
+                if (!addLoopAssignedElements(lnode, node, assigned))
+                    return false;
+                continue;
+
+            case CGOpCode::DependentRefRhs:
+            case CGOpCode::IndexDeclaration:
+                continue;
+
+            default:
+                break;
+        }
+
+        if (isDependent(node))
+            return false;
+
+        if (requiresVariableName(node)) {
+            localTmps.push_back(&node);
+            tmps.insert(&node);
+        }
+    }
+
+    if (tmps.empty())
+        return true;
+
+    /**
+     * temporary variables cannot be used after the loop
+     */
+    std::set<const OperationNode<Base>*> visited;
+    std::vector<const OperationNode<Base>*> stack;
+
+    for (size_t i = end; i < variableOrder.size(); i++) {
+        for (const Argument<Base>& a : variableOrder[i]->getArguments()) {
+            if (a.getOperation() != nullptr)
+                stack.push_back(a.getOperation());
+        }
+
+        while (!stack.empty()) {
+            const OperationNode<Base>* n = stack.back();
+            stack.pop_back();
+            if (!visited.insert(n).second)
+                continue;
+
+            if (tmps.find(n) != tmps.end())
+                return false;
+
+            if (position.find(n) == position.end()) {
+                // an expression printed inline
+                for (const Argument<Base>& a : n->getArguments()) {
+                    if (a.getOperation() != nullptr)
+                        stack.push_back(a.getOperation());
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+template<class Base>
+inline bool LanguageC<Base>::addLoopAssignedElements(const LoopStartOperationNode<Base>& loopStart,
+                                                     const OperationNode<Base>& node,
+                                                     std::set<long>& assigned) const {
+    const std::vector<Argument<Base> >& args = node.getArguments();
+    if (args.size() != 2 || args[0].getOperation() == nullptr || args[1].getOperation() == nullptr)
+        return false;
+
+    if (args[0].getOperation()->getOperationType() == CGOpCode::ArrayElement)
+        return false; // might be assigned using an auxiliary loop
+
+    if (args[1].getOperation()->getOperationType() != CGOpCode::Index)
+        return false;
+
+    const IndexOperationNode<Base>& iop = static_cast<const IndexOperationNode<Base>&> (*args[1].getOperation());
+    if (&iop.getIndex() != &loopStart.getIndex())
+        return false; // depends on other indexes
+
+    const IndexPattern* ip = _info->loopDependentIndexPatterns[node.getInfo()[0]];
+
+    size_t nIterations = loopStart.getIterationCount();
+    for (size_t x = 0; x < nIterations; x++) {
+        long y;
+        if (!evaluateIndexPattern(*ip, x, y) || !assigned.insert(y).second)
+            return false;
+    }
+
+    return true;
+}
+
+template<class Base>
+inline bool LanguageC<Base>::evaluateIndexPattern(const IndexPattern& ip,
+                                                  size_t x,
+                                                  long& y) {
+    switch (ip.getType()) {
+        case IndexPatternType::Linear:
+            y = static_cast<const LinearIndexPattern&> (ip).evaluate(x);
+            return true;
+
+        case IndexPatternType::Sectioned:
+        {
+            const std::map<size_t, IndexPattern*>& sections = static_cast<const SectionedIndexPattern&> (ip).getLinearSections();
+            std::map<size_t, IndexPattern*>::const_iterator it = sections.upper_bound(x);
+            if (it == sections.begin())
+                return false;
+            --it;
+            return evaluateIndexPattern(*it->second, x, y);
+        }
+
+        case IndexPatternType::Random1D:
+        {
+            const std::map<size_t, size_t>& values = static_cast<const Random1DIndexPattern&> (ip).getValues();
+            std::map<size_t, size_t>::const_iterator it = values.find(x);
+            if (it == values.end())
+                return false;
+            y = it->second;
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+
 } // END cg namespace
 } // END CppAD namespace
 
@@ -801,6 +801,8 @@ protected:
                 return printOperationMul(node);
             case CGOpCode::Pow:
                 return printPowFunction(node);
+            case CGOpCode::Fma:
+                return printFmaFunction(node);
             case CGOpCode::Pri:
                 // do nothing
                 return makeNodeName(node);
@@ -872,6 +874,20 @@ protected:
         return name;
     }
 
+    virtual std::string printFmaFunction(OperationNode<Base>& op) {
+        CPPADCG_ASSERT_KNOWN(op.getArguments().size() == 3, "Invalid number of arguments for fma() function");
+
+        std::string a0 = print(op.getArguments()[0]);
+        std::string a1 = print(op.getArguments()[1]);
+        std::string a2 = print(op.getArguments()[2]);
+
+        std::string name = printNodeDeclaration(op);
+
+        printEdges(name, op, std::vector<std::string>{a0, a1, a2}, std::vector<std::string>{"label=\"$1\"", "label=\"$2\"", "label=\"$3\""});
+
+        return name;
+    }
+
     virtual std::string printUnaryFunction(OperationNode<Base>& op) {
         CPPADCG_ASSERT_KNOWN(op.getArguments().size() == 1, "Invalid number of arguments for an unary function");
 
@@ -1406,7 +1422,7 @@ protected:
     }
 
     static bool isFunction(enum CGOpCode op) {
-        return isUnaryFunction(op) || op == CGOpCode::Pow;
+        return isUnaryFunction(op) || op == CGOpCode::Pow || op == CGOpCode::Fma;
     }
 
     static bool isUnaryFunction(enum CGOpCode op) {
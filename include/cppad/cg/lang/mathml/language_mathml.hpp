@@ -1266,6 +1266,9 @@ protected:
             case CGOpCode::Pow:
                 printPowFunction(node);
                 break;
+            case CGOpCode::Fma:
+                printFmaFunction(node);
+                break;
             case CGOpCode::Pri:
                 // do nothing
                 break;
@@ -1581,6 +1584,42 @@ protected:
         }
     }
 
+    virtual void printFmaFunction(Node& op) {
+        CPPADCG_ASSERT_KNOWN(op.getArguments().size() == 3, "Invalid number of arguments for fma() function");
+
+        const Arg& left = op.getArguments()[0];
+        const Arg& right = op.getArguments()[1];
+        const Arg& addend = op.getArguments()[2];
+
+        bool encloseLeft = encloseInParenthesesMul(left);
+        bool encloseRight = encloseInParenthesesMul(right);
+
+        if (encloseLeft) {
+            _code << "<mfenced><mrow>";
+        }
+        print(left);
+        if (encloseLeft) {
+            _code << "</mrow></mfenced>";
+        }
+        _code << _multOpStr;
+        if (encloseRight) {
+            _code << "<mfenced><mrow>";
+        }
+        print(right);
+        if (encloseRight) {
+            _code << "</mrow></mfenced>";
+        }
+
+        if (addend.getParameter() == nullptr || (*addend.getParameter() >= 0)) {
+            _code << "<mo>+</mo>";
+            print(addend);
+        } else {
+            // the addend is a negative parameter so we would get v0 v1 + -v2
+            _code << "<mo>-</mo>";
+            printParameter(-*addend.getParameter()); // make it positive
+        }
+    }
+
     virtual void printOperationUnaryMinus(Node& op) {
         CPPADCG_ASSERT_KNOWN(op.getArguments().size() == 1, "Invalid number of arguments for unary minus");
 
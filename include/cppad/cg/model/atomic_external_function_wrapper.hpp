@@ -129,12 +129,17 @@ private:
                            size_t n,
                            size_t p,
                            size_t k) {
-        CPPADCG_ASSERT_KNOWN(!to.sparse, "output must be a dense array");
         CPPADCG_ASSERT_KNOWN(to.size >= n, "invalid size");
 
         Base* values = static_cast<Base*> (to.data);
 
-        if (p == 0) {
+        if (to.sparse) {
+            // only the requested locations are provided
+            size_t p1 = p + 1;
+            for (size_t e = 0; e < to.nnz; e++) {
+                values[e] = from[to.idx[e] * p1 + k];
+            }
+        } else if (p == 0) {
             std::copy(&from[0], &from[0] + n, values);
         } else {
             size_t p1 = p + 1;
@@ -0,0 +1,317 @@
+#ifndef CPPAD_CG_BUILD_MANIFEST_INCLUDED
+#define CPPAD_CG_BUILD_MANIFEST_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include <cstdint>
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Creates a fingerprint (a 64 bit FNV-1a hash) of the data which
+ * determines the content of generated files.
+ *
+ * @author Joao Leal
+ */
+class BuildFingerprint {
+private:
+    uint64_t hash_;
+public:
+
+    inline BuildFingerprint() :
+        hash_(14695981039346656037ull) {
+    }
+
+    inline void add(const void* data,
+                    size_t size) {
+        const unsigned char* d = static_cast<const unsigned char*> (data);
+        for (size_t i = 0; i < size; i++) {
+            hash_ ^= d[i];
+            hash_ *= 1099511628211ull;
+        }
+    }
+
+    inline BuildFingerprint& operator<<(const std::string& s) {
+        *this << s.size();
+        add(s.data(), s.size());
+        return *this;
+    }
+
+    inline BuildFingerprint& operator<<(const char* s) {
+        return *this << std::string(s);
+    }
+
+    inline BuildFingerprint& operator<<(unsigned long long v) {
+        // independent from the endianness and size of the integer types
+        unsigned char bytes[8];
+        for (size_t i = 0; i < 8; i++) {
+            bytes[i] = static_cast<unsigned char> (v >> (8 * i));
+        }
+        add(bytes, 8);
+        return *this;
+    }
+
+    inline BuildFingerprint& operator<<(unsigned long v) {
+        return *this << static_cast<unsigned long long> (v);
+    }
+
+    inline BuildFingerprint& operator<<(unsigned int v) {
+        return *this << static_cast<unsigned long long> (v);
+    }
+
+    inline BuildFingerprint& operator<<(int v) {
+        return *this << static_cast<unsigned long long> (static_cast<long long> (v));
+    }
+
+    inline BuildFingerprint& operator<<(bool v) {
+        return *this << static_cast<unsigned long long> (v ? 1 : 0);
+    }
+
+    inline BuildFingerprint& operator<<(double v) {
+        std::ostringstream os;
+        os << std::setprecision(std::numeric_limits<double>::max_digits10) << v;
+        return *this << os.str();
+    }
+
+    inline BuildFingerprint& operator<<(const BuildFingerprint& other) {
+        return *this << other.hash_;
+    }
+
+    template<class T>
+    inline BuildFingerprint& operator<<(const std::vector<T>& v) {
+        *this << v.size();
+        for (const T& e : v)
+            *this << e;
+        return *this;
+    }
+
+    template<class T>
+    inline BuildFingerprint& operator<<(const std::set<T>& v) {
+        *this << v.size();
+        for (const T& e : v)
+            *this << e;
+        return *this;
+    }
+
+    /**
+     * @return the fingerprint as 16 hexadecimal digits
+     */
+    inline std::string str() const {
+        static const char digits[] = "0123456789abcdef";
+        std::string s(16, '0');
+        for (size_t i = 0; i < 16; i++) {
+            s[15 - i] = digits[(hash_ >> (4 * i)) & 0xf];
+        }
+        return s;
+    }
+};
+
+/**
+ * Information on the previous build of a library which allows to
+ * recompile only the models whose sources would change.
+ * It is saved as a text file next to the library.
+ *
+ * @author Joao Leal
+ */
+class ModelLibraryBuildManifest {
+public:
+
+    /**
+     * A group of sources (e.g. all the sources of a model)
+     */
+    class Entry {
+    public:
+        /**
+         * the fingerprint of the data used to create the sources
+         */
+        std::string fingerprint;
+        /**
+         * the object files compiled from the sources
+         */
+        std::set<std::string> objectFiles;
+        /**
+         * the names of the atomic functions used by the sources (in the
+         * order used by the generated code)
+         */
+        std::vector<std::string> atomicFunctions;
+    };
+
+private:
+    /**
+     * the fingerprint of the compiler configuration
+     */
+    std::string configuration_;
+    std::map<std::string, Entry> entries_;
+public:
+
+    /**
+     * The first line of a manifest file
+     */
+    inline static const std::string& header() {
+        static const std::string h = "cppadcg_build_manifest 2";
+        return h;
+    }
+
+    inline const std::string& getConfiguration() const {
+        return configuration_;
+    }
+
+    inline void setConfiguration(const std::string& configuration) {
+        configuration_ = configuration;
+    }
+
+    inline const std::map<std::string, Entry>& getEntries() const {
+        return entries_;
+    }
+
+    /**
+     * @return the entry with the provided name or nullptr if there is none
+     */
+    inline const Entry* find(const std::string& name) const {
+        auto it = entries_.find(name);
+        if (it == entries_.end())
+            return nullptr;
+        return &it->second;
+    }
+
+    inline void add(const std::string& name,
+                    const std::string& fingerprint,
+                    const std::set<std::string>& objectFiles,
+                    const std::vector<std::string>& atomicFunctions = std::vector<std::string>()) {
+        Entry& e = entries_[name];
+        e.fingerprint = fingerprint;
+        e.objectFiles = objectFiles;
+        e.atomicFunctions = atomicFunctions;
+    }
+
+    inline void remove(const std::string& name) {
+        entries_.erase(name);
+    }
+
+    /**
+     * Determines whether or not the object files of an entry from a
+     * previous build can be reused.
+     *
+     * @param name the entry name
+     * @param fingerprint the fingerprint of the data for the new sources
+     * @param configuration the fingerprint of the new compiler configuration
+     */
+    inline bool isUpToDate(const std::string& name,
+                           const std::string& fingerprint,
+                           const std::string& configuration) const {
+        if (configuration != configuration_)
+            return false;
+
+        const Entry* e = find(name);
+        if (e == nullptr || e->fingerprint != fingerprint)
+            return false;
+
+        for (const std::string& o : e->objectFiles) {
+            if (!system::isFile(o))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Loads a manifest from a file.
+     *
+     * @param path the file path
+     * @return false if the file does not exist or it is not a valid
+     *         manifest (this object is then empty)
+     */
+    inline bool read(const std::string& path) {
+        configuration_.clear();
+        entries_.clear();
+
+        std::ifstream in(path.c_str());
+        if (!in)
+            return false;
+
+        std::string line;
+        if (!std::getline(in, line) || line != header())
+            return false;
+
+        std::string key;
+        if (!(in >> key >> configuration_) || key != "configuration") {
+            configuration_.clear();
+            return false;
+        }
+
+        while (in >> key) {
+            std::string name, fingerprint;
+            size_t nFiles, nAtomics;
+            if (key != "entry" || !(in >> name >> fingerprint >> nFiles >> nAtomics)) {
+                configuration_.clear();
+                entries_.clear();
+                return false;
+            }
+            in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+            Entry& e = entries_[name];
+            e.fingerprint = fingerprint;
+            for (size_t i = 0; i < nFiles; i++) {
+                if (!std::getline(in, line)) {
+                    configuration_.clear();
+                    entries_.clear();
+                    return false;
+                }
+                e.objectFiles.insert(line);
+            }
+            for (size_t i = 0; i < nAtomics; i++) {
+                if (!std::getline(in, line)) {
+                    configuration_.clear();
+                    entries_.clear();
+                    return false;
+                }
+                e.atomicFunctions.push_back(line);
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Saves this manifest into a file.
+     *
+     * @param path the file path
+     */
+    inline void write(const std::string& path) const {
+        std::ofstream out(path.c_str());
+        if (!out)
+            throw CGException("Failed to create build manifest '", path, "'");
+
+        out << header() << "\n";
+        out << "configuration " << configuration_ << "\n";
+        for (const auto& it : entries_) {
+            const Entry& e = it.second;
+            out << "entry " << it.first << " " << e.fingerprint << " " << e.objectFiles.size()
+                    << " " << e.atomicFunctions.size() << "\n";
+            for (const std::string& o : e.objectFiles)
+                out << o << "\n";
+            for (const std::string& a : e.atomicFunctions)
+                out << a << "\n";
+        }
+
+        if (!out)
+            throw CGException("Failed to save build manifest '", path, "'");
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -15,6 +15,8 @@
  * Author: Joao Leal
  */
 
+#include <atomic>
+
 namespace CppAD {
 namespace cg {
 
@@ -31,12 +33,18 @@ protected:
     std::string _tmpFolder;
     std::string _sourcesFolder; // path where source files are saved
     std::set<std::string> _ofiles; // compiled object files
+    std::set<std::string> _keptOfiles; // object files which are not deleted by cleanup()
     std::set<std::string> _sfiles; // compiled source files
+    std::set<std::string> _hfiles; // shared header files (including precompiled headers)
+    std::vector<std::string> _headerFlags; // compilation flags required to use the shared headers
     std::vector<std::string> _compileFlags;
     std::vector<std::string> _compileLibFlags;
     std::vector<std::string> _linkFlags;
     bool _verbose;
     bool _saveToDiskFirst;
+    size_t _compileThreads; // maximum number of files compiled at the same time
+    mutable std::string _versionOutput; // output of '<compiler> --version' (used in fingerprints)
+    mutable std::string _versionOutputPath; // the compiler path used to determine _versionOutput
 public:
 
     AbstractCCompiler(const std::string& compilerPath) :
@@ -44,7 +52,8 @@ public:
         _tmpFolder("cppadcg_tmp"),
         _sourcesFolder("cppadcg_sources"),
         _verbose(false),
-        _saveToDiskFirst(false) {
+        _saveToDiskFirst(false),
+        _compileThreads(1) {
     }
 
     AbstractCCompiler(const AbstractCCompiler& orig) = delete;
@@ -126,6 +135,29 @@ public:
         _compileLibFlags.push_back(compileLibFlag);
     }
 
+    /**
+     * Provides the maximum number of source files which are compiled at
+     * the same time.
+     */
+    size_t getCompileThreads() const {
+        return _compileThreads;
+    }
+
+    /**
+     * Defines the maximum number of source files which are compiled at
+     * the same time (each one by a different compiler process).
+     * This is particularly useful when the sources are grouped into a few
+     * large files (see ModelLibraryCSourceGen::setUnityUnits()).
+     *
+     * @param threads the number of threads (0 uses the number of
+     *                concurrent threads supported by the hardware)
+     */
+    void setCompileThreads(size_t threads) {
+        if (threads == 0)
+            threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        _compileThreads = threads;
+    }
+
     virtual bool isVerbose() const override {
         return _verbose;
     }
@@ -153,22 +185,91 @@ public:
                                 JobTimer* timer,
                                 const std::string& outputExtension,
                                 std::set<std::string>& outputFiles) {
+        compileSources(sources, posIndepCode, timer, this->_tmpFolder, outputExtension, outputFiles);
+    }
+
+    virtual void createSharedHeader(const std::string& name,
+                                    const std::string& content,
+                                    bool posIndepCode,
+                                    JobTimer* timer = nullptr) override {
+        system::createFolder(_tmpFolder);
+
+        std::string path = system::createPath(_tmpFolder, name);
+        std::ofstream headerFile(path.c_str());
+        headerFile << content;
+        headerFile.close();
+        if (!headerFile)
+            throw CGException("Failed to create header file '", path, "'");
+        _hfiles.insert(path);
+
+        std::string includeFlag = "-I" + _tmpFolder;
+        if (std::find(_headerFlags.begin(), _headerFlags.end(), includeFlag) == _headerFlags.end())
+            _headerFlags.push_back(includeFlag);
+
+        if (timer != nullptr) {
+            timer->startingJob("'" + path + "'", JobTypeHolder<>::COMPILING);
+        } else if (_verbose) {
+            std::cout << "compiling header '" << path << "'" << std::endl;
+        }
+
+        precompileHeader(path, posIndepCode);
+
+        if (timer != nullptr) {
+            timer->finishedJob();
+        }
+    }
+
+    virtual void compileSourcesToFolder(const std::map<std::string, std::string>& sources,
+                                        bool posIndepCode,
+                                        const std::string& outputFolder,
+                                        std::set<std::string>& objectFiles,
+                                        JobTimer* timer = nullptr) override {
+        std::set<std::string> newFiles;
+        compileSources(sources, posIndepCode, timer, outputFolder, ".o", newFiles);
+
+        objectFiles.insert(newFiles.begin(), newFiles.end());
+        addObjectFiles(newFiles);
+    }
+
+    virtual void addObjectFiles(const std::set<std::string>& objectFiles) override {
+        _ofiles.insert(objectFiles.begin(), objectFiles.end());
+        _keptOfiles.insert(objectFiles.begin(), objectFiles.end());
+    }
+
+    virtual std::string getConfigurationFingerprint() const override {
+        BuildFingerprint fp;
+        fp << _path << getVersionOutput() << _compileFlags << _compileLibFlags;
+        return fp.str();
+    }
+
+    virtual void compileSources(const std::map<std::string, std::string>& sources,
+                                bool posIndepCode,
+                                JobTimer* timer,
+                                const std::string& outputFolder,
+                                const std::string& outputExtension,
+                                std::set<std::string>& outputFiles) {
         using namespace std::chrono;
 
         if (sources.empty())
             return; // nothing to do
 
-        system::createFolder(this->_tmpFolder);
+        system::createFolder(outputFolder);
 
         // determine the maximum file name length
         size_t maxsize = 0;
         std::map<std::string, std::string>::const_iterator it;
         for (it = sources.begin(); it != sources.end(); ++it) {
             _sfiles.insert(it->first);
-            std::string file = system::createPath(this->_tmpFolder, it->first + outputExtension);
+            std::string file = system::createPath(outputFolder, it->first + outputExtension);
             maxsize = std::max(maxsize, file.size());
         }
 
+        size_t nThreads = std::min(_compileThreads, sources.size());
+        if (nThreads > 1) {
+            compileSourcesParallel(sources, posIndepCode, timer, outputFolder, outputExtension, outputFiles, nThreads);
+            return;
+        }
+
         size_t countWidth = std::ceil(std::log10(sources.size()));
 
         size_t count = 0;
@@ -190,7 +291,7 @@ public:
         // compile each source code file into a different object file
         for (it = sources.begin(); it != sources.end(); ++it) {
             count++;
-            std::string file = system::createPath(this->_tmpFolder, it->first + outputExtension);
+            std::string file = system::createPath(outputFolder, it->first + outputExtension);
             outputFiles.insert(file);
 
             steady_clock::time_point beginTime;
@@ -214,20 +315,7 @@ public:
                 std::cout.fill(f); // restore fill character
             }
 
-            if (_saveToDiskFirst) {
-                // save a new source file to disk
-                std::ofstream sourceFile;
-                std::string srcfile = system::createPath(_sourcesFolder, it->first);
-                sourceFile.open(srcfile.c_str());
-                sourceFile << it->second;
-                sourceFile.close();
-
-                // compile the file
-                compileFile(srcfile, file, posIndepCode);
-            } else {
-                 // compile without saving the source code to disk
-                compileSource(it->second, file, posIndepCode);
-            }
+            compileSourceOrFile(it->first, it->second, file, posIndepCode);
 
             if (timer != nullptr) {
                 timer->finishedJob();
@@ -242,6 +330,81 @@ public:
 
     }
 
+    /**
+     * Compiles several source files at the same time using multiple
+     * threads.
+     * The object files are the same as those created by compileSources().
+     *
+     * @param nThreads the number of threads
+     */
+    virtual void compileSourcesParallel(const std::map<std::string, std::string>& sources,
+                                        bool posIndepCode,
+                                        JobTimer* timer,
+                                        const std::string& outputFolder,
+                                        const std::string& outputExtension,
+                                        std::set<std::string>& outputFiles,
+                                        size_t nThreads) {
+        struct CompileJob {
+            const std::string* name;
+            const std::string* source;
+            std::string output;
+            std::exception_ptr error;
+        };
+
+        std::vector<CompileJob> jobs(sources.size());
+        size_t pos = 0;
+        for (const auto& it : sources) {
+            CompileJob& job = jobs[pos++];
+            job.name = &it.first;
+            job.source = &it.second;
+            job.output = system::createPath(outputFolder, it.first + outputExtension);
+            outputFiles.insert(job.output);
+        }
+
+        if (_saveToDiskFirst) {
+            system::createFolder(_sourcesFolder);
+        }
+
+        if (timer != nullptr) {
+            timer->startingJob("'" + outputFolder + "'", JobTypeHolder<>::COMPILING,
+                               "[" + std::to_string(jobs.size()) + " files, " + std::to_string(nThreads) + " threads]");
+        } else if (_verbose) {
+            std::cout << "compiling " << jobs.size() << " files into '" << outputFolder << "' using "
+                    << nThreads << " threads" << std::endl;
+        }
+
+        std::atomic<size_t> nextJob(0);
+
+        auto worker = [&]() {
+            for (size_t j = nextJob++; j < jobs.size(); j = nextJob++) {
+                CompileJob& job = jobs[j];
+                try {
+                    compileSourceOrFile(*job.name, *job.source, job.output, posIndepCode);
+                } catch (...) {
+                    job.error = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(nThreads - 1);
+        for (size_t t = 1; t < nThreads; t++)
+            threads.push_back(std::thread(worker));
+        worker();
+        for (std::thread& t : threads)
+            t.join();
+
+        // report the error of the first file (deterministic)
+        for (const CompileJob& job : jobs) {
+            if (job.error != nullptr)
+                std::rethrow_exception(job.error);
+        }
+
+        if (timer != nullptr) {
+            timer->finishedJob();
+        }
+    }
+
     /**
      * Creates a dynamic library from a set of object files
      * 
@@ -253,12 +416,22 @@ public:
     virtual void cleanup() override {
         // clean up;
         for (const std::string& it : _ofiles) {
+            if (_keptOfiles.find(it) != _keptOfiles.end())
+                continue;
             if (remove(it.c_str()) != 0)
                 std::cerr << "Failed to delete temporary file '" << it << "'" << std::endl;
         }
         _ofiles.clear();
+        _keptOfiles.clear();
         _sfiles.clear();
 
+        for (const std::string& it : _hfiles) {
+            if (remove(it.c_str()) != 0)
+                std::cerr << "Failed to delete temporary file '" << it << "'" << std::endl;
+        }
+        _hfiles.clear();
+        _headerFlags.clear();
+
         remove(this->_tmpFolder.c_str());
     }
 
@@ -268,6 +441,66 @@ public:
 
 protected:
 
+    /**
+     * Provides the output of '<compiler> --version' which identifies the
+     * compiler release (e.g. after a system update the same path can
+     * point to a different compiler).
+     * The compiler is only called once for each compiler path.
+     */
+    const std::string& getVersionOutput() const {
+        if (_versionOutputPath != _path || _versionOutput.empty()) {
+            std::vector<std::string> args {"--version"};
+            std::string output;
+            system::callExecutable(_path, args, &output);
+            _versionOutput = output;
+            _versionOutputPath = _path;
+        }
+        return _versionOutput;
+    }
+
+    /**
+     * Compiles a single source file either directly from memory or after
+     * saving it to the sources folder.
+     *
+     * @param name the source file name
+     * @param source the content of the source file
+     * @param output the compiled output file name (the object file path)
+     */
+    inline void compileSourceOrFile(const std::string& name,
+                                    const std::string& source,
+                                    const std::string& output,
+                                    bool posIndepCode) {
+        if (_saveToDiskFirst) {
+            // save a new source file to disk
+            std::ofstream sourceFile;
+            std::string srcfile = system::createPath(_sourcesFolder, name);
+            sourceFile.open(srcfile.c_str());
+            sourceFile << source;
+            sourceFile.close();
+
+            // compile the file
+            compileFile(srcfile, output, posIndepCode);
+        } else {
+            // compile without saving the source code to disk
+            compileSource(source, output, posIndepCode);
+        }
+    }
+
+    /**
+     * Precompiles a header file so that it is used by the sources compiled
+     * afterwards (the default implementation does nothing).
+     * The created files should be added to _hfiles and the required
+     * compilation flags to _headerFlags.
+     *
+     * @param path the path to the header file
+     * @param posIndepCode whether or not the sources which include the
+     *                     header are compiled with position-independent
+     *                     code
+     */
+    virtual void precompileHeader(const std::string& path,
+                                  bool posIndepCode) {
+    }
+
     /**
      * Compiles a single source file into an object file.
      * 
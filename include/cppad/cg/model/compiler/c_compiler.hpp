@@ -82,6 +82,58 @@ public:
                                 bool posIndepCode,
                                 JobTimer* timer = nullptr) = 0;
 
+    /**
+     * Creates a header file which can be included by the sources compiled
+     * afterwards (e.g. using #include "name").
+     * Compilers which support precompiled headers also precompile it.
+     * The header is deleted by cleanup().
+     *
+     * @param name the header file name
+     * @param content the content of the header file
+     * @param posIndepCode whether or not the sources which include the
+     *                     header are compiled with position-independent
+     *                     code
+     */
+    virtual void createSharedHeader(const std::string& name,
+                                    const std::string& content,
+                                    bool posIndepCode,
+                                    JobTimer* timer = nullptr) = 0;
+
+    /**
+     * Compiles the provided C source code into object files saved in a
+     * folder which are not deleted by cleanup() (e.g. for incremental
+     * builds).
+     * The object files are also used to create libraries.
+     *
+     * @param sources maps the names to the content of the source files
+     * @param posIndepCode whether or not to create position-independent
+     *                     code for dynamic linking
+     * @param outputFolder the folder where the object files are created
+     * @param objectFiles the paths of the created object files are
+     *                    added to this set
+     */
+    virtual void compileSourcesToFolder(const std::map<std::string, std::string>& sources,
+                                        bool posIndepCode,
+                                        const std::string& outputFolder,
+                                        std::set<std::string>& objectFiles,
+                                        JobTimer* timer = nullptr) = 0;
+
+    /**
+     * Adds object files, which were compiled previously (e.g. by
+     * compileSourcesToFolder() in a previous build), to the files used to
+     * create libraries.
+     * These files are not deleted by cleanup().
+     *
+     * @param objectFiles the object file paths
+     */
+    virtual void addObjectFiles(const std::set<std::string>& objectFiles) = 0;
+
+    /**
+     * Provides a fingerprint of the compiler (including its version) and
+     * of the options which affect the compiled object files and libraries.
+     */
+    virtual std::string getConfigurationFingerprint() const = 0;
+
     /**
      * Creates a dynamic library from the previously compiled object files
      * 
@@ -27,6 +27,7 @@ template<class Base>
 class ClangCompiler : public AbstractCCompiler<Base> {
 protected:
     std::set<std::string> _bcfiles; // bitcode files
+    std::map<std::string, std::string> _pchFiles; // shared header name -> precompiled header
     std::string _version;
 public:
 
@@ -122,6 +123,7 @@ public:
                 std::cerr << "Failed to delete temporary file '" << it << "'" << std::endl;
         }
         _bcfiles.clear();
+        _pchFiles.clear();
 
         // other files and temporary folder
         AbstractCCompiler<Base>::cleanup();
@@ -159,6 +161,8 @@ protected:
         args.push_back("-x");
         args.push_back("c"); // C source files
         args.insert(args.end(), this->_compileFlags.begin(), this->_compileFlags.end());
+        args.insert(args.end(), this->_headerFlags.begin(), this->_headerFlags.end());
+        addPrecompiledHeader(args, source.substr(0, source.find('\n')));
         args.push_back("-c");
         args.push_back("-");
         if (posIndepCode) {
@@ -170,6 +174,51 @@ protected:
         system::callExecutable(this->_path, args, nullptr, &source);
     }
 
+    /**
+     * Precompiles a header file which is then used by the sources which
+     * include it in the first line.
+     *
+     * @param path the path to the header file
+     */
+    virtual void precompileHeader(const std::string& path,
+                                  bool posIndepCode) override {
+        std::string output = path + ".pch";
+
+        std::vector<std::string> args;
+        args.push_back("-x");
+        args.push_back("c-header"); // C header files
+        args.insert(args.end(), this->_compileFlags.begin(), this->_compileFlags.end());
+        if (posIndepCode) {
+            args.push_back("-fPIC"); // must match the sources
+        }
+        args.push_back(path);
+        args.push_back("-o");
+        args.push_back(output);
+
+        system::callExecutable(this->_path, args);
+
+        this->_hfiles.insert(output);
+        _pchFiles[system::filenameFromPath(path)] = output;
+    }
+
+    /**
+     * Clang only uses precompiled headers which are explicitly requested
+     * (the original header must have an include guard since it is
+     * included again by the source).
+     *
+     * @param firstLine the first line of the source file
+     */
+    inline void addPrecompiledHeader(std::vector<std::string>& args,
+                                     const std::string& firstLine) const {
+        for (const auto& it : _pchFiles) {
+            if (firstLine == "#include \"" + it.first + "\"") {
+                args.push_back("-include-pch");
+                args.push_back(it.second);
+                return;
+            }
+        }
+    }
+
     virtual void compileFile(const std::string& path,
                              const std::string& output,
                              bool posIndepCode) override {
@@ -177,6 +226,13 @@ protected:
         args.push_back("-x");
         args.push_back("c"); // C source files
         args.insert(args.end(), this->_compileFlags.begin(), this->_compileFlags.end());
+        args.insert(args.end(), this->_headerFlags.begin(), this->_headerFlags.end());
+        if (!_pchFiles.empty()) {
+            std::ifstream sourceFile(path.c_str());
+            std::string firstLine;
+            std::getline(sourceFile, firstLine);
+            addPrecompiledHeader(args, firstLine);
+        }
         if (posIndepCode) {
             args.push_back("-fPIC"); // position-independent code for dynamic linking
         }
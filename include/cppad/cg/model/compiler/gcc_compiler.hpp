@@ -91,6 +91,7 @@ protected:
         args.push_back("-x");
         args.push_back("c"); // C source files
         args.insert(args.end(), this->_compileFlags.begin(), this->_compileFlags.end());
+        args.insert(args.end(), this->_headerFlags.begin(), this->_headerFlags.end());
         args.push_back("-c");
         args.push_back("-");
         if (posIndepCode) {
@@ -102,6 +103,32 @@ protected:
         system::callExecutable(this->_path, args, nullptr, &source);
     }
 
+    /**
+     * Precompiles a header file which is then found by the compiler
+     * (instead of the original header) in the include directories.
+     *
+     * @param path the path to the header file
+     */
+    virtual void precompileHeader(const std::string& path,
+                                  bool posIndepCode) override {
+        std::string output = path + ".gch";
+
+        std::vector<std::string> args;
+        args.push_back("-x");
+        args.push_back("c-header"); // C header files
+        args.insert(args.end(), this->_compileFlags.begin(), this->_compileFlags.end());
+        if (posIndepCode) {
+            args.push_back("-fPIC"); // must match the sources
+        }
+        args.push_back(path);
+        args.push_back("-o");
+        args.push_back(output);
+
+        system::callExecutable(this->_path, args);
+
+        this->_hfiles.insert(output);
+    }
+
     virtual void compileFile(const std::string& path,
                              const std::string& output,
                              bool posIndepCode) override {
@@ -109,6 +136,7 @@ protected:
         args.push_back("-x");
         args.push_back("c"); // C source files
         args.insert(args.end(), this->_compileFlags.begin(), this->_compileFlags.end());
+        args.insert(args.end(), this->_headerFlags.begin(), this->_headerFlags.end());
         if (posIndepCode) {
             args.push_back("-fPIC"); // position-independent code for dynamic linking
         }
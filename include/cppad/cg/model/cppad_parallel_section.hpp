@@ -0,0 +1,118 @@
+#ifndef CPPAD_CG_CPPAD_PARALLEL_SECTION_INCLUDED
+#define CPPAD_CG_CPPAD_PARALLEL_SECTION_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include <atomic>
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Configures CppAD for multiple threads while an object of this class
+ * exists, so that different ADFun<Base> objects (e.g. copies of the same
+ * tape) can be used concurrently by threads created by CppADCodeGen.
+ * CppAD returns to sequential mode when the object is destroyed.
+ *
+ * Worker threads must call setThreadNumber() before using CppAD and
+ * release all CppAD objects they created before they terminate.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class CppADParallelSection {
+private:
+    const size_t nThreads_;
+public:
+
+    /**
+     * Whether or not CppAD can be configured by this class (CppAD is not
+     * already being used with multiple threads).
+     */
+    inline static bool isAvailable() {
+        return !thread_alloc::in_parallel() && thread_alloc::num_threads() == 1;
+    }
+
+    /**
+     * The maximum number of threads supported by CppAD.
+     */
+    inline static size_t maxThreads() {
+        return CPPAD_MAX_NUM_THREADS;
+    }
+
+    /**
+     * @param nThreads the total number of threads including the current
+     *                 one (which is always thread 0)
+     */
+    explicit inline CppADParallelSection(size_t nThreads) :
+        nThreads_(nThreads) {
+        CPPADCG_ASSERT_KNOWN(isAvailable(), "CppAD is already being used with multiple threads");
+        CPPADCG_ASSERT_KNOWN(nThreads_ > 0 && nThreads_ <= maxThreads(), "Invalid number of threads");
+
+        setThreadNumber(0);
+        thread_alloc::parallel_setup(nThreads_, &inParallel, &threadNumber);
+        CppAD::parallel_ad<Base>();
+        running() = true;
+    }
+
+    CppADParallelSection(const CppADParallelSection&) = delete;
+    CppADParallelSection& operator=(const CppADParallelSection&) = delete;
+
+    /**
+     * Must only be called after all the worker threads have finished.
+     */
+    inline ~CppADParallelSection() {
+        running() = false;
+        for (size_t t = 1; t < nThreads_; t++) {
+            thread_alloc::free_available(t);
+        }
+        thread_alloc::parallel_setup(1, nullptr, nullptr);
+    }
+
+    /**
+     * Defines the CppAD thread number of the current thread.
+     *
+     * @param thread a unique number for each worker thread (lower than
+     *               the number of threads provided in the constructor)
+     */
+    inline static void setThreadNumber(size_t thread) {
+        threadId() = thread;
+    }
+
+private:
+
+    inline static std::atomic<bool>& running() {
+        static std::atomic<bool> r(false);
+        return r;
+    }
+
+    inline static size_t& threadId() {
+        static thread_local size_t id = 0;
+        return id;
+    }
+
+    static bool inParallel() {
+        return running();
+    }
+
+    static size_t threadNumber() {
+        return threadId();
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
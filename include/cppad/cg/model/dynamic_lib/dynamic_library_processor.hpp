@@ -39,6 +39,11 @@ protected:
      * System dependent custom options
      */
     std::map<std::string, std::string> _options;
+    /**
+     * Whether or not to only regenerate and recompile the models which
+     * changed since the previous build
+     */
+    bool _incremental;
 public:
 
     /**
@@ -53,7 +58,8 @@ public:
                                         const std::string& libraryName = "cppad_cg_model") :
         ModelLibraryProcessor<Base>(modelLibGen),
         _libraryName(libraryName),
-        _customLibExtension(nullptr) {
+        _customLibExtension(nullptr),
+        _incremental(false) {
     }
 
     inline const std::string& getLibraryName() const {
@@ -107,6 +113,28 @@ public:
         return _options;
     }
 
+    inline bool isIncrementalBuild() const {
+        return _incremental;
+    }
+
+    /**
+     * Defines whether or not libraries are built incrementally.
+     * A manifest file is saved next to the library (the library path
+     * with the ".manifest" extension) with a fingerprint of the tape and
+     * of the source generation options of each model, and the object
+     * files are kept in a folder next to the library (the library path
+     * with the ".objects" extension).
+     * A new build only regenerates and recompiles the sources of the
+     * models whose fingerprint changed (or of all models if the compiler
+     * configuration changed), while the object files of the other models
+     * are linked again.
+     *
+     * @param incremental whether or not to use incremental builds
+     */
+    inline void setIncrementalBuild(bool incremental) {
+        _incremental = incremental;
+    }
+
     /**
      * Compiles all models and generates a dynamic library.
      * 
@@ -122,30 +150,21 @@ public:
 
         this->modelLibraryHelper_->startingJob("", JobTimer::DYNAMIC_MODEL_LIBRARY);
 
-        const std::map<std::string, ModelCSourceGen<Base>*>& models = this->modelLibraryHelper_->getModels();
         try {
-            for (const auto& p : models) {
-                const std::map<std::string, std::string>& modelSources = this->getSources(*p.second);
-
-                this->modelLibraryHelper_->startingJob("", JobTimer::COMPILING_FOR_MODEL);
-                compiler.compileSources(modelSources, true, this->modelLibraryHelper_);
-                this->modelLibraryHelper_->finishedJob();
-            }
-
-            const std::map<std::string, std::string>& sources = this->getLibrarySources();
-            compiler.compileSources(sources, true, this->modelLibraryHelper_);
-
-            const std::map<std::string, std::string>& customSource = this->modelLibraryHelper_->getCustomSources();
-            compiler.compileSources(customSource, true, this->modelLibraryHelper_);
-
             std::string libname = _libraryName;
             if (_customLibExtension != nullptr)
                 libname += *_customLibExtension;
             else
                 libname += system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
 
+            ModelLibraryBuildManifest manifest;
+            compileLibrarySources(compiler, true, libname, manifest);
+
             compiler.buildDynamic(libname, this->modelLibraryHelper_);
 
+            if (_incremental)
+                saveBuildManifest(libname, manifest);
+
         } catch (...) {
             compiler.cleanup();
             throw;
@@ -179,29 +198,20 @@ public:
 
         this->modelLibraryHelper_->startingJob("", JobTimer::STATIC_MODEL_LIBRARY);
 
-        const std::map<std::string, ModelCSourceGen<Base>*>& models = this->modelLibraryHelper_->getModels();
         try {
-            for (const auto& p : models) {
-                const std::map<std::string, std::string>& modelSources = this->getSources(*p.second);
-
-                this->modelLibraryHelper_->startingJob("", JobTimer::COMPILING_FOR_MODEL);
-                compiler.compileSources(modelSources, posIndepCode, this->modelLibraryHelper_);
-                this->modelLibraryHelper_->finishedJob();
-            }
-
-            const std::map<std::string, std::string>& sources = this->getLibrarySources();
-            compiler.compileSources(sources, posIndepCode, this->modelLibraryHelper_);
-
-            const std::map<std::string, std::string>& customSource = this->modelLibraryHelper_->getCustomSources();
-            compiler.compileSources(customSource, posIndepCode, this->modelLibraryHelper_);
-
             std::string libname = _libraryName;
             if (_customLibExtension != nullptr)
                 libname += *_customLibExtension;
             else
                 libname += system::SystemInfo<>::STATIC_LIB_EXTENSION;
 
+            ModelLibraryBuildManifest manifest;
+            compileLibrarySources(compiler, posIndepCode, libname, manifest);
+
             ar.create(libname, compiler.getObjectFiles(), this->modelLibraryHelper_);
+
+            if (_incremental)
+                saveBuildManifest(libname, manifest);
         } catch (...) {
             compiler.cleanup();
             throw;
@@ -219,6 +229,161 @@ protected:
 
     virtual std::unique_ptr<DynamicLib<Base>> loadDynamicLibrary();
 
+    /**
+     * Compiles the sources of all models, the library sources and the
+     * custom sources.
+     * In incremental builds, the object files from the previous build
+     * are reused for the sources which did not change.
+     *
+     * @param compiler the compiler
+     * @param posIndepCode whether or not to create position-independent
+     *                     code
+     * @param library the path of the library to be created
+     * @param manifest saves the information on the compiled sources
+     *                 (only used in incremental builds)
+     */
+    virtual void compileLibrarySources(CCompiler<Base>& compiler,
+                                       bool posIndepCode,
+                                       const std::string& library,
+                                       ModelLibraryBuildManifest& manifest) {
+        const std::map<std::string, ModelCSourceGen<Base>*>& models = this->modelLibraryHelper_->getModels();
+
+        const bool sharedHeader = this->modelLibraryHelper_->isSharedHeader();
+        bool sharedHeaderCreated = false;
+        auto createSharedHeader = [&]() {
+            if (sharedHeader && !sharedHeaderCreated) {
+                compiler.createSharedHeader(ModelLibraryCSourceGen<Base>::FILE_SHARED_HEADER,
+                                            this->modelLibraryHelper_->getSharedHeader(),
+                                            posIndepCode, this->modelLibraryHelper_);
+                sharedHeaderCreated = true;
+            }
+        };
+
+        if (!_incremental) {
+            createSharedHeader();
+
+            for (const auto& p : models) {
+                const std::map<std::string, std::string>& modelSources = this->getSources(*p.second);
+
+                this->modelLibraryHelper_->startingJob("", JobTimer::COMPILING_FOR_MODEL);
+                compiler.compileSources(modelSources, posIndepCode, this->modelLibraryHelper_);
+                this->modelLibraryHelper_->finishedJob();
+            }
+
+            const std::map<std::string, std::string>& sources = this->getLibrarySources();
+            compiler.compileSources(sources, posIndepCode, this->modelLibraryHelper_);
+
+            const std::map<std::string, std::string>& customSource = this->modelLibraryHelper_->getCustomSources();
+            compiler.compileSources(customSource, posIndepCode, this->modelLibraryHelper_);
+            return;
+        }
+
+        const std::string manifestPath = library + ".manifest";
+        ModelLibraryBuildManifest previous;
+        previous.read(manifestPath);
+        const ModelLibraryBuildManifest original = previous;
+
+        /**
+         * the object files of an entry are about to be replaced:
+         * its old information must not be used again if this build fails
+         */
+        auto invalidate = [&](const std::string& name) {
+            if (previous.find(name) != nullptr) {
+                previous.remove(name);
+                previous.write(manifestPath);
+            }
+        };
+
+        BuildFingerprint configFp;
+        configFp << compiler.getConfigurationFingerprint() << posIndepCode;
+        const std::string config = configFp.str();
+        manifest.setConfiguration(config);
+
+        const std::string objFolder = library + ".objects";
+        system::createFolder(objFolder);
+
+        /**
+         * models
+         */
+        for (const auto& p : models) {
+            const std::string& name = p.first;
+            const std::string fingerprint = this->getSourcesFingerprint(*p.second);
+
+            if (previous.isUpToDate(name, fingerprint, config)) {
+                const ModelLibraryBuildManifest::Entry& e = *previous.find(name);
+                compiler.addObjectFiles(e.objectFiles);
+                // required by the library sources (e.g. direct model calls)
+                this->restoreAtomicFunctions(*p.second, e.atomicFunctions);
+                manifest.add(name, fingerprint, e.objectFiles, e.atomicFunctions);
+                continue;
+            }
+
+            const std::map<std::string, std::string>& modelSources = this->getSources(*p.second);
+
+            invalidate(name);
+            createSharedHeader();
+
+            std::set<std::string> objs;
+            this->modelLibraryHelper_->startingJob("", JobTimer::COMPILING_FOR_MODEL);
+            compiler.compileSourcesToFolder(modelSources, posIndepCode, system::createPath(objFolder, name),
+                                            objs, this->modelLibraryHelper_);
+            this->modelLibraryHelper_->finishedJob();
+
+            manifest.add(name, fingerprint, objs, this->getAtomicFunctions(*p.second));
+        }
+
+        /**
+         * library and custom sources (which are cheap to generate)
+         * using names which cannot be model names
+         */
+        auto compileOther = [&](const std::string& name,
+                                const std::map<std::string, std::string>& sources) {
+            BuildFingerprint fp;
+            for (const auto& it : sources)
+                fp << it.first << it.second;
+            if (sharedHeader)
+                fp << this->modelLibraryHelper_->getSharedHeader();
+            const std::string fingerprint = fp.str();
+
+            if (previous.isUpToDate(name, fingerprint, config)) {
+                const std::set<std::string>& objs = previous.find(name)->objectFiles;
+                compiler.addObjectFiles(objs);
+                manifest.add(name, fingerprint, objs);
+            } else {
+                invalidate(name);
+                createSharedHeader();
+
+                std::set<std::string> objs;
+                compiler.compileSourcesToFolder(sources, posIndepCode, system::createPath(objFolder, name),
+                                                objs, this->modelLibraryHelper_);
+                manifest.add(name, fingerprint, objs);
+            }
+        };
+
+        compileOther("_library", this->getLibrarySources());
+        compileOther("_custom", this->modelLibraryHelper_->getCustomSources());
+
+        /**
+         * remove object files which are no longer used
+         */
+        for (const auto& itPrev : original.getEntries()) {
+            const ModelLibraryBuildManifest::Entry* e = manifest.find(itPrev.first);
+            for (const std::string& o : itPrev.second.objectFiles) {
+                if (e == nullptr || e->objectFiles.find(o) == e->objectFiles.end())
+                    remove(o.c_str());
+            }
+        }
+    }
+
+    /**
+     * Saves the manifest of an incremental build after the library was
+     * successfully created.
+     */
+    virtual void saveBuildManifest(const std::string& library,
+                                   const ModelLibraryBuildManifest& manifest) {
+        manifest.write(library + ".manifest");
+    }
+
 };
 
 } // END cg namespace
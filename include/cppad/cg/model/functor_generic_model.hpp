@@ -45,6 +45,8 @@ protected:
     std::vector<ExternalFunctionWrapper<Base>* > _atomic;
     size_t _missingAtomicFunctions;
     CppAD::vector<Base> _tx, _ty, _px, _py;
+    // location of each element in the compressed results of sparse methods
+    std::vector<size_t> _compressedPos;
     // original model function
     void (*_zero)(Base const*const*, Base * const*, LangCAtomicFun);
     // first order forward mode
@@ -67,6 +69,10 @@ protected:
     void (*_sparseJacobian)(Base const*const*, Base * const*, LangCAtomicFun);
     // sparse hessian function in the dynamic library
     void (*_sparseHessian)(Base const*const*, Base * const*, LangCAtomicFun);
+    // model and sparse jacobian function in the dynamic library
+    void (*_forwardZeroSparseJacobian)(Base const*const*, Base * const*, LangCAtomicFun);
+    // lagrangian, its gradient, and its sparse hessian function in the dynamic library
+    void (*_lagrangianSparseHessian)(Base const*const*, Base * const*, LangCAtomicFun);
     //
     void (*_forwardOneSparsity)(unsigned long, unsigned long const**, unsigned long*);
     //
@@ -87,6 +93,21 @@ protected:
             unsigned long * nnz);
     void (*_atomicFunctions)(const char*** names,
             unsigned long * n);
+    // jobs of the multithreaded sparse jacobian and sparse hessian in the dynamic library
+    void (*_sparseJacobianJobs)(const char** function,
+            unsigned long const** keyStart,
+            unsigned long const** keys,
+            float const** elapsed,
+            unsigned long* nJobs);
+    void (*_sparseHessianJobs)(const char** function,
+            unsigned long const** keyStart,
+            unsigned long const** keys,
+            float const** elapsed,
+            unsigned long* nJobs);
+    // compressed row storage of the sparsity patterns (created on demand)
+    CsrSparsity _jacCsr;
+    CsrSparsity _hessCsr;
+    std::map<size_t, CsrSparsity> _hessCsrEq;
 
 public:
 
@@ -170,6 +191,31 @@ public:
         std::copy(col, col + nnz, variables.begin());
     }
 
+    virtual void JacobianSparsity(ArrayView<const unsigned long>& equations,
+                                  ArrayView<const unsigned long>& variables) override {
+        CooSparsityView s = JacobianSparsityCoo();
+        ArrayView<const unsigned long>(s.rows()).swap(equations);
+        ArrayView<const unsigned long>(s.cols()).swap(variables);
+    }
+
+    virtual CooSparsityView JacobianSparsityCoo() override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_jacobianSparsity != nullptr, "No Jacobian sparsity function defined in the dynamic library");
+
+        unsigned long const* row, *col;
+        unsigned long nnz;
+        (*_jacobianSparsity)(&row, &col, &nnz);
+
+        return CooSparsityView(_m, _n, row, col, nnz);
+    }
+
+    virtual CsrSparsityView JacobianSparsityCsr() override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        if (!_jacCsr.isReady())
+            _jacCsr.build(JacobianSparsityCoo());
+        return _jacCsr.view();
+    }
+
     // Hessian sparsity 
     virtual bool isHessianSparsityAvailable() override {
         return _hessianSparsity != nullptr;
@@ -223,6 +269,31 @@ public:
         std::copy(col, col + nnz, cols.begin());
     }
 
+    virtual void HessianSparsity(ArrayView<const unsigned long>& rows,
+                                 ArrayView<const unsigned long>& cols) override {
+        CooSparsityView s = HessianSparsityCoo();
+        ArrayView<const unsigned long>(s.rows()).swap(rows);
+        ArrayView<const unsigned long>(s.cols()).swap(cols);
+    }
+
+    virtual CooSparsityView HessianSparsityCoo() override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_hessianSparsity != nullptr, "No Hessian sparsity function defined in the dynamic library");
+
+        unsigned long const* row, *col;
+        unsigned long nnz;
+        (*_hessianSparsity)(&row, &col, &nnz);
+
+        return CooSparsityView(_n, _n, row, col, nnz);
+    }
+
+    virtual CsrSparsityView HessianSparsityCsr() override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        if (!_hessCsr.isReady())
+            _hessCsr.build(HessianSparsityCoo());
+        return _hessCsr.view();
+    }
+
     virtual bool isEquationHessianSparsityAvailable() override {
         return _hessianSparsity2 != nullptr;
     }
@@ -275,6 +346,34 @@ public:
         std::copy(col, col + nnz, cols.begin());
     }
 
+    virtual void HessianSparsity(size_t i,
+                                 ArrayView<const unsigned long>& rows,
+                                 ArrayView<const unsigned long>& cols) override {
+        CooSparsityView s = HessianSparsityCoo(i);
+        ArrayView<const unsigned long>(s.rows()).swap(rows);
+        ArrayView<const unsigned long>(s.cols()).swap(cols);
+    }
+
+    virtual CooSparsityView HessianSparsityCoo(size_t i) override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_hessianSparsity2 != nullptr, "No Hessian sparsity function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(i < _m, "Invalid equation index");
+
+        unsigned long const* row, *col;
+        unsigned long nnz;
+        (*_hessianSparsity2)(i, &row, &col, &nnz);
+
+        return CooSparsityView(_n, _n, row, col, nnz);
+    }
+
+    virtual CsrSparsityView HessianSparsityCsr(size_t i) override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CsrSparsity& csr = _hessCsrEq[i];
+        if (!csr.isReady())
+            csr.build(HessianSparsityCoo(i));
+        return csr.view();
+    }
+
     /// number of independent variables
 
     virtual size_t Domain() const override {
@@ -341,9 +440,9 @@ public:
         if (vx.size() > 0) {
             CPPADCG_ASSERT_KNOWN(vx.size() >= _n, "Invalid vx size");
             CPPADCG_ASSERT_KNOWN(vy.size() >= _m, "Invalid vy size");
-            const std::vector<std::set<size_t> > jacSparsity = JacobianSparsitySet();
+            const CsrSparsityView jacSparsity = JacobianSparsityCsr();
             for (size_t i = 0; i < _m; i++) {
-                for (size_t j : jacSparsity[i]) {
+                for (unsigned long j : jacSparsity.rowCols(i)) {
                     if (vx[j]) {
                         vy[i] = true;
                         break;
@@ -460,6 +559,32 @@ public:
         }
     }
 
+    virtual void ForwardOne(ArrayView<const Base> x,
+                            size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                            size_t ty1Nnz, const size_t ty1Idx[], Base ty1[]) override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_sparseForwardOne != nullptr, "No sparse forward one function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(_forwardOneSparsity != nullptr, "No forward one sparsity function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(x.size() >= _n, "Invalid x size");
+        CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
+
+        _ty.resize(_m);
+        _inHess[0] = x.data();
+
+        evalSparseCompressed(_sparseForwardOne, _forwardOneSparsity, &_inHess[0], _m,
+                             tx1Nnz, idx, tx1,
+                             ty1Nnz, ty1Idx, ty1,
+                             &_ty[0]);
+    }
+
+    virtual void ForwardOneSparsity(std::vector<size_t>& start,
+                                    std::vector<size_t>& elements) override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_forwardOneSparsity != nullptr, "No forward one sparsity function defined in the dynamic library");
+
+        loadDirectionalSparsity(_forwardOneSparsity, _n, start, elements);
+    }
+
     virtual bool isReverseOneAvailable() override {
         return _reverseOne != nullptr;
     }
@@ -526,6 +651,32 @@ public:
         }
     }
 
+    virtual void ReverseOne(ArrayView<const Base> x,
+                            size_t pxNnz, const size_t pxIdx[], Base px[],
+                            size_t pyNnz, const size_t idx[], const Base py[]) override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_sparseReverseOne != nullptr, "No sparse reverse one function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(_reverseOneSparsity != nullptr, "No reverse one sparsity function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(x.size() >= _n, "Invalid x size");
+        CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
+
+        _px.resize(_n);
+        _inHess[0] = x.data();
+
+        evalSparseCompressed(_sparseReverseOne, _reverseOneSparsity, &_inHess[0], _n,
+                             pyNnz, idx, py,
+                             pxNnz, pxIdx, px,
+                             &_px[0]);
+    }
+
+    virtual void ReverseOneSparsity(std::vector<size_t>& start,
+                                    std::vector<size_t>& elements) override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_reverseOneSparsity != nullptr, "No reverse one sparsity function defined in the dynamic library");
+
+        loadDirectionalSparsity(_reverseOneSparsity, _m, start, elements);
+    }
+
     virtual bool isReverseTwoAvailable() override {
         return _reverseTwo != nullptr;
     }
@@ -598,6 +749,37 @@ public:
         }
     }
 
+    virtual void ReverseTwo(ArrayView<const Base> x,
+                            size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                            size_t px2Nnz, const size_t px2Idx[], Base px2[],
+                            ArrayView<const Base> py2) override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_sparseReverseTwo != nullptr, "No sparse reverse two function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(_reverseTwoSparsity != nullptr, "No reverse two sparsity function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(x.size() >= _n, "Invalid x size");
+        CPPADCG_ASSERT_KNOWN(py2.size() >= _m, "Invalid py2 size");
+        CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
+
+        _px.resize(_n);
+
+        const Base * in[3];
+        in[0] = x.data();
+        in[2] = py2.data();
+
+        evalSparseCompressed(_sparseReverseTwo, _reverseTwoSparsity, in, _n,
+                             tx1Nnz, idx, tx1,
+                             px2Nnz, px2Idx, px2,
+                             &_px[0]);
+    }
+
+    virtual void ReverseTwoSparsity(std::vector<size_t>& start,
+                                    std::vector<size_t>& elements) override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_reverseTwoSparsity != nullptr, "No reverse two sparsity function defined in the dynamic library");
+
+        loadDirectionalSparsity(_reverseTwoSparsity, _n, start, elements);
+    }
+
     virtual bool isSparseJacobianAvailable() override {
         return _jacobianSparsity != nullptr && _sparseJacobian != nullptr;
     }
@@ -842,6 +1024,70 @@ public:
         }
     }
 
+    virtual bool isForwardZeroSparseJacobianAvailable() override {
+        return _jacobianSparsity != nullptr && _forwardZeroSparseJacobian != nullptr;
+    }
+
+    virtual void ForwardZeroSparseJacobian(ArrayView<const Base> x,
+                                           ArrayView<Base> dep,
+                                           ArrayView<Base> jac) override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_forwardZeroSparseJacobian != nullptr, "No model and sparse Jacobian function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+                             " please use the variable size methods");
+        CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size");
+        CPPADCG_ASSERT_KNOWN(dep.size() == _m, "Invalid dependent array size");
+        CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
+
+        unsigned long const* row, *col;
+        unsigned long nnz;
+        (*_jacobianSparsity)(&row, &col, &nnz);
+        CPPADCG_ASSERT_KNOWN(jac.size() == nnz, "Invalid number of non-zero elements in Jacobian");
+
+        const Base* in[] = {x.data()};
+        Base* out[] = {dep.data(), jac.data()};
+
+        (*_forwardZeroSparseJacobian)(in, out, _atomicFuncArg);
+    }
+
+    virtual bool isLagrangianSparseHessianAvailable() override {
+        return _hessianSparsity != nullptr && _lagrangianSparseHessian != nullptr;
+    }
+
+    virtual void LagrangianSparseHessian(ArrayView<const Base> x,
+                                         ArrayView<const Base> w,
+                                         Base& lagrangian,
+                                         ArrayView<Base> grad,
+                                         ArrayView<Base> hess) override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_lagrangianSparseHessian != nullptr, "No Lagrangian and sparse Hessian function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+                             " please use the variable size methods");
+        CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size");
+        CPPADCG_ASSERT_KNOWN(w.size() == _m, "Invalid multiplier array size");
+        CPPADCG_ASSERT_KNOWN(grad.size() == _n, "Invalid gradient array size");
+        CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
+
+        unsigned long const* row, *col;
+        unsigned long nnz;
+        (*_hessianSparsity)(&row, &col, &nnz);
+        CPPADCG_ASSERT_KNOWN(hess.size() == nnz, "Invalid number of non-zero elements in Hessian");
+
+        const Base* in[] = {x.data(), w.data()};
+        Base* out[] = {&lagrangian, grad.data(), hess.data()};
+
+        (*_lagrangianSparseHessian)(in, out, _atomicFuncArg);
+    }
+
+    virtual ThreadPoolJobProfile getThreadPoolJobProfile() override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+
+        ThreadPoolJobProfile profile;
+        addJobProfile(profile, _sparseJacobianJobs);
+        addJobProfile(profile, _sparseHessianJobs);
+        return profile;
+    }
+
 protected:
 
     /**
@@ -867,12 +1113,16 @@ protected:
         _sparseReverseTwo(nullptr),
         _sparseJacobian(nullptr),
         _sparseHessian(nullptr),
+        _forwardZeroSparseJacobian(nullptr),
+        _lagrangianSparseHessian(nullptr),
         _forwardOneSparsity(nullptr),
         _reverseOneSparsity(nullptr),
         _reverseTwoSparsity(nullptr),
         _jacobianSparsity(nullptr),
         _hessianSparsity(nullptr),
-        _hessianSparsity2(nullptr) {
+        _hessianSparsity2(nullptr),
+        _sparseJacobianJobs(nullptr),
+        _sparseHessianJobs(nullptr) {
 
     }
 
@@ -931,12 +1181,16 @@ protected:
         _sparseReverseTwo = reinterpret_cast<decltype(_sparseReverseTwo)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_SPARSE_REVERSE_TWO, false));
         _sparseJacobian = reinterpret_cast<decltype(_sparseJacobian)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_SPARSE_JACOBIAN, false));
         _sparseHessian = reinterpret_cast<decltype(_sparseHessian)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_SPARSE_HESSIAN, false));
+        _forwardZeroSparseJacobian = reinterpret_cast<decltype(_forwardZeroSparseJacobian)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_FORWARD_ZERO_SPARSE_JACOBIAN, false));
+        _lagrangianSparseHessian = reinterpret_cast<decltype(_lagrangianSparseHessian)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_LAGRANGIAN_SPARSE_HESSIAN, false));
         _forwardOneSparsity = reinterpret_cast<decltype(_forwardOneSparsity)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_FORWARD_ONE_SPARSITY, false));
         _reverseOneSparsity = reinterpret_cast<decltype(_reverseOneSparsity)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_REVERSE_ONE_SPARSITY, false));
         _reverseTwoSparsity = reinterpret_cast<decltype(_reverseTwoSparsity)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_REVERSE_TWO_SPARSITY, false));
         _jacobianSparsity = reinterpret_cast<decltype(_jacobianSparsity)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_JACOBIAN_SPARSITY, false));
         _hessianSparsity = reinterpret_cast<decltype(_hessianSparsity)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_HESSIAN_SPARSITY, false));
         _hessianSparsity2 = reinterpret_cast<decltype(_hessianSparsity2)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_HESSIAN_SPARSITY2, false));
+        _sparseJacobianJobs = reinterpret_cast<decltype(_sparseJacobianJobs)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_SPARSE_JACOBIAN_JOBS, false));
+        _sparseHessianJobs = reinterpret_cast<decltype(_sparseHessianJobs)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_SPARSE_HESSIAN_JOBS, false));
         _atomicFunctions = reinterpret_cast<decltype(_atomicFunctions)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_ATOMIC_FUNC_NAMES, true));
 
         CPPADCG_ASSERT_KNOWN((_sparseForwardOne == nullptr) == (_forwardOneSparsity == nullptr), "Missing functions in the dynamic library");
@@ -947,6 +1201,8 @@ protected:
         CPPADCG_ASSERT_KNOWN((_sparseReverseTwo == nullptr) == (_reverseTwo == nullptr), "Missing functions in the dynamic library");
         CPPADCG_ASSERT_KNOWN((_sparseJacobian == nullptr) || (_jacobianSparsity != nullptr), "Missing functions in the dynamic library");
         CPPADCG_ASSERT_KNOWN((_sparseHessian == nullptr) || (_hessianSparsity != nullptr), "Missing functions in the dynamic library");
+        CPPADCG_ASSERT_KNOWN((_forwardZeroSparseJacobian == nullptr) || (_jacobianSparsity != nullptr), "Missing functions in the dynamic library");
+        CPPADCG_ASSERT_KNOWN((_lagrangianSparseHessian == nullptr) || (_hessianSparsity != nullptr), "Missing functions in the dynamic library");
 
         /**
          * Prepare the atomic functions argument
@@ -1008,6 +1264,78 @@ protected:
         }
     }
 
+    inline void loadDirectionalSparsity(void (*sparsity)(unsigned long, unsigned long const**, unsigned long*),
+                                        size_t nDirections,
+                                        std::vector<size_t>& start,
+                                        std::vector<size_t>& elements) {
+        start.resize(nDirections + 1);
+        elements.clear();
+
+        unsigned long const* pos;
+        unsigned long nnz = 0;
+
+        for (size_t d = 0; d < nDirections; d++) {
+            start[d] = elements.size();
+            (*sparsity)(d, &pos, &nnz);
+            elements.insert(elements.end(), pos, pos + nnz);
+        }
+        start[nDirections] = elements.size();
+    }
+
+    /**
+     * Evaluates a sparse directional function for each non-zero seed and
+     * accumulates the results in a compressed output vector.
+     * The location of each output element is kept in _compressedPos which
+     * is only cleared for the requested locations, so that the cost does
+     * not depend on the size of the output.
+     */
+    inline void evalSparseCompressed(int (*eval)(unsigned long, Base const *const *, Base * const *, LangCAtomicFun),
+                                     void (*sparsity)(unsigned long, unsigned long const**, unsigned long*),
+                                     const Base** in,
+                                     size_t outSize,
+                                     size_t seedNnz, const size_t seedIdx[], const Base seed[],
+                                     size_t outNnz, const size_t outIdx[], Base out[],
+                                     Base* compressed) {
+        const size_t unassigned = (std::numeric_limits<size_t>::max)();
+
+        std::fill(out, out + outNnz, Base(0));
+        if (seedNnz == 0 || outNnz == 0)
+            return; //nothing to do
+
+        if (_compressedPos.size() < outSize)
+            _compressedPos.resize(outSize, unassigned);
+
+        for (size_t e = 0; e < outNnz; e++) {
+            CPPADCG_ASSERT_KNOWN(outIdx[e] < outSize, "Invalid output index");
+            _compressedPos[outIdx[e]] = e;
+        }
+
+        unsigned long const* pos;
+        unsigned long nnz = 0;
+
+        _out[0] = compressed;
+
+        for (size_t e = 0; e < seedNnz; e++) {
+            size_t j = seedIdx[e];
+            (*sparsity)(j, &pos, &nnz);
+
+            in[1] = &seed[e];
+            int ret = (*eval)(j, in, &_out[0], _atomicFuncArg);
+
+            CPPADCG_ASSERT_KNOWN(ret == 0, "Sparse directional evaluation failed."); // generic failure
+
+            for (size_t ePos = 0; ePos < nnz; ePos++) {
+                size_t o = _compressedPos[pos[ePos]];
+                CPPADCG_ASSERT_KNOWN(o != unassigned, "The output locations do not contain all structural non-zeros");
+                out[o] += compressed[ePos];
+            }
+        }
+
+        for (size_t e = 0; e < outNnz; e++) {
+            _compressedPos[outIdx[e]] = unassigned;
+        }
+    }
+
     virtual void modelLibraryClosed() {
         _isLibraryReady = false;
         _zero = nullptr;
@@ -1027,10 +1355,36 @@ protected:
         _jacobianSparsity = nullptr;
         _hessianSparsity = nullptr;
         _hessianSparsity2 = nullptr;
+        _forwardZeroSparseJacobian = nullptr;
+        _lagrangianSparseHessian = nullptr;
+        _sparseJacobianJobs = nullptr;
+        _sparseHessianJobs = nullptr;
     }
 
 private:
 
+    /**
+     * Adds the jobs of a multithreaded function to a profile
+     */
+    static void addJobProfile(ThreadPoolJobProfile& profile,
+                              void (*jobsFunc)(const char**, unsigned long const**, unsigned long const**, float const**, unsigned long*)) {
+        if (jobsFunc == nullptr)
+            return;
+
+        const char* function = nullptr;
+        unsigned long const* keyStart, *keys;
+        float const* elapsed;
+        unsigned long nJobs;
+        (*jobsFunc)(&function, &keyStart, &keys, &elapsed, &nJobs);
+
+        std::vector<ThreadPoolJobProfile::Job> jobs(nJobs);
+        for (size_t j = 0; j < nJobs; j++) {
+            jobs[j].keys.assign(keys + keyStart[j], keys + keyStart[j + 1]);
+            jobs[j].elapsed = elapsed[j];
+        }
+        profile.set(function, std::move(jobs));
+    }
+
     template<class ExtFunc, class Wrapper>
     inline bool addExternalFunction(ExtFunc& atomic,
                                     const std::string& name) {
@@ -39,6 +39,12 @@ protected:
     int (*_isThreadPoolVerbose)();
     void (*_setThreadPoolGuidedMaxWork)(float v);
     float (*_getThreadPoolGuidedMaxWork)();
+    void (*_setThreadPoolAffinity)(int a);
+    int (*_getThreadPoolAffinity)();
+    void (*_setThreadPoolSpinTime)(float seconds);
+    float (*_getThreadPoolSpinTime)();
+    void (*_setThreadPoolCallerExecutes)(int e);
+    int (*_isThreadPoolCallerExecutes)();
     void (*_setThreadPoolNumberOfTimeMeas)(unsigned int n);
     unsigned int (*_getThreadPoolNumberOfTimeMeas)();
 public:
@@ -152,6 +158,45 @@ public:
         return 1.0;
     }
 
+    virtual ThreadPoolAffinity getThreadPoolAffinity() const override {
+        if (_getThreadPoolAffinity != nullptr) {
+            return ThreadPoolAffinity((*_getThreadPoolAffinity)());
+        }
+        return ThreadPoolAffinity::NONE;
+    }
+
+    virtual void setThreadPoolAffinity(ThreadPoolAffinity a) override {
+        if (_setThreadPoolAffinity != nullptr) {
+            (*_setThreadPoolAffinity)(int(a));
+        }
+    }
+
+    virtual float getThreadPoolSpinTime() const override {
+        if (_getThreadPoolSpinTime != nullptr) {
+            return (*_getThreadPoolSpinTime)();
+        }
+        return 0;
+    }
+
+    virtual void setThreadPoolSpinTime(float seconds) override {
+        if (_setThreadPoolSpinTime != nullptr) {
+            (*_setThreadPoolSpinTime)(seconds);
+        }
+    }
+
+    virtual bool isThreadPoolCallerExecutesJobs() const override {
+        if (_isThreadPoolCallerExecutes != nullptr) {
+            return bool((*_isThreadPoolCallerExecutes)());
+        }
+        return false;
+    }
+
+    virtual void setThreadPoolCallerExecutesJobs(bool e) override {
+        if (_setThreadPoolCallerExecutes != nullptr) {
+            (*_setThreadPoolCallerExecutes)(int(e));
+        }
+    }
+
     virtual void setThreadPoolNumberOfTimeMeas(unsigned int n) override {
         if (_setThreadPoolNumberOfTimeMeas != nullptr) {
             (*_setThreadPoolNumberOfTimeMeas)(n);
@@ -182,6 +227,12 @@ protected:
             _isThreadPoolVerbose(nullptr),
             _setThreadPoolGuidedMaxWork(nullptr),
             _getThreadPoolGuidedMaxWork(nullptr),
+            _setThreadPoolAffinity(nullptr),
+            _getThreadPoolAffinity(nullptr),
+            _setThreadPoolSpinTime(nullptr),
+            _getThreadPoolSpinTime(nullptr),
+            _setThreadPoolCallerExecutes(nullptr),
+            _isThreadPoolCallerExecutes(nullptr),
             _setThreadPoolNumberOfTimeMeas(nullptr),
             _getThreadPoolNumberOfTimeMeas(nullptr) {
     }
@@ -231,6 +282,12 @@ protected:
         _isThreadPoolVerbose = reinterpret_cast<decltype(_isThreadPoolVerbose)> (this->loadFunction(ModelLibraryCSourceGen<Base>::FUNCTION_ISTHREADPOOLVERBOSE, false));
         _setThreadPoolGuidedMaxWork = reinterpret_cast<decltype(_setThreadPoolGuidedMaxWork)> (this->loadFunction(ModelLibraryCSourceGen<Base>::FUNCTION_SETTHREADPOOLGUIDEDMAXGROUPWORK, false));
         _getThreadPoolGuidedMaxWork = reinterpret_cast<decltype(_getThreadPoolGuidedMaxWork)> (this->loadFunction(ModelLibraryCSourceGen<Base>::FUNCTION_GETTHREADPOOLGUIDEDMAXGROUPWORK, false));
+        _setThreadPoolAffinity = reinterpret_cast<decltype(_setThreadPoolAffinity)> (this->loadFunction(ModelLibraryCSourceGen<Base>::FUNCTION_SETTHREADPOOLAFFINITY, false));
+        _getThreadPoolAffinity = reinterpret_cast<decltype(_getThreadPoolAffinity)> (this->loadFunction(ModelLibraryCSourceGen<Base>::FUNCTION_GETTHREADPOOLAFFINITY, false));
+        _setThreadPoolSpinTime = reinterpret_cast<decltype(_setThreadPoolSpinTime)> (this->loadFunction(ModelLibraryCSourceGen<Base>::FUNCTION_SETTHREADPOOLSPINTIME, false));
+        _getThreadPoolSpinTime = reinterpret_cast<decltype(_getThreadPoolSpinTime)> (this->loadFunction(ModelLibraryCSourceGen<Base>::FUNCTION_GETTHREADPOOLSPINTIME, false));
+        _setThreadPoolCallerExecutes = reinterpret_cast<decltype(_setThreadPoolCallerExecutes)> (this->loadFunction(ModelLibraryCSourceGen<Base>::FUNCTION_SETTHREADPOOLCALLEREXECUTES, false));
+        _isThreadPoolCallerExecutes = reinterpret_cast<decltype(_isThreadPoolCallerExecutes)> (this->loadFunction(ModelLibraryCSourceGen<Base>::FUNCTION_ISTHREADPOOLCALLEREXECUTES, false));
         _setThreadPoolNumberOfTimeMeas = reinterpret_cast<decltype(_setThreadPoolNumberOfTimeMeas)> (this->loadFunction(ModelLibraryCSourceGen<Base>::FUNCTION_SETTHREADPOOLNUMBEROFTIMEMEAS, false));
         _getThreadPoolNumberOfTimeMeas = reinterpret_cast<decltype(_getThreadPoolNumberOfTimeMeas)> (this->loadFunction(ModelLibraryCSourceGen<Base>::FUNCTION_GETTHREADPOOLNUMBEROFTIMEMEAS, false));
 
@@ -61,6 +61,33 @@ public:
     virtual void JacobianSparsity(std::vector<size_t>& equations,
                                   std::vector<size_t>& variables) = 0;
 
+    /**
+     * Provides the Jacobian sparsity pattern without copying or allocating
+     * the indexes, which remain owned by the model library (they are only
+     * valid while the library is loaded).
+     *
+     * @param equations the row of each non-zero element
+     * @param variables the column of each non-zero element
+     */
+    virtual void JacobianSparsity(ArrayView<const unsigned long>& equations,
+                                  ArrayView<const unsigned long>& variables) = 0;
+
+    /**
+     * Provides a read-only view of the Jacobian sparsity pattern in
+     * coordinate format which refers directly to the arrays in the model
+     * library (only valid while the library is loaded).
+     */
+    virtual CooSparsityView JacobianSparsityCoo() = 0;
+
+    /**
+     * Provides a read-only view of the Jacobian sparsity pattern in
+     * compressed sparse row format.
+     * It is created only once by the model (without copying the column
+     * indexes when the elements are already ordered by row) and it is
+     * only valid while the model exists.
+     */
+    virtual CsrSparsityView JacobianSparsityCsr() = 0;
+
     /**
      * Determines whether or not the sparsity pattern for the weighted sum of
      * the Hessians can be requested.
@@ -80,6 +107,10 @@ public:
     virtual std::vector<bool> HessianSparsityBool() = 0;
     virtual void HessianSparsity(std::vector<size_t>& rows,
                                  std::vector<size_t>& cols) = 0;
+    virtual void HessianSparsity(ArrayView<const unsigned long>& rows,
+                                 ArrayView<const unsigned long>& cols) = 0;
+    virtual CooSparsityView HessianSparsityCoo() = 0;
+    virtual CsrSparsityView HessianSparsityCsr() = 0;
 
     /**
      * Determines whether or not the sparsity pattern for the Hessian
@@ -101,6 +132,11 @@ public:
     virtual void HessianSparsity(size_t i,
                                  std::vector<size_t>& rows,
                                  std::vector<size_t>& cols) = 0;
+    virtual void HessianSparsity(size_t i,
+                                 ArrayView<const unsigned long>& rows,
+                                 ArrayView<const unsigned long>& cols) = 0;
+    virtual CooSparsityView HessianSparsityCoo(size_t i) = 0;
+    virtual CsrSparsityView HessianSparsityCsr(size_t i) = 0;
 
     /**
      * Provides the number of independent variables.
@@ -405,6 +441,46 @@ public:
                             size_t tx1Nnz, const size_t idx[], const Base tx1[],
                             ArrayView<Base> ty1) = 0;
 
+    /**
+     * Computes results during a first-order forward mode sweep just like
+     * the previous method, however the directional derivatives of the
+     * dependent variables are also provided in a compressed form.
+     * The cost of this method depends only on the number of non-zeros and
+     * not on the number of dependent variables.
+     * @warning do not used it as a generic forward mode function!
+     *
+     * @param x independent variable vector
+     * @param tx1Nnz the number of non-zeros of the directional derivatives
+     *               of the independent variables (seed directions)
+     * @param idx the locations of the non-zero values of the directional
+     *            derivatives of the independent variables (seeds)
+     * @param tx1 the non-zero values of the directional derivatives of the
+     *            independent variables (seeds)
+     * @param ty1Nnz the number of elements in the compressed results
+     * @param ty1Idx the locations of the dependent variables to be
+     *               determined (it must contain all the structural
+     *               non-zeros for the provided seed directions)
+     * @param ty1 the directional derivatives of the dependent variables
+     *            at the locations in <code>ty1Idx</code>
+     */
+    virtual void ForwardOne(ArrayView<const Base> x,
+                            size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                            size_t ty1Nnz, const size_t ty1Idx[], Base ty1[]) = 0;
+
+    /**
+     * Provides the sparsity pattern used by the sparse first-order forward
+     * mode methods in a compressed row format: the dependent variables
+     * affected by the independent variable <code>j</code> are
+     * <code>elements[start[j]]</code> to <code>elements[start[j + 1] - 1]</code>.
+     * It should only be called if isSparseForwardOneAvailable() returns true.
+     *
+     * @param start the position of the first element for each independent
+     *              variable (size n + 1)
+     * @param elements the dependent variable indexes
+     */
+    virtual void ForwardOneSparsity(std::vector<size_t>& start,
+                                    std::vector<size_t>& elements) = 0;
+
     /***********************************************************************
      *                        Reverse one
      **********************************************************************/
@@ -495,6 +571,46 @@ public:
                             ArrayView<Base> px,
                             size_t pyNnz, const size_t idx[], const Base py[]) = 0;
 
+    /**
+     * Computes results during a reverse mode sweep just like the previous
+     * method, however the partial derivatives of the independent variables
+     * are also provided in a compressed form.
+     * The cost of this method depends only on the number of non-zeros and
+     * not on the number of independent variables.
+     * @warning do not used it as a generic reverse mode function!
+     *
+     * @param x independent variable vector
+     * @param pxNnz the number of elements in the compressed results
+     * @param pxIdx the locations of the independent variables to be
+     *              determined (it must contain all the structural
+     *              non-zeros for the provided weight functionals)
+     * @param px partial derivatives of the independent variables at the
+     *           locations in <code>pxIdx</code>
+     * @param pyNnz the number of non-zeros of the partial derivatives of
+     *              the dependent variables (weight functionals)
+     * @param idx the locations of the non-zero values the partial
+     *            derivatives of the dependent variables (weight functionals)
+     * @param py the non-zero values of the partial derivatives of the
+     *           dependent variables (weight functionals)
+     */
+    virtual void ReverseOne(ArrayView<const Base> x,
+                            size_t pxNnz, const size_t pxIdx[], Base px[],
+                            size_t pyNnz, const size_t idx[], const Base py[]) = 0;
+
+    /**
+     * Provides the sparsity pattern used by the sparse first-order reverse
+     * mode methods in a compressed row format: the independent variables
+     * affected by the dependent variable <code>i</code> are
+     * <code>elements[start[i]]</code> to <code>elements[start[i + 1] - 1]</code>.
+     * It should only be called if isSparseReverseOneAvailable() returns true.
+     *
+     * @param start the position of the first element for each dependent
+     *              variable (size m + 1)
+     * @param elements the independent variable indexes
+     */
+    virtual void ReverseOneSparsity(std::vector<size_t>& start,
+                                    std::vector<size_t>& elements) = 0;
+
     /***********************************************************************
      *                        Reverse two
      **********************************************************************/
@@ -590,6 +706,47 @@ public:
                             ArrayView<Base> px2,
                             ArrayView<const Base> py2) = 0;
 
+    /**
+     * Computes second-order results during a reverse mode sweep just like
+     * the previous method, however the second-order partials of the
+     * independent variables are also provided in a compressed form.
+     * @warning do not used it as a generic reverse mode function!
+     *
+     * @param x independent variable vector
+     * @param tx1Nnz the number of non-zeros of the first-order Taylor
+     *               coefficients of the independents
+     * @param idx the locations of the non-zero values of the first-order
+     *            Taylor coefficients of the independents
+     * @param tx1 the values of the non-zero first-order Taylor coefficients
+     *            of the independents
+     * @param px2Nnz the number of elements in the compressed results
+     * @param px2Idx the locations of the independent variables to be
+     *               determined (it must contain all the structural
+     *               non-zeros for the provided Taylor coefficients)
+     * @param px2 second-order partials of the independents at the
+     *            locations in <code>px2Idx</code>
+     * @param py2 second-order partials of the dependents
+     *            (should have the size of the dependent variables)
+     */
+    virtual void ReverseTwo(ArrayView<const Base> x,
+                            size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                            size_t px2Nnz, const size_t px2Idx[], Base px2[],
+                            ArrayView<const Base> py2) = 0;
+
+    /**
+     * Provides the sparsity pattern used by the sparse second-order reverse
+     * mode methods in a compressed row format: the second-order partials
+     * affected by the independent variable <code>j</code> are
+     * <code>elements[start[j]]</code> to <code>elements[start[j + 1] - 1]</code>.
+     * It should only be called if isSparseReverseTwoAvailable() returns true.
+     *
+     * @param start the position of the first element for each independent
+     *              variable (size n + 1)
+     * @param elements the independent variable indexes
+     */
+    virtual void ReverseTwoSparsity(std::vector<size_t>& start,
+                                    std::vector<size_t>& elements) = 0;
+
     /***********************************************************************
      *                        Sparse Jacobians
      **********************************************************************/
@@ -744,6 +901,74 @@ public:
                                size_t const** row,
                                size_t const** col) = 0;
 
+    /***********************************************************************
+     *                        Combined evaluations
+     **********************************************************************/
+
+    /**
+     * Determines whether or not the model values and the sparse Jacobian
+     * can be evaluated with a single call.
+     *
+     * @return true if ForwardZeroSparseJacobian() can be called
+     */
+    virtual bool isForwardZeroSparseJacobianAvailable() = 0;
+
+    /**
+     * Evaluates the model and the sparse Jacobian at the same point using
+     * a single compiled function which shares all the intermediate values
+     * (cheaper than ForwardZero() followed by SparseJacobian()).
+     *
+     * @param x independent variable array (must have n elements)
+     * @param dep the dependent variable values (must have m elements)
+     * @param jac the Jacobian values in the order provided by
+     *            JacobianSparsity()
+     */
+    virtual void ForwardZeroSparseJacobian(ArrayView<const Base> x,
+                                           ArrayView<Base> dep,
+                                           ArrayView<Base> jac) = 0;
+
+    /**
+     * Determines whether or not the Lagrangian, its gradient and its sparse
+     * Hessian can be evaluated with a single call.
+     *
+     * @return true if LagrangianSparseHessian() can be called
+     */
+    virtual bool isLagrangianSparseHessianAvailable() = 0;
+
+    /**
+     * Evaluates the Lagrangian \f$ L(x, w) = \sum_i w_i F_i(x) \f$, its
+     * gradient with respect to \f$ x \f$, and its sparse Hessian using a
+     * single compiled function which shares all the intermediate values.
+     *
+     * @param x independent variable array (must have n elements)
+     * @param w the multipliers (must have m elements)
+     * @param lagrangian the Lagrangian value
+     * @param grad the gradient (must have n elements)
+     * @param hess the Hessian values in the order provided by
+     *             HessianSparsity()
+     */
+    virtual void LagrangianSparseHessian(ArrayView<const Base> x,
+                                         ArrayView<const Base> w,
+                                         Base& lagrangian,
+                                         ArrayView<Base> grad,
+                                         ArrayView<Base> hess) = 0;
+
+    /***********************************************************************
+     *                        Thread pool
+     **********************************************************************/
+
+    /**
+     * Provides the reference elapsed times measured by the thread pool for
+     * the jobs of the multithreaded sparse Jacobian and sparse Hessian
+     * (only available if the library was created with
+     * MultiThreadingType::PTHREADS).
+     * The profile can be saved and provided to ModelCSourceGen in order to
+     * improve the load balance when the model is generated again.
+     *
+     * @return the measured job times (empty if there are none)
+     */
+    virtual ThreadPoolJobProfile getThreadPoolJobProfile() = 0;
+
     /**
      * Provides a wrapper for this compiled model allowing it to be used as
      * an atomic function. The model must not be deleted while the atomic
@@ -18,14 +18,41 @@
 namespace CppAD {
 namespace cg {
 
+/**
+ * Allows a generic model to be called as an atomic function from the
+ * generated source code of another model.
+ * Directional derivatives are exchanged in a compressed form and the
+ * sparsity of the called model is only requested once for each
+ * pair of calling/called models (one wrapper is created for each pair).
+ */
 template<class Base>
 class GenericModelExternalFunctionWrapper : public ExternalFunctionWrapper<Base> {
 private:
     GenericModel<Base>* model_;
+    /**
+     * Whether or not the sparsity of the called model has already been
+     * loaded
+     */
+    bool sparsityLoaded_;
+    /**
+     * Sparsity of the called model for the first-order forward mode,
+     * first-order reverse mode, and second-order reverse mode
+     * (compressed row format)
+     */
+    std::vector<size_t> for1Start_, for1Elements_;
+    std::vector<size_t> rev1Start_, rev1Elements_;
+    std::vector<size_t> rev2Start_, rev2Elements_;
+    /**
+     * Work arrays used to determine the locations of the results
+     */
+    std::vector<bool> marked_;
+    std::vector<size_t> outIdx_;
+    std::vector<Base> outValues_;
 public:
 
     inline GenericModelExternalFunctionWrapper(GenericModel<Base>& model) :
-        model_(&model) {
+        model_(&model),
+        sparsityLoaded_(false) {
     }
 
     inline virtual ~GenericModelExternalFunctionWrapper() {
@@ -39,21 +66,32 @@ public:
         CPPADCG_ASSERT_KNOWN(!tx[0].sparse, "independent array must be dense");
         ArrayView<const Base> x(static_cast<const Base*> (tx[0].data), tx[0].size);
 
-        CPPADCG_ASSERT_KNOWN(!ty.sparse, "dependent array must be dense");
-        ArrayView<Base> y(static_cast<Base*> (ty.data), ty.size);
-
-
         if (p == 0) {
+            CPPADCG_ASSERT_KNOWN(!ty.sparse, "dependent array must be dense");
+            ArrayView<Base> y(static_cast<Base*> (ty.data), ty.size);
+
             model_->ForwardZero(x, y);
             return true;
 
         } else if (p == 1) {
             CPPADCG_ASSERT_KNOWN(tx[1].sparse, "independent Taylor array must be sparse");
-            Base* tx1 = static_cast<Base*> (tx[1].data);
+            const Base* tx1 = static_cast<const Base*> (tx[1].data);
+
+            loadSparsity();
 
-            model_->ForwardOne(x,
-                               tx[1].nnz, tx[1].idx, tx1,
-                               y);
+            if (ty.sparse) {
+                model_->ForwardOne(x,
+                                   tx[1].nnz, tx[1].idx, tx1,
+                                   ty.nnz, ty.idx, static_cast<Base*> (ty.data));
+            } else {
+                determineOutputLocations(for1Start_, for1Elements_, tx[1].nnz, tx[1].idx, ty.size);
+
+                model_->ForwardOne(x,
+                                   tx[1].nnz, tx[1].idx, tx1,
+                                   outIdx_.size(), outIdx_.data(), outValues_.data());
+
+                scatter(static_cast<Base*> (ty.data));
+            }
             return true;
         }
 
@@ -68,16 +106,25 @@ public:
         CPPADCG_ASSERT_KNOWN(!tx[0].sparse, "independent array must be dense");
         ArrayView<const Base> x(static_cast<const Base*> (tx[0].data), tx[0].size);
 
-        CPPADCG_ASSERT_KNOWN(!px.sparse, "independent partials array must be dense");
-        ArrayView<Base> pxb(static_cast<Base*> (px.data), px.size);
+        loadSparsity();
 
         if (p == 0) {
             CPPADCG_ASSERT_KNOWN(py[0].sparse, "dependent partials array must be sparse");
-            Base* pyb = static_cast<Base*> (py[0].data);
+            const Base* pyb = static_cast<const Base*> (py[0].data);
+
+            if (px.sparse) {
+                model_->ReverseOne(x,
+                                   px.nnz, px.idx, static_cast<Base*> (px.data),
+                                   py[0].nnz, py[0].idx, pyb);
+            } else {
+                determineOutputLocations(rev1Start_, rev1Elements_, py[0].nnz, py[0].idx, px.size);
 
-            model_->ReverseOne(x,
-                               pxb,
-                               py[0].nnz, py[0].idx, pyb);
+                model_->ReverseOne(x,
+                                   outIdx_.size(), outIdx_.data(), outValues_.data(),
+                                   py[0].nnz, py[0].idx, pyb);
+
+                scatter(static_cast<Base*> (px.data));
+            }
             return true;
 
         } else if (p == 1) {
@@ -88,16 +135,90 @@ public:
             CPPADCG_ASSERT_KNOWN(!py[1].sparse, "independent partials array must be dense");
             ArrayView<const Base> py2(static_cast<Base*> (py[1].data), py[1].size);
 
-            model_->ReverseTwo(x,
-                               tx[1].nnz, tx[1].idx, tx1,
-                               pxb,
-                               py2);
+            if (px.sparse) {
+                model_->ReverseTwo(x,
+                                   tx[1].nnz, tx[1].idx, tx1,
+                                   px.nnz, px.idx, static_cast<Base*> (px.data),
+                                   py2);
+            } else {
+                determineOutputLocations(rev2Start_, rev2Elements_, tx[1].nnz, tx[1].idx, px.size);
+
+                model_->ReverseTwo(x,
+                                   tx[1].nnz, tx[1].idx, tx1,
+                                   outIdx_.size(), outIdx_.data(), outValues_.data(),
+                                   py2);
+
+                scatter(static_cast<Base*> (px.data));
+            }
             return true;
         }
 
         return false;
     }
 
+private:
+
+    /**
+     * Requests the sparsity of the called model (only once).
+     */
+    inline void loadSparsity() {
+        if (sparsityLoaded_)
+            return;
+
+        if (model_->isSparseForwardOneAvailable())
+            model_->ForwardOneSparsity(for1Start_, for1Elements_);
+        if (model_->isSparseReverseOneAvailable())
+            model_->ReverseOneSparsity(rev1Start_, rev1Elements_);
+        if (model_->isSparseReverseTwoAvailable())
+            model_->ReverseTwoSparsity(rev2Start_, rev2Elements_);
+
+        sparsityLoaded_ = true;
+    }
+
+    /**
+     * Determines the locations which can be affected by the provided
+     * non-zero directions (saved in outIdx_).
+     */
+    inline void determineOutputLocations(const std::vector<size_t>& start,
+                                         const std::vector<size_t>& elements,
+                                         size_t nnz,
+                                         const unsigned long* idx,
+                                         size_t outSize) {
+        CPPADCG_ASSERT_KNOWN(!start.empty(), "The sparsity of the called model is not available");
+
+        if (marked_.size() < outSize)
+            marked_.resize(outSize, false);
+
+        outIdx_.clear();
+        for (size_t e = 0; e < nnz; e++) {
+            size_t d = idx[e];
+            for (size_t p = start[d]; p < start[d + 1]; p++) {
+                size_t o = elements[p];
+                if (!marked_[o]) {
+                    marked_[o] = true;
+                    outIdx_.push_back(o);
+                }
+            }
+        }
+
+        for (size_t o : outIdx_) {
+            marked_[o] = false;
+        }
+
+        outValues_.resize(outIdx_.size());
+    }
+
+    /**
+     * Places the compressed results in a dense array.
+     * The generated source code always provides dense results initialized
+     * with zeros, therefore only the locations in outIdx_ are changed.
+     */
+    inline void scatter(Base* out) const {
+        for (size_t e = 0; e < outIdx_.size(); e++) {
+            out[outIdx_[e]] = outValues_[e];
+        }
+    }
+
 };
 
 } // END cg namespace
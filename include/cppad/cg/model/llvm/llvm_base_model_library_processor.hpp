@@ -80,6 +80,12 @@ protected:
 
         const std::map<std::string, ModelCSourceGen<Base>*>& models = this->modelLibraryHelper_->getModels();
         try {
+            if (this->modelLibraryHelper_->isSharedHeader()) {
+                clang.createSharedHeader(ModelLibraryCSourceGen<Base>::FILE_SHARED_HEADER,
+                                         this->modelLibraryHelper_->getSharedHeader(),
+                                         false, this->modelLibraryHelper_);
+            }
+
             /**
              * generate bit code
              */
@@ -58,6 +58,9 @@ public:
 
         _linker.release();
 
+        CPPADCG_ASSERT_KNOWN(!this->modelLibraryHelper_->isSharedHeader(),
+                             "Shared headers are only supported when the bitcode is generated by an external Clang compiler");
+
         this->modelLibraryHelper_->startingJob("", JobTimer::JIT_MODEL_LIBRARY);
 
         llvm::InitializeAllTargets();
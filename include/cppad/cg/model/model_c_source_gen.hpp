@@ -48,6 +48,10 @@ public:
     static const std::string FUNCTION_REVERSE_TWO;
     static const std::string FUNCTION_SPARSE_JACOBIAN;
     static const std::string FUNCTION_SPARSE_HESSIAN;
+    static const std::string FUNCTION_FORWARD_ZERO_SPARSE_JACOBIAN;
+    static const std::string FUNCTION_LAGRANGIAN_SPARSE_HESSIAN;
+    static const std::string FUNCTION_SPARSE_JACOBIAN_JOBS;
+    static const std::string FUNCTION_SPARSE_HESSIAN_JOBS;
     static const std::string FUNCTION_JACOBIAN_SPARSITY;
     static const std::string FUNCTION_HESSIAN_SPARSITY;
     static const std::string FUNCTION_HESSIAN_SPARSITY2;
@@ -181,6 +185,13 @@ protected:
     bool _sparseJacobian;
     /// generate source code for a sparse Hessian
     bool _sparseHessian;
+    /// generate source code for the zero order model and a sparse Jacobian in a single function
+    bool _forwardZeroSparseJacobian;
+    /**
+     * generate source code for the Lagrangian, its gradient, and its
+     * sparse Hessian in a single function
+     */
+    bool _lagrangianSparseHessian;
     /**
      * generate source-code for the Hessian sparsity pattern for each
      * equation/dependent
@@ -203,6 +214,17 @@ protected:
      */
     bool _sparseHessianReusesRev2;
     JacobianADMode _jacMode;
+    /**
+     * the mode selected for the sparse Jacobian when _jacMode is
+     * Cheapest (Cheapest while it has not been determined)
+     */
+    JacobianADMode _jacCheapestMode;
+    /**
+     * the rows of the sparse Jacobian evaluated with reverse mode sweeps
+     * in the bidirectional mode
+     */
+    std::set<size_t> _jacBidirReverseRows;
+    bool _jacBidirReverseRowsDetermined;
     /**
      * Custom Jacobian element indexes 
      */
@@ -221,6 +243,12 @@ protected:
      * The order of the atomic functions
      */
     std::vector<std::string> _atomicFunctions;
+    /**
+     * Whether or not _atomicFunctions contains all the atomic functions
+     * used by the generated sources (they were all generated or they are
+     * reused from a previous build)
+     */
+    bool _atomicFunctionsKnown;
     /**
      * Maps each atomic function ID to information regarding how the atomic function is used
      */
@@ -233,6 +261,56 @@ protected:
      * maximum number of assignments per function (~ lines)
      */
     size_t _maxAssignPerFunc;
+    /**
+     * compilation cost model used to decide where to split large
+     * functions (nullptr means that only _maxAssignPerFunc is used)
+     */
+    std::unique_ptr<FunctionSplitCostModel> _funcSplitModel;
+    /**
+     * algebraic simplifications applied to the operation graphs before
+     * the source code is generated (nullptr means no rewrites)
+     */
+    std::unique_ptr<GraphSimplifier<Base> > _graphSimplifier;
+    /**
+     * information on the functions created by splitting larger functions
+     * (only available when a cost model is used)
+     */
+    std::map<std::string, std::vector<FunctionSplitInfo> > _funcSplitReport;
+    /**
+     * whether or not to generate loops with independent iterations so
+     * that they can be vectorized by the compiler
+     */
+    bool _vectorizeLoops;
+    /**
+     * whether or not to copy the values indexed by vectorized loops into
+     * contiguous arrays (structure of arrays)
+     */
+    bool _packLoopArrays;
+    /**
+     * the table of constants shared by the generated functions of this
+     * model (nullptr if constants are always printed as literals)
+     */
+    std::unique_ptr<LangCConstantPool<Base> > _constantPool;
+    /**
+     * the number of threads used to generate the source code for the
+     * second-order reverse mode
+     */
+    size_t _genThreads;
+    /**
+     * the number of jobs for the multithreaded sparse Jacobian and sparse
+     * Hessian (0 uses a job for each row/column)
+     */
+    size_t _multiThreadingJobs;
+    /**
+     * the elapsed times of the jobs measured in a previous library
+     */
+    ThreadPoolJobProfile _jobProfile;
+    /**
+     * atomic functions implemented by other models in the same library
+     * which are called directly from the generated code
+     * (defined by ModelLibraryCSourceGen)
+     */
+    std::set<std::string> _directAtomicModels;
     /**
      * 
      */
@@ -275,6 +353,11 @@ protected:
      * Generated source code (maps file names to content)
      */
     std::map<std::string, std::string> _sources;
+    /**
+     * the header included at the beginning of the generated source files
+     * instead of the common declarations (empty if not used)
+     */
+    std::string _sharedHeader;
 public:
 
     /**
@@ -298,6 +381,8 @@ public:
         _hessian(false),
         _sparseJacobian(false),
         _sparseHessian(false),
+        _forwardZeroSparseJacobian(false),
+        _lagrangianSparseHessian(false),
         _hessianByEquation(false),
         _forwardOne(false),
         _reverseOne(false),
@@ -305,8 +390,15 @@ public:
         _sparseJacobianReusesOne(true),
         _sparseHessianReusesRev2(true),
         _jacMode(JacobianADMode::Automatic),
+        _jacCheapestMode(JacobianADMode::Cheapest),
+        _jacBidirReverseRowsDetermined(false),
+        _atomicFunctionsKnown(false),
         _atomicsInfo(nullptr),
         _maxAssignPerFunc(20000),
+        _vectorizeLoops(false),
+        _packLoopArrays(false),
+        _genThreads(1),
+        _multiThreadingJobs(0),
         _jobTimer(nullptr) {
 
         CPPADCG_ASSERT_KNOWN(!_name.empty(), "Model name cannot be empty");
@@ -414,6 +506,58 @@ public:
         _multiThreading = multiThreading;
     }
 
+    /**
+     * Provides the number of jobs used by the multithreaded sparse Jacobian
+     * and sparse Hessian.
+     *
+     * @return the number of jobs (0 if each row/column is a job)
+     */
+    inline size_t getMultiThreadingJobCount() const {
+        return _multiThreadingJobs;
+    }
+
+    /**
+     * Defines the number of jobs used by the multithreaded sparse Jacobian
+     * and sparse Hessian.
+     * The rows/columns are grouped into jobs with a similar cost (using the
+     * job profile if available or otherwise the number of elements) and
+     * rows/columns which evaluate the same elements, and are therefore
+     * likely to share temporary variables, are preferably placed in the
+     * same job.
+     * Fewer jobs reduce the scheduling overhead of models with many cheap
+     * rows/columns.
+     *
+     * @param nJobs the number of jobs (0 uses a job for each row/column)
+     */
+    inline void setMultiThreadingJobCount(size_t nJobs) {
+        _multiThreadingJobs = nJobs;
+    }
+
+    /**
+     * Provides the elapsed times of the thread pool jobs measured with a
+     * previously compiled version of this model.
+     */
+    inline const ThreadPoolJobProfile& getThreadPoolJobProfile() const {
+        return _jobProfile;
+    }
+
+    /**
+     * Defines the elapsed times of the thread pool jobs measured with a
+     * previously compiled version of this model
+     * (see GenericModel::getThreadPoolJobProfile()).
+     * They are used to group the rows/columns into balanced jobs
+     * (see setMultiThreadingJobCount()) and as the initial reference
+     * times and job order of the pthread pool, which avoids the initial
+     * measurements with a poor load balance.
+     * Rows/columns which were not measured (e.g. after changes to the
+     * model) are estimated from their number of elements.
+     *
+     * @param profile the measured job times
+     */
+    inline void setThreadPoolJobProfile(const ThreadPoolJobProfile& profile) {
+        _jobProfile = profile;
+    }
+
     inline bool isJacobianMultiThreadingEnabled() const {
         return _multiThreading && _loopTapes.empty() && _sparseJacobian && _sparseJacobianReusesOne && (_forwardOne || _reverseOne);
     }
@@ -462,6 +606,7 @@ public:
      */
     inline void setJacobianADMode(JacobianADMode mode) {
         _jacMode = mode;
+        _jacCheapestMode = JacobianADMode::Cheapest;
     }
 
     /**
@@ -530,6 +675,38 @@ public:
         _sparseHessian = create;
     }
 
+    /**
+     * Determines whether or not to generate source-code for a single
+     * function that evaluates the Lagrangian
+     * L(x, w) = sum_i w_i f_i(x), its gradient, and the sparse Hessian of
+     * the Lagrangian (the same values as the sparse Hessian function).
+     *
+     * @return true if source-code for the combined function should be
+     *         created, false otherwise
+     */
+    inline bool isCreateLagrangianSparseHessian() const {
+        return _lagrangianSparseHessian;
+    }
+
+    /**
+     * Defines whether or not to generate source-code for a single
+     * function that evaluates the Lagrangian
+     * L(x, w) = sum_i w_i f_i(x), its gradient, and the sparse Hessian of
+     * the Lagrangian (with the elements defined by
+     * setCustomSparseHessianElements(), if provided).
+     * All the values are determined from the same zero order forward
+     * sweep and the same temporary variables, which is cheaper than
+     * evaluating them separately (e.g. in the iterations of NLP
+     * solvers).
+     * Models with loops are not supported.
+     *
+     * @param create true if source-code for the combined function should
+     *               be created, false otherwise
+     */
+    inline void setCreateLagrangianSparseHessian(bool create) {
+        _lagrangianSparseHessian = create;
+    }
+
     /**
      * Determines whether or not the sparse Hessian should reuse functions
      * generated for the reverse two pass.
@@ -620,6 +797,35 @@ public:
         _sparseJacobian = create;
     }
 
+    /**
+     * Determines whether or not to generate source-code for a single
+     * function that evaluates both the original model and the sparse
+     * Jacobian.
+     *
+     * @return true if source-code for the combined function should be
+     *         created, false otherwise
+     */
+    inline bool isCreateForwardZeroSparseJacobian() const {
+        return _forwardZeroSparseJacobian;
+    }
+
+    /**
+     * Defines whether or not to generate source-code for a single
+     * function that evaluates both the original model and the sparse
+     * Jacobian (with the elements defined by
+     * setCustomSparseJacobianElements(), if provided).
+     * The Jacobian is determined from the same zero order forward sweep
+     * used for the model values, which is cheaper than evaluating them
+     * separately (e.g. in the iterations of Newton methods).
+     * Models with loops are not supported.
+     *
+     * @param create true if source-code for the combined function should
+     *               be created, false otherwise
+     */
+    inline void setCreateForwardZeroSparseJacobian(bool create) {
+        _forwardZeroSparseJacobian = create;
+    }
+
     /**
      * Determines whether or not the sparse Jacobian should reuse functions
      * generated for the forward one or reverse one pass.
@@ -811,6 +1017,181 @@ public:
         _maxAssignPerFunc = maxAssignPerFunc;
     }
 
+    /**
+     * Provides the compilation cost model used to determine where large
+     * functions are split.
+     *
+     * @return the cost model or nullptr if functions are only split
+     *         according to the maximum number of assignments
+     */
+    inline const FunctionSplitCostModel* getFunctionSplitCostModel() const {
+        return _funcSplitModel.get();
+    }
+
+    /**
+     * Defines a compilation cost model used to automatically determine
+     * where large functions are split.
+     * The maximum number of assignments per function remains an upper
+     * bound but functions are split where the estimated compilation time
+     * and the number of values passed between functions is minimal.
+     *
+     * @param model the cost model (a copy is saved) or nullptr to split
+     *              functions only based on the number of assignments
+     */
+    inline void setFunctionSplitCostModel(const FunctionSplitCostModel* model) {
+        if (model != nullptr)
+            _funcSplitModel.reset(new FunctionSplitCostModel(*model));
+        else
+            _funcSplitModel.reset();
+    }
+
+    /**
+     * Provides information on the functions created by splitting larger
+     * functions using the compilation cost model.
+     *
+     * @return maps the original function names to the information on
+     *         each created function
+     */
+    inline const std::map<std::string, std::vector<FunctionSplitInfo> >& getFunctionSplitReport() const {
+        return _funcSplitReport;
+    }
+
+    /**
+     * Provides the algebraic simplifications applied to the operation
+     * graphs before the source code is generated.
+     *
+     * @return the simplifier or nullptr if no rewrites are performed
+     */
+    inline const GraphSimplifier<Base>* getGraphSimplifier() const {
+        return _graphSimplifier.get();
+    }
+
+    /**
+     * Defines algebraic simplifications and strength reductions
+     * (e.g. pow() lowering, fused multiply-add) which are applied to the
+     * operation graphs of all generated functions.
+     * The floating point strictness of the simplifier determines how much
+     * the results can differ from the original operations.
+     *
+     * @param simplifier the simplifier (a copy is saved) or nullptr to
+     *                   disable rewrites
+     */
+    inline void setGraphSimplifier(const GraphSimplifier<Base>* simplifier) {
+        if (simplifier != nullptr)
+            _graphSimplifier.reset(new GraphSimplifier<Base>(*simplifier));
+        else
+            _graphSimplifier.reset();
+    }
+
+    inline bool isVectorizeLoops() const {
+        return _vectorizeLoops;
+    }
+
+    /**
+     * Defines whether or not loops whose iterations are independent are
+     * marked with <tt>#pragma omp simd</tt> and use iteration private
+     * temporary variables so that they can be vectorized by the compiler
+     * (the compiler must be called with e.g. <tt>-fopenmp-simd</tt>).
+     * This only affects models with loops (see setRelatedDependents()).
+     *
+     * @param vectorize whether or not to vectorize loops
+     */
+    inline void setVectorizeLoops(bool vectorize) {
+        _vectorizeLoops = vectorize;
+    }
+
+    inline bool isPackLoopArrays() const {
+        return _packLoopArrays;
+    }
+
+    /**
+     * Defines whether or not the independent and dependent values used
+     * with strided index patterns inside vectorized loops (see
+     * setVectorizeLoops()) are copied into contiguous per-iteration arrays
+     * (structure of arrays) so that the loop body only uses unit-stride
+     * accesses.
+     *
+     * @param pack whether or not to pack loop arrays
+     */
+    inline void setPackLoopArrays(bool pack) {
+        _packLoopArrays = pack;
+    }
+
+    inline bool isConstantPool() const {
+        return _constantPool != nullptr;
+    }
+
+    /**
+     * Defines whether or not the constants which are used several times
+     * in the generated functions of this model are read from a table of
+     * unique values shared by all those functions (the array
+     * <tt>NAME_constants</tt> defined in its own source file) instead of
+     * being printed as literals.
+     * The uses of each constant are counted in all the functions before
+     * the table is created, so the table does not depend on the order in
+     * which the functions are generated (e.g. in parallel, see
+     * setSourceGenerationThreads()).
+     *
+     * @param use whether or not to use a table of constants
+     * @param minUses constants used fewer times than this in all the
+     *                functions are printed as literals
+     * @param maxInlineLength constants whose literal has at most this
+     *                        number of characters are always printed as
+     *                        literals
+     */
+    inline void setConstantPool(bool use,
+                                size_t minUses = 2,
+                                size_t maxInlineLength = 4) {
+        if (use) {
+            _constantPool.reset(new LangCConstantPool<Base>(_name + "_constants", minUses, maxInlineLength));
+        } else {
+            _constantPool.reset();
+        }
+    }
+
+    /**
+     * Provides the number of threads used to generate the source code of
+     * the second-order reverse mode.
+     *
+     * @return the number of threads (1 for sequential generation)
+     */
+    inline size_t getSourceGenerationThreads() const {
+        return _genThreads;
+    }
+
+    /**
+     * Defines the number of threads used to generate the source code of
+     * the second-order reverse mode (sparse reverse two).
+     * Each thread uses its own copy of the tape to create and optimize the
+     * operation graph and to print the source code of a subset of the
+     * independent variables.
+     * Unlike the sequential generation, which creates a single operation
+     * graph with all the Hessian elements for models without atomic
+     * functions, each function is then created from its own graph
+     * (a zero and first-order forward sweep along the direction of the
+     * independent variable followed by a second-order reverse sweep, as
+     * for models with atomic functions).
+     * Since the operations are not the same, the results can differ from
+     * the sequential version by rounding errors.
+     * The generated source code does not depend on the number of threads
+     * (when more than one is used).
+     *
+     * CppAD is temporarily set up for multiple threads during the source
+     * generation, therefore the tape must not be used simultaneously by
+     * other threads.
+     * The generation is always sequential for models with atomic
+     * functions or loops, or if CppAD is already configured for multiple
+     * threads by the user.
+     *
+     * @param nThreads the number of threads (0 uses the number of
+     *                 hardware threads)
+     */
+    inline void setSourceGenerationThreads(size_t nThreads) {
+        if (nThreads == 0)
+            nThreads = std::thread::hardware_concurrency();
+        _genThreads = std::max<size_t>(1, nThreads);
+    }
+
     inline virtual ~ModelCSourceGen() {
         delete _funNoLoops;
         delete _atomicsInfo;
@@ -843,14 +1224,48 @@ protected:
     virtual void generateSources(MultiThreadingType multiThreadingType,
                                  JobTimer* timer = nullptr);
 
+    /**
+     * Creates a fingerprint of everything which determines the generated
+     * sources: the operations in the tape (obtained from a zero order
+     * evaluation) and all the source generation options.
+     * It is much cheaper to determine than the sources themselves and
+     * it allows incremental builds of model libraries.
+     *
+     * @param multiThreadingType the multithreading type used by the
+     *                           library
+     * @return the fingerprint as hexadecimal digits
+     */
+    virtual std::string getSourcesFingerprint(MultiThreadingType multiThreadingType);
+
     virtual void generateLoops();
 
     virtual void generateInfoSource();
 
+    /**
+     * Creates the source file with the table of constants used by the
+     * other functions (see setConstantPool()) and replaces the references
+     * to the table in those functions.
+     * It must be called after all the other functions are generated.
+     */
+    virtual void generateConstantPoolSource();
+
     virtual void generateAtomicFuncNames();
 
     virtual bool isAtomicsUsed();
 
+    /**
+     * Defines the atomic functions used by sources which are not going to
+     * be generated again (e.g. when the object files from a previous build
+     * are reused).
+     *
+     * @param atomicFunctions the names of the atomic functions in the
+     *                        order used by the generated sources
+     */
+    inline void restoreAtomicFunctions(const std::vector<std::string>& atomicFunctions) {
+        _atomicFunctions = atomicFunctions;
+        _atomicFunctionsKnown = true;
+    }
+
     virtual const std::map<size_t, AtomicUseInfo<Base> >& getAtomicsInfo();
 
     /***********************************************************************
@@ -875,6 +1290,78 @@ protected:
 
     virtual void generateSparseJacobianSource(bool forward);
 
+    /**
+     * Generates the sparse Jacobian source.
+     *
+     * @param mode JacobianADMode::Forward, JacobianADMode::Reverse or
+     *             JacobianADMode::Bidirectional
+     */
+    virtual void generateSparseJacobianSource(JacobianADMode mode);
+
+    /**
+     * Determines the mode used to evaluate the sparse Jacobian.
+     *
+     * @return JacobianADMode::Forward, JacobianADMode::Reverse or
+     *         JacobianADMode::Bidirectional
+     */
+    virtual JacobianADMode getSparseJacobianADMode();
+
+    /**
+     * Creates the operation graph of the sparse Jacobian for each mode
+     * and selects the one with fewer operations.
+     *
+     * @return JacobianADMode::Forward, JacobianADMode::Reverse or
+     *         JacobianADMode::Bidirectional
+     */
+    virtual JacobianADMode determineCheapestSparseJacobianADMode();
+
+    /**
+     * Determines the number of operations required to evaluate the
+     * sparse Jacobian (after graph simplifications) without generating
+     * its source code.
+     *
+     * @param mode JacobianADMode::Forward, JacobianADMode::Reverse or
+     *             JacobianADMode::Bidirectional
+     */
+    virtual size_t countSparseJacobianOperations(JacobianADMode mode);
+
+    /**
+     * Determines which rows of the sparse Jacobian are evaluated with
+     * reverse mode sweeps (all the other elements use forward mode
+     * sweeps).
+     *
+     * @param mode JacobianADMode::Forward, JacobianADMode::Reverse or
+     *             JacobianADMode::Bidirectional
+     */
+    virtual std::set<size_t> determineReverseJacobianRows(JacobianADMode mode);
+
+    /**
+     * Provides the rows of the sparse Jacobian evaluated with reverse mode
+     * sweeps in the bidirectional mode (determined only once).
+     */
+    inline const std::set<size_t>& getBidirectionalReverseRows();
+
+    /**
+     * Selects the densest rows of the Jacobian for reverse mode sweeps so
+     * that the total number of sweeps is minimized.
+     * The number of sweeps is determined with the same compression used
+     * by sparseJacobianFromForwardZero(): the colors of the columns of the
+     * forward rows plus the colors of the reverse rows.
+     */
+    virtual std::set<size_t> determineBidirectionalReverseRows();
+
+    /**
+     * Creates the operation graph for the elements of the sparse Jacobian.
+     *
+     * @param handler the code handler which owns the independent variables
+     * @param indVars the independent variables
+     * @param mode JacobianADMode::Forward, JacobianADMode::Reverse or
+     *             JacobianADMode::Bidirectional
+     */
+    virtual std::vector<CGBase> prepareSparseJacobian(CodeHandler<Base>& handler,
+                                                      const std::vector<CGBase>& indVars,
+                                                      JacobianADMode mode);
+
     virtual void generateSparseJacobianForRevSource(bool forward,
                                                     MultiThreadingType multiThreadingType);
 
@@ -976,6 +1463,47 @@ protected:
 
     virtual void generateSparseHessianSourceDirectly();
 
+    /***********************************************************************
+     * Combined functions
+     **********************************************************************/
+
+    virtual void generateForwardZeroSparseJacobianSource();
+
+    virtual void generateLagrangianSparseHessianSource();
+
+    /**
+     * Determines the sparse Jacobian elements from the zero order
+     * Taylor coefficients already computed in the tape (colored first
+     * order forward and reverse sweeps).
+     *
+     * @param reverseRows the rows evaluated with reverse mode sweeps
+     */
+    virtual std::vector<CGBase> sparseJacobianFromForwardZero(const std::set<size_t>& reverseRows);
+
+    /**
+     * Determines the gradient of the Lagrangian and the sparse Hessian
+     * elements from the zero order Taylor coefficients already computed
+     * in the tape (colored first order forward and second order reverse
+     * sweeps).
+     */
+    virtual void sparseHessianFromForwardZero(const std::vector<CGBase>& w,
+                                              std::vector<CGBase>& grad,
+                                              std::vector<CGBase>& hess);
+
+    /**
+     * Colors the columns of a sparsity pattern so that columns with the
+     * same color do not share any row (greedy coloring).
+     *
+     * @param rowSparsity the columns of each row
+     * @param nCols the number of columns
+     * @param cols the columns which must be colored (the others get the
+     *             color nCols)
+     * @return the color of each column
+     */
+    static std::vector<size_t> colorColumns(const SparsitySetType& rowSparsity,
+                                            size_t nCols,
+                                            const std::set<size_t>& cols);
+
     virtual void generateSparseHessianSourceFromRev2(MultiThreadingType multiThreadingType);
 
     virtual std::string generateSparseHessianRev2SingleThreadSource(const std::string& functionName,
@@ -1126,6 +1654,23 @@ protected:
                                                           const std::vector<size_t>& evalRows,
                                                           const std::vector<size_t>& evalCols);
 
+    virtual void generateSparseReverseTwoSourcesParallel(const std::map<size_t, std::vector<size_t> >& elements,
+                                                         size_t nThreads);
+
+    /**
+     * Generates the source code of the sparse reverse two function for a
+     * single independent variable using a new operation graph.
+     * It does not modify the state of this object and it can be called
+     * concurrently with different tapes and output containers.
+     */
+    virtual void generateSparseReverseTwoSource(ADFun<CGBase>& fun,
+                                                size_t j,
+                                                const std::vector<size_t>& cols,
+                                                std::map<std::string, std::string>& sources,
+                                                std::map<std::string, std::vector<FunctionSplitInfo> >& funcSplitReport,
+                                                std::vector<std::string>& atomicFunctions,
+                                                JobTimer* jobTimer);
+
     virtual void generateReverseTwoSources();
 
     virtual void generateGlobalDirectionalFunctionSource(const std::string& function,
@@ -1197,6 +1742,111 @@ protected:
     static void printFileStartPThreads(std::ostringstream& cache,
                                        const std::string& baseTypeName);
 
+    /**
+     * Prints the declarations at the beginning of a generated source file
+     * (see LanguageC::printFileStart()) or the include of the shared
+     * header when one is used (see setSharedHeader()).
+     *
+     * @param cache the output stream
+     * @param multiThreadingType the type of multithreading used by the
+     *                           functions in the file
+     */
+    inline void printFileStart(std::ostringstream& cache,
+                               MultiThreadingType multiThreadingType = MultiThreadingType::NONE) const;
+
+    /**
+     * Defines a header with the declarations common to all generated
+     * source files which is included instead of those declarations.
+     * It must be defined before the sources are generated.
+     *
+     * @param fileName the header file name (empty if not used)
+     * @throws CGException if the sources were already generated with a
+     *                     different header
+     */
+    inline void setSharedHeader(const std::string& fileName) {
+        if (fileName != _sharedHeader && !_sources.empty()) {
+            throw CGException("The sources of model '", _name, "' were already generated ",
+                              (_sharedHeader.empty() ? "without" : "with"), " a shared header");
+        }
+        _sharedHeader = fileName;
+    }
+
+    /**
+     * The structure with the arguments of the functions executed by the
+     * pthread pool
+     */
+    static std::string pthreadsExecArgDefinition(const std::string& baseTypeName);
+
+    /**
+     * The function executed by the pthread pool (without the storage-class
+     * specifier)
+     */
+    static const std::string& pthreadsExecFunctionDefinition();
+
+    /**
+     * Groups the rows/columns of the multithreaded sparse Jacobian or
+     * sparse Hessian into jobs.
+     *
+     * @param info the elements evaluated by each row/column
+     * @param profileFunction the name of the function which evaluates a
+     *                        row/column (the key in the job profile)
+     * @param jobElapsed the expected elapsed time of each job (zero if
+     *                   there is no profile)
+     * @return the rows/columns of each job
+     */
+    virtual std::vector<std::vector<size_t> > determineParallelJobs(const std::map<size_t, CompressedVectorInfo>& info,
+                                                                    const std::string& profileFunction,
+                                                                    std::vector<float>& jobElapsed) const;
+
+    /**
+     * Prints the functions which evaluate several rows/columns in a single
+     * job and defines the function called by each job.
+     *
+     * @param functionName the name of the multithreaded function
+     * @param info the elements evaluated by each row/column
+     * @param keyFunction the prefix of the functions which evaluate a
+     *                    row/column
+     * @param jobs the rows/columns of each job
+     * @param jobFunctions the function called by each job
+     * @param jobOffsets the position in the output array provided to each
+     *                   job
+     */
+    virtual void printParallelJobFunctions(std::ostringstream& cache,
+                                           const std::string& functionName,
+                                           const std::map<size_t, CompressedVectorInfo>& info,
+                                           const std::string& keyFunction,
+                                           const std::vector<std::vector<size_t> >& jobs,
+                                           std::vector<std::string>& jobFunctions,
+                                           std::vector<size_t>& jobOffsets);
+
+    /**
+     * Prints the static arrays with the job functions and output offsets
+     * (p and offset).
+     */
+    static void printParallelJobArrays(std::ostringstream& cache,
+                                       const std::vector<std::string>& jobFunctions,
+                                       const std::vector<size_t>& jobOffsets);
+
+    /**
+     * Prints the file-scope state used to measure and order the jobs of a
+     * function, and a function which exports the measured times
+     * (see GenericModel::getThreadPoolJobProfile()).
+     *
+     * @param functionName the name of the multithreaded function
+     * @param profileFunction the name of the function which evaluates a
+     *                        row/column
+     * @param jobs the rows/columns of each job
+     * @param jobElapsed the initial reference time of each job
+     * @param multiThreadingType the state of the pthread pool also
+     *                           includes the job to thread mapping
+     */
+    static void printJobState(std::ostringstream& cache,
+                              const std::string& functionName,
+                              const std::string& profileFunction,
+                              const std::vector<std::vector<size_t> >& jobs,
+                              const std::vector<float>& jobElapsed,
+                              MultiThreadingType multiThreadingType);
+
     static void printFunctionStartPThreads(std::ostringstream& cache,
                                            size_t size);
 
@@ -1208,11 +1858,53 @@ protected:
     static void printFunctionStartOpenMP(std::ostringstream& cache,
                                          size_t size);
 
-    static void printLoopStartOpenMP(std::ostringstream& cache,
-                                     size_t size);
+    /**
+     * Prints the execution of the jobs with OpenMP.
+     * Jobs are started by decreasing measured time. They become tasks of
+     * the current team when the function is called inside a parallel
+     * region, otherwise a new parallel region is created according to the
+     * scheduling strategy.
+     *
+     * @param jobBody the evaluation of job i (without indentation)
+     *                which uses the private variables i and outLocal
+     */
+    static void printParallelLoopOpenMP(std::ostringstream& cache,
+                                        size_t size,
+                                        const std::string& jobBody);
 
-    static void printLoopEndOpenMP(std::ostringstream& cache,
-                                   size_t size);
+    /**
+     * Applies the model options to the language used to generate the
+     * source code of a model function (function splitting, vectorization,
+     * constant pool, direct atomic calls and parameter precision).
+     *
+     * @param langC the language
+     * @param sources where the additional functions created by splitting
+     *                are saved
+     * @param funcSplitReport where the function splitting decisions are
+     *                        saved
+     */
+    inline void configureLanguage(LanguageC<Base>& langC,
+                                  std::map<std::string, std::string>& sources,
+                                  std::map<std::string, std::vector<FunctionSplitInfo> >& funcSplitReport);
+
+    inline void configureLanguage(LanguageC<Base>& langC) {
+        configureLanguage(langC, _sources, _funcSplitReport);
+    }
+
+    /**
+     * Applies the model options to the code handler used to create the
+     * operation graph of a model function.
+     *
+     * @param handler the code handler
+     * @param jobTimer the timer used to report the progress (it can be
+     *                 null)
+     */
+    inline void configureHandler(CodeHandler<Base>& handler,
+                                 JobTimer* jobTimer);
+
+    inline void configureHandler(CodeHandler<Base>& handler) {
+        configureHandler(handler, _jobTimer);
+    }
 
     /**
      * 
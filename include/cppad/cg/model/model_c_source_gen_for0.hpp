@@ -25,7 +25,7 @@ void ModelCSourceGen<Base>::generateZeroSource() {
     startingJob("'" + jobName + "'", JobTimer::GRAPH);
 
     CodeHandler<Base> handler;
-    handler.setJobTimer(_jobTimer);
+    configureHandler(handler);
 
     std::vector<CGBase> indVars(_fun.Domain());
     handler.makeVariables(indVars);
@@ -49,8 +49,7 @@ void ModelCSourceGen<Base>::generateZeroSource() {
     finishedJob();
 
     LanguageC<Base> langC(_baseTypeName);
-    langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-    langC.setParameterPrecision(_parameterPrecision);
+    configureLanguage(langC);
     langC.setGenerateFunction(_name + "_" + FUNCTION_FORWAD_ZERO);
 
     std::ostringstream code;
@@ -83,7 +83,7 @@ void ModelCSourceGen<Base>::generateSparseForwardOneSourcesWithAtomics(const std
         startingJob("'" + subJobName + "'", JobTimer::GRAPH);
 
         CodeHandler<Base> handler;
-        handler.setJobTimer(_jobTimer);
+        configureHandler(handler);
 
         vector<CGBase> indVars(n);
         handler.makeVariables(indVars);
@@ -114,8 +114,7 @@ void ModelCSourceGen<Base>::generateSparseForwardOneSourcesWithAtomics(const std
         finishedJob();
 
         LanguageC<Base> langC(_baseTypeName);
-        langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-        langC.setParameterPrecision(_parameterPrecision);
+        configureLanguage(langC);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_FORWARD_ONE << "_indep" << j;
         langC.setGenerateFunction(_cache.str());
@@ -138,7 +137,7 @@ void ModelCSourceGen<Base>::generateSparseForwardOneSourcesNoAtomics(const std::
     size_t n = _fun.Domain();
 
     CodeHandler<Base> handler;
-    handler.setJobTimer(_jobTimer);
+    configureHandler(handler);
 
     vector<CGBase> x(n);
     handler.makeVariables(x);
@@ -200,8 +199,7 @@ void ModelCSourceGen<Base>::generateSparseForwardOneSourcesNoAtomics(const std::
         const std::string subJobName = _cache.str();
 
         LanguageC<Base> langC(_baseTypeName);
-        langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-        langC.setParameterPrecision(_parameterPrecision);
+        configureLanguage(langC);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_FORWARD_ONE << "_indep" << j;
         langC.setGenerateFunction(_cache.str());
@@ -229,10 +227,8 @@ void ModelCSourceGen<Base>::generateForwardOneSources() {
     std::string args = langC.generateDefaultFunctionArguments();
 
     _cache.str("");
-    _cache << "#include <stdlib.h>\n"
-            << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n"
-            "\n"
-            "int " << _name << "_" << FUNCTION_SPARSE_FORWARD_ONE << "(unsigned long pos, " << argsDcl << ");\n"
+    printFileStart(_cache);
+    _cache << "int " << _name << "_" << FUNCTION_SPARSE_FORWARD_ONE << "(unsigned long pos, " << argsDcl << ");\n"
             "void " << _name << "_" << FUNCTION_FORWARD_ONE_SPARSITY << "(unsigned long pos, unsigned long const** elements, unsigned long* nnz);\n"
             "\n";
     LanguageC<Base>::printFunctionDeclaration(_cache, "int", model_function, {_baseTypeName + " const tx[]",
@@ -0,0 +1,304 @@
+#ifndef CPPAD_CG_MODEL_C_SOURCE_GEN_FUSED_INCLUDED
+#define CPPAD_CG_MODEL_C_SOURCE_GEN_FUSED_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+template<class Base>
+void ModelCSourceGen<Base>::generateForwardZeroSparseJacobianSource() {
+    using std::vector;
+
+    CPPADCG_ASSERT_KNOWN(_loopTapes.empty(),
+                         "The combined model and sparse Jacobian function is not available for models with loops");
+
+    const std::string jobName = "model and sparse Jacobian";
+
+    size_t m = _fun.Range();
+    size_t n = _fun.Domain();
+
+    determineJacobianSparsity();
+    std::set<size_t> reverseRows = determineReverseJacobianRows(getSparseJacobianADMode());
+
+    startingJob("'" + jobName + "'", JobTimer::GRAPH);
+
+    CodeHandler<Base> handler;
+    configureHandler(handler);
+
+    vector<CGBase> indVars(n);
+    handler.makeVariables(indVars);
+    if (_x.size() > 0) {
+        for (size_t i = 0; i < n; i++) {
+            indVars[i].setValue(_x[i]);
+        }
+    }
+
+    // the Jacobian uses the same zero order values
+    vector<CGBase> dep = _fun.Forward(0, indVars);
+    vector<CGBase> jac = sparseJacobianFromForwardZero(reverseRows);
+
+    finishedJob();
+
+    vector<CGBase> out;
+    out.reserve(m + jac.size());
+    out.insert(out.end(), dep.begin(), dep.end());
+    out.insert(out.end(), jac.begin(), jac.end());
+
+    LanguageC<Base> langC(_baseTypeName);
+    configureLanguage(langC);
+    langC.setGenerateFunction(_name + "_" + FUNCTION_FORWARD_ZERO_SPARSE_JACOBIAN);
+
+    std::ostringstream code;
+    LangCMultiDepVariableNameGenerator<Base> nameGen({"y", "jac"}, {m, jac.size()});
+
+    handler.generateCode(code, langC, out, nameGen, _atomicFunctions, jobName);
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::generateLagrangianSparseHessianSource() {
+    using std::vector;
+
+    CPPADCG_ASSERT_KNOWN(_loopTapes.empty(),
+                         "The combined Lagrangian and sparse Hessian function is not available for models with loops");
+
+    const std::string jobName = "Lagrangian and sparse Hessian";
+
+    size_t m = _fun.Range();
+    size_t n = _fun.Domain();
+
+    determineHessianSparsity();
+
+    startingJob("'" + jobName + "'", JobTimer::GRAPH);
+
+    CodeHandler<Base> handler;
+    configureHandler(handler);
+
+    // independent variables
+    vector<CGBase> indVars(n);
+    handler.makeVariables(indVars);
+    if (_x.size() > 0) {
+        for (size_t i = 0; i < n; i++) {
+            indVars[i].setValue(_x[i]);
+        }
+    }
+
+    // multipliers
+    vector<CGBase> w(m);
+    handler.makeVariables(w);
+    if (_x.size() > 0) {
+        for (size_t i = 0; i < m; i++) {
+            w[i].setValue(Base(1.0));
+        }
+    }
+
+    vector<CGBase> y = _fun.Forward(0, indVars);
+
+    CGBase lag = Base(0);
+    for (size_t i = 0; i < m; i++) {
+        lag += w[i] * y[i];
+    }
+
+    vector<CGBase> grad, hess;
+    sparseHessianFromForwardZero(w, grad, hess);
+
+    finishedJob();
+
+    vector<CGBase> out;
+    out.reserve(1 + n + hess.size());
+    out.push_back(lag);
+    out.insert(out.end(), grad.begin(), grad.end());
+    out.insert(out.end(), hess.begin(), hess.end());
+
+    LanguageC<Base> langC(_baseTypeName);
+    configureLanguage(langC);
+    langC.setGenerateFunction(_name + "_" + FUNCTION_LAGRANGIAN_SPARSE_HESSIAN);
+
+    std::ostringstream code;
+    LangCMultiDepVariableNameGenerator<Base> nameGen({"lag", "grad", "hess"}, {1, n, hess.size()});
+    LangCDefaultHessianVarNameGenerator<Base> nameGenHess(&nameGen, n);
+
+    handler.generateCode(code, langC, out, nameGenHess, _atomicFunctions, jobName);
+}
+
+template<class Base>
+std::vector<CG<Base> > ModelCSourceGen<Base>::sparseJacobianFromForwardZero(const std::set<size_t>& reverseRows) {
+    using std::vector;
+
+    size_t m = _fun.Range();
+    size_t n = _fun.Domain();
+
+    const SparsitySetType& sparsity = _jacSparsity.sparsity;
+    const vector<size_t>& rows = _jacSparsity.rows;
+    const vector<size_t>& cols = _jacSparsity.cols;
+
+    // elements not in the sparsity pattern are always zero
+    vector<CGBase> jac(rows.size(), CGBase(Base(0)));
+
+    /**
+     * split the requested non-zero elements
+     */
+    SparsitySetType forSparsity(m); // columns of the rows using the forward mode
+    SparsitySetType revSparsity(n); // rows of the columns using the reverse mode
+    std::set<size_t> forCols;
+    vector<size_t> forEls, revEls;
+    for (size_t e = 0; e < rows.size(); e++) {
+        size_t i = rows[e];
+        size_t j = cols[e];
+        if (sparsity[i].find(j) == sparsity[i].end())
+            continue;
+
+        if (reverseRows.find(i) != reverseRows.end()) {
+            revSparsity[j].insert(i);
+            revEls.push_back(e);
+        } else {
+            forSparsity[i].insert(j);
+            forCols.insert(j);
+            forEls.push_back(e);
+        }
+    }
+
+    /**
+     * forward mode (column compression)
+     */
+    if (!forEls.empty()) {
+        vector<size_t> color = colorColumns(forSparsity, n, forCols);
+
+        std::map<size_t, vector<size_t> > colorCols, colorEls;
+        for (size_t j : forCols)
+            colorCols[color[j]].push_back(j);
+        for (size_t e : forEls)
+            colorEls[color[cols[e]]].push_back(e);
+
+        vector<CGBase> dx(n);
+        for (const auto& it : colorEls) {
+            std::fill(dx.begin(), dx.end(), CGBase(Base(0)));
+            for (size_t j : colorCols[it.first])
+                dx[j] = Base(1);
+
+            vector<CGBase> dy = _fun.Forward(1, dx);
+            for (size_t e : it.second)
+                jac[e] = dy[rows[e]];
+        }
+    }
+
+    /**
+     * reverse mode (row compression)
+     */
+    if (!revEls.empty()) {
+        std::set<size_t> revRows;
+        for (size_t e : revEls)
+            revRows.insert(rows[e]);
+
+        vector<size_t> color = colorColumns(revSparsity, m, revRows);
+
+        std::map<size_t, vector<size_t> > colorRows, colorEls;
+        for (size_t i : revRows)
+            colorRows[color[i]].push_back(i);
+        for (size_t e : revEls)
+            colorEls[color[rows[e]]].push_back(e);
+
+        vector<CGBase> w(m);
+        for (const auto& it : colorEls) {
+            std::fill(w.begin(), w.end(), CGBase(Base(0)));
+            for (size_t i : colorRows[it.first])
+                w[i] = Base(1);
+
+            vector<CGBase> dw = _fun.Reverse(1, w);
+            for (size_t e : it.second)
+                jac[e] = dw[cols[e]];
+        }
+    }
+
+    return jac;
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::sparseHessianFromForwardZero(const std::vector<CGBase>& w,
+                                                          std::vector<CGBase>& grad,
+                                                          std::vector<CGBase>& hess) {
+    using std::vector;
+
+    size_t n = _fun.Domain();
+
+    const SparsitySetType& sparsity = _hessSparsity.sparsity; // symmetric
+    const vector<size_t>& rows = _hessSparsity.rows;
+    const vector<size_t>& cols = _hessSparsity.cols;
+
+    // only uses the zero order values
+    grad = _fun.Reverse(1, w);
+
+    // elements not in the sparsity pattern are always zero
+    hess.assign(rows.size(), CGBase(Base(0)));
+
+    std::set<size_t> usedCols(cols.begin(), cols.end());
+    vector<size_t> color = colorColumns(sparsity, n, usedCols);
+
+    std::map<size_t, vector<size_t> > colorCols, colorEls;
+    for (size_t j : usedCols)
+        colorCols[color[j]].push_back(j);
+    for (size_t e = 0; e < rows.size(); e++) {
+        if (sparsity[rows[e]].find(cols[e]) != sparsity[rows[e]].end())
+            colorEls[color[cols[e]]].push_back(e);
+    }
+
+    vector<CGBase> dx(n);
+    for (const auto& it : colorEls) {
+        std::fill(dx.begin(), dx.end(), CGBase(Base(0)));
+        for (size_t j : colorCols[it.first])
+            dx[j] = Base(1);
+
+        _fun.Forward(1, dx);
+        // derivative of w^T * F'(x) * dx
+        vector<CGBase> ddw = _fun.Reverse(2, w);
+        for (size_t e : it.second)
+            hess[e] = ddw[rows[e] * 2 + 1];
+    }
+}
+
+template<class Base>
+std::vector<size_t> ModelCSourceGen<Base>::colorColumns(const SparsitySetType& rowSparsity,
+                                                        size_t nCols,
+                                                        const std::set<size_t>& cols) {
+    std::vector<std::vector<size_t> > colRows(nCols);
+    for (size_t i = 0; i < rowSparsity.size(); i++) {
+        for (size_t j : rowSparsity[i])
+            colRows[j].push_back(i);
+    }
+
+    std::vector<size_t> color(nCols, nCols);
+    std::vector<size_t> forbidden(nCols, nCols); // the last column which cannot use each color
+
+    for (size_t j : cols) {
+        for (size_t i : colRows[j]) {
+            for (size_t k : rowSparsity[i]) {
+                if (color[k] < nCols)
+                    forbidden[color[k]] = j;
+            }
+        }
+
+        size_t c = 0;
+        while (forbidden[c] == j)
+            c++;
+        color[j] = c;
+    }
+
+    return color;
+}
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
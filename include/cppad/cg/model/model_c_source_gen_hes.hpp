@@ -27,7 +27,7 @@ void ModelCSourceGen<Base>::generateHessianSource() {
     startingJob("'" + jobName + "'", JobTimer::GRAPH);
 
     CodeHandler<Base> handler;
-    handler.setJobTimer(_jobTimer);
+    configureHandler(handler);
 
     size_t m = _fun.Range();
     size_t n = _fun.Domain();
@@ -63,8 +63,7 @@ void ModelCSourceGen<Base>::generateHessianSource() {
     finishedJob();
 
     LanguageC<Base> langC(_baseTypeName);
-    langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-    langC.setParameterPrecision(_parameterPrecision);
+    configureLanguage(langC);
     langC.setGenerateFunction(_name + "_" + FUNCTION_HESSIAN);
 
     std::ostringstream code;
@@ -160,7 +159,7 @@ void ModelCSourceGen<Base>::generateSparseHessianSourceDirectly() {
     startingJob("'" + jobName + "'", JobTimer::GRAPH);
 
     CodeHandler<Base> handler;
-    handler.setJobTimer(_jobTimer);
+    configureHandler(handler);
 
     // independent variables
     vector<CGBase> indVars(n);
@@ -210,8 +209,7 @@ void ModelCSourceGen<Base>::generateSparseHessianSourceDirectly() {
     finishedJob();
 
     LanguageC<Base> langC(_baseTypeName);
-    langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-    langC.setParameterPrecision(_parameterPrecision);
+    configureLanguage(langC);
     langC.setGenerateFunction(_name + "_" + FUNCTION_SPARSE_HESSIAN);
 
     std::ostringstream code;
@@ -310,8 +308,7 @@ std::string ModelCSourceGen<Base>::generateSparseHessianRev2SingleThreadSource(c
     std::vector<std::string> argsDcl2 = langC.generateDefaultFunctionArgumentsDcl2();
 
     _cache.str("");
-    _cache << "#include <stdlib.h>\n"
-            << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+    printFileStart(_cache);
     generateFunctionDeclarationSource(_cache, functionRev2, rev2Suffix, hessInfo, argsDcl);
     _cache << "\n";
     LanguageC<Base>::printFunctionDeclaration(_cache, "void", functionName, argsDcl2);
@@ -383,8 +380,7 @@ std::string ModelCSourceGen<Base>::generateSparseHessianRev2MultiThreadSource(co
     std::vector<std::string> argsDcl2 = langC.generateDefaultFunctionArgumentsDcl2();
 
     _cache.str("");
-    _cache << "#include <stdlib.h>\n"
-           << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+    printFileStart(_cache, multiThreadingType);
     generateFunctionDeclarationSource(_cache, functionRev2, rev2Suffix, hessInfo, argsDcl);
 
 
@@ -430,51 +426,26 @@ std::string ModelCSourceGen<Base>::generateSparseHessianRev2MultiThreadSource(co
         _cache << "}\n";
     }
 
-    _cache << "\n"
-            "typedef void (*cppadcg_function_type) (" << argsDcl << ");\n";
+    /**
+     * Group the rows into jobs
+     */
+    std::vector<float> jobElapsed;
+    std::vector<std::vector<size_t> > jobs = determineParallelJobs(hessInfo, FUNCTION_SPARSE_REVERSE_TWO, jobElapsed);
+    size_t nJobs = jobs.size();
 
+    std::vector<std::string> jobFunctions;
+    std::vector<size_t> jobOffsets;
+    printParallelJobFunctions(_cache, functionName, hessInfo, functionRev2 + "_" + rev2Suffix, jobs, jobFunctions, jobOffsets);
 
-    if (multiThreadingType == MultiThreadingType::OPENMP) {
-        _cache << "\n";
-        printFileStartOpenMP(_cache);
-        _cache << "\n";
-
-    } else {
-        /**
-         * PThreads pool needs a function with a void pointer argument
-         */
-        assert(multiThreadingType == MultiThreadingType::PTHREADS);
-
-        printFileStartPThreads(_cache, _baseTypeName);
-    }
+    printJobState(_cache, functionName, FUNCTION_SPARSE_REVERSE_TWO, jobs, jobElapsed, multiThreadingType);
 
     /**
      * Hessian function
      */
     _cache << "\n"
-            "void " << functionName << "(" << argsDcl << ") {\n"
-            "   static const cppadcg_function_type p[" << hessInfo.size() << "] = {";
-    for (const auto& it : hessInfo) {
-        size_t index = it.first;
-        if (index != hessInfo.begin()->first) _cache << ", ";
-        if (it.second.ordered) {
-            _cache << functionRev2 << "_" << rev2Suffix << index;
-        } else {
-            _cache << functionRev2 << "_" << rev2Suffix << index << "_wrap";
-        }
-    }
-    _cache << "};\n"
-            "   static const long offset["<< hessInfo.size() <<"] = {";
-    for (const auto& it : hessInfo) {
-        if (it.first != hessInfo.begin()->first) _cache << ", ";
-        if (it.second.ordered) {
-            _cache << *it.second.locations[0].begin();
-        } else {
-            _cache << "0";
-        }
-    }
-    _cache << "};\n"
-            "   " << _baseTypeName << " inLocal1 = 1;\n"
+            "void " << functionName << "(" << argsDcl << ") {\n";
+    printParallelJobArrays(_cache, jobFunctions, jobOffsets);
+    _cache << "   " << _baseTypeName << " inLocal1 = 1;\n"
             "   " << _baseTypeName << " const * inLocal[3] = {in[0], &inLocal1, in[1]};\n"
             "   " << _baseTypeName << " * outLocal[1];\n";
     _cache << "   " << _baseTypeName << " * hess = out[0];\n"
@@ -482,20 +453,19 @@ std::string ModelCSourceGen<Base>::generateSparseHessianRev2MultiThreadSource(co
             "\n";
 
     if(multiThreadingType == MultiThreadingType::OPENMP) {
-        printFunctionStartOpenMP(_cache, hessInfo.size());
+        printFunctionStartOpenMP(_cache, nJobs);
         _cache << "\n";
-        printLoopStartOpenMP(_cache, hessInfo.size());
-        _cache << "      outLocal[0] = &hess[offset[i]];\n"
-                "      (*p[i])(" << argsLocal << ");\n";
-        printLoopEndOpenMP(_cache, hessInfo.size());
+        printParallelLoopOpenMP(_cache, nJobs,
+                                "outLocal[0] = &hess[offset[i]];\n"
+                                "(*p[i])(" + argsLocal + ");\n");
         _cache << "\n";
 
     } else {
         assert(multiThreadingType == MultiThreadingType::PTHREADS);
 
-        printFunctionStartPThreads(_cache, hessInfo.size());
+        printFunctionStartPThreads(_cache, nJobs);
         _cache << "\n"
-                "   for(i = 0; i < " << hessInfo.size() << "; ++i) {\n"
+                "   for(i = 0; i < " << nJobs << "; ++i) {\n"
                 "      args[i] = (ExecArgStruct*) malloc(sizeof(ExecArgStruct));\n"
                 "      args[i]->func = p[i];\n"
                 "      args[i]->in = inLocal;\n"
@@ -503,7 +473,7 @@ std::string ModelCSourceGen<Base>::generateSparseHessianRev2MultiThreadSource(co
                 "      args[i]->atomicFun = " << langC .getArgumentAtomic() << ";\n"
                 "   }\n"
                 "\n";
-        printFunctionEndPThreads(_cache, hessInfo.size());
+        printFunctionEndPThreads(_cache, nJobs);
     }
 
     _cache << "\n"
@@ -547,14 +517,31 @@ void ModelCSourceGen<Base>::determineHessianSparsity() {
     size_t m = _fun.Range();
     size_t n = _fun.Domain();
 
+    std::set<size_t> customVarsInHess;
+    if (_custom_hess.defined) {
+        customVarsInHess.insert(_custom_hess.row.begin(), _custom_hess.row.end());
+        customVarsInHess.insert(_custom_hess.col.begin(), _custom_hess.col.end());
+    }
+
     /**
-     * sparsity for the sum of the hessians of all equations
+     * sparsity for the hessian of each equation
+     * (only the non-empty rows are kept since a complete sparsity pattern
+     *  per equation would require m * n sets)
      */
-    SparsitySetType r(n); // identity matrix
-    for (size_t j = 0; j < n; j++)
-        r[j].insert(j);
-    SparsitySetType jac = _fun.ForSparseJac(n, r);
+    std::vector<std::map<size_t, std::set<size_t> > > eqSparsities;
+    if (_hessianByEquation || _reverseTwo) {
+        eqSparsities = hessianSparsityByEquation(_fun, customVarsInHess);
+    } else {
+        SparsitySetType r(n); // identity matrix
+        for (size_t j = 0; j < n; j++)
+            r[j].insert(j);
+        _fun.ForSparseJac(n, r);
+    }
 
+    /**
+     * sparsity for the sum of the hessians of all equations
+     * (reuses the forward Jacobian sparsity sweep above)
+     */
     SparsitySetType s(1);
     for (size_t i = 0; i < m; i++) {
         s[0].insert(i);
@@ -563,81 +550,26 @@ void ModelCSourceGen<Base>::determineHessianSparsity() {
     //printSparsityPattern(_hessSparsity.sparsity, "hessian");
 
     if (_hessianByEquation || _reverseTwo) {
-        /**
-         * sparsity for the hessian of each equations
-         */
-
-        std::set<size_t> customVarsInHess;
-        if (_custom_hess.defined) {
-            customVarsInHess.insert(_custom_hess.row.begin(), _custom_hess.row.end());
-            customVarsInHess.insert(_custom_hess.col.begin(), _custom_hess.col.end());
-
-            r = SparsitySetType(n); //clear r
-            for (size_t j : customVarsInHess) {
-                r[j].insert(j);
-            }
-            jac = _fun.ForSparseJac(n, r);
-        }
-
-        /**
-         * Coloring
-         */
-        const std::vector<Color> colors = colorByRow(customVarsInHess, jac);
-
-        /**
-         * For each individual equation
-         */
         _hessSparsities.resize(m);
-        for (size_t i = 0; i < m; i++) {
-            _hessSparsities[i].sparsity.resize(n);
-        }
-
-        for (size_t c = 0; c < colors.size(); c++) {
-            const Color& color = colors[c];
-
-            // first-order
-            r = SparsitySetType(n); //clear r
-            for (size_t j : color.forbiddenRows) {
-                r[j].insert(j);
-            }
-            _fun.ForSparseJac(n, r);
-
-            // second-order
-            s[0].clear();
-            const std::set<size_t>& equations = color.rows;
-            for (size_t i : equations) {
-                s[0].insert(i);
-            }
-
-            SparsitySetType sparsityc = _fun.RevSparseHes(n, s, false);
-
-            /**
-             * Retrieve the individual hessians for each equation
-             */
-            const std::map<size_t, size_t>& var2Eq = color.column2Row;
-            for (size_t j : color.forbiddenRows) { //used variables
-                if (sparsityc[j].size() > 0) {
-                    size_t i = var2Eq.at(j);
-                    _hessSparsities[i].sparsity[j].insert(sparsityc[j].begin(),
-                                                          sparsityc[j].end());
-                }
-            }
-
-        }
-
         for (size_t i = 0; i < m; i++) {
             LocalSparsityInfo& hessSparsitiesi = _hessSparsities[i];
+            const std::map<size_t, std::set<size_t> >& eqSparsity = eqSparsities[i];
 
             if (!_custom_hess.defined) {
-                generateSparsityIndexes(hessSparsitiesi.sparsity,
-                                        hessSparsitiesi.rows, hessSparsitiesi.cols);
+                for (const auto& itRow : eqSparsity) {
+                    for (size_t j2 : itRow.second) {
+                        hessSparsitiesi.rows.push_back(itRow.first);
+                        hessSparsitiesi.cols.push_back(j2);
+                    }
+                }
 
             } else {
                 size_t nnz = _custom_hess.row.size();
                 for (size_t e = 0; e < nnz; e++) {
                     size_t i1 = _custom_hess.row[e];
                     size_t i2 = _custom_hess.col[e];
-                    if (hessSparsitiesi.sparsity[i1].find(i2) != hessSparsitiesi.sparsity[i1].end()) {
+                    auto itRow = eqSparsity.find(i1);
+                    if (itRow != eqSparsity.end() && itRow->second.find(i2) != itRow->second.end()) {
                         hessSparsitiesi.rows.push_back(i1);
                         hessSparsitiesi.cols.push_back(i2);
                     }
@@ -45,6 +45,18 @@ const std::string ModelCSourceGen<Base>::FUNCTION_SPARSE_JACOBIAN = "sparse_jaco
 template<class Base>
 const std::string ModelCSourceGen<Base>::FUNCTION_SPARSE_HESSIAN = "sparse_hessian";
 
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_FORWARD_ZERO_SPARSE_JACOBIAN = "forward_zero_sparse_jacobian";
+
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_LAGRANGIAN_SPARSE_HESSIAN = "lagrangian_sparse_hessian";
+
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_SPARSE_JACOBIAN_JOBS = "sparse_jacobian_jobs";
+
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_SPARSE_HESSIAN_JOBS = "sparse_hessian_jobs";
+
 template<class Base>
 const std::string ModelCSourceGen<Base>::FUNCTION_JACOBIAN_SPARSITY = "jacobian_sparsity";
 
@@ -105,6 +117,10 @@ void ModelCSourceGen<Base>::generateSources(MultiThreadingType multiThreadingTyp
 
     generateLoops();
 
+    if (_constantPool != nullptr) {
+        _constantPool->clear();
+    }
+
     startingJob("'" + _name + "'", JobTimer::SOURCE_FOR_MODEL);
 
     if (_zero) {
@@ -143,19 +159,50 @@ void ModelCSourceGen<Base>::generateSources(MultiThreadingType multiThreadingTyp
         generateSparseHessianSource(multiThreadingType);
     }
 
-    if (_sparseJacobian || _forwardOne || _reverseOne) {
+    if (_forwardZeroSparseJacobian) {
+        generateForwardZeroSparseJacobianSource();
+    }
+
+    if (_lagrangianSparseHessian) {
+        generateLagrangianSparseHessianSource();
+    }
+
+    if (_sparseJacobian || _forwardOne || _reverseOne || _forwardZeroSparseJacobian) {
         generateJacobianSparsitySource();
     }
 
-    if (_sparseHessian || _reverseTwo) {
+    if (_sparseHessian || _reverseTwo || _lagrangianSparseHessian) {
         generateHessianSparsitySource();
     }
 
+    generateConstantPoolSource();
+
     generateInfoSource();
 
     generateAtomicFuncNames();
+    _atomicFunctionsKnown = true;
 
     finishedJob();
+
+    if (_jobTimer != nullptr && _jobTimer->isVerbose()) {
+        for (const auto& it : _funcSplitReport) {
+            const std::vector<FunctionSplitInfo>& splits = it.second;
+            if (splits.size() < 2)
+                continue;
+
+            double time = 0;
+            for (const FunctionSplitInfo& s : splits) {
+                time += s.compileTime;
+            }
+
+            std::cout << " " << it.first << ": " << splits.size() << " functions"
+                    << "  estimated compilation time: " << time << "s" << "  spilled:";
+            for (size_t f = 0; f + 1 < splits.size(); f++) {
+                std::cout << " " << splits[f].spilledOut;
+            }
+            std::cout << std::endl;
+        }
+    }
 }
 
 template<class Base>
@@ -167,7 +214,7 @@ void ModelCSourceGen<Base>::generateLoops() {
     startingJob("", JobTimer::LOOP_DETECTION);
 
     CodeHandler<Base> handler;
-    handler.setJobTimer(_jobTimer);
+    configureHandler(handler);
 
     std::vector<CGBase> xx(_fun.Domain());
     handler.makeVariables(xx);
@@ -189,6 +236,111 @@ void ModelCSourceGen<Base>::generateLoops() {
     }
 }
 
+template<class Base>
+std::string ModelCSourceGen<Base>::getSourcesFingerprint(MultiThreadingType multiThreadingType) {
+    BuildFingerprint fp;
+
+    auto printBase = [](const Base& v) {
+        std::ostringstream os;
+        os << std::setprecision(std::numeric_limits<Base>::max_digits10) << v;
+        return os.str();
+    };
+
+    /**
+     * the generator version (the generated code may change between versions)
+     */
+    fp << CPPAD_CG_VERSION;
+
+    /**
+     * options
+     */
+    fp << _name << _baseTypeName << _parameterPrecision;
+    fp << static_cast<int> (multiThreadingType) << _multiThreading;
+    fp << _zero << _jacobian << _hessian << _sparseJacobian << _sparseHessian << _hessianByEquation;
+    fp << _forwardZeroSparseJacobian << _lagrangianSparseHessian;
+    fp << _forwardOne << _reverseOne << _reverseTwo << _sparseJacobianReusesOne << _sparseHessianReusesRev2;
+    fp << static_cast<int> (_jacMode);
+    fp << _custom_jac.defined << _custom_jac.row << _custom_jac.col;
+    fp << _custom_hess.defined << _custom_hess.row << _custom_hess.col;
+    fp << _maxAssignPerFunc << _vectorizeLoops << _packLoopArrays << _directAtomicModels << _relatedDepCandidates;
+    fp << (_constantPool != nullptr);
+    if (_constantPool != nullptr)
+        fp << _constantPool->getMinUses() << _constantPool->getMaxInlineLength();
+    fp << _multiThreadingJobs;
+    for (const auto& it : _jobProfile.getFunctions()) {
+        fp << it.first << it.second.size();
+        for (const ThreadPoolJobProfile::Job& job : it.second)
+            fp << job.keys << static_cast<double> (job.elapsed);
+    }
+
+    fp << (_funcSplitModel != nullptr);
+    if (_funcSplitModel != nullptr) {
+        fp << _funcSplitModel->getPerFunction() << _funcSplitModel->getPerAssignment()
+                << _funcSplitModel->getExponent() << _funcSplitModel->getSpillWeight();
+    }
+
+    fp << (_graphSimplifier != nullptr);
+    if (_graphSimplifier != nullptr) {
+        fp << static_cast<int> (_graphSimplifier->getFloatingPointStrictness())
+                << _graphSimplifier->isLowerPow() << _graphSimplifier->isReciprocal()
+                << _graphSimplifier->isFma() << _graphSimplifier->isReassociate()
+                << _graphSimplifier->getMaxPowExponent();
+    }
+
+    fp << _x.size();
+    for (const Base& v : _x)
+        fp << printBase(v);
+
+    /**
+     * the operations in the tape (only the ones used by the dependents
+     * with the same order and the same constant positions in each run)
+     */
+    CodeHandler<Base> handler;
+
+    std::vector<CGBase> x(_fun.Domain());
+    handler.makeVariables(x);
+
+    std::vector<CGBase> y = _fun.Forward(0, x);
+
+    CompactGraph<Base> graph(x, y);
+
+    fp << graph.getIndependentCount() << graph.getNodeCount() << y.size();
+
+    for (uint32_t id = 0; id < graph.getNodeCount(); id++) {
+        CGOpCode op = graph.getOperationType(id);
+        fp << static_cast<int> (op);
+
+        ArrayView<const uint32_t> info = graph.getInfo(id);
+        fp << info.size();
+        if (op == CGOpCode::Pri) {
+            for (uint32_t pos : info)
+                fp << graph.getString(pos);
+        } else if ((op == CGOpCode::AtomicForward || op == CGOpCode::AtomicReverse) && info.size() > 0) {
+            // atomic function IDs change with each execution
+            const std::string* name = handler.getAtomicFunctionName(info[0]);
+            fp << (name != nullptr ? *name : std::string());
+            for (size_t i = 1; i < info.size(); i++)
+                fp << info[i];
+        } else {
+            for (uint32_t i : info)
+                fp << i;
+        }
+
+        ArrayView<const uint32_t> args = graph.getArguments(id);
+        fp << args.size();
+        for (uint32_t a : args)
+            fp << a;
+    }
+
+    fp << graph.getDependents();
+
+    fp << graph.getConstants().size();
+    for (const Base& v : graph.getConstants())
+        fp << printBase(v);
+
+    return fp.str();
+}
+
 template<class Base>
 void ModelCSourceGen<Base>::generateInfoSource() {
     const char* localBaseName = typeid (Base).name();
@@ -214,6 +366,31 @@ void ModelCSourceGen<Base>::generateInfoSource() {
     _sources[funcName + ".c"] = _cache.str();
 }
 
+template<class Base>
+void ModelCSourceGen<Base>::generateConstantPoolSource() {
+    if (_constantPool == nullptr)
+        return;
+
+    /**
+     * the uses of the constants in all the functions are known
+     */
+    _constantPool->createTable();
+
+    for (auto& it : _sources) {
+        _constantPool->resolveReferences(it.second);
+    }
+
+    if (_constantPool->empty())
+        return;
+
+    LanguageC<Base> langC(_baseTypeName);
+
+    _cache.str("");
+    langC.printConstantPool(_cache, *_constantPool);
+
+    _sources[_constantPool->getName() + ".c"] = _cache.str();
+}
+
 template<class Base>
 void ModelCSourceGen<Base>::generateAtomicFuncNames() {
     std::string funcName = _name + "_" + FUNCTION_ATOMIC_FUNC_NAMES;
@@ -237,7 +414,7 @@ void ModelCSourceGen<Base>::generateAtomicFuncNames() {
 
 template<class Base>
 bool ModelCSourceGen<Base>::isAtomicsUsed() {
-    if (_zeroEvaluated) {
+    if (_zeroEvaluated || _atomicFunctionsKnown) {
         return _atomicFunctions.size() > 0;
     } else {
         return !getAtomicsInfo().empty();
@@ -329,7 +506,7 @@ void ModelCSourceGen<Base>::generateGlobalDirectionalFunctionSource(const std::s
     std::string model_function = _cache.str();
     _cache.str("");
 
-    _cache << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+    printFileStart(_cache);
     generateFunctionDeclarationSource(_cache, model_function, suffix, elements, argsDcl);
     _cache << "\n";
     LanguageC<Base>::printFunctionDeclaration(_cache, "int", model_function, {"unsigned long pos"}, argsDcl2);
@@ -649,22 +826,226 @@ void ModelCSourceGen<Base>::printFileStartPThreads(std::ostringstream& cache,
     cache << "\n";
     cache << CPPADCG_PTHREAD_POOL_H_FILE << "\n";
     cache << "\n";
-    cache << "typedef struct ExecArgStruct {\n"
+    cache << pthreadsExecArgDefinition(baseTypeName) << "\n"
+            "static " << pthreadsExecFunctionDefinition();
+}
+
+template<class Base>
+inline void ModelCSourceGen<Base>::printFileStart(std::ostringstream& cache,
+                                                  MultiThreadingType multiThreadingType) const {
+    LanguageC<Base>::printFileStart(cache, _sharedHeader);
+    if (!_sharedHeader.empty() || multiThreadingType == MultiThreadingType::NONE)
+        return;
+
+    LanguageC<Base> langC(_baseTypeName);
+    cache << "typedef void (*cppadcg_function_type) (" << langC.generateDefaultFunctionArgumentsDcl() << ");\n";
+
+    if (multiThreadingType == MultiThreadingType::OPENMP) {
+        cache << "\n";
+        printFileStartOpenMP(cache);
+    } else {
+        CPPADCG_ASSERT_UNKNOWN(multiThreadingType == MultiThreadingType::PTHREADS);
+        printFileStartPThreads(cache, _baseTypeName);
+    }
+    cache << "\n";
+}
+
+template<class Base>
+std::string ModelCSourceGen<Base>::pthreadsExecArgDefinition(const std::string& baseTypeName) {
+    return "typedef struct ExecArgStruct {\n"
             "   cppadcg_function_type func;\n"
-            "   " << baseTypeName + " const *const * in;\n"
-            "   " << baseTypeName + "* out[1];\n"
+            "   " + baseTypeName + " const *const * in;\n"
+            "   " + baseTypeName + "* out[1];\n"
             "   struct LangCAtomicFun atomicFun;\n"
-            "} ExecArgStruct;\n"
-            "\n"
-            "static void exec_func(void* arg) {\n"
+            "} ExecArgStruct;\n";
+}
+
+template<class Base>
+const std::string& ModelCSourceGen<Base>::pthreadsExecFunctionDefinition() {
+    static const std::string def = "void cppadcg_exec_func(void* arg) {\n"
             "   ExecArgStruct* eArg = (ExecArgStruct*) arg;\n"
             "   (*eArg->func)(eArg->in, eArg->out, eArg->atomicFun);\n"
             "}\n";
+    return def;
 }
 
 template<class Base>
-void ModelCSourceGen<Base>::printFunctionStartPThreads(std::ostringstream& cache,
-                                                       size_t size) {
+std::vector<std::vector<size_t> > ModelCSourceGen<Base>::determineParallelJobs(const std::map<size_t, CompressedVectorInfo>& info,
+                                                                                const std::string& profileFunction,
+                                                                                std::vector<float>& jobElapsed) const {
+    std::map<size_t, float> cost;
+    for (const auto& it : info) {
+        cost[it.first] = static_cast<float> (it.second.indexes.size());
+    }
+
+    std::map<size_t, float> elapsed = _jobProfile.estimateKeyElapsed(profileFunction, cost);
+    const std::map<size_t, float>& keyCost = elapsed.empty() ? cost : elapsed;
+
+    std::vector<std::vector<size_t> > jobs;
+
+    if (_multiThreadingJobs == 0 || _multiThreadingJobs >= info.size()) {
+        // a job for each row/column
+        jobs.reserve(info.size());
+        for (const auto& it : info) {
+            jobs.push_back(std::vector<size_t>{it.first});
+        }
+
+    } else {
+        /**
+         * longest processing time first: the most expensive rows/columns
+         * are placed first in the job with the lowest load, unless there is
+         * a job which evaluates the same elements (probably sharing
+         * temporary variables) that can receive it without exceeding the
+         * ideal load
+         */
+        size_t nJobs = _multiThreadingJobs;
+
+        std::vector<std::pair<float, size_t> > sorted; // (-cost, key)
+        sorted.reserve(keyCost.size());
+        float total = 0;
+        for (const auto& it : keyCost) {
+            sorted.push_back(std::make_pair(-it.second, it.first));
+            total += it.second;
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        float target = std::max(total / nJobs, -sorted[0].first);
+
+        jobs.resize(nJobs);
+        std::vector<float> load(nJobs, 0);
+        std::vector<std::set<size_t> > elements(nJobs);
+
+        for (const auto& p : sorted) {
+            float c = -p.first;
+            size_t key = p.second;
+            const std::vector<size_t>& els = info.at(key).indexes;
+
+            size_t best = 0;
+            for (size_t j = 1; j < nJobs; j++) {
+                if (load[j] < load[best])
+                    best = j;
+            }
+
+            size_t bestShared = 0;
+            for (size_t j = 0; j < nJobs; j++) {
+                if (load[j] + c > target)
+                    continue;
+
+                size_t shared = 0;
+                for (size_t e : els) {
+                    if (elements[j].find(e) != elements[j].end())
+                        shared++;
+                }
+                if (shared > bestShared || (shared == bestShared && shared > 0 && load[j] < load[best])) {
+                    best = j;
+                    bestShared = shared;
+                }
+            }
+
+            jobs[best].push_back(key);
+            load[best] += c;
+            elements[best].insert(els.begin(), els.end());
+        }
+
+        jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](const std::vector<size_t>& j) {
+            return j.empty();
+        }), jobs.end());
+
+        for (std::vector<size_t>& j : jobs) {
+            std::sort(j.begin(), j.end());
+        }
+        std::sort(jobs.begin(), jobs.end());
+    }
+
+    jobElapsed.assign(jobs.size(), 0);
+    if (!elapsed.empty()) {
+        for (size_t j = 0; j < jobs.size(); j++) {
+            for (size_t key : jobs[j])
+                jobElapsed[j] += elapsed.at(key);
+        }
+    }
+
+    return jobs;
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::printParallelJobFunctions(std::ostringstream& cache,
+                                                      const std::string& functionName,
+                                                      const std::map<size_t, CompressedVectorInfo>& info,
+                                                      const std::string& keyFunction,
+                                                      const std::vector<std::vector<size_t> >& jobs,
+                                                      std::vector<std::string>& jobFunctions,
+                                                      std::vector<size_t>& jobOffsets) {
+    jobFunctions.resize(jobs.size());
+    jobOffsets.resize(jobs.size());
+
+    LanguageC<Base> langC(_baseTypeName);
+    std::vector<std::string> argsDcl2 = langC.generateDefaultFunctionArgumentsDcl2();
+    std::string out = langC.getArgumentOut();
+    langC.setArgumentOut("outLocal");
+    std::string argsLocal = langC.generateDefaultFunctionArguments();
+
+    auto keyFunctionName = [&](size_t key) {
+        const CompressedVectorInfo& ki = info.at(key);
+        return keyFunction + std::to_string(key) + (ki.ordered ? "" : "_wrap");
+    };
+    auto keyOffset = [&](size_t key) {
+        const CompressedVectorInfo& ki = info.at(key);
+        return ki.ordered ? *ki.locations[0].begin() : 0;
+    };
+
+    for (size_t j = 0; j < jobs.size(); j++) {
+        if (jobs[j].size() == 1) {
+            jobFunctions[j] = keyFunctionName(jobs[j][0]);
+            jobOffsets[j] = keyOffset(jobs[j][0]);
+            continue;
+        }
+
+        jobFunctions[j] = functionName + "_job" + std::to_string(j);
+        jobOffsets[j] = 0;
+
+        cache << "\n";
+        LanguageC<Base>::printFunctionDeclaration(cache, "static void", jobFunctions[j], argsDcl2);
+        cache << " {\n"
+                "   " << _baseTypeName << " * outLocal[1];\n"
+                "\n";
+        for (size_t key : jobs[j]) {
+            cache << "   outLocal[0] = &" << out << "[0][" << keyOffset(key) << "];\n"
+                    "   " << keyFunctionName(key) << "(" << argsLocal << ");\n";
+        }
+        cache << "}\n";
+    }
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::printParallelJobArrays(std::ostringstream& cache,
+                                                   const std::vector<std::string>& jobFunctions,
+                                                   const std::vector<size_t>& jobOffsets) {
+    size_t size = jobFunctions.size();
+
+    cache << "   static const cppadcg_function_type p[" << size << "] = {";
+    for (size_t j = 0; j < size; ++j) {
+        if (j != 0) cache << ", ";
+        cache << jobFunctions[j];
+    }
+    cache << "};\n"
+            "   static const long offset[" << size << "] = {";
+    for (size_t j = 0; j < size; ++j) {
+        if (j != 0) cache << ", ";
+        cache << jobOffsets[j];
+    }
+    cache << "};\n";
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::printJobState(std::ostringstream& cache,
+                                          const std::string& functionName,
+                                          const std::string& profileFunction,
+                                          const std::vector<std::vector<size_t> >& jobs,
+                                          const std::vector<float>& jobElapsed,
+                                          MultiThreadingType multiThreadingType) {
+    size_t size = jobs.size();
+
     auto repeatFill = [&](const std::string& txt){
         cache << "{";
         for (size_t i = 0; i < size; ++i) {
@@ -674,28 +1055,96 @@ void ModelCSourceGen<Base>::printFunctionStartPThreads(std::ostringstream& cache
         cache << "};";
     };
 
-    cache << "   ExecArgStruct* args[" << size << "];\n";
-    cache << "   static cppadcg_thpool_function_type execute_functions[" << size << "] = ";
-    repeatFill("exec_func");
-    cache << "\n";
-    cache << "   static float ref_elapsed[" << size << "] = ";
-    repeatFill("0");
-    cache << "\n";
-    cache << "   static float elapsed[" << size << "] = ";
-    repeatFill("0");
+    // the initial order follows the profiled times (descending)
+    std::vector<size_t> sorted(size);
+    for (size_t i = 0; i < size; ++i) {
+        sorted[i] = i;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) {
+        return jobElapsed[a] > jobElapsed[b];
+    });
+    std::vector<size_t> order(size);
+    for (size_t i = 0; i < size; ++i) {
+        order[sorted[i]] = i;
+    }
+
     cache << "\n"
-            "   static int order[" << size << "] = {";
+            "static float ref_elapsed[" << size << "] = {";
+    std::streamsize precision = cache.precision(std::numeric_limits<float>::max_digits10);
+    for (size_t i = 0; i < size; ++i) {
+        if (i != 0) cache << ", ";
+        cache << jobElapsed[i];
+    }
+    cache.precision(precision);
+    cache << "};\n";
+    if (multiThreadingType == MultiThreadingType::PTHREADS) {
+        cache << "static float elapsed[" << size << "] = ";
+        repeatFill("0");
+        cache << "\n";
+    }
+    cache << "static int order[" << size << "] = {";
     for (size_t i = 0; i < size; ++i) {
         if (i != 0) cache << ", ";
-        cache << i;
+        cache << order[i];
+    }
+    cache << "};\n";
+    if (multiThreadingType == MultiThreadingType::PTHREADS) {
+        cache << "static int job2Thread[" << size << "] = ";
+        repeatFill("-1");
+        cache << "\n"
+                "static int last_elapsed_changed = 1;\n";
+    }
+    cache << "static unsigned int n_meas = 0;\n"
+            "\n";
+
+    size_t nKeys = 0;
+    for (const auto& j : jobs)
+        nKeys += j.size();
+
+    cache << "void " << functionName << "_jobs(const char** function,\n"
+            "     unsigned long const** keyStart,\n"
+            "     unsigned long const** keys,\n"
+            "     float const** elapsed_,\n"
+            "     unsigned long* nJobs) {\n"
+            "   static const unsigned long jobKeyStart[" << (size + 1) << "] = {0";
+    size_t start = 0;
+    for (const auto& j : jobs) {
+        start += j.size();
+        cache << ", " << start;
+    }
+    cache << "};\n"
+            "   static const unsigned long jobKeys[" << std::max<size_t>(nKeys, 1) << "] = {";
+    bool first = true;
+    for (const auto& j : jobs) {
+        for (size_t key : j) {
+            if (!first) cache << ", ";
+            cache << key;
+            first = false;
+        }
+    }
+    if (nKeys == 0)
+        cache << "0";
+    cache << "};\n"
+            "\n"
+            "   *function = \"" << profileFunction << "\";\n"
+            "   *keyStart = jobKeyStart;\n"
+            "   *keys = jobKeys;\n"
+            "   *elapsed_ = ref_elapsed;\n"
+            "   *nJobs = " << size << ";\n"
+            "}\n";
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::printFunctionStartPThreads(std::ostringstream& cache,
+                                                       size_t size) {
+    cache << "   ExecArgStruct* args[" << size << "];\n";
+    cache << "   static cppadcg_thpool_function_type execute_functions[" << size << "] = {";
+    for (size_t i = 0; i < size; ++i) {
+        if (i != 0) cache << ", ";
+        cache << "cppadcg_exec_func";
     }
     cache << "};\n"
-            "   static int job2Thread[" << size << "] = ";
-    repeatFill("-1");
-    cache << "\n"
-            "   static int last_elapsed_changed = 1;\n"
             "   unsigned int nBench = cppadcg_thpool_get_n_time_meas();\n"
-            "   static unsigned int n_meas = 0;\n"
             "   int do_benchmark = " << (size > 0 ? "(n_meas < nBench && !cppadcg_thpool_is_disabled())" : "0") << ";\n"
             "   float* elapsed_p = do_benchmark ? elapsed : NULL;\n";
 }
@@ -731,59 +1180,105 @@ template<class Base>
 void ModelCSourceGen<Base>::printFunctionStartOpenMP(std::ostringstream& cache,
                                                      size_t size) {
     cache << "\n"
-            "   enum omp_sched_t old_kind;\n"
-            "   int old_modifier;\n"
             "   int enabled = !cppadcg_openmp_is_disabled();\n"
             "   int verbose = cppadcg_openmp_is_verbose();\n"
+            "   int nested = omp_in_parallel();\n"
+            "   enum ScheduleStrategy strategy = cppadcg_openmp_get_scheduler_strategy();\n"
+            "   int do_benchmark = (enabled && !nested && n_meas < cppadcg_openmp_get_n_time_meas());\n"
             "   struct timespec start[" << size << "];\n"
             "   struct timespec end[" << size << "];\n"
             "   int thread_id[" << size << "];\n"
+            "   float elapsed[" << size << "];\n"
+            "   int sorted[" << size << "];\n"
+            "   long k;\n"
             "   unsigned int n_threads = cppadcg_openmp_get_threads();\n"
             "   if(n_threads > " << size << ")\n"
-            "      n_threads = " << size << ";\n"
-            "\n"
-            "   if(enabled) {\n"
-            "      omp_get_schedule(&old_kind, &old_modifier);\n"
-            "      cppadcg_openmp_apply_scheduler_strategy();\n"
-            "   }\n";
+            "      n_threads = " << size << ";\n";
 }
 
 template<class Base>
-void ModelCSourceGen<Base>::printLoopStartOpenMP(std::ostringstream& cache,
-                                                 size_t size) {
-    cache <<"#pragma omp parallel for private(outLocal) schedule(runtime) if(enabled) num_threads(n_threads)\n"
-            "   for(i = 0; i < " << size << "; ++i) {\n"
-            "      int info;\n"
-            "      if(verbose) {\n"
-            "         thread_id[i] = omp_get_thread_num();\n"
-            "         info = clock_gettime(CLOCK_MONOTONIC, &start[i]);\n"
-            "         if(info != 0) {\n"
-            "            start[i].tv_sec = 0;\n"
-            "            start[i].tv_nsec = 0;\n"
-            "            end[i].tv_sec = 0;\n"
-            "            end[i].tv_nsec = 0;\n"
-            "         }\n"
-            "      }\n"
-            "\n";
-}
+void ModelCSourceGen<Base>::printParallelLoopOpenMP(std::ostringstream& cache,
+                                                    size_t size,
+                                                    const std::string& jobBody) {
 
-template<class Base>
-void ModelCSourceGen<Base>::printLoopEndOpenMP(std::ostringstream& cache,
-                                               size_t size) {
-    cache <<"\n"
-            "      if(verbose) {\n"
-            "         if(info == 0) {\n"
-            "            info = clock_gettime(CLOCK_MONOTONIC, &end[i]);\n"
-            "            if(info != 0) {\n"
-            "               end[i].tv_sec = 0;\n"
-            "               end[i].tv_nsec = 0;\n"
-            "            }\n"
-            "         }\n"
-            "      }\n"
+    /**
+     * the same job code is used by every execution mode
+     */
+    auto printJob = [&](const std::string& indent) {
+        cache << indent << "{\n" <<
+                indent << "   double t0 = 0;\n" <<
+                indent << "   int info = 0;\n" <<
+                indent << "   i = sorted[k];\n" <<
+                indent << "   if(verbose) {\n" <<
+                indent << "      thread_id[i] = omp_get_thread_num();\n" <<
+                indent << "      info = clock_gettime(CLOCK_MONOTONIC, &start[i]);\n" <<
+                indent << "      if(info != 0) {\n" <<
+                indent << "         start[i].tv_sec = 0;\n" <<
+                indent << "         start[i].tv_nsec = 0;\n" <<
+                indent << "         end[i].tv_sec = 0;\n" <<
+                indent << "         end[i].tv_nsec = 0;\n" <<
+                indent << "      }\n" <<
+                indent << "   }\n" <<
+                indent << "   if(do_benchmark)\n" <<
+                indent << "      t0 = omp_get_wtime();\n" <<
+                "\n";
+
+        std::istringstream body(jobBody);
+        std::string line;
+        while (std::getline(body, line)) {
+            cache << indent << "   " << line << "\n";
+        }
+
+        cache << "\n" <<
+                indent << "   if(do_benchmark)\n" <<
+                indent << "      elapsed[i] = (float) (omp_get_wtime() - t0);\n" <<
+                indent << "   if(verbose && info == 0) {\n" <<
+                indent << "      info = clock_gettime(CLOCK_MONOTONIC, &end[i]);\n" <<
+                indent << "      if(info != 0) {\n" <<
+                indent << "         end[i].tv_sec = 0;\n" <<
+                indent << "         end[i].tv_nsec = 0;\n" <<
+                indent << "      }\n" <<
+                indent << "   }\n" <<
+                indent << "}\n";
+    };
+
+    cache << "   for(i = 0; i < " << size << "; ++i) {\n"
+            "      sorted[order[i]] = i; // longest jobs first\n"
             "   }\n"
             "\n"
-            "   if(enabled) {\n"
-            "      omp_set_schedule(old_kind, old_modifier);\n"
+            "   if(nested) {\n"
+            "      // use the threads of the enclosing parallel region\n"
+            "      for(k = 0; k < " << size << "; ++k) {\n"
+            "#pragma omp task default(shared) firstprivate(k) private(i, outLocal) if(enabled)\n";
+    printJob("         ");
+    cache << "      }\n"
+            "#pragma omp taskwait\n"
+            "\n"
+            "   } else if(strategy == SCHED_DYNAMIC) {\n"
+            "#pragma omp parallel num_threads(n_threads) if(enabled)\n"
+            "      {\n"
+            "#pragma omp single\n"
+            "         for(k = 0; k < " << size << "; ++k) {\n"
+            "#pragma omp task default(shared) firstprivate(k) private(i, outLocal)\n";
+    printJob("            ");
+    cache << "         }\n"
+            "      }\n"
+            "\n"
+            "   } else if(strategy == SCHED_GUIDED) {\n"
+            "#pragma omp parallel for private(i, outLocal) schedule(guided) if(enabled) num_threads(n_threads)\n"
+            "      for(k = 0; k < " << size << "; ++k)\n";
+    printJob("      ");
+    cache << "\n"
+            "   } else {\n"
+            "      // round-robin of the sorted jobs (the same thread always evaluates the same jobs)\n"
+            "#pragma omp parallel for private(i, outLocal) schedule(static, 1) if(enabled) num_threads(n_threads)\n"
+            "      for(k = 0; k < " << size << "; ++k)\n";
+    printJob("      ");
+    cache << "   }\n"
+            "\n"
+            "   if(do_benchmark) {\n"
+            "      cppadcg_openmp_update_order(ref_elapsed, n_meas, elapsed, order, " << size << ");\n"
+            "      n_meas++;\n"
             "   }\n"
             "\n"
             "   if(verbose) {\n"
@@ -800,7 +1295,27 @@ void ModelCSourceGen<Base>::printLoopEndOpenMP(std::ostringstream& cache,
             "                 thread_id[i], i, start[i].tv_sec, start[i].tv_nsec, end[i].tv_sec, end[i].tv_nsec, diff.tv_sec, diff.tv_nsec);\n"
             "      }\n"
             "   }\n";
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::configureLanguage(LanguageC<Base>& langC,
+                                              std::map<std::string, std::string>& sources,
+                                              std::map<std::string, std::vector<FunctionSplitInfo> >& funcSplitReport) {
+    langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &sources);
+    langC.setFunctionSplitCostModel(_funcSplitModel.get(), &funcSplitReport);
+    langC.setVectorizeLoops(_vectorizeLoops);
+    langC.setPackLoopArrays(_packLoopArrays);
+    langC.setConstantPool(_constantPool.get());
+    langC.setDirectAtomicFunctions(_directAtomicModels);
+    langC.setParameterPrecision(_parameterPrecision);
+    langC.setSharedHeader(_sharedHeader);
+}
 
+template<class Base>
+void ModelCSourceGen<Base>::configureHandler(CodeHandler<Base>& handler,
+                                             JobTimer* jobTimer) {
+    handler.setJobTimer(jobTimer);
+    handler.setGraphSimplifier(_graphSimplifier.get());
 }
 
 template<class Base>
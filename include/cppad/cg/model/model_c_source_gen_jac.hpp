@@ -27,7 +27,7 @@ void ModelCSourceGen<Base>::generateJacobianSource() {
     startingJob("'" + jobName + "'", JobTimer::GRAPH);
 
     CodeHandler<Base> handler;
-    handler.setJobTimer(_jobTimer);
+    configureHandler(handler);
 
     vector<CGBase> indVars(_fun.Domain());
     handler.makeVariables(indVars);
@@ -41,19 +41,18 @@ void ModelCSourceGen<Base>::generateJacobianSource() {
     size_t n = _fun.Domain();
 
     vector<CGBase> jac(n * m);
-    if (_jacMode == JacobianADMode::Automatic) {
-        jac = _fun.Jacobian(indVars);
-    } else if (_jacMode == JacobianADMode::Forward) {
+    if (_jacMode == JacobianADMode::Forward) {
         JacobianFor(_fun, indVars, jac);
-    } else {
+    } else if (_jacMode == JacobianADMode::Reverse) {
         JacobianRev(_fun, indVars, jac);
+    } else {
+        jac = _fun.Jacobian(indVars);
     }
 
     finishedJob();
 
     LanguageC<Base> langC(_baseTypeName);
-    langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-    langC.setParameterPrecision(_parameterPrecision);
+    configureLanguage(langC);
     langC.setGenerateFunction(_name + "_" + FUNCTION_JACOBIAN);
 
     std::ostringstream code;
@@ -64,51 +63,101 @@ void ModelCSourceGen<Base>::generateJacobianSource() {
 
 template<class Base>
 void ModelCSourceGen<Base>::generateSparseJacobianSource(MultiThreadingType multiThreadingType) {
-    size_t m = _fun.Range();
-    size_t n = _fun.Domain();
-
     /**
      * Determine the sparsity pattern
      */
     determineJacobianSparsity();
 
-    bool forwardMode;
-
-    if (_jacMode == JacobianADMode::Automatic) {
-        if (_custom_jac.defined) {
-            forwardMode = estimateBestJacobianADMode(_jacSparsity.rows, _jacSparsity.cols);
-        } else {
-            forwardMode = n <= m;
-        }
-    } else {
-        forwardMode = _jacMode == JacobianADMode::Forward;
-    }
+    JacobianADMode mode = getSparseJacobianADMode();
 
     /**
      * call the appropriate method for source code generation
      */
-    if (_sparseJacobianReusesOne && _forwardOne && forwardMode) {
+    if (_sparseJacobianReusesOne && _forwardOne && mode == JacobianADMode::Forward) {
         generateSparseJacobianForRevSource(true, multiThreadingType);
-    } else if (_sparseJacobianReusesOne && _reverseOne && !forwardMode) {
+    } else if (_sparseJacobianReusesOne && _reverseOne && mode == JacobianADMode::Reverse) {
         generateSparseJacobianForRevSource(false, multiThreadingType);
     } else {
-        generateSparseJacobianSource(forwardMode);
+        generateSparseJacobianSource(mode);
     }
 }
 
 template<class Base>
-void ModelCSourceGen<Base>::generateSparseJacobianSource(bool forward) {
-    using std::vector;
+JacobianADMode ModelCSourceGen<Base>::getSparseJacobianADMode() {
+    size_t m = _fun.Range();
+    size_t n = _fun.Domain();
 
-    const std::string jobName = "sparse Jacobian";
+    determineJacobianSparsity();
 
-    //size_t m = _fun.Range();
-    size_t n = _fun.Domain();
+    // the number of operations inside loops cannot be compared directly
+    // and the bidirectional mode does not support loops
+    if (_loopTapes.empty()) {
+        if (_jacMode == JacobianADMode::Cheapest) {
+            if (_jacCheapestMode == JacobianADMode::Cheapest) {
+                _jacCheapestMode = determineCheapestSparseJacobianADMode();
+            }
+            return _jacCheapestMode;
+        } else if (_jacMode == JacobianADMode::Bidirectional) {
+            return JacobianADMode::Bidirectional;
+        }
+    }
 
-    startingJob("'" + jobName + "'", JobTimer::GRAPH);
+    if (_jacMode == JacobianADMode::Forward || _jacMode == JacobianADMode::Reverse) {
+        return _jacMode;
+    }
+
+    bool forward;
+    if (_custom_jac.defined) {
+        forward = estimateBestJacobianADMode(_jacSparsity.rows, _jacSparsity.cols);
+    } else {
+        forward = n <= m;
+    }
+    return forward ? JacobianADMode::Forward : JacobianADMode::Reverse;
+}
+
+template<class Base>
+JacobianADMode ModelCSourceGen<Base>::determineCheapestSparseJacobianADMode() {
+    startingJob("'sparse Jacobian AD mode selection'");
+
+    size_t forwardOps = countSparseJacobianOperations(JacobianADMode::Forward);
+    size_t reverseOps = countSparseJacobianOperations(JacobianADMode::Reverse);
+
+    JacobianADMode mode = forwardOps <= reverseOps ? JacobianADMode::Forward : JacobianADMode::Reverse;
+    size_t bestOps = std::min(forwardOps, reverseOps);
+
+    // the bidirectional mode only differs from the others when some rows are split
+    size_t bidirOps = 0;
+    const std::set<size_t>& reverseRows = getBidirectionalReverseRows();
+    std::set<size_t> usedRows(_jacSparsity.rows.begin(), _jacSparsity.rows.end());
+    bool bidirectional = !reverseRows.empty() && reverseRows.size() < usedRows.size();
+    if (bidirectional) {
+        bidirOps = countSparseJacobianOperations(JacobianADMode::Bidirectional);
+        if (bidirOps < bestOps) {
+            mode = JacobianADMode::Bidirectional;
+        }
+    }
+
+    finishedJob();
+
+    if (_jobTimer != nullptr && _jobTimer->isVerbose()) {
+        std::cout << " operations  forward: " << forwardOps << "  reverse: " << reverseOps;
+        if (bidirectional)
+            std::cout << "  bidirectional: " << bidirOps;
+        std::cout << "  selected: " << (mode == JacobianADMode::Forward ? "forward" :
+                                       mode == JacobianADMode::Reverse ? "reverse" : "bidirectional") << std::endl;
+    }
+
+    return mode;
+}
+
+template<class Base>
+size_t ModelCSourceGen<Base>::countSparseJacobianOperations(JacobianADMode mode) {
+    using std::vector;
+
+    size_t n = _fun.Domain();
 
     CodeHandler<Base> handler;
-    handler.setJobTimer(_jobTimer);
+    configureHandler(handler, nullptr); // no progress output
 
     vector<CGBase> indVars(n);
     handler.makeVariables(indVars);
@@ -118,8 +167,125 @@ void ModelCSourceGen<Base>::generateSparseJacobianSource(bool forward) {
         }
     }
 
-    vector<CGBase> jac(_jacSparsity.rows.size());
-    if (_loopTapes.empty()) {
+    vector<CGBase> jac = prepareSparseJacobian(handler, indVars, mode);
+
+    // no source code is generated
+    return handler.countOperations(jac);
+}
+
+template<class Base>
+std::set<size_t> ModelCSourceGen<Base>::determineReverseJacobianRows(JacobianADMode mode) {
+    if (mode == JacobianADMode::Forward) {
+        return std::set<size_t>();
+    } else if (mode == JacobianADMode::Reverse) {
+        return std::set<size_t>(_jacSparsity.rows.begin(), _jacSparsity.rows.end());
+    } else {
+        return getBidirectionalReverseRows();
+    }
+}
+
+template<class Base>
+const std::set<size_t>& ModelCSourceGen<Base>::getBidirectionalReverseRows() {
+    if (!_jacBidirReverseRowsDetermined) {
+        _jacBidirReverseRows = determineBidirectionalReverseRows();
+        _jacBidirReverseRowsDetermined = true;
+    }
+    return _jacBidirReverseRows;
+}
+
+template<class Base>
+std::set<size_t> ModelCSourceGen<Base>::determineBidirectionalReverseRows() {
+    size_t m = _fun.Range();
+    size_t n = _fun.Domain();
+
+    const SparsitySetType& sparsity = _jacSparsity.sparsity;
+    const std::vector<size_t>& rows = _jacSparsity.rows;
+    const std::vector<size_t>& cols = _jacSparsity.cols;
+
+    // only the requested non-zero elements
+    SparsitySetType pattern(m);
+    for (size_t e = 0; e < rows.size(); e++) {
+        if (sparsity[rows[e]].find(cols[e]) != sparsity[rows[e]].end())
+            pattern[rows[e]].insert(cols[e]);
+    }
+
+    std::vector<size_t> order;
+    for (size_t i = 0; i < m; i++) {
+        if (!pattern[i].empty())
+            order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t i1, size_t i2) {
+        return pattern[i1].size() > pattern[i2].size();
+    });
+
+    auto countColors = [](const std::vector<size_t>& color,
+                          const std::set<size_t>& colored) {
+        size_t nColors = 0;
+        for (size_t j : colored)
+            nColors = std::max(nColors, color[j] + 1);
+        return nColors;
+    };
+
+    /**
+     * the same compression used by sparseJacobianFromForwardZero():
+     * columns of the forward rows and rows of the reverse rows
+     */
+    SparsitySetType revPattern(n); // the reverse rows of each column
+    std::set<size_t> revRows;
+    size_t revMinColors = 0; // the reverse rows which share a column need different colors
+
+    auto countSweeps = [&]() {
+        std::set<size_t> forCols;
+        for (const std::set<size_t>& r : pattern)
+            forCols.insert(r.begin(), r.end());
+        size_t sweeps = countColors(colorColumns(pattern, n, forCols), forCols);
+        if (!revRows.empty())
+            sweeps += countColors(colorColumns(revPattern, m, revRows), revRows);
+        return sweeps;
+    };
+
+    // move the densest rows to reverse mode while it reduces the number of sweeps
+    size_t bestSweeps = countSweeps();
+    size_t bestRev = 0;
+    for (size_t k = 0; k < order.size(); k++) {
+        size_t i = order[k];
+        for (size_t j : pattern[i]) {
+            revPattern[j].insert(i);
+            revMinColors = std::max(revMinColors, revPattern[j].size());
+        }
+        revRows.insert(i);
+        pattern[i].clear();
+
+        if (revMinColors >= bestSweeps)
+            break; // it can only get worse
+
+        size_t sweeps = countSweeps();
+        if (sweeps < bestSweeps) {
+            bestSweeps = sweeps;
+            bestRev = k + 1;
+        }
+    }
+
+    return std::set<size_t>(order.begin(), order.begin() + bestRev);
+}
+
+template<class Base>
+std::vector<CG<Base> > ModelCSourceGen<Base>::prepareSparseJacobian(CodeHandler<Base>& handler,
+                                                                   const std::vector<CGBase>& indVars,
+                                                                   JacobianADMode mode) {
+    bool forward = mode == JacobianADMode::Forward;
+
+    std::vector<CGBase> jac(_jacSparsity.rows.size());
+    if (!_loopTapes.empty()) {
+        CPPADCG_ASSERT_KNOWN(mode != JacobianADMode::Bidirectional,
+                             "The bidirectional sparse Jacobian is not available for models with loops");
+        jac = prepareSparseJacobianWithLoops(handler, indVars, forward);
+
+    } else if (mode == JacobianADMode::Bidirectional) {
+        _fun.Forward(0, indVars);
+        jac = sparseJacobianFromForwardZero(getBidirectionalReverseRows());
+
+    } else {
         //printSparsityPattern(_jacSparsity.sparsity, "jac sparsity");
         CppAD::sparse_jacobian_work work;
         if (forward) {
@@ -127,16 +293,44 @@ void ModelCSourceGen<Base>::generateSparseJacobianSource(bool forward) {
         } else {
             _fun.SparseJacobianReverse(indVars, _jacSparsity.sparsity, _jacSparsity.rows, _jacSparsity.cols, jac, work);
         }
+    }
 
-    } else {
-        jac = prepareSparseJacobianWithLoops(handler, indVars, forward);
+    return jac;
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::generateSparseJacobianSource(bool forward) {
+    generateSparseJacobianSource(forward ? JacobianADMode::Forward : JacobianADMode::Reverse);
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::generateSparseJacobianSource(JacobianADMode mode) {
+    using std::vector;
+
+    const std::string jobName = "sparse Jacobian";
+
+    //size_t m = _fun.Range();
+    size_t n = _fun.Domain();
+
+    startingJob("'" + jobName + "'", JobTimer::GRAPH);
+
+    CodeHandler<Base> handler;
+    configureHandler(handler);
+
+    vector<CGBase> indVars(n);
+    handler.makeVariables(indVars);
+    if (_x.size() > 0) {
+        for (size_t i = 0; i < n; i++) {
+            indVars[i].setValue(_x[i]);
+        }
     }
 
+    vector<CGBase> jac = prepareSparseJacobian(handler, indVars, mode);
+
     finishedJob();
 
     LanguageC<Base> langC(_baseTypeName);
-    langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-    langC.setParameterPrecision(_parameterPrecision);
+    configureLanguage(langC);
     langC.setGenerateFunction(_name + "_" + FUNCTION_SPARSE_JACOBIAN);
 
     std::ostringstream code;
@@ -260,9 +454,7 @@ std::string ModelCSourceGen<Base>::generateSparseJacobianForRevSingleThreadSourc
     std::vector<std::string> argsDcl2 = langC.generateDefaultFunctionArgumentsDcl2();
 
     _cache.str("");
-    _cache << "#include <stdlib.h>\n"
-            "\n"
-           << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+    printFileStart(_cache);
     generateFunctionDeclarationSource(_cache, functionRevFor, revForSuffix, jacInfo, argsDcl);
     _cache << "\n";
     LanguageC<Base>::printFunctionDeclaration(_cache, "void", functionName, argsDcl2);
@@ -327,9 +519,7 @@ std::string ModelCSourceGen<Base>::generateSparseJacobianForRevMultiThreadSource
     std::vector<std::string> argsDcl2 = langC.generateDefaultFunctionArgumentsDcl2();
 
     _cache.str("");
-    _cache << "#include <stdlib.h>\n"
-            "\n"
-           << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+    printFileStart(_cache, multiThreadingType);
     generateFunctionDeclarationSource(_cache, functionRevFor, revForSuffix, jacInfo, argsDcl);
 
     langC.setArgumentIn("inLocal");
@@ -374,50 +564,27 @@ std::string ModelCSourceGen<Base>::generateSparseJacobianForRevMultiThreadSource
         _cache << "}\n";
     }
 
-    _cache << "\n"
-            "typedef void (*cppadcg_function_type) (" << argsDcl << ");\n";
-
     /**
-     * PThreads pool needs a function with a void pointer argument
+     * Group the rows/columns into jobs
      */
-    if(multiThreadingType == MultiThreadingType::OPENMP) {
-        _cache << "\n";
-        printFileStartOpenMP(_cache);
-        _cache << "\n";
+    const std::string& profileFunction = forward ? FUNCTION_SPARSE_FORWARD_ONE : FUNCTION_SPARSE_REVERSE_ONE;
+    std::vector<float> jobElapsed;
+    std::vector<std::vector<size_t> > jobs = determineParallelJobs(jacInfo, profileFunction, jobElapsed);
+    size_t nJobs = jobs.size();
 
-    } else {
-        assert(multiThreadingType == MultiThreadingType::PTHREADS);
+    std::vector<std::string> jobFunctions;
+    std::vector<size_t> jobOffsets;
+    printParallelJobFunctions(_cache, functionName, jacInfo, functionRevFor + "_" + revForSuffix, jobs, jobFunctions, jobOffsets);
 
-        printFileStartPThreads(_cache, _baseTypeName);
-    }
+    printJobState(_cache, functionName, profileFunction, jobs, jobElapsed, multiThreadingType);
 
     /**
      * Jacobian function
      */
     _cache << "\n"
-            "void " << functionName << "(" << argsDcl << ") {\n"
-            "   static const cppadcg_function_type p[" << jacInfo.size() << "] = {";
-    for (const auto& it : jacInfo) {
-        size_t index = it.first;
-        if (index != jacInfo.begin()->first) _cache << ", ";
-        if (it.second.ordered) {
-            _cache << functionRevFor << "_" << revForSuffix << index;
-        } else {
-            _cache << functionRevFor << "_" << revForSuffix << index << "_wrap";
-        }
-    }
-    _cache << "};\n"
-            "   static const long offset["<< jacInfo.size() <<"] = {";
-    for (const auto& it : jacInfo) {
-        if (it.first != jacInfo.begin()->first) _cache << ", ";
-        if (it.second.ordered) {
-            _cache << *it.second.locations[0].begin();
-        } else {
-            _cache << "0";
-        }
-    }
-    _cache << "};\n"
-            "   " << _baseTypeName << " inLocal1 = 1;\n"
+            "void " << functionName << "(" << argsDcl << ") {\n";
+    printParallelJobArrays(_cache, jobFunctions, jobOffsets);
+    _cache << "   " << _baseTypeName << " inLocal1 = 1;\n"
             "   " << _baseTypeName << " const * inLocal[2] = {in[0], &inLocal1};\n"
             "   " << _baseTypeName << " * outLocal[1];\n"
             "   " << _baseTypeName << " * jac = out[0];\n"
@@ -425,20 +592,19 @@ std::string ModelCSourceGen<Base>::generateSparseJacobianForRevMultiThreadSource
             "\n";
 
     if(multiThreadingType == MultiThreadingType::OPENMP) {
-        printFunctionStartOpenMP(_cache, jacInfo.size());
+        printFunctionStartOpenMP(_cache, nJobs);
         _cache << "\n";
-        printLoopStartOpenMP(_cache, jacInfo.size());
-        _cache << "      outLocal[0] = &jac[offset[i]];\n"
-                "      (*p[i])(" << argsLocal << ");\n";
-        printLoopEndOpenMP(_cache, jacInfo.size());
+        printParallelLoopOpenMP(_cache, nJobs,
+                                "outLocal[0] = &jac[offset[i]];\n"
+                                "(*p[i])(" + argsLocal + ");\n");
         _cache << "\n";
 
     } else {
         assert(multiThreadingType == MultiThreadingType::PTHREADS);
 
-        printFunctionStartPThreads(_cache, jacInfo.size());
+        printFunctionStartPThreads(_cache, nJobs);
         _cache << "\n"
-                "   for(i = 0; i < " << jacInfo.size() << "; ++i) {\n"
+                "   for(i = 0; i < " << nJobs << "; ++i) {\n"
                 "      args[i] = (ExecArgStruct*) malloc(sizeof(ExecArgStruct));\n"
                 "      args[i]->func = p[i];\n"
                 "      args[i]->in = inLocal;\n"
@@ -446,7 +612,7 @@ std::string ModelCSourceGen<Base>::generateSparseJacobianForRevMultiThreadSource
                 "      args[i]->atomicFun = " << langC.getArgumentAtomic() << ";\n"
                 "   }\n"
                 "\n";
-        printFunctionEndPThreads(_cache, jacInfo.size());
+        printFunctionEndPThreads(_cache, nJobs);
     }
 
     _cache << "\n"
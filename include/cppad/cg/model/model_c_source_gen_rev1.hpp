@@ -87,7 +87,7 @@ void ModelCSourceGen<Base>::generateSparseReverseOneSourcesWithAtomics(const std
         startingJob("'" + subJobName + "'", JobTimer::GRAPH);
 
         CodeHandler<Base> handler;
-        handler.setJobTimer(_jobTimer);
+        configureHandler(handler);
 
         vector<CGBase> indVars(_fun.Domain());
         handler.makeVariables(indVars);
@@ -119,8 +119,7 @@ void ModelCSourceGen<Base>::generateSparseReverseOneSourcesWithAtomics(const std
         finishedJob();
 
         LanguageC<Base> langC(_baseTypeName);
-        langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-        langC.setParameterPrecision(_parameterPrecision);
+        configureLanguage(langC);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_ONE << "_dep" << i;
         langC.setGenerateFunction(_cache.str());
@@ -144,7 +143,7 @@ void ModelCSourceGen<Base>::generateSparseReverseOneSourcesNoAtomics(const std::
     size_t n = _fun.Domain();
 
     CodeHandler<Base> handler;
-    handler.setJobTimer(_jobTimer);
+    configureHandler(handler);
 
     vector<CGBase> x(n);
     handler.makeVariables(x);
@@ -206,8 +205,7 @@ void ModelCSourceGen<Base>::generateSparseReverseOneSourcesNoAtomics(const std::
         const std::string subJobName = _cache.str();
 
         LanguageC<Base> langC(_baseTypeName);
-        langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-        langC.setParameterPrecision(_parameterPrecision);
+        configureLanguage(langC);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_ONE << "_dep" << i;
         langC.setGenerateFunction(_cache.str());
@@ -234,10 +232,8 @@ void ModelCSourceGen<Base>::generateReverseOneSources() {
     std::string argsDcl = langC.generateDefaultFunctionArgumentsDcl();
     std::string args = langC.generateDefaultFunctionArguments();
 
-    _cache << "#include <stdlib.h>\n"
-            << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n"
-            "\n"
-            "int " << _name << "_" << FUNCTION_SPARSE_REVERSE_ONE << "(unsigned long pos, " << argsDcl << ");\n"
+    printFileStart(_cache);
+    _cache << "int " << _name << "_" << FUNCTION_SPARSE_REVERSE_ONE << "(unsigned long pos, " << argsDcl << ");\n"
             "void " << _name << "_" << FUNCTION_REVERSE_ONE_SPARSITY << "(unsigned long pos, unsigned long const** elements, unsigned long* nnz);\n"
             "\n";
     LanguageC<Base>::printFunctionDeclaration(_cache, "int", model_function, {_baseTypeName + " const x[]",
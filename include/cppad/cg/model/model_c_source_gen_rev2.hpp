@@ -15,6 +15,9 @@
  * Author: Joao Leal
  */
 
+#include <atomic>
+#include <exception>
+
 namespace CppAD {
 namespace cg {
 
@@ -48,8 +51,17 @@ void ModelCSourceGen<Base>::generateSparseReverseTwoSources() {
 
         startingJob("'model (reverse two)'", JobTimer::SOURCE_GENERATION);
 
+        size_t nThreads = std::min(_genThreads, elements.size());
+        nThreads = std::min(nThreads, CppADParallelSection<CGBase>::maxThreads());
+
         if (isAtomicsUsed()) {
             generateSparseReverseTwoSourcesWithAtomics(elements);
+        } else if (nThreads > 1 && CppADParallelSection<CGBase>::isAvailable()) {
+            /**
+             * each independent variable is processed with a new tape
+             * copy and operation graph by the first available thread
+             */
+            generateSparseReverseTwoSourcesParallel(elements, nThreads);
         } else {
             generateSparseReverseTwoSourcesNoAtomics(elements, evalRows, evalCols);
         }
@@ -67,78 +79,155 @@ void ModelCSourceGen<Base>::generateSparseReverseTwoSources() {
 
 template<class Base>
 void ModelCSourceGen<Base>::generateSparseReverseTwoSourcesWithAtomics(const std::map<size_t, std::vector<size_t> >& elements) {
+    for (const auto& it : elements) {
+        generateSparseReverseTwoSource(_fun, it.first, it.second,
+                                       _sources, _funcSplitReport, _atomicFunctions, _jobTimer);
+    }
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::generateSparseReverseTwoSourcesParallel(const std::map<size_t, std::vector<size_t> >& elements,
+                                                                    size_t nThreads) {
+    /**
+     * the result for each independent variable
+     */
+    struct ColumnSources {
+        size_t j;
+        const std::vector<size_t>* cols;
+        std::map<std::string, std::string> sources;
+        std::map<std::string, std::vector<FunctionSplitInfo> > funcSplitReport;
+        std::exception_ptr error;
+    };
+
+    std::vector<ColumnSources> columns(elements.size());
+    size_t pos = 0;
+    for (const auto& it : elements) {
+        columns[pos].j = it.first;
+        columns[pos].cols = &it.second;
+        pos++;
+    }
+
+    std::atomic<size_t> nextColumn(0);
+
+    auto worker = [&](size_t thread) {
+        CppADParallelSection<CGBase>::setThreadNumber(thread);
+        std::unique_ptr<ADFun<CGBase> > fun; // only used by this thread
+
+        for (size_t c = nextColumn++; c < columns.size(); c = nextColumn++) {
+            ColumnSources& col = columns[c];
+            try {
+                if (fun == nullptr) {
+                    fun.reset(new ADFun<CGBase>());
+                    *fun = _fun;
+                }
+                std::vector<std::string> atomicFunctions; // there are no atomic functions
+                generateSparseReverseTwoSource(*fun, col.j, *col.cols,
+                                               col.sources, col.funcSplitReport, atomicFunctions, nullptr);
+                CPPADCG_ASSERT_UNKNOWN(atomicFunctions.empty());
+            } catch (...) {
+                col.error = std::current_exception();
+            }
+        }
+    };
+
+    {
+        CppADParallelSection<CGBase> parallel(nThreads);
+
+        std::vector<std::thread> threads;
+        threads.reserve(nThreads - 1);
+        for (size_t t = 1; t < nThreads; t++)
+            threads.push_back(std::thread(worker, t));
+        worker(0);
+        for (std::thread& t : threads)
+            t.join();
+    }
+
+    // keep a deterministic order
+    for (ColumnSources& col : columns) {
+        if (col.error != nullptr)
+            std::rethrow_exception(col.error);
+
+        for (auto& itSrc : col.sources)
+            _sources[itSrc.first].swap(itSrc.second);
+        for (auto& itRep : col.funcSplitReport)
+            _funcSplitReport[itRep.first].swap(itRep.second);
+    }
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::generateSparseReverseTwoSource(ADFun<CGBase>& fun,
+                                                           size_t j,
+                                                           const std::vector<size_t>& cols,
+                                                           std::map<std::string, std::string>& sources,
+                                                           std::map<std::string, std::vector<FunctionSplitInfo> >& funcSplitReport,
+                                                           std::vector<std::string>& atomicFunctions,
+                                                           JobTimer* jobTimer) {
     using std::vector;
 
-    const size_t m = _fun.Range();
-    const size_t n = _fun.Domain();
+    const size_t m = fun.Range();
+    const size_t n = fun.Domain();
     //const size_t k = 1;
     const size_t p = 2;
 
-    vector<CGBase> tx1v(n);
+    std::ostringstream name;
+    name << "model (reverse two, indep " << j << ")";
+    const std::string subJobName = name.str();
 
-    for (const auto& it : elements) {
-        size_t j = it.first;
-        const std::vector<size_t>& cols = it.second;
+    if (jobTimer != nullptr)
+        jobTimer->startingJob("'" + subJobName + "'", JobTimer::GRAPH);
 
-        _cache.str("");
-        _cache << "model (reverse two, indep " << j << ")";
-        const std::string subJobName = _cache.str();
-
-        startingJob("'" + subJobName + "'", JobTimer::GRAPH);
-
-        CodeHandler<Base> handler;
-        handler.setJobTimer(_jobTimer);
+    CodeHandler<Base> handler;
+    configureHandler(handler, jobTimer);
 
-        vector<CGBase> tx0(n);
-        handler.makeVariables(tx0);
-        if (_x.size() > 0) {
-            for (size_t i = 0; i < n; i++) {
-                tx0[i].setValue(_x[i]);
-            }
+    vector<CGBase> tx0(n);
+    handler.makeVariables(tx0);
+    if (_x.size() > 0) {
+        for (size_t i = 0; i < n; i++) {
+            tx0[i].setValue(_x[i]);
         }
+    }
 
-        CGBase tx1;
-        handler.makeVariable(tx1);
-        if (_x.size() > 0) {
-            tx1.setValue(Base(1.0));
-        }
+    CGBase tx1;
+    handler.makeVariable(tx1);
+    if (_x.size() > 0) {
+        tx1.setValue(Base(1.0));
+    }
 
-        vector<CGBase> py(m); // (k+1)*m is not used because we are not interested in all values
-        handler.makeVariables(py);
-        if (_x.size() > 0) {
-            for (size_t i = 0; i < m; i++) {
-                py[i].setValue(Base(1.0));
-            }
+    vector<CGBase> py(m); // (k+1)*m is not used because we are not interested in all values
+    handler.makeVariables(py);
+    if (_x.size() > 0) {
+        for (size_t i = 0; i < m; i++) {
+            py[i].setValue(Base(1.0));
         }
+    }
 
-        _fun.Forward(0, tx0);
+    fun.Forward(0, tx0);
 
-        tx1v[j] = tx1;
-        _fun.Forward(1, tx1v);
-        tx1v[j] = Base(0);
-        vector<CGBase> px = _fun.Reverse(2, py);
-        CPPADCG_ASSERT_UNKNOWN(px.size() == 2 * n);
+    vector<CGBase> tx1v(n);
+    tx1v[j] = tx1;
+    fun.Forward(1, tx1v);
+    vector<CGBase> px = fun.Reverse(2, py);
+    CPPADCG_ASSERT_UNKNOWN(px.size() == 2 * n);
+
+    vector<CGBase> pxCustom;
+    for (size_t jj : cols) {
+        pxCustom.push_back(px[jj * p + 1]); // not interested in all values
+    }
 
-        vector<CGBase> pxCustom;
-        for (size_t jj : cols) {
-            pxCustom.push_back(px[jj * p + 1]); // not interested in all values
-        }
+    if (jobTimer != nullptr)
+        jobTimer->finishedJob();
 
-        finishedJob();
-
-        LanguageC<Base> langC(_baseTypeName);
-        langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-        langC.setParameterPrecision(_parameterPrecision);
-        _cache.str("");
-        _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "_indep" << j;
-        langC.setGenerateFunction(_cache.str());
+    LanguageC<Base> langC(_baseTypeName);
+    configureLanguage(langC, sources, funcSplitReport);
+    name.str("");
+    name << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "_indep" << j;
+    langC.setGenerateFunction(name.str());
 
-        std::ostringstream code;
-        std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator("px"));
-        LangCDefaultReverse2VarNameGenerator<Base> nameGenRev2(nameGen.get(), n, 1);
+    std::ostringstream code;
+    std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator("px"));
+    LangCDefaultReverse2VarNameGenerator<Base> nameGenRev2(nameGen.get(), n, 1);
 
-        handler.generateCode(code, langC, pxCustom, nameGenRev2, _atomicFunctions, subJobName);
-    }
+    handler.generateCode(code, langC, pxCustom, nameGenRev2, atomicFunctions, subJobName);
 }
 
 template<class Base>
@@ -165,7 +254,7 @@ void ModelCSourceGen<Base>::generateSparseReverseTwoSourcesNoAtomics(const std::
 
     // we can use a new handler to reduce memory usage
     CodeHandler<Base> handler;
-    handler.setJobTimer(_jobTimer);
+    configureHandler(handler);
 
     vector<CGBase> tx0(n);
     handler.makeVariables(tx0);
@@ -229,8 +318,7 @@ void ModelCSourceGen<Base>::generateSparseReverseTwoSourcesNoAtomics(const std::
         }
 
         LanguageC<Base> langC(_baseTypeName);
-        langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-        langC.setParameterPrecision(_parameterPrecision);
+        configureLanguage(langC);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "_indep" << j;
         langC.setGenerateFunction(_cache.str());
@@ -257,10 +345,8 @@ void ModelCSourceGen<Base>::generateReverseTwoSources() {
     std::string argsDcl = langC.generateDefaultFunctionArgumentsDcl();
     std::string args = langC.generateDefaultFunctionArguments();
 
-    _cache << "#include <stdlib.h>\n"
-            << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n"
-            "\n"
-            "int " << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "(unsigned long pos, " << argsDcl << ");\n"
+    printFileStart(_cache);
+    _cache << "int " << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "(unsigned long pos, " << argsDcl << ");\n"
             "void " << _name << "_" << FUNCTION_REVERSE_TWO_SPARSITY << "(unsigned long pos, unsigned long const** elements, unsigned long* nnz);\n"
             "\n";
     LanguageC<Base>::printFunctionDeclaration(_cache, "int", model_function, {_baseTypeName + " const tx[]",
@@ -109,6 +109,76 @@ public:
 
     virtual float getThreadPoolGuidedMaxWork() const = 0;
 
+    /**
+     * Provides how the threads used to determine sparse Jacobians and
+     * sparse Hessians are pinned to CPUs.
+     * This value is only used by the models if they were compiled with
+     * multithreading support.
+     *
+     * @return the thread affinity
+     */
+    virtual ThreadPoolAffinity getThreadPoolAffinity() const = 0;
+
+    /**
+     * Defines how the threads used to determine sparse Jacobians and
+     * sparse Hessians are pinned to CPUs.
+     * When combined with the static scheduling strategy, the same thread
+     * (and therefore the same CPU or NUMA node) evaluates the same jobs
+     * once the elapsed time measurements are complete.
+     * Existing threads are pinned the next time they receive work.
+     * This value is only used by the models if they were compiled with
+     * multithreading support (it is currently only supported by the
+     * pthread pool on Linux).
+     *
+     * @param a the thread affinity
+     */
+    virtual void setThreadPoolAffinity(ThreadPoolAffinity a) = 0;
+
+    /**
+     * Provides the time that idle threads (and the thread waiting for the
+     * results) actively wait for new work before blocking.
+     * This value is only used by the models if they were compiled with
+     * multithreading support.
+     *
+     * @return the active waiting time in seconds
+     */
+    virtual float getThreadPoolSpinTime() const = 0;
+
+    /**
+     * Defines the time that idle threads (and the thread waiting for the
+     * results) actively wait for new work before blocking.
+     * Active waiting reduces the latency of waking up threads for short
+     * evaluations (e.g. small sparse Jacobians) at the cost of CPU time.
+     * Threads yield the CPU while waiting if there are more threads than
+     * CPUs.
+     * This value is only used by the models if they were compiled with
+     * multithreading support.
+     *
+     * @param seconds the active waiting time in seconds (zero to block
+     *                immediately)
+     */
+    virtual void setThreadPoolSpinTime(float seconds) = 0;
+
+    /**
+     * Whether or not the thread requesting a multithreaded evaluation also
+     * executes jobs while it waits for the results.
+     * This value is only used by the models if they were compiled with
+     * multithreading support.
+     */
+    virtual bool isThreadPoolCallerExecutesJobs() const = 0;
+
+    /**
+     * Defines whether or not the thread requesting a multithreaded
+     * evaluation also executes jobs while it waits for the results.
+     * Jobs assigned to the pool threads by the static scheduling strategy
+     * are never executed by the calling thread.
+     * This value is only used by the models if they were compiled with
+     * multithreading support.
+     *
+     * @param e true if the calling thread should execute jobs
+     */
+    virtual void setThreadPoolCallerExecutesJobs(bool e) = 0;
+
     /**
      * Defines the number of time measurements taken by each computational
      * task during multithreaded model evaluations. This is used to schedule
@@ -39,8 +39,17 @@ public:
     static const std::string FUNCTION_ISTHREADPOOLVERBOSE;
     static const std::string FUNCTION_SETTHREADPOOLGUIDEDMAXGROUPWORK;
     static const std::string FUNCTION_GETTHREADPOOLGUIDEDMAXGROUPWORK;
+    static const std::string FUNCTION_SETTHREADPOOLAFFINITY;
+    static const std::string FUNCTION_GETTHREADPOOLAFFINITY;
+    static const std::string FUNCTION_SETTHREADPOOLSPINTIME;
+    static const std::string FUNCTION_GETTHREADPOOLSPINTIME;
+    static const std::string FUNCTION_SETTHREADPOOLCALLEREXECUTES;
+    static const std::string FUNCTION_ISTHREADPOOLCALLEREXECUTES;
     static const std::string FUNCTION_SETTHREADPOOLNUMBEROFTIMEMEAS;
     static const std::string FUNCTION_GETTHREADPOOLNUMBEROFTIMEMEAS;
+    static const std::string FILE_DIRECT_MODEL_CALLS;
+    static const std::string FILE_SHARED_HEADER;
+    static const std::string FILE_SHARED_SOURCE;
     static const unsigned long API_VERSION;
 protected:
     static const std::string CONST;
@@ -63,6 +72,26 @@ protected:
      * Parallelization can be disabled locally for each model.
      */
     MultiThreadingType _multiThreading;
+    /**
+     * Whether or not models in this library call the other models in this
+     * library, which are used as atomic functions, directly
+     */
+    bool _directModelCalls;
+    /**
+     * Whether or not the declarations common to all generated source files
+     * are placed in a single header file
+     */
+    bool _sharedHeader;
+    /**
+     * The maximum number of unity files into which the sources of each
+     * model are grouped (zero if unity builds are not used)
+     */
+    size_t _unityUnits;
+    /**
+     * The last model sources grouped into unity files
+     * (model name -> file name -> content)
+     */
+    std::map<std::string, std::map<std::string, std::string> > _modelUnitySources;
     /**
      * temporary stream to generate source code
      */
@@ -77,7 +106,10 @@ public:
      *              this object)
      */
     inline ModelLibraryCSourceGen(ModelCSourceGen<Base>& model):
-        _multiThreading(MultiThreadingType::NONE) {
+        _multiThreading(MultiThreadingType::NONE),
+        _directModelCalls(false),
+        _sharedHeader(false),
+        _unityUnits(0) {
         CPPADCG_ASSERT_KNOWN(_models.find(model.getName()) == _models.end(),
                              "Another model with the same name was already registered");
 
@@ -111,6 +143,8 @@ public:
 
         _models[model.getName()] = &model;
 
+        updateDirectModelCalls();
+
         _libSources.clear(); // must regenerate library sources again
     }
 
@@ -158,6 +192,112 @@ public:
         _multiThreading = multiThreading;
     }
 
+    /**
+     * Whether or not a model which uses another model from this library as
+     * an atomic function calls it directly.
+     *
+     * @return true if direct calls between models are enabled
+     */
+    inline bool isDirectModelCalls() const {
+        return _directModelCalls;
+    }
+
+    /**
+     * Defines whether or not a model which uses another model from this
+     * library as an atomic function (an atomic function with the same
+     * name as the model) calls it directly.
+     * Direct calls go from the generated code of the outer model to the
+     * sparse forward/reverse functions of the inner model without passing
+     * through LangCAtomicFun and the external function wrappers of
+     * FunctorGenericModel.
+     * If the inner model does not provide the required functions or if it
+     * uses atomic functions itself, the call falls back to the function
+     * registered with GenericModel::addExternalModel().
+     * The atomic function must be equivalent to the model in this library
+     * with the same name.
+     * This option must be defined before generating the model sources.
+     *
+     * @param direct whether or not to enable direct calls between models
+     */
+    inline void setDirectModelCalls(bool direct) {
+        _directModelCalls = direct;
+        updateDirectModelCalls();
+        _libSources.clear(); // must regenerate library sources again
+    }
+
+    /**
+     * Whether or not the declarations which are common to the generated
+     * source files are placed in a single header file.
+     *
+     * @return true if the generated sources include a shared header
+     */
+    inline bool isSharedHeader() const {
+        return _sharedHeader;
+    }
+
+    /**
+     * Defines whether or not the declarations which are repeated in every
+     * generated source file (standard library includes, the LangCAtomicFun
+     * and Array structures, the thread pool declarations, ...) are placed
+     * in a single header file (FILE_SHARED_HEADER).
+     * Helper functions used by several files (e.g. the function executed
+     * by the pthread pool jobs) are then compiled only once in a
+     * library source file (FILE_SHARED_SOURCE).
+     * The preamble of each source file is replaced by a single include
+     * directive, and compilers such as GccCompiler and ClangCompiler
+     * precompile the header only once.
+     * The header must be provided to the compiler (see
+     * CCompiler::createSharedHeader()) which is done by
+     * DynamicModelLibraryProcessor.
+     *
+     * @param sharedHeader whether or not to use a shared header
+     */
+    inline void setSharedHeader(bool sharedHeader) {
+        _sharedHeader = sharedHeader;
+        _libSources.clear(); // must regenerate library sources again
+    }
+
+    /**
+     * Provides the maximum number of unity files into which the sources of
+     * each model are grouped.
+     *
+     * @return the number of unity files or zero if unity builds are not
+     *         used
+     */
+    inline size_t getUnityUnits() const {
+        return _unityUnits;
+    }
+
+    /**
+     * Defines whether or not the many small source files generated for
+     * each model (and the library level source files) are grouped into a
+     * few larger files (unity builds), which reduces the time spent
+     * starting compiler processes, parsing the same declarations and
+     * linking.
+     * The files are distributed deterministically so that the estimated
+     * number of assignments in each unity file is balanced.
+     * The shared declarations are placed only once at the beginning of
+     * each unity file (see setSharedHeader()) and file scope static
+     * symbols are renamed in order to avoid clashes.
+     * The unity files can be compiled in parallel using
+     * AbstractCCompiler::setCompileThreads().
+     *
+     * @param units the maximum number of unity files for each model
+     *              (zero disables unity builds)
+     */
+    inline void setUnityUnits(size_t units) {
+        _unityUnits = units;
+        _libSources.clear(); // must regenerate library sources again
+    }
+
+    /**
+     * Provides the content of the header shared by the generated sources.
+     *
+     * @return the header content or an empty string if shared headers are
+     *         not used
+     */
+    virtual std::string getSharedHeader();
+
     /**
      * Saves the generated C source code into several files.
      * 
@@ -186,6 +326,70 @@ protected:
 
     virtual void generateThreadPoolSources(std::map<std::string, std::string>& sources);
 
+    virtual void generateDirectModelCallsSource(std::map<std::string, std::string>& sources);
+
+    /**
+     * Provides the sources of a model which include the shared header if
+     * it is used.
+     */
+    virtual const std::map<std::string, std::string>& getModelSources(ModelCSourceGen<Base>& model);
+
+    /**
+     * Provides the declarations which are placed in the shared header.
+     */
+    virtual std::vector<std::string> getSharedDeclarations();
+
+    /**
+     * Creates the content of the shared header.
+     */
+    virtual std::string generateSharedHeader();
+
+    /**
+     * Whether or not the generated source files start with the inclusion
+     * of the shared header instead of the shared declarations.
+     */
+    inline bool isSharedHeaderIncluded() const;
+
+    /**
+     * Prints the beginning of a library source file.
+     *
+     * @param declarations the declarations required by the source file
+     *                     which are replaced by the inclusion of the shared
+     *                     header when it is used
+     */
+    inline void printFileStart(std::ostringstream& cache,
+                               const std::string& declarations) const;
+
+    /**
+     * Groups source files into unity files.
+     *
+     * @param sources the source files which are replaced by the unity files
+     * @param name the prefix for the unity file names
+     */
+    virtual void createUnityUnits(std::map<std::string, std::string>& sources,
+                                  const std::string& name);
+
+    /**
+     * Estimates the number of assignments in a source file (the number
+     * of statements).
+     */
+    static size_t estimateAssignments(const std::string& source);
+
+    /**
+     * Determines the names of the static functions and variables defined
+     * at file scope in a source file.
+     */
+    static std::vector<std::string> findStaticSymbols(const std::string& source);
+
+    virtual void generateSharedSource(std::map<std::string, std::string>& sources);
+
+    /**
+     * Whether or not any model uses multithreading.
+     */
+    inline bool isMultiThreadingUsed() const;
+
+    inline void updateDirectModelCalls();
+
     static void saveSources(const std::string& sourcesFolder,
                             const std::map<std::string, std::string>& sources);
 
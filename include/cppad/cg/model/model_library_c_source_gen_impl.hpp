@@ -62,12 +62,39 @@ const std::string ModelLibraryCSourceGen<Base>::FUNCTION_SETTHREADPOOLGUIDEDMAXG
 template<class Base>
 const std::string ModelLibraryCSourceGen<Base>::FUNCTION_GETTHREADPOOLGUIDEDMAXGROUPWORK = "cppad_cg_thpool_get_guided_maxgroupwork";
 
+template<class Base>
+const std::string ModelLibraryCSourceGen<Base>::FUNCTION_SETTHREADPOOLAFFINITY = "cppad_cg_thpool_set_affinity";
+
+template<class Base>
+const std::string ModelLibraryCSourceGen<Base>::FUNCTION_GETTHREADPOOLAFFINITY = "cppad_cg_thpool_get_affinity";
+
+template<class Base>
+const std::string ModelLibraryCSourceGen<Base>::FUNCTION_SETTHREADPOOLSPINTIME = "cppad_cg_thpool_set_spin_time";
+
+template<class Base>
+const std::string ModelLibraryCSourceGen<Base>::FUNCTION_GETTHREADPOOLSPINTIME = "cppad_cg_thpool_get_spin_time";
+
+template<class Base>
+const std::string ModelLibraryCSourceGen<Base>::FUNCTION_SETTHREADPOOLCALLEREXECUTES = "cppad_cg_thpool_set_caller_executes";
+
+template<class Base>
+const std::string ModelLibraryCSourceGen<Base>::FUNCTION_ISTHREADPOOLCALLEREXECUTES = "cppad_cg_thpool_is_caller_executes";
+
 template<class Base>
 const std::string ModelLibraryCSourceGen<Base>::FUNCTION_SETTHREADPOOLNUMBEROFTIMEMEAS = "cppad_cg_thpool_set_number_of_time_meas";
 
 template<class Base>
 const std::string ModelLibraryCSourceGen<Base>::FUNCTION_GETTHREADPOOLNUMBEROFTIMEMEAS = "cppad_cg_thpool_get_number_of_time_meas";
 
+template<class Base>
+const std::string ModelLibraryCSourceGen<Base>::FILE_DIRECT_MODEL_CALLS = "cppad_cg_direct_model_calls";
+
+template<class Base>
+const std::string ModelLibraryCSourceGen<Base>::FILE_SHARED_HEADER = "cppad_cg_shared.h";
+
+template<class Base>
+const std::string ModelLibraryCSourceGen<Base>::FILE_SHARED_SOURCE = "cppad_cg_shared";
+
 template<class Base>
 const std::string ModelLibraryCSourceGen<Base>::CONST = "const";
 
@@ -79,7 +106,11 @@ void ModelLibraryCSourceGen<Base>::saveSources(const std::string& sourcesFolder)
 
     // save/generate model sources
     for (const auto& it : _models) {
-        saveSources(sourcesFolder, it.second->getSources());
+        saveSources(sourcesFolder, getModelSources(*it.second));
+    }
+
+    if (_sharedHeader) {
+        saveSources(sourcesFolder, {{FILE_SHARED_HEADER, getSharedHeader()}});
     }
 
     // save/generate library sources
@@ -109,6 +140,7 @@ const std::map<std::string, std::string>& ModelLibraryCSourceGen<Base>::getLibra
         generateModelsSource(_libSources);
         generateOnCloseSource(_libSources);
         generateThreadPoolSources(_libSources);
+        generateDirectModelCallsSource(_libSources);
 
         if(_multiThreading != MultiThreadingType::NONE) {
             bool usingMultiThreading = false;
@@ -128,11 +160,263 @@ const std::map<std::string, std::string>& ModelLibraryCSourceGen<Base>::getLibra
                 }
             }
         }
+
+        if (_unityUnits > 0) {
+            generateSharedSource(_libSources);
+            createUnityUnits(_libSources, "cppad_cg_library");
+        } else if (_sharedHeader) {
+            generateSharedSource(_libSources);
+        }
     }
 
     return _libSources;
 }
 
+template<class Base>
+const std::map<std::string, std::string>& ModelLibraryCSourceGen<Base>::getModelSources(ModelCSourceGen<Base>& model) {
+    // the sources cannot be modified after they are generated
+    model.setSharedHeader(isSharedHeaderIncluded() ? FILE_SHARED_HEADER : "");
+
+    const std::map<std::string, std::string>& sources = model.getSources(_multiThreading, this);
+    if (_unityUnits == 0)
+        return sources;
+
+    std::map<std::string, std::string>& modelSources = _modelUnitySources[model.getName()];
+    modelSources = sources;
+    createUnityUnits(modelSources, model.getName());
+    return modelSources;
+}
+
+template<class Base>
+std::vector<std::string> ModelLibraryCSourceGen<Base>::getSharedDeclarations() {
+    const std::string baseType = ModelCSourceGen<Base>::baseTypeName();
+    LanguageC<Base> langC(baseType);
+
+    std::vector<std::string> dcls{"#include <math.h>\n",
+                                  "#include <stdio.h>\n",
+                                  "#include <stdlib.h>\n"};
+
+    MultiThreadingType multiThreading = isMultiThreadingUsed() ? _multiThreading : MultiThreadingType::NONE;
+
+    if (multiThreading == MultiThreadingType::OPENMP) {
+        dcls.push_back("#include <omp.h>\n");
+        dcls.push_back("#include <time.h>\n");
+    }
+
+    dcls.push_back(LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION);
+
+    if (multiThreading != MultiThreadingType::NONE) {
+        dcls.push_back("typedef void (*cppadcg_function_type) (" + langC.generateDefaultFunctionArgumentsDcl() + ");\n");
+    }
+
+    if (multiThreading == MultiThreadingType::PTHREADS) {
+        dcls.push_back(CPPADCG_PTHREAD_POOL_H_FILE);
+        dcls.push_back(ModelCSourceGen<Base>::pthreadsExecArgDefinition(baseType));
+        dcls.push_back("static " + ModelCSourceGen<Base>::pthreadsExecFunctionDefinition());
+    } else if (multiThreading == MultiThreadingType::OPENMP) {
+        dcls.push_back(CPPADCG_OPENMP_H_FILE);
+    }
+
+    return dcls;
+}
+
+template<class Base>
+std::string ModelLibraryCSourceGen<Base>::getSharedHeader() {
+    if (!_sharedHeader)
+        return "";
+
+    return generateSharedHeader();
+}
+
+template<class Base>
+std::string ModelLibraryCSourceGen<Base>::generateSharedHeader() {
+    std::ostringstream out;
+    out << "#ifndef CPPAD_CG_SHARED_H\n"
+            "#define CPPAD_CG_SHARED_H\n"
+            "\n";
+
+    const std::string execFunc = "static " + ModelCSourceGen<Base>::pthreadsExecFunctionDefinition();
+
+    for (const std::string& dcl : getSharedDeclarations()) {
+        if (dcl == execFunc) {
+            // compiled only once in the shared source file
+            out << "void cppadcg_exec_func(void* arg);\n";
+        } else if (dcl.compare(0, 9, "#include ") == 0) {
+            out << dcl;
+        } else {
+            out << "\n" << dcl << "\n";
+        }
+    }
+
+    out << "\n"
+            "#endif\n";
+
+    return out.str();
+}
+
+template<class Base>
+inline bool ModelLibraryCSourceGen<Base>::isSharedHeaderIncluded() const {
+    return _sharedHeader || _unityUnits > 0;
+}
+
+template<class Base>
+inline void ModelLibraryCSourceGen<Base>::printFileStart(std::ostringstream& cache,
+                                                         const std::string& declarations) const {
+    if (isSharedHeaderIncluded()) {
+        // must be the first line so that a precompiled header can be used
+        cache << "#include \"" << FILE_SHARED_HEADER << "\"\n\n";
+    } else {
+        cache << declarations << "\n\n";
+    }
+}
+
+template<class Base>
+void ModelLibraryCSourceGen<Base>::createUnityUnits(std::map<std::string, std::string>& sources,
+                                                    const std::string& name) {
+    const std::string include = "#include \"" + FILE_SHARED_HEADER + "\"\n";
+
+    std::map<std::string, std::string> units;
+    std::vector<std::pair<size_t, const std::string*> > files; // estimated cost, file name
+
+    for (auto& it : sources) {
+        if (it.first == "thread_pool.c") {
+            units[it.first].swap(it.second); // not a generated source (it is not grouped)
+            continue;
+        }
+
+        std::string& source = it.second;
+        if (source.compare(0, include.size(), include) == 0)
+            source.erase(0, include.size()); // the header is included once by the unit
+
+        files.push_back(std::make_pair(estimateAssignments(source) + 1, &it.first));
+    }
+
+    if (!files.empty()) {
+        /**
+         * longest processing time first: each file is added to the unit
+         * with the lowest cost (ties are resolved using the file names
+         * so that the units are always the same)
+         */
+        std::stable_sort(files.begin(), files.end(),
+                         [](const std::pair<size_t, const std::string*>& a,
+                            const std::pair<size_t, const std::string*>& b) {
+                             return a.first > b.first;
+                         });
+
+        const size_t nUnits = std::min(_unityUnits, files.size());
+        std::vector<size_t> cost(nUnits, 0);
+        std::vector<std::vector<const std::string*> > unitFiles(nUnits);
+        for (const auto& f : files) {
+            size_t u = std::min_element(cost.begin(), cost.end()) - cost.begin();
+            cost[u] += f.first;
+            unitFiles[u].push_back(f.second);
+        }
+
+        const std::string header = _sharedHeader ? include : generateSharedHeader();
+
+        std::ostringstream out;
+        for (size_t u = 0; u < nUnits; u++) {
+            std::vector<const std::string*>& names = unitFiles[u];
+            std::sort(names.begin(), names.end(),
+                      [](const std::string* a, const std::string* b) {
+                          return *a < *b;
+                      });
+
+            out.str("");
+            out << header << "\n";
+            for (size_t f = 0; f < names.size(); f++) {
+                const std::string& source = sources.at(*names[f]);
+
+                // static symbols with the same name may exist in other files
+                std::vector<std::string> statics = findStaticSymbols(source);
+
+                out << "/* " << *names[f] << " */\n";
+                for (const std::string& s : statics)
+                    out << "#define " << s << " " << s << "__" << f << "\n";
+                out << "#line 1 \"" << *names[f] << "\"\n";
+                out << source;
+                if (!source.empty() && source.back() != '\n')
+                    out << "\n";
+                for (const std::string& s : statics)
+                    out << "#undef " << s << "\n";
+                out << "\n";
+            }
+
+            units[name + "_unity" + std::to_string(u) + ".c"] = out.str();
+        }
+    }
+
+    sources.swap(units);
+}
+
+template<class Base>
+size_t ModelLibraryCSourceGen<Base>::estimateAssignments(const std::string& source) {
+    return std::count(source.begin(), source.end(), ';');
+}
+
+template<class Base>
+std::vector<std::string> ModelLibraryCSourceGen<Base>::findStaticSymbols(const std::string& source) {
+    static const std::set<std::string> keywords{"void", "char", "short", "int", "long", "float", "double",
+                                                "signed", "unsigned", "const", "volatile", "inline", "struct"};
+    const std::string staticStr = "static ";
+
+    std::vector<std::string> names;
+
+    size_t pos = 0;
+    while (pos < source.size()) {
+        size_t end = source.find('\n', pos);
+        if (end == std::string::npos)
+            end = source.size();
+
+        if (source.compare(pos, staticStr.size(), staticStr) == 0) {
+            // the name is the last identifier before the arguments, dimensions or initialization
+            size_t e = source.find_first_of("([=;{", pos);
+            if (e != std::string::npos && e < end) {
+                while (e > pos && std::isspace(static_cast<unsigned char> (source[e - 1])))
+                    e--;
+                size_t b = e;
+                while (b > pos && (std::isalnum(static_cast<unsigned char> (source[b - 1])) || source[b - 1] == '_'))
+                    b--;
+                std::string symbol = source.substr(b, e - b);
+                if (!symbol.empty() && !std::isdigit(static_cast<unsigned char> (symbol[0])) && keywords.find(symbol) == keywords.end() &&
+                    std::find(names.begin(), names.end(), symbol) == names.end()) {
+                    names.push_back(symbol);
+                }
+            }
+        }
+
+        pos = end + 1;
+    }
+
+    return names;
+}
+
+template<class Base>
+void ModelLibraryCSourceGen<Base>::generateSharedSource(std::map<std::string, std::string>& sources) {
+    if (!isMultiThreadingUsed() || _multiThreading != MultiThreadingType::PTHREADS)
+        return; // no helper functions
+
+    _cache.str("");
+    _cache << "#include \"" << FILE_SHARED_HEADER << "\"\n"
+            "\n"
+            << ModelCSourceGen<Base>::pthreadsExecFunctionDefinition();
+
+    sources[FILE_SHARED_SOURCE + ".c"] = _cache.str();
+}
+
+template<class Base>
+inline bool ModelLibraryCSourceGen<Base>::isMultiThreadingUsed() const {
+    if (_multiThreading == MultiThreadingType::NONE)
+        return false;
+
+    for (const auto& it : _models) {
+        if (it.second->isJacobianMultiThreadingEnabled() || it.second->isHessianMultiThreadingEnabled()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 template<class Base>
 void ModelLibraryCSourceGen<Base>::generateVersionSource(std::map<std::string, std::string>& sources) {
     _cache.str("");
@@ -179,7 +463,7 @@ void ModelLibraryCSourceGen<Base>::generateOnCloseSource(std::map<std::string, s
 
     _cache.str("");
     if (pthreads) {
-        _cache << CPPADCG_PTHREAD_POOL_H_FILE << "\n\n";
+        printFileStart(_cache, CPPADCG_PTHREAD_POOL_H_FILE);
     }
     _cache << "void " << FUNCTION_ONCLOSE << "() {\n";
     if (pthreads) {
@@ -205,7 +489,7 @@ void ModelLibraryCSourceGen<Base>::generateThreadPoolSources(std::map<std::strin
 
     if (usingMultiThreading && _multiThreading == MultiThreadingType::PTHREADS) {
         _cache.str("");
-        _cache << CPPADCG_PTHREAD_POOL_H_FILE << "\n\n";
+        printFileStart(_cache, CPPADCG_PTHREAD_POOL_H_FILE);
 
         _cache << "void " << FUNCTION_SETTHREADPOOLDISABLED << "(int disabled) {\n";
         _cache << "   cppadcg_thpool_set_disabled(disabled);\n";
@@ -247,6 +531,30 @@ void ModelLibraryCSourceGen<Base>::generateThreadPoolSources(std::map<std::strin
         _cache << "   return cppadcg_thpool_get_guided_maxgroupwork();\n";
         _cache << "}\n\n";
 
+        _cache << "void " << FUNCTION_SETTHREADPOOLAFFINITY << "(enum ThreadAffinity a) {\n";
+        _cache << "   cppadcg_thpool_set_affinity(a);\n";
+        _cache << "}\n\n";
+
+        _cache << "enum ThreadAffinity " << FUNCTION_GETTHREADPOOLAFFINITY << "() {\n";
+        _cache << "   return cppadcg_thpool_get_affinity();\n";
+        _cache << "}\n\n";
+
+        _cache << "void " << FUNCTION_SETTHREADPOOLSPINTIME << "(float seconds) {\n";
+        _cache << "   cppadcg_thpool_set_spin_time(seconds);\n";
+        _cache << "}\n\n";
+
+        _cache << "float " << FUNCTION_GETTHREADPOOLSPINTIME << "() {\n";
+        _cache << "   return cppadcg_thpool_get_spin_time();\n";
+        _cache << "}\n\n";
+
+        _cache << "void " << FUNCTION_SETTHREADPOOLCALLEREXECUTES << "(int e) {\n";
+        _cache << "   cppadcg_thpool_set_caller_executes(e);\n";
+        _cache << "}\n\n";
+
+        _cache << "int " << FUNCTION_ISTHREADPOOLCALLEREXECUTES << "() {\n";
+        _cache << "   return cppadcg_thpool_is_caller_executes();\n";
+        _cache << "}\n\n";
+
         _cache << "void " << FUNCTION_SETTHREADPOOLNUMBEROFTIMEMEAS << "(unsigned int n) {\n";
         _cache << "   cppadcg_thpool_set_n_time_meas(n);\n";
         _cache << "}\n\n";
@@ -259,8 +567,7 @@ void ModelLibraryCSourceGen<Base>::generateThreadPoolSources(std::map<std::strin
 
     } else if(usingMultiThreading && _multiThreading == MultiThreadingType::OPENMP) {
         _cache.str("");
-        _cache << "#include <omp.h>\n";
-        _cache << CPPADCG_OPENMP_H_FILE << "\n\n";
+        printFileStart(_cache, std::string("#include <omp.h>\n") + CPPADCG_OPENMP_H_FILE);
 
         _cache << "void " << FUNCTION_SETTHREADPOOLDISABLED << "(int disabled) {\n";
         _cache << "   cppadcg_openmp_set_disabled(disabled);\n";
@@ -302,10 +609,11 @@ void ModelLibraryCSourceGen<Base>::generateThreadPoolSources(std::map<std::strin
         _cache << "}\n\n";
 
         _cache << "void " << FUNCTION_SETTHREADPOOLNUMBEROFTIMEMEAS << "(unsigned int n) {\n";
+        _cache << "   cppadcg_openmp_set_n_time_meas(n);\n";
         _cache << "}\n\n";
 
         _cache << "unsigned int " << FUNCTION_GETTHREADPOOLNUMBEROFTIMEMEAS << "() {\n";
-        _cache << "   return 0;\n";
+        _cache << "   return cppadcg_openmp_get_n_time_meas();\n";
         _cache << "}\n\n";
 
         sources["thread_pool_access.c"] = _cache.str();
@@ -360,6 +668,176 @@ void ModelLibraryCSourceGen<Base>::generateThreadPoolSources(std::map<std::strin
     }
 }
 
+template<class Base>
+void ModelLibraryCSourceGen<Base>::generateDirectModelCallsSource(std::map<std::string, std::string>& sources) {
+    if (!_directModelCalls || _models.size() < 2)
+        return;
+
+    const std::string baseType = ModelCSourceGen<Base>::baseTypeName();
+    const std::string& uIdx = LanguageC<Base>::U_INDEX_TYPE;
+
+    _cache.str("");
+    printFileStart(_cache, LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION);
+
+    for (const auto& it : _models) {
+        const std::string& name = it.first;
+        ModelCSourceGen<Base>& model = *it.second;
+
+        /**
+         * the inner model functions can only be called directly if they do
+         * not use atomic functions (the LangCAtomicFun of the outer model
+         * would be used)
+         */
+        bool noAtomics = !model.isAtomicsUsed();
+        bool zero = noAtomics && model._zero;
+        bool for1 = noAtomics && model._forwardOne;
+        bool rev1 = noAtomics && model._reverseOne;
+        bool rev2 = noAtomics && model._reverseTwo;
+
+        size_t n = model._fun.Domain();
+        size_t m = model._fun.Range();
+
+        std::string zeroName = name + "_" + ModelCSourceGen<Base>::FUNCTION_FORWAD_ZERO;
+        std::string for1Name = name + "_" + ModelCSourceGen<Base>::FUNCTION_SPARSE_FORWARD_ONE;
+        std::string for1SpName = name + "_" + ModelCSourceGen<Base>::FUNCTION_FORWARD_ONE_SPARSITY;
+        std::string rev1Name = name + "_" + ModelCSourceGen<Base>::FUNCTION_SPARSE_REVERSE_ONE;
+        std::string rev1SpName = name + "_" + ModelCSourceGen<Base>::FUNCTION_REVERSE_ONE_SPARSITY;
+        std::string rev2Name = name + "_" + ModelCSourceGen<Base>::FUNCTION_SPARSE_REVERSE_TWO;
+        std::string rev2SpName = name + "_" + ModelCSourceGen<Base>::FUNCTION_REVERSE_TWO_SPARSITY;
+
+        _cache << "/**\n"
+                " * model " << name << "\n"
+                " */\n";
+        if (zero)
+            _cache << "void " << zeroName << "(" << baseType << " const *const * in, " << baseType << "*const * out, struct LangCAtomicFun atomicFun);\n";
+        if (for1) {
+            _cache << "int " << for1Name << "(" << uIdx << " pos, " << baseType << " const *const * in, " << baseType << "*const * out, struct LangCAtomicFun atomicFun);\n";
+            _cache << "void " << for1SpName << "(" << uIdx << " pos, " << uIdx << " const** elements, " << uIdx << "* nnz);\n";
+        }
+        if (rev1) {
+            _cache << "int " << rev1Name << "(" << uIdx << " pos, " << baseType << " const *const * in, " << baseType << "*const * out, struct LangCAtomicFun atomicFun);\n";
+            _cache << "void " << rev1SpName << "(" << uIdx << " pos, " << uIdx << " const** elements, " << uIdx << "* nnz);\n";
+        }
+        if (rev2) {
+            _cache << "int " << rev2Name << "(" << uIdx << " pos, " << baseType << " const *const * in, " << baseType << "*const * out, struct LangCAtomicFun atomicFun);\n";
+            _cache << "void " << rev2SpName << "(" << uIdx << " pos, " << uIdx << " const** elements, " << uIdx << "* nnz);\n";
+        }
+        _cache << "\n";
+
+        /**
+         * forward mode
+         */
+        _cache << LanguageC<Base>::directAtomicForwardDeclaration(name) << " {\n";
+        if (zero || for1) {
+            _cache << "   " << baseType << " const* in[2];\n"
+                    "   " << baseType << "* out[1];\n";
+        }
+        if (for1) {
+            _cache << "   " << baseType << " compressed[" << std::max<size_t>(m, 1) << "];\n"
+                    "   " << baseType << "* ty1;\n"
+                    "   " << baseType << " const* tx1;\n"
+                    "   " << uIdx << " const* pos;\n"
+                    "   " << uIdx << " nnz, e, ePos, j;\n";
+        }
+        _cache << "\n";
+        if (zero) {
+            _cache << "   if (p == 0 && !tx[0].sparse && !ty->sparse) {\n"
+                    "      in[0] = (" << baseType << " const*) tx[0].data;\n"
+                    "      out[0] = (" << baseType << "*) ty->data;\n"
+                    "      " << zeroName << "(in, out, atomicFun);\n"
+                    "      return 1;\n"
+                    "   }\n\n";
+        }
+        if (for1) {
+            _cache << "   if (p == 1 && !tx[0].sparse && tx[1].sparse && !ty->sparse) {\n"
+                    "      ty1 = (" << baseType << "*) ty->data;\n"
+                    "      for (e = 0; e < " << m << "; e++) ty1[e] = 0;\n"
+                    "      tx1 = (" << baseType << " const*) tx[1].data;\n"
+                    "      in[0] = (" << baseType << " const*) tx[0].data;\n"
+                    "      out[0] = compressed;\n"
+                    "      for (e = 0; e < tx[1].nnz; e++) {\n"
+                    "         j = tx[1].idx[e];\n"
+                    "         " << for1SpName << "(j, &pos, &nnz);\n"
+                    "         in[1] = &tx1[e];\n"
+                    "         if (" << for1Name << "(j, in, out, atomicFun) != 0) return 0;\n"
+                    "         for (ePos = 0; ePos < nnz; ePos++) ty1[pos[ePos]] += compressed[ePos];\n"
+                    "      }\n"
+                    "      return 1;\n"
+                    "   }\n\n";
+        }
+        _cache << "   return atomicFun.forward(atomicFun.libModel, atomicIndex, q, p, tx, ty);\n"
+                "}\n\n";
+
+        /**
+         * reverse mode
+         */
+        _cache << LanguageC<Base>::directAtomicReverseDeclaration(name) << " {\n";
+        if (rev1 || rev2) {
+            _cache << "   " << baseType << " const* in[3];\n"
+                    "   " << baseType << "* out[1];\n"
+                    "   " << baseType << " compressed[" << std::max<size_t>(n, 1) << "];\n"
+                    "   " << baseType << "* px0;\n"
+                    "   " << baseType << " const* v;\n"
+                    "   " << uIdx << " const* pos;\n"
+                    "   " << uIdx << " nnz, e, ePos, i;\n";
+        }
+        _cache << "\n";
+        if (rev1) {
+            _cache << "   if (p == 0 && !tx[0].sparse && !px->sparse && py[0].sparse) {\n"
+                    "      px0 = (" << baseType << "*) px->data;\n"
+                    "      for (e = 0; e < " << n << "; e++) px0[e] = 0;\n"
+                    "      v = (" << baseType << " const*) py[0].data;\n"
+                    "      in[0] = (" << baseType << " const*) tx[0].data;\n"
+                    "      out[0] = compressed;\n"
+                    "      for (e = 0; e < py[0].nnz; e++) {\n"
+                    "         i = py[0].idx[e];\n"
+                    "         " << rev1SpName << "(i, &pos, &nnz);\n"
+                    "         in[1] = &v[e];\n"
+                    "         if (" << rev1Name << "(i, in, out, atomicFun) != 0) return 0;\n"
+                    "         for (ePos = 0; ePos < nnz; ePos++) px0[pos[ePos]] += compressed[ePos];\n"
+                    "      }\n"
+                    "      return 1;\n"
+                    "   }\n\n";
+        }
+        if (rev2) {
+            _cache << "   if (p == 1 && !tx[0].sparse && tx[1].sparse && !px->sparse && py[0].sparse && py[0].nnz == 0 && !py[1].sparse) {\n"
+                    "      px0 = (" << baseType << "*) px->data;\n"
+                    "      for (e = 0; e < " << n << "; e++) px0[e] = 0;\n"
+                    "      v = (" << baseType << " const*) tx[1].data;\n"
+                    "      in[0] = (" << baseType << " const*) tx[0].data;\n"
+                    "      in[2] = (" << baseType << " const*) py[1].data;\n"
+                    "      out[0] = compressed;\n"
+                    "      for (e = 0; e < tx[1].nnz; e++) {\n"
+                    "         i = tx[1].idx[e];\n"
+                    "         " << rev2SpName << "(i, &pos, &nnz);\n"
+                    "         in[1] = &v[e];\n"
+                    "         if (" << rev2Name << "(i, in, out, atomicFun) != 0) return 0;\n"
+                    "         for (ePos = 0; ePos < nnz; ePos++) px0[pos[ePos]] += compressed[ePos];\n"
+                    "      }\n"
+                    "      return 1;\n"
+                    "   }\n\n";
+        }
+        _cache << "   return atomicFun.reverse(atomicFun.libModel, atomicIndex, p, tx, px, py);\n"
+                "}\n\n";
+    }
+
+    sources[FILE_DIRECT_MODEL_CALLS + ".c"] = _cache.str();
+}
+
+template<class Base>
+inline void ModelLibraryCSourceGen<Base>::updateDirectModelCalls() {
+    for (const auto& it : _models) {
+        ModelCSourceGen<Base>& model = *it.second;
+        model._directAtomicModels.clear();
+        if (_directModelCalls) {
+            for (const auto& it2 : _models) {
+                if (it2.second != &model)
+                    model._directAtomicModels.insert(it2.first);
+            }
+        }
+    }
+}
+
 } // END cg namespace
 } // END CppAD namespace
 
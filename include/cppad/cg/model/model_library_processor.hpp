@@ -43,7 +43,34 @@ protected:
     }
 
     inline const std::map<std::string, std::string>& getSources(ModelCSourceGen<Base>& model) {
-        return model.getSources(modelLibraryHelper_->getMultiThreading(), modelLibraryHelper_);
+        return modelLibraryHelper_->getModelSources(model);
+    }
+
+    inline std::string getSourcesFingerprint(ModelCSourceGen<Base>& model) {
+        std::string fingerprint = model.getSourcesFingerprint(modelLibraryHelper_->getMultiThreading());
+        if (!modelLibraryHelper_->isSharedHeader() && modelLibraryHelper_->getUnityUnits() == 0)
+            return fingerprint;
+
+        BuildFingerprint fp;
+        fp << fingerprint << modelLibraryHelper_->getSharedHeader() << modelLibraryHelper_->getUnityUnits();
+        return fp.str();
+    }
+
+    /**
+     * @return the names of the atomic functions used by the generated
+     *         sources of a model
+     */
+    inline const std::vector<std::string>& getAtomicFunctions(const ModelCSourceGen<Base>& model) const {
+        return model._atomicFunctions;
+    }
+
+    /**
+     * Defines the atomic functions used by a model whose sources are not
+     * generated again (see ModelCSourceGen::restoreAtomicFunctions()).
+     */
+    inline void restoreAtomicFunctions(ModelCSourceGen<Base>& model,
+                                       const std::vector<std::string>& atomicFunctions) {
+        model.restoreAtomicFunctions(atomicFunctions);
     }
 
 };
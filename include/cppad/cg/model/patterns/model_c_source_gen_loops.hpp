@@ -1159,6 +1159,8 @@ void printForRevUsageFunction(std::ostringstream& out,
  * @param baseTypeName
  * @param suffix
  * @param generateLocalFunctionName
+ * @param sharedHeader the header with the common declarations included
+ *                     at the beginning of the file (empty if not used)
  * @return 
  */
 template<class Base>
@@ -1169,7 +1171,8 @@ std::string generateGlobalForRevWithLoopsFunctionSource(const std::map<size_t, s
                                                         const std::string& modelName,
                                                         const std::string& baseTypeName,
                                                         const std::string& suffix,
-                                                        void (*generateLocalFunctionName)(std::ostringstream& cache, const std::string& modelName, const LoopModel<Base>& loop, size_t g)) {
+                                                        void (*generateLocalFunctionName)(std::ostringstream& cache, const std::string& modelName, const LoopModel<Base>& loop, size_t g),
+                                                        const std::string& sharedHeader) {
 
     using namespace std;
 
@@ -1199,8 +1202,7 @@ std::string generateGlobalForRevWithLoopsFunctionSource(const std::map<size_t, s
     string noLoopFunc = functionName + "_noloop_" + suffix;
 
     std::ostringstream out;
-    out << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n"
-            "\n";
+    LanguageC<Base>::printFileStart(out, sharedHeader);
     ModelCSourceGen<Base>::generateFunctionDeclarationSource(out, functionName, "noloop_" + suffix, nonLoopElements, argsDcl);
     generateFunctionDeclarationSourceLoopForRev(out, langC, modelName, "j", loopGroups, generateLocalFunctionName);
     out << "\n";
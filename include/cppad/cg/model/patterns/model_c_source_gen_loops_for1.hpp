@@ -31,7 +31,7 @@ void ModelCSourceGen<Base>::prepareSparseForwardOneWithLoops(const std::map<size
     size_t n = _fun.Domain();
     
     CodeHandler<Base> handler;
-    handler.setJobTimer(_jobTimer);
+    configureHandler(handler);
     handler.setZeroDependents(false);
 
     auto& indexJcolDcl = *handler.makeIndexDclrNode("jcol");
@@ -368,12 +368,8 @@ void ModelCSourceGen<Base>::prepareSparseForwardOneWithLoops(const std::map<size
             std::string argsDcl = langC.generateFunctionArgumentsDcl();
 
             _cache.str("");
-            _cache << "#include <stdlib.h>\n"
-                    "#include <math.h>\n"
-                    "\n"
-                    << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n"
-                    "\n"
-                    "void " << functionName << "(" << argsDcl << ") {\n";
+            printFileStart(_cache);
+            _cache << "void " << functionName << "(" << argsDcl << ") {\n";
             nameGenHess.customFunctionVariableDeclarations(_cache);
             _cache << langC.generateIndependentVariableDeclaration() << "\n";
             _cache << langC.generateDependentVariableDeclaration() << "\n";
@@ -408,7 +404,8 @@ void ModelCSourceGen<Base>::prepareSparseForwardOneWithLoops(const std::map<size
     _sources[functionFor1 + ".c"] = generateGlobalForRevWithLoopsFunctionSource(elements,
                                                                                 _loopFor1Groups, _nonLoopFor1Elements,
                                                                                 functionFor1, _name, _baseTypeName, "indep",
-                                                                                generateFunctionNameLoopFor1);
+                                                                                generateFunctionNameLoopFor1,
+                                                                                _sharedHeader);
     /**
      * Sparsity
      */
@@ -429,8 +426,7 @@ void ModelCSourceGen<Base>::createForwardOneWithLoopsNL(CodeHandler<Base>& handl
     const std::string jobName = _cache.str();
 
     LanguageC<Base> langC(_baseTypeName);
-    langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-    langC.setParameterPrecision(_parameterPrecision);
+    configureLanguage(langC);
     _cache.str("");
     _cache << _name << "_" << FUNCTION_SPARSE_FORWARD_ONE << "_noloop_indep" << j;
     langC.setGenerateFunction(_cache.str());
@@ -37,7 +37,7 @@ void ModelCSourceGen<Base>::prepareSparseReverseOneWithLoops(const std::map<size
     size_t n = _fun.Domain();
 
     CodeHandler<Base> handler;
-    handler.setJobTimer(_jobTimer);
+    configureHandler(handler);
     handler.setZeroDependents(false);
 
     auto& indexJrowDcl = *handler.makeIndexDclrNode("jrow");
@@ -303,12 +303,8 @@ void ModelCSourceGen<Base>::prepareSparseReverseOneWithLoops(const std::map<size
             std::string argsDcl = langC.generateFunctionArgumentsDcl();
 
             _cache.str("");
-            _cache << "#include <stdlib.h>\n"
-                    "#include <math.h>\n"
-                    "\n"
-                    << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n"
-                    "\n"
-                    "void " << functionName << "(" << argsDcl << ") {\n";
+            printFileStart(_cache);
+            _cache << "void " << functionName << "(" << argsDcl << ") {\n";
             nameGenHess.customFunctionVariableDeclarations(_cache);
             _cache << langC.generateIndependentVariableDeclaration() << "\n";
             _cache << langC.generateDependentVariableDeclaration() << "\n";
@@ -343,7 +339,8 @@ void ModelCSourceGen<Base>::prepareSparseReverseOneWithLoops(const std::map<size
     _sources[functionRev1 + ".c"] = generateGlobalForRevWithLoopsFunctionSource(elements,
                                                                                 _loopRev1Groups, _nonLoopRev1Elements,
                                                                                 functionRev1, _name, _baseTypeName, "dep",
-                                                                                generateFunctionNameLoopRev1);
+                                                                                generateFunctionNameLoopRev1,
+                                                                                _sharedHeader);
     /**
      * Sparsity
      */
@@ -364,8 +361,7 @@ void ModelCSourceGen<Base>::createReverseOneWithLoopsNL(CodeHandler<Base>& handl
     const std::string jobName = _cache.str();
 
     LanguageC<Base> langC(_baseTypeName);
-    langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-    langC.setParameterPrecision(_parameterPrecision);
+    configureLanguage(langC);
     _cache.str("");
     _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_ONE << "_noloop_dep" << i;
     langC.setGenerateFunction(_cache.str());
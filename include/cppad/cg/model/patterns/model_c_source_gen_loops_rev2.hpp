@@ -67,7 +67,7 @@ void ModelCSourceGen<Base>::prepareSparseReverseTwoWithLoops(const std::map<size
     size_t n = _fun.Domain();
     
     CodeHandler<Base> handler;
-    handler.setJobTimer(_jobTimer);
+    configureHandler(handler);
     handler.setZeroDependents(false);
     
     auto& indexJrowDcl = *handler.makeIndexDclrNode("jrow");
@@ -403,12 +403,8 @@ void ModelCSourceGen<Base>::prepareSparseReverseTwoWithLoops(const std::map<size
             std::string argsDcl = langC.generateFunctionArgumentsDcl();
 
             _cache.str("");
-            _cache << "#include <stdlib.h>\n"
-                    "#include <math.h>\n"
-                    "\n"
-                    << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n"
-                    "\n"
-                    "void " << functionName << "(" << argsDcl << ") {\n";
+            printFileStart(_cache);
+            _cache << "void " << functionName << "(" << argsDcl << ") {\n";
             nameGenRev2.customFunctionVariableDeclarations(_cache);
             _cache << langC.generateIndependentVariableDeclaration() << "\n";
             _cache << langC.generateDependentVariableDeclaration() << "\n";
@@ -454,7 +450,7 @@ void ModelCSourceGen<Base>::prepareSparseReverseTwoWithLoops(const std::map<size
 
             // we can use a new handler to reduce memory usage
             CodeHandler<Base> handlerNL;
-            handlerNL.setJobTimer(_jobTimer);
+            configureHandler(handlerNL);
 
             std::vector<CGBase> tx0(n);
             handlerNL.makeVariables(tx0);
@@ -523,8 +519,7 @@ void ModelCSourceGen<Base>::prepareSparseReverseTwoWithLoops(const std::map<size
                 }
 
                 LanguageC<Base> langC(_baseTypeName);
-                langC.setMaxAssigmentsPerFunction(_maxAssignPerFunc, &_sources);
-                langC.setParameterPrecision(_parameterPrecision);
+                configureLanguage(langC);
                 _cache.str("");
                 _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "_noloop_indep" << j;
                 string functionName = _cache.str();
@@ -549,7 +544,8 @@ void ModelCSourceGen<Base>::prepareSparseReverseTwoWithLoops(const std::map<size
     _sources[functionRev2 + ".c"] = generateGlobalForRevWithLoopsFunctionSource(elements,
                                                                                 _loopRev2Groups, _nonLoopRev2Elements,
                                                                                 functionRev2, _name, _baseTypeName, "indep",
-                                                                                generateFunctionNameLoopRev2);
+                                                                                generateFunctionNameLoopRev2,
+                                                                                _sharedHeader);
     /**
      * Sparsity
      */
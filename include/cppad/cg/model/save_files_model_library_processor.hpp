@@ -65,6 +65,10 @@ public:
             saveFile(it.first, it.second);
         }
 
+        if (this->modelLibraryHelper_->isSharedHeader()) {
+            saveFile(ModelLibraryCSourceGen<Base>::FILE_SHARED_HEADER, this->modelLibraryHelper_->getSharedHeader());
+        }
+
         for (const auto& it : this->modelLibraryHelper_->getCustomSources()) {
             saveFile(it.first, it.second);
         }
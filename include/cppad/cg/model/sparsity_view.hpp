@@ -0,0 +1,278 @@
+#ifndef CPPAD_CG_SPARSITY_VIEW_INCLUDED
+#define CPPAD_CG_SPARSITY_VIEW_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A read-only sparsity pattern in coordinate format (COO) whose index
+ * arrays are owned by someone else (e.g. the static arrays of a compiled
+ * model library).
+ * Element k is at row rows()[k] and column cols()[k] and it corresponds to
+ * element k of the compressed results of the sparse evaluation methods.
+ *
+ * @author Joao Leal
+ */
+class CooSparsityView {
+private:
+    size_t nRows_;
+    size_t nCols_;
+    ArrayView<const unsigned long> rows_;
+    ArrayView<const unsigned long> cols_;
+public:
+
+    inline CooSparsityView() :
+        nRows_(0),
+        nCols_(0) {
+    }
+
+    inline CooSparsityView(size_t nRows,
+                           size_t nCols,
+                           const unsigned long* rows,
+                           const unsigned long* cols,
+                           size_t nnz) :
+        nRows_(nRows),
+        nCols_(nCols),
+        rows_(rows, nnz),
+        cols_(cols, nnz) {
+    }
+
+    inline CooSparsityView(const CooSparsityView& orig) = default;
+
+    /**
+     * Makes this view refer to the same arrays as another view (the
+     * arrays are never copied).
+     */
+    inline CooSparsityView& operator=(const CooSparsityView& orig) {
+        nRows_ = orig.nRows_;
+        nCols_ = orig.nCols_;
+        ArrayView<const unsigned long>(orig.rows_).swap(rows_);
+        ArrayView<const unsigned long>(orig.cols_).swap(cols_);
+        return *this;
+    }
+
+    inline size_t getRowCount() const {
+        return nRows_;
+    }
+
+    inline size_t getColumnCount() const {
+        return nCols_;
+    }
+
+    /**
+     * @return the number of non-zero elements
+     */
+    inline size_t nnz() const {
+        return rows_.size();
+    }
+
+    inline const ArrayView<const unsigned long>& rows() const {
+        return rows_;
+    }
+
+    inline const ArrayView<const unsigned long>& cols() const {
+        return cols_;
+    }
+
+    /**
+     * @return whether or not the elements are ordered by row
+     */
+    inline bool isRowOrdered() const {
+        for (size_t k = 1; k < rows_.size(); k++) {
+            if (rows_[k] < rows_[k - 1])
+                return false;
+        }
+        return true;
+    }
+};
+
+/**
+ * A read-only sparsity pattern in compressed sparse row format (CSR).
+ * The columns of row i are cols()[k] for start()[i] <= k < start()[i + 1]
+ * and element k corresponds to element position(k) of the compressed
+ * results of the sparse evaluation methods.
+ *
+ * @author Joao Leal
+ */
+class CsrSparsityView {
+private:
+    size_t nCols_;
+    ArrayView<const size_t> start_;
+    ArrayView<const unsigned long> cols_;
+    /**
+     * the position of each element in the coordinate format (empty if
+     * it is the same)
+     */
+    ArrayView<const size_t> positions_;
+public:
+
+    inline CsrSparsityView() :
+        nCols_(0) {
+    }
+
+    inline CsrSparsityView(size_t nCols,
+                           ArrayView<const size_t> start,
+                           ArrayView<const unsigned long> cols,
+                           ArrayView<const size_t> positions) :
+        nCols_(nCols),
+        start_(start),
+        cols_(cols),
+        positions_(positions) {
+    }
+
+    inline CsrSparsityView(const CsrSparsityView& orig) = default;
+
+    /**
+     * Makes this view refer to the same arrays as another view (the
+     * arrays are never copied).
+     */
+    inline CsrSparsityView& operator=(const CsrSparsityView& orig) {
+        nCols_ = orig.nCols_;
+        ArrayView<const size_t>(orig.start_).swap(start_);
+        ArrayView<const unsigned long>(orig.cols_).swap(cols_);
+        ArrayView<const size_t>(orig.positions_).swap(positions_);
+        return *this;
+    }
+
+    inline size_t getRowCount() const {
+        return start_.empty() ? 0 : start_.size() - 1;
+    }
+
+    inline size_t getColumnCount() const {
+        return nCols_;
+    }
+
+    inline size_t nnz() const {
+        return cols_.size();
+    }
+
+    /**
+     * @return the index of the first element of each row (with an
+     *         additional element equal to nnz())
+     */
+    inline const ArrayView<const size_t>& start() const {
+        return start_;
+    }
+
+    inline const ArrayView<const unsigned long>& cols() const {
+        return cols_;
+    }
+
+    /**
+     * @return the columns of a row
+     */
+    inline ArrayView<const unsigned long> rowCols(size_t i) const {
+        return ArrayView<const unsigned long>(cols_.data() + start_[i], start_[i + 1] - start_[i]);
+    }
+
+    /**
+     * @return the position of an element in the coordinate format
+     */
+    inline size_t position(size_t k) const {
+        return positions_.empty() ? k : positions_[k];
+    }
+};
+
+/**
+ * Compressed sparse row storage created from a sparsity pattern in
+ * coordinate format.
+ * The column indexes are not copied when the coordinate elements are
+ * already ordered by row (such as those generated by ModelCSourceGen),
+ * in which case the coordinate arrays must outlive this object.
+ *
+ * @author Joao Leal
+ */
+class CsrSparsity {
+private:
+    bool ready_;
+    size_t nCols_;
+    std::vector<size_t> start_;
+    ArrayView<const unsigned long> cols_;
+    std::vector<unsigned long> colsCopy_;
+    std::vector<size_t> positions_;
+public:
+
+    inline CsrSparsity() :
+        ready_(false),
+        nCols_(0) {
+    }
+
+    CsrSparsity(const CsrSparsity&) = delete;
+    CsrSparsity& operator=(const CsrSparsity&) = delete;
+
+    inline bool isReady() const {
+        return ready_;
+    }
+
+    /**
+     * Creates the compressed row storage from a sparsity pattern in
+     * coordinate format (O(nnz + rows)).
+     */
+    inline void build(const CooSparsityView& coo) {
+        const ArrayView<const unsigned long>& rows = coo.rows();
+        const size_t nnz = coo.nnz();
+
+        nCols_ = coo.getColumnCount();
+        start_.assign(coo.getRowCount() + 1, 0);
+        for (size_t k = 0; k < nnz; k++) {
+            CPPADCG_ASSERT_KNOWN(rows[k] < coo.getRowCount(), "Invalid sparsity row index");
+            start_[rows[k] + 1]++;
+        }
+        for (size_t i = 1; i < start_.size(); i++) {
+            start_[i] += start_[i - 1];
+        }
+
+        if (coo.isRowOrdered()) {
+            ArrayView<const unsigned long>(coo.cols()).swap(cols_);
+            colsCopy_.clear();
+            positions_.clear();
+        } else {
+            // stable counting sort
+            colsCopy_.resize(nnz);
+            positions_.resize(nnz);
+            std::vector<size_t> next(start_.begin(), start_.end() - 1);
+            for (size_t k = 0; k < nnz; k++) {
+                size_t e = next[rows[k]]++;
+                colsCopy_[e] = coo.cols()[k];
+                positions_[e] = k;
+            }
+            ArrayView<const unsigned long>(colsCopy_.data(), colsCopy_.size()).swap(cols_);
+        }
+
+        ready_ = true;
+    }
+
+    inline void clear() {
+        ready_ = false;
+        start_.clear();
+        ArrayView<const unsigned long>().swap(cols_);
+        colsCopy_.clear();
+        positions_.clear();
+    }
+
+    inline CsrSparsityView view() const {
+        return CsrSparsityView(nCols_,
+                               ArrayView<const size_t>(start_.data(), start_.size()),
+                               cols_,
+                               ArrayView<const size_t>(positions_.data(), positions_.size()));
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -17,6 +17,7 @@
 
 #if CPPAD_CG_SYSTEM_LINUX
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
@@ -69,7 +70,8 @@ public:
 
     inline void create() {
         int fd[2]; /** file descriptors used to communicate between processes*/
-        if (pipe(fd) < 0) {
+        // not inherited by other executables started concurrently by other threads
+        if (pipe2(fd, O_CLOEXEC) < 0) {
             throw CGException("Failed to create pipe");
         }
         read.fd = fd[0];
@@ -194,6 +196,20 @@ inline void callExecutable(const std::string& executable,
         pipeSrc.create();
     }
 
+    /**
+     * the arguments are prepared before forking since memory should not be
+     * allocated by the child process of a multithreaded process
+     */
+    std::vector<std::string> argsStr(args.size() + 1);
+    argsStr[0] = execName;
+    std::copy(args.begin(), args.end(), argsStr.begin() + 1);
+
+    std::vector<char*> args2(argsStr.size() + 1);
+    for (size_t i = 0; i < argsStr.size(); i++) {
+        args2[i] = &argsStr[i][0];
+    }
+    args2.back() = (char *) nullptr; // END
+
     //Fork the compiler, pipe source to it, wait for the compiler to exit
     pid_t pid = fork();
     if (pid < 0) {
@@ -232,29 +248,8 @@ inline void callExecutable(const std::string& executable,
             }
         }
 
-        auto toCharArray = [](const std::string & args) {
-            const size_t s = args.size() + 1;
-            char* args2 = new char[s];
-            for (size_t c = 0; c < s - 1; c++) {
-                args2[c] = args.at(c);
-            }
-            args2[s - 1] = '\0';
-            return args2;
-        };
-
-        std::vector<char*> args2(args.size() + 2);
-        args2[0] = toCharArray(execName);
-        for (size_t i = 0; i < args.size(); i++) {
-            args2[i + 1] = toCharArray(args[i]);
-        }
-        args2.back() = (char *) nullptr; // END             
-
         int eCode = execv(executable.c_str(), &args2[0]);
 
-        for (size_t i = 0; i < args.size(); i++) {
-            delete [] args2[i];
-        }
-
         if(stdOutErrMessage != nullptr) {
             pipeStdOutErr.write.close();
         }
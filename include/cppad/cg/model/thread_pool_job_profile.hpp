@@ -0,0 +1,230 @@
+#ifndef CPPAD_CG_THREAD_POOL_JOB_PROFILE_INCLUDED
+#define CPPAD_CG_THREAD_POOL_JOB_PROFILE_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * The elapsed times of the jobs executed by the thread pool in the
+ * multithreaded sparse Jacobian and sparse Hessian of a compiled model.
+ * It can be saved into a file and provided to ModelCSourceGen when the
+ * model source code is generated again in order to group the
+ * rows/columns into balanced jobs and to start with a good job order.
+ *
+ * Jobs are grouped by the name of the model function they evaluate
+ * (e.g. "sparse_reverse_one") and each job identifies the indexes
+ * provided to that function (e.g. Jacobian rows).
+ *
+ * @author Joao Leal
+ */
+class ThreadPoolJobProfile {
+public:
+
+    class Job {
+    public:
+        /**
+         * the indexes evaluated by the job (e.g. Jacobian rows)
+         */
+        std::vector<size_t> keys;
+        /**
+         * the reference elapsed time (in seconds)
+         */
+        float elapsed;
+
+        inline Job() :
+            elapsed(0) {
+        }
+
+        inline Job(std::vector<size_t> keys,
+                   float elapsed) :
+            keys(std::move(keys)),
+            elapsed(elapsed) {
+        }
+    };
+
+private:
+    std::map<std::string, std::vector<Job> > functions_;
+public:
+
+    /**
+     * The first line of a profile file
+     */
+    inline static const std::string& header() {
+        static const std::string h = "cppadcg_job_profile 1";
+        return h;
+    }
+
+    inline bool empty() const {
+        return functions_.empty();
+    }
+
+    inline const std::map<std::string, std::vector<Job> >& getFunctions() const {
+        return functions_;
+    }
+
+    /**
+     * @return the jobs of a function or nullptr if there are none
+     */
+    inline const std::vector<Job>* find(const std::string& function) const {
+        auto it = functions_.find(function);
+        if (it == functions_.end())
+            return nullptr;
+        return &it->second;
+    }
+
+    /**
+     * Defines the jobs of a function (replacing any previous jobs)
+     */
+    inline void set(const std::string& function,
+                    std::vector<Job> jobs) {
+        functions_[function] = std::move(jobs);
+    }
+
+    inline void clear() {
+        functions_.clear();
+    }
+
+    /**
+     * Estimates the elapsed time of each key of a function.
+     * The time of a job with several keys is split in proportion to the
+     * provided cost estimates and keys which were not profiled receive
+     * their cost multiplied by the measured time per unit of cost.
+     *
+     * @param function the function name
+     * @param cost an estimate of the cost of each key in the new jobs
+     *             (e.g. the number of evaluated elements)
+     * @return the elapsed time of each key or an empty map if there are
+     *         no measurements for the function
+     */
+    inline std::map<size_t, float> estimateKeyElapsed(const std::string& function,
+                                                      const std::map<size_t, float>& cost) const {
+        std::map<size_t, float> elapsed;
+
+        const std::vector<Job>* jobs = find(function);
+        if (jobs == nullptr)
+            return elapsed;
+
+        float totalCost = 0, totalElapsed = 0;
+        for (const Job& job : *jobs) {
+            float jobCost = 0;
+            for (size_t k : job.keys) {
+                auto it = cost.find(k);
+                if (it != cost.end())
+                    jobCost += it->second;
+            }
+            if (jobCost <= 0 || !(job.elapsed > 0) || std::isinf(job.elapsed))
+                continue;
+
+            for (size_t k : job.keys) {
+                auto it = cost.find(k);
+                if (it != cost.end())
+                    elapsed[k] = job.elapsed * it->second / jobCost;
+            }
+            totalCost += jobCost;
+            totalElapsed += job.elapsed;
+        }
+
+        if (totalCost <= 0)
+            return elapsed; // empty
+
+        for (const auto& it : cost) {
+            if (elapsed.find(it.first) == elapsed.end())
+                elapsed[it.first] = it.second * totalElapsed / totalCost;
+        }
+
+        return elapsed;
+    }
+
+    /**
+     * Loads a profile from a file.
+     *
+     * @param path the file path
+     * @return false if the file does not exist or it is not a valid
+     *         profile (this object is then empty)
+     */
+    inline bool read(const std::string& path) {
+        functions_.clear();
+
+        std::ifstream in(path.c_str());
+        if (!in)
+            return false;
+
+        std::string line;
+        if (!std::getline(in, line) || line != header())
+            return false;
+
+        std::string key;
+        while (in >> key) {
+            std::string name;
+            size_t nJobs;
+            if (key != "function" || !(in >> name >> nJobs)) {
+                functions_.clear();
+                return false;
+            }
+
+            std::vector<Job>& jobs = functions_[name];
+            jobs.resize(nJobs);
+            for (Job& job : jobs) {
+                size_t nKeys;
+                if (!(in >> key >> job.elapsed >> nKeys) || key != "job") {
+                    functions_.clear();
+                    return false;
+                }
+                job.keys.resize(nKeys);
+                for (size_t& k : job.keys) {
+                    if (!(in >> k)) {
+                        functions_.clear();
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Saves this profile into a file.
+     *
+     * @param path the file path
+     */
+    inline void write(const std::string& path) const {
+        std::ofstream out(path.c_str());
+        if (!out)
+            throw CGException("Failed to create job profile '", path, "'");
+
+        out << header() << "\n";
+        out << std::setprecision(std::numeric_limits<float>::max_digits10);
+        for (const auto& it : functions_) {
+            out << "function " << it.first << " " << it.second.size() << "\n";
+            for (const Job& job : it.second) {
+                out << "job " << job.elapsed << " " << job.keys.size();
+                for (size_t k : job.keys)
+                    out << " " << k;
+                out << "\n";
+            }
+        }
+
+        if (!out)
+            throw CGException("Failed to save job profile '", path, "'");
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
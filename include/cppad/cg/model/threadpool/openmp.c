@@ -15,6 +15,7 @@
 
 #include <omp.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 enum ScheduleStrategy {SCHED_STATIC = 1,
                        SCHED_DYNAMIC = 2,
@@ -24,6 +25,7 @@ enum ScheduleStrategy {SCHED_STATIC = 1,
 static volatile int cppadcg_openmp_enabled = 1; // false
 static volatile int cppadcg_openmp_verbose = 1; // false
 static volatile unsigned int cppadcg_openmp_n_threads = 2;
+static unsigned int cppadcg_openmp_time_meas = 10; // default number of time measurements
 
 static enum ScheduleStrategy schedule_strategy = SCHED_DYNAMIC;
 
@@ -62,12 +64,75 @@ enum ScheduleStrategy cppadcg_openmp_get_scheduler_strategy() {
     return schedule_strategy;
 }
 
-void cppadcg_openmp_apply_scheduler_strategy() {
-    if (schedule_strategy == SCHED_DYNAMIC) {
-        omp_set_schedule(omp_sched_dynamic, 1);
-    } else if (schedule_strategy == SCHED_GUIDED) {
-        omp_set_schedule(omp_sched_guided, 0);
-    } else {
-        omp_set_schedule(omp_sched_static, 0);
+void cppadcg_openmp_set_n_time_meas(unsigned int n) {
+    cppadcg_openmp_time_meas = n;
+}
+
+unsigned int cppadcg_openmp_get_n_time_meas() {
+    return cppadcg_openmp_time_meas;
+}
+
+typedef struct pair_double_int {
+    float val;
+    int index;
+} pair_double_int;
+
+static int comparePair(const void* a, const void* b) {
+    if (((pair_double_int*) a)->val < ((pair_double_int*) b)->val)
+        return -1;
+    if (((pair_double_int*) a)->val == ((pair_double_int*) b)->val)
+        return 0;
+    return 1;
+}
+
+/**
+ * Updates the reference time of each job with the minimum measured time
+ * and determines the position of each job (longest jobs first).
+ */
+void cppadcg_openmp_update_order(float refElapsed[],
+                                 unsigned int nTimeMeas,
+                                 const float elapsed[],
+                                 int order[],
+                                 int nJobs) {
+    if(nJobs == 0 || refElapsed == NULL || elapsed == NULL || order == NULL)
+        return;
+
+    struct pair_double_int elapsedOrder[nJobs];
+    int i;
+    int nonZero = 0; // false
+
+    for(i = 0; i < nJobs; ++i) {
+        if(elapsed[i] != 0) {
+            nonZero = 1;
+            break;
+        }
     }
-}
\ No newline at end of file
+
+    if (!nonZero) {
+        if (cppadcg_openmp_verbose) {
+            fprintf(stdout, "order not updated: all times are zero\n");
+        }
+        return;
+    }
+
+    for (i = 0; i < nJobs; ++i) {
+        if(nTimeMeas == 0 || elapsed[i] < refElapsed[i]) {
+            refElapsed[i] = elapsed[i];
+        }
+        elapsedOrder[i].val = refElapsed[i];
+        elapsedOrder[i].index = i;
+    }
+
+    qsort(elapsedOrder, nJobs, sizeof(struct pair_double_int), comparePair);
+
+    for (i = 0; i < nJobs; ++i) {
+        order[elapsedOrder[i].index] = nJobs - i - 1; // descending order
+    }
+
+    if (cppadcg_openmp_verbose) {
+        fprintf(stdout, "new order (%i values):\n", nTimeMeas + 1);
+        for (i = 0; i < nJobs; ++i) {
+            fprintf(stdout, " job id: %i   order: %i   time: %e s\n", i, order[i], refElapsed[i]);
+        }
+    }
+}
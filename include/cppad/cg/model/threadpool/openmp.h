@@ -18,9 +18,9 @@
 extern "C" {
 #endif
 
-enum ScheduleStrategy {SCHED_STATIC = 1, // omp_sched_static
-                       SCHED_DYNAMIC = 2, // omp_sched_dynamic with chunk size 1
-                       SCHED_GUIDED = 3 // omp_sched_guided
+enum ScheduleStrategy {SCHED_STATIC = 1, // parallel loop with schedule(static)
+                       SCHED_DYNAMIC = 2, // tasks created by decreasing job time
+                       SCHED_GUIDED = 3 // parallel loop with schedule(guided)
                        };
 
 
@@ -33,7 +33,16 @@ void cppadcg_openmp_set_scheduler_strategy(enum ScheduleStrategy s);
 
 enum ScheduleStrategy cppadcg_openmp_get_scheduler_strategy();
 
-void cppadcg_openmp_apply_scheduler_strategy();
+
+void cppadcg_openmp_set_n_time_meas(unsigned int n);
+
+unsigned int cppadcg_openmp_get_n_time_meas();
+
+void cppadcg_openmp_update_order(float refElapsed[],
+                                 unsigned int nTimeMeas,
+                                 const float elapsed[],
+                                 int order[],
+                                 int nJobs);
 
 
 void cppadcg_openmp_set_verbose(int v);
@@ -18,14 +18,22 @@
  *  https://github.com/Pithikos/C-Thread-Pool/blob/master/thpool.c
  */
 
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+/* syscall() and clock_gettime() are not declared in strict C modes (e.g. -std=c99) */
+#define _DEFAULT_SOURCE
+#endif
+
 #include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <pthread.h>
+#include <sched.h>
 #include <errno.h>
+#include <string.h>
 #include <time.h>
 #if defined(__linux__)
 #include <sys/prctl.h>
+#include <sys/syscall.h>
 #include <time.h>
 #include <sys/time.h>
 #define __USE_GNU /* required before including  resource.h */
@@ -40,6 +48,11 @@ enum ScheduleStrategy {SCHED_STATIC = 1,
 enum ElapsedTimeReference {ELAPSED_TIME_AVG,
                            ELAPSED_TIME_MIN};
 
+enum ThreadAffinity {THREAD_AFFINITY_NONE = 0,
+                     THREAD_AFFINITY_CORE = 1,
+                     THREAD_AFFINITY_NUMA_NODE = 2
+                     };
+
 typedef struct ThPool ThPool;
 typedef void (* thpool_function_type)(void*);
 
@@ -50,6 +63,11 @@ static int cppadcg_pool_verbose = 0; // false
 static enum ElapsedTimeReference cppadcg_pool_time_update = ELAPSED_TIME_MIN;
 static unsigned int cppadcg_pool_time_meas = 10; // default number of time measurements
 static float cppadcg_pool_guided_maxgroupwork = 0.75;
+static enum ThreadAffinity cppadcg_pool_affinity = THREAD_AFFINITY_NONE;
+static volatile int cppadcg_pool_affinity_version = 0; // incremented when the affinity changes
+static float cppadcg_pool_spin_time = 20e-6f; // time spent actively waiting before blocking (in seconds)
+static int cppadcg_pool_caller_executes = 1; // true
+static int cppadcg_pool_oversubscribed = 0; // more threads than CPUs (active waiting yields the CPU)
 
 static enum ScheduleStrategy schedule_strategy = SCHED_DYNAMIC;
 
@@ -78,14 +96,26 @@ static void thpool_wait(ThPool*);
 static void thpool_destroy(ThPool*);
 
 /* ========================== STRUCTURES ============================ */
-/* Binary semaphore */
+/* Binary semaphore (waiters spin for a while before blocking) */
 typedef struct BSem {
     pthread_mutex_t mutex;
     pthread_cond_t   cond;
     int v;
+    int parked;                          /* number of threads blocked on cond */
 } BSem;
 
 
+#if defined(__linux__)
+#define CPPADCG_THPOOL_MAX_CPUS 4096
+#define CPPADCG_THPOOL_CPU_BITS (8 * sizeof(unsigned long))
+
+/* CPU set (cpu_set_t is not used since it requires _GNU_SOURCE) */
+typedef struct CpuMask {
+    unsigned long bits[CPPADCG_THPOOL_MAX_CPUS / CPPADCG_THPOOL_CPU_BITS];
+} CpuMask;
+#endif
+
+
 /* Job */
 typedef struct Job {
     struct Job*  prev;                   /* pointer to previous job              */
@@ -112,8 +142,8 @@ typedef struct JobQueue {
     pthread_mutex_t rwmutex;             /* used for queue r/w access */
     Job  *front;                         /* pointer to front of queue */
     Job  *rear;                          /* pointer to rear  of queue */
-    WorkGroup* group_front;              /* previously created work groups (SCHED_STATIC scheduling only)*/
-    BSem *has_jobs;                      /* flag as binary semaphore  */
+    WorkGroup** thread_groups;           /* work groups of each thread (SCHED_STATIC scheduling only) */
+    int   n_thread_groups;               /* number of work groups in thread_groups */
     int   len;                           /* number of jobs in queue   */
     float total_time;                    /* total expected time to complete the work */
     float highest_expected_return;       /* the time when the last running thread is expected to request new work */
@@ -125,6 +155,8 @@ typedef struct Thread {
     int id;                              /* friendly id                          */
     pthread_t pthread;                   /* pointer to actual thread             */
     struct ThPool* thpool;               /* access to ThPool                     */
+    BSem has_jobs;                       /* flag as binary semaphore             */
+    int affinity_version;                /* the affinity version last applied    */
     WorkGroup* processed_groups;         /* processed work groups (verbose only) */
 } Thread;
 
@@ -139,6 +171,10 @@ typedef struct ThPool {
     pthread_cond_t threads_all_idle;     /* signal to thpool_wait     */
     JobQueue* jobqueue;                  /* pointer to the job queue  */
     volatile int threads_keepalive;
+#if defined(__linux__)
+    CpuMask process_cpus;                /* CPUs available when the pool was created */
+    int process_cpus_valid;
+#endif
 } ThPool;
 
 /* ========================== PUBLIC API ============================ */
@@ -231,6 +267,31 @@ int cppadcg_thpool_is_verbose() {
     return cppadcg_pool_verbose;
 }
 
+void cppadcg_thpool_set_spin_time(float seconds) {
+    cppadcg_pool_spin_time = seconds > 0 ? seconds : 0;
+}
+
+float cppadcg_thpool_get_spin_time() {
+    return cppadcg_pool_spin_time;
+}
+
+void cppadcg_thpool_set_caller_executes(int e) {
+    cppadcg_pool_caller_executes = e;
+}
+
+int cppadcg_thpool_is_caller_executes() {
+    return cppadcg_pool_caller_executes;
+}
+
+void cppadcg_thpool_set_affinity(enum ThreadAffinity a) {
+    cppadcg_pool_affinity = a;
+    cppadcg_pool_affinity_version++; // existing threads update their affinity when they receive new work
+}
+
+enum ThreadAffinity cppadcg_thpool_get_affinity() {
+    return cppadcg_pool_affinity;
+}
+
 void cppadcg_thpool_prepare() {
     if(cppadcg_pool == NULL) {
         cppadcg_pool = thpool_init(cppadcg_pool_n_threads);
@@ -368,13 +429,18 @@ static int  thread_init(ThPool* thpool,
                         Thread** thread,
                         int id);
 static void* thread_do(Thread* thread);
+static void  workgroup_execute(WorkGroup* workGroup);
+static void  thread_set_affinity(Thread* thread);
+#if defined(__linux__)
+static int   cpumask_count(const CpuMask* mask);
+#endif
 static void  thread_destroy(Thread* thread);
 
 static int   jobqueue_init(ThPool* thpool);
 static void  jobqueue_clear(ThPool* thpool);
-static void  jobqueue_push(JobQueue* queue,
+static void  jobqueue_push(ThPool* thpool,
                            Job* newjob_p);
-static void jobqueue_multipush(JobQueue* queue,
+static void jobqueue_multipush(ThPool* thpool,
                                Job* newjob[],
                                int nJobs);
 static int jobqueue_push_static_jobs(ThPool* thpool,
@@ -387,10 +453,10 @@ static WorkGroup* jobqueue_pull(ThPool* thpool, int id);
 static void  jobqueue_destroy(ThPool* thpool);
 
 static void  bsem_init(BSem *bsem, int value);
-static void  bsem_reset(BSem *bsem);
 static void  bsem_post(BSem *bsem);
-static void  bsem_post_all(BSem *bsem);
 static void  bsem_wait(BSem *bsem);
+static void  cpu_relax();
+static void  thpool_post_all(ThPool* thpool);
 
 
 /* ============================ TIME ============================== */
@@ -417,6 +483,16 @@ static float get_monotonic_time(struct timespec* time,
     }
 }
 
+/**
+ * Time used to limit active waiting (in nanoseconds)
+ */
+static long long get_monotonic_time_ns() {
+    struct timespec time;
+    if (clock_gettime(CLOCK_MONOTONIC, &time) != 0)
+        return 0;
+    return time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
 static void get_monotonic_time2(struct timespec* time) {
     int info;
     info = clock_gettime(CLOCK_MONOTONIC, time);
@@ -504,6 +580,20 @@ struct ThPool* thpool_init(int num_threads) {
     pthread_mutex_init(&(thpool->thcount_lock), NULL);
     pthread_cond_init(&thpool->threads_all_idle, NULL);
 
+#if defined(__linux__)
+    /* CPUs which can be used by the threads (e.g. restricted by taskset or cgroups) */
+    memset(&thpool->process_cpus, 0, sizeof(CpuMask));
+    thpool->process_cpus_valid = syscall(SYS_sched_getaffinity, 0, sizeof(CpuMask), &thpool->process_cpus) > 0;
+#endif
+
+    /* the calling thread can also be executing jobs */
+    int n_cpus = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#if defined(__linux__)
+    if (thpool->process_cpus_valid)
+        n_cpus = cpumask_count(&thpool->process_cpus);
+#endif
+    cppadcg_pool_oversubscribed = n_cpus > 0 && num_threads + 1 > n_cpus;
+
     /* Thread init */
     int n;
     for (n = 0; n < num_threads; n++) {
@@ -563,7 +653,7 @@ static int thpool_add_job(ThPool* thpool,
     newjob->elapsed = elapsed;
 
     /* add job to queue */
-    jobqueue_push(thpool->jobqueue, newjob);
+    jobqueue_push(thpool, newjob);
 
     return 0;
 }
@@ -581,14 +671,14 @@ static int thpool_add_jobs(ThPool* thpool,
     int i;
     int j;
 
-    for (i = 0; i < nJobs; ++i) {
+    for (j = 0; j < nJobs; ++j) {
+        i = order != NULL ? order[j] : j; // the position of job j in the queue
         newjobs[i] = (Job*) malloc(sizeof(Job));
         if (newjobs[i] == NULL) {
             fprintf(stderr, "thpool_add_jobs(): Could not allocate memory for new jobs\n");
             return -1;
         }
 
-        j = order != NULL ? order[i] : i;
         /* add function and argument */
         newjobs[i]->function = functions[j];
         newjobs[i]->arg = args[j];
@@ -605,16 +695,20 @@ static int thpool_add_jobs(ThPool* thpool,
     }
 
     /* add jobs to queue */
-    if (schedule_strategy == SCHED_STATIC && avgElapsed != NULL && order != NULL && nJobs > 0 && avgElapsed[0] > 0) {
+    if (schedule_strategy == SCHED_STATIC && job2Thread != NULL && nJobs > 0) {
         return jobqueue_push_static_jobs(thpool, newjobs, avgElapsed, job2Thread, nJobs, lastElapsedChanged);
     } else {
-        jobqueue_multipush(thpool->jobqueue, newjobs, nJobs);
+        jobqueue_multipush(thpool, newjobs, nJobs);
         return 0;
     }
 }
 
 /**
  * Split work among the threads evenly considering the elapsed time of each job.
+ * Each work group is only executed by the thread it was assigned to so that,
+ * while the job to thread mapping (jobs2thread) is reused, the same thread
+ * always evaluates the same jobs (and writes to the same outputs).
+ * Jobs are assumed to take the same time when there is no timing information.
  */
 static int jobqueue_push_static_jobs(ThPool* thpool,
                                      Job* newjobs[],
@@ -625,41 +719,62 @@ static int jobqueue_push_static_jobs(ThPool* thpool,
     float total_duration, target_duration, next_duration, best_duration;
     int i, j, iBest;
     int added;
+    int reuse;
+    int timed;
     int num_threads = thpool->num_threads;
     int* n_jobs;
     float* durations = NULL;
+    float* job_durations;
     WorkGroup** groups;
     WorkGroup* group;
+    JobQueue* queue = thpool->jobqueue;
 
     if(nJobs < num_threads)
         num_threads = nJobs;
 
     n_jobs = (int*) malloc(num_threads * sizeof(int));
-    if (n_jobs == NULL) {
-        fprintf(stderr, "jobqueue_push_static_jobs(): Could not allocate memory\n");
-        return -1;
-    }
-
     groups = (WorkGroup**) malloc(num_threads * sizeof(WorkGroup*));
-    if (groups == NULL) {
+    job_durations = (float*) malloc(nJobs * sizeof(float));
+    if (n_jobs == NULL || groups == NULL || job_durations == NULL) {
         fprintf(stderr, "jobqueue_push_static_jobs(): Could not allocate memory\n");
+        free(n_jobs);
+        free(groups);
+        free(job_durations);
         return -1;
     }
 
     for (i = 0; i < num_threads; ++i) {
         n_jobs[i] = 0;
+        groups[i] = NULL;
     }
 
     total_duration = 0;
-    for (i = 0; i < nJobs; ++i) {
-        total_duration += avgElapsed[i];
+    for (j = 0; j < nJobs; ++j) {
+        job_durations[j] = newjobs[j]->avgElapsed != NULL ? *newjobs[j]->avgElapsed : 0;
+        total_duration += job_durations[j];
+    }
+    timed = avgElapsed != NULL && total_duration > 0;
+    if (!timed) {
+        for (j = 0; j < nJobs; ++j) {
+            job_durations[j] = 1;
+        }
+        total_duration = nJobs;
     }
 
+    // the previous mapping can only be reused if it is still valid (e.g. the number of threads did not change)
+    reuse = !lastElapsedChanged;
+    for (j = 0; j < nJobs && reuse; ++j) {
+        if (jobs2thread[j] < 0 || jobs2thread[j] >= num_threads)
+            reuse = 0;
+    }
 
-    if (nJobs > 0 && (lastElapsedChanged || jobs2thread[0] < 0)) {
+    if (!reuse) {
         durations = (float*) malloc(num_threads * sizeof(float));
         if (durations == NULL) {
             fprintf(stderr, "jobqueue_push_static_jobs(): Could not allocate memory\n");
+            free(n_jobs);
+            free(groups);
+            free(job_durations);
             return -1;
         }
 
@@ -673,8 +788,8 @@ static int jobqueue_push_static_jobs(ThPool* thpool,
         for (j = 0; j < nJobs; ++j) {
             added = 0;
             for (i = 0; i < num_threads; ++i) {
-                next_duration = durations[i] + avgElapsed[j];
-                if (next_duration < target_duration) {
+                next_duration = durations[i] + job_durations[j];
+                if (next_duration <= target_duration) {
                     durations[i] = next_duration;
                     n_jobs[i]++;
                     jobs2thread[j] = i;
@@ -684,10 +799,10 @@ static int jobqueue_push_static_jobs(ThPool* thpool,
             }
 
             if (!added) {
-                best_duration = durations[0] + avgElapsed[j];
+                best_duration = durations[0] + job_durations[j];
                 iBest = 0;
                 for (i = 1; i < num_threads; ++i) {
-                    next_duration = durations[i] + avgElapsed[j];
+                    next_duration = durations[i] + job_durations[j];
                     if (next_duration < best_duration) {
                         best_duration = next_duration;
                         iBest = i;
@@ -711,15 +826,14 @@ static int jobqueue_push_static_jobs(ThPool* thpool,
      * create the work groups
      */
     for (i = 0; i < num_threads; ++i) {
+        if (n_jobs[i] == 0)
+            continue;
         group = (WorkGroup*) malloc(sizeof(WorkGroup));
+        group->prev = NULL;
         group->size = 0;
         group->jobs = (Job*) malloc(n_jobs[i] * sizeof(Job));
         groups[i] = group;
     }
-    for (i = 0; i < num_threads - 1; ++i) {
-        groups[i]->prev = groups[i + 1];
-    }
-    groups[num_threads - 1]->prev = NULL;
 
     // place jobs on the work groups
     for (j = 0; j < nJobs; ++j) {
@@ -731,33 +845,42 @@ static int jobqueue_push_static_jobs(ThPool* thpool,
     }
 
     if (cppadcg_pool_verbose) {
-        if (durations != NULL) {
-            for (i = 0; i < num_threads; ++i) {
-                fprintf(stdout, "jobqueue_push_static_jobs(): work group %i with %i jobs for %e s\n", i, groups[i]->size, durations[i]);
-            }
-        } else {
-            for (i = 0; i < num_threads; ++i) {
-                fprintf(stdout, "jobqueue_push_static_jobs(): work group %i with %i jobs\n", i, groups[i]->size);
+        for (i = 0; i < num_threads; ++i) {
+            if (durations != NULL) {
+                fprintf(stdout, "jobqueue_push_static_jobs(): work group for thread %i with %i jobs for %e %s\n", i, n_jobs[i], durations[i], timed ? "s" : "jobs");
+            } else {
+                fprintf(stdout, "jobqueue_push_static_jobs(): work group for thread %i with %i jobs (reused)\n", i, n_jobs[i]);
             }
         }
     }
 
     /**
-     * add to the queue
+     * add to the queue of each thread
      */
-    pthread_mutex_lock(&thpool->jobqueue->rwmutex);
+    pthread_mutex_lock(&queue->rwmutex);
 
-    groups[num_threads - 1]->prev = thpool->jobqueue->group_front;
-    thpool->jobqueue->group_front = groups[0];
+    for (i = 0; i < num_threads; ++i) {
+        if (groups[i] != NULL) {
+            groups[i]->prev = queue->thread_groups[i];
+            queue->thread_groups[i] = groups[i];
+            queue->n_thread_groups++;
+        }
+    }
 
-    bsem_post_all(thpool->jobqueue->has_jobs);
+    pthread_mutex_unlock(&queue->rwmutex);
 
-    pthread_mutex_unlock(&thpool->jobqueue->rwmutex);
+    // only wake up the threads which received work
+    for (i = 0; i < num_threads; ++i) {
+        if (groups[i] != NULL) {
+            bsem_post(&thpool->threads[i]->has_jobs);
+        }
+    }
 
     // clean up
     free(durations);
     free(n_jobs);
     free(groups);
+    free(job_durations);
 
     return 0;
 }
@@ -769,6 +892,11 @@ static int jobqueue_push_static_jobs(ThPool* thpool,
  * Once the queue is empty and all work has completed, the calling thread
  * (probably the main program) will continue.
  *
+ * Unless disabled, the calling thread also executes jobs from the shared
+ * queue (work groups of the SCHED_STATIC strategy are only executed by
+ * their threads) and then actively waits for up to
+ * cppadcg_pool_spin_time before blocking.
+ *
  * Smart polling is used in wait. The polling is initially 0 - meaning that
  * there is virtually no polling at all. If after 1 seconds the threads
  * haven't finished, the polling interval starts growing exponentially
@@ -789,8 +917,43 @@ static int jobqueue_push_static_jobs(ThPool* thpool,
  * @param threadpool     the threadpool to wait for
  */
 static void thpool_wait(ThPool* thpool) {
+    WorkGroup* workGroup;
+    JobQueue* queue = thpool->jobqueue;
+    long long end_time;
+    int i = 0;
+
+    if (cppadcg_pool_caller_executes) {
+        while (1) {
+            pthread_mutex_lock(&queue->rwmutex);
+            workGroup = jobqueue_pull(thpool, -1);
+            pthread_mutex_unlock(&queue->rwmutex);
+
+            if (workGroup == NULL)
+                break;
+
+            workgroup_execute(workGroup);
+
+            if (cppadcg_pool_verbose) {
+                fprintf(stdout, "thpool_wait(): calling thread executed a work group with %i jobs\n", workGroup->size);
+            }
+            free(workGroup->jobs);
+            free(workGroup);
+        }
+    }
+
+    if (cppadcg_pool_spin_time > 0) {
+        end_time = get_monotonic_time_ns() + (long long) (cppadcg_pool_spin_time * 1e9f);
+        while (__atomic_load_n(&queue->len, __ATOMIC_SEQ_CST) ||
+               __atomic_load_n(&queue->n_thread_groups, __ATOMIC_SEQ_CST) ||
+               __atomic_load_n(&thpool->num_threads_working, __ATOMIC_SEQ_CST)) {
+            cpu_relax();
+            if ((++i & 63) == 0 && get_monotonic_time_ns() > end_time)
+                break;
+        }
+    }
+
     pthread_mutex_lock(&thpool->thcount_lock);
-    while (thpool->jobqueue->len || thpool->jobqueue->group_front || thpool->num_threads_working) {  //// PROBLEM HERE!!!! len is not locked!!!!
+    while (thpool->jobqueue->len || thpool->jobqueue->n_thread_groups || thpool->num_threads_working) {  //// PROBLEM HERE!!!! len is not locked!!!!
         pthread_cond_wait(&thpool->threads_all_idle, &thpool->thcount_lock);
     }
     thpool->jobqueue->total_time = 0;
@@ -888,14 +1051,14 @@ static void thpool_destroy(ThPool* thpool) {
     double tpassed = 0.0;
     time(&start);
     while (tpassed < TIMEOUT && thpool->num_threads_alive) {
-        bsem_post_all(thpool->jobqueue->has_jobs);
+        thpool_post_all(thpool);
         time(&end);
         tpassed = difftime(end, start);
     }
 
     /* Poll remaining threads */
     while (thpool->num_threads_alive) {
-        bsem_post_all(thpool->jobqueue->has_jobs);
+        thpool_post_all(thpool);
         sleep(1);
     }
 
@@ -941,7 +1104,9 @@ static int thread_init(ThPool* thpool,
 
     (*thread)->thpool = thpool;
     (*thread)->id = id;
+    (*thread)->affinity_version = -1;
     (*thread)->processed_groups = NULL;
+    bsem_init(&(*thread)->has_jobs, 0);
 
     pthread_create(&(*thread)->pthread, NULL, (void*) thread_do, (*thread));
     pthread_detach((*thread)->pthread);
@@ -957,15 +1122,8 @@ static int thread_init(ThPool* thpool,
 * @return nothing
 */
 static void* thread_do(Thread* thread) {
-    float elapsed;
-    int info;
-    struct timespec cputime;
     JobQueue* queue;
     WorkGroup* workGroup;
-    Job* job;
-    thpool_function_type func_buff;
-    void* arg_buff;
-    int i;
 
     /* Set thread name for profiling and debugging */
     char thread_name[128] = {0};
@@ -990,14 +1148,20 @@ static void* thread_do(Thread* thread) {
 
     queue = thpool->jobqueue;
 
+    thread_set_affinity(thread);
+
     while (thpool->threads_keepalive) {
 
-        bsem_wait(queue->has_jobs);
+        bsem_wait(&thread->has_jobs);
 
         if (!thpool->threads_keepalive) {
             break;
         }
 
+        if (thread->affinity_version != cppadcg_pool_affinity_version) {
+            thread_set_affinity(thread);
+        }
+
         pthread_mutex_lock(&thpool->thcount_lock);
         thpool->num_threads_working++;
         pthread_mutex_unlock(&thpool->thcount_lock);
@@ -1011,42 +1175,9 @@ static void* thread_do(Thread* thread) {
             if (workGroup == NULL)
                 break;
 
-            if (cppadcg_pool_verbose) {
-                get_monotonic_time2(&workGroup->startTime);
-            }
-
-            for (i = 0; i < workGroup->size; ++i) {
-                job = &workGroup->jobs[i];
-
-                if (cppadcg_pool_verbose) {
-                    get_monotonic_time2(&job->startTime);
-                }
-
-                int do_benchmark = job->elapsed != NULL;
-                if (do_benchmark) {
-                    elapsed = -get_thread_time(&cputime, &info);
-                }
-
-                /* Execute the job */
-                func_buff = job->function;
-                arg_buff = job->arg;
-                func_buff(arg_buff);
-
-                if (do_benchmark && info == 0) {
-                    elapsed += get_thread_time(&cputime, &info);
-                    if (info == 0) {
-                        (*job->elapsed) = elapsed;
-                    }
-                }
-
-                if (cppadcg_pool_verbose) {
-                    get_monotonic_time2(&job->endTime);
-                }
-            }
+            workgroup_execute(workGroup);
 
             if (cppadcg_pool_verbose) {
-                get_monotonic_time2(&workGroup->endTime);
-
                 if (thread->processed_groups == NULL) {
                     thread->processed_groups = workGroup;
                 } else {
@@ -1075,6 +1206,254 @@ static void* thread_do(Thread* thread) {
 }
 
 
+#if defined(__linux__)
+
+static int cpumask_isset(const CpuMask* mask, int cpu) {
+    return (mask->bits[cpu / CPPADCG_THPOOL_CPU_BITS] >> (cpu % CPPADCG_THPOOL_CPU_BITS)) & 1UL;
+}
+
+static void cpumask_set(CpuMask* mask, int cpu) {
+    mask->bits[cpu / CPPADCG_THPOOL_CPU_BITS] |= 1UL << (cpu % CPPADCG_THPOOL_CPU_BITS);
+}
+
+static int cpumask_count(const CpuMask* mask) {
+    int cpu, n = 0;
+    for (cpu = 0; cpu < CPPADCG_THPOOL_MAX_CPUS; ++cpu) {
+        n += cpumask_isset(mask, cpu);
+    }
+    return n;
+}
+
+/**
+ * Reads the CPUs of a NUMA node (only those in allowed) from a list
+ * such as "0-7,16-23".
+ *
+ * @return 0 on success, -1 if the node does not exist
+ */
+static int numa_node_cpus(int node,
+                          const CpuMask* allowed,
+                          CpuMask* mask) {
+    char path[128];
+    char line[4096];
+    char* c;
+    char* end;
+    long first, last, cpu;
+    FILE* f;
+
+    sprintf(path, "/sys/devices/system/node/node%i/cpulist", node);
+    f = fopen(path, "r");
+    if (f == NULL)
+        return -1;
+
+    memset(mask, 0, sizeof(CpuMask));
+    if (fgets(line, sizeof(line), f) != NULL) {
+        c = line;
+        while (*c != '\0' && *c != '\n') {
+            first = strtol(c, &end, 10);
+            if (end == c)
+                break;
+            last = first;
+            c = end;
+            if (*c == '-') {
+                last = strtol(c + 1, &end, 10);
+                c = end;
+            }
+            for (cpu = first; cpu <= last && cpu < CPPADCG_THPOOL_MAX_CPUS; ++cpu) {
+                if (cpumask_isset(allowed, cpu))
+                    cpumask_set(mask, cpu);
+            }
+            if (*c == ',')
+                c++;
+        }
+    }
+    fclose(f);
+
+    return 0;
+}
+
+/**
+ * Reads the number of possible NUMA node identifiers from a list such as
+ * "0-3" (some of the nodes in this range might not exist).
+ *
+ * @return the highest possible node identifier plus one, 0 if unknown
+ */
+static int numa_possible_nodes() {
+    char line[4096];
+    char* c;
+    char* end;
+    long last = -1;
+    FILE* f;
+
+    f = fopen("/sys/devices/system/node/possible", "r");
+    if (f == NULL)
+        return 0;
+
+    if (fgets(line, sizeof(line), f) != NULL) {
+        c = line;
+        while (*c != '\0' && *c != '\n') {
+            last = strtol(c, &end, 10);
+            if (end == c)
+                break;
+            c = end;
+            if (*c == '-' || *c == ',')
+                c++;
+        }
+    }
+    fclose(f);
+
+    return (int) (last + 1);
+}
+
+/**
+ * Determines the CPUs a thread should be pinned to.
+ *
+ * @return 0 on success, -1 if the thread should not be pinned
+ */
+static int thread_cpus(Thread* thread,
+                       enum ThreadAffinity affinity,
+                       CpuMask* mask) {
+    const CpuMask* allowed = &thread->thpool->process_cpus;
+    int num_threads = thread->thpool->num_threads;
+    int n_cpus, n_nodes, max_nodes, node, target, cpu, k;
+    CpuMask node_cpus;
+
+    if (affinity == THREAD_AFFINITY_CORE) {
+        // threads are placed on consecutive CPUs
+        n_cpus = cpumask_count(allowed);
+        if (n_cpus == 0)
+            return -1;
+        target = thread->id % n_cpus;
+        memset(mask, 0, sizeof(CpuMask));
+        for (cpu = 0, k = 0; cpu < CPPADCG_THPOOL_MAX_CPUS; ++cpu) {
+            if (cpumask_isset(allowed, cpu) && k++ == target) {
+                cpumask_set(mask, cpu);
+                return 0;
+            }
+        }
+        return -1;
+
+    } else if (affinity == THREAD_AFFINITY_NUMA_NODE) {
+        // consecutive threads (which receive neighbouring jobs) share the same node
+        // node identifiers are not necessarily contiguous
+        max_nodes = numa_possible_nodes();
+        n_nodes = 0;
+        for (node = 0; node < max_nodes; ++node) {
+            if (numa_node_cpus(node, allowed, &node_cpus) == 0 && cpumask_count(&node_cpus) > 0)
+                n_nodes++;
+        }
+        if (n_nodes == 0)
+            return -1;
+
+        target = thread->id * n_nodes / num_threads;
+        for (node = 0, k = 0; node < max_nodes; ++node) {
+            if (numa_node_cpus(node, allowed, mask) == 0 && cpumask_count(mask) > 0 && k++ == target)
+                return 0;
+        }
+        return -1;
+
+    } else {
+        // THREAD_AFFINITY_NONE
+        *mask = *allowed;
+        return 0;
+    }
+}
+
+#endif
+
+/**
+ * Pins the current thread according to the affinity of the thread pool.
+ * It must be called by the thread itself.
+ */
+static void thread_set_affinity(Thread* thread) {
+    int version = cppadcg_pool_affinity_version;
+    enum ThreadAffinity affinity = cppadcg_pool_affinity;
+
+    if (thread->affinity_version == version)
+        return;
+
+    if (thread->affinity_version < 0 && affinity == THREAD_AFFINITY_NONE) {
+        // new thread which already uses all the available CPUs
+        thread->affinity_version = version;
+        return;
+    }
+
+    thread->affinity_version = version;
+
+#if defined(__linux__)
+    CpuMask mask;
+
+    if (!thread->thpool->process_cpus_valid || thread_cpus(thread, affinity, &mask) != 0) {
+        if (cppadcg_pool_verbose) {
+            fprintf(stderr, "thread_set_affinity(): unable to determine the CPUs of thread %i\n", thread->id);
+        }
+        return;
+    }
+
+    /* Use the system call directly to prevent using _GNU_SOURCE flag (like prctl) */
+    if (syscall(SYS_sched_setaffinity, 0, sizeof(CpuMask), &mask) != 0) {
+        fprintf(stderr, "thread_set_affinity(): failed to set the affinity of thread %i\n", thread->id);
+    } else if (cppadcg_pool_verbose) {
+        fprintf(stdout, "thread_set_affinity(): thread %i pinned to %i CPU(s)\n", thread->id, cpumask_count(&mask));
+    }
+#else
+    if (affinity != THREAD_AFFINITY_NONE) {
+        fprintf(stderr, "thread_set_affinity(): thread affinity is not supported on this system\n");
+    }
+#endif
+}
+
+
+/**
+ * Executes the jobs of a work group in the current thread
+ */
+static void workgroup_execute(WorkGroup* workGroup) {
+    float elapsed;
+    int info;
+    struct timespec cputime;
+    Job* job;
+    thpool_function_type func_buff;
+    void* arg_buff;
+    int i;
+
+    if (cppadcg_pool_verbose) {
+        get_monotonic_time2(&workGroup->startTime);
+    }
+
+    for (i = 0; i < workGroup->size; ++i) {
+        job = &workGroup->jobs[i];
+
+        if (cppadcg_pool_verbose) {
+            get_monotonic_time2(&job->startTime);
+        }
+
+        int do_benchmark = job->elapsed != NULL;
+        if (do_benchmark) {
+            elapsed = -get_thread_time(&cputime, &info);
+        }
+
+        /* Execute the job */
+        func_buff = job->function;
+        arg_buff = job->arg;
+        func_buff(arg_buff);
+
+        if (do_benchmark && info == 0) {
+            elapsed += get_thread_time(&cputime, &info);
+            if (info == 0) {
+                (*job->elapsed) = elapsed;
+            }
+        }
+
+        if (cppadcg_pool_verbose) {
+            get_monotonic_time2(&job->endTime);
+        }
+    }
+
+    if (cppadcg_pool_verbose) {
+        get_monotonic_time2(&workGroup->endTime);
+    }
+}
+
+
 /* Frees a thread  */
 static void thread_destroy(Thread* thread) {
     free(thread);
@@ -1095,17 +1474,16 @@ static int jobqueue_init(ThPool* thpool) {
     queue->len = 0;
     queue->front = NULL;
     queue->rear = NULL;
-    queue->group_front = NULL;
+    queue->n_thread_groups = 0;
     queue->total_time = 0;
     queue->highest_expected_return = 0;
 
-    queue->has_jobs = (BSem*) malloc(sizeof(BSem));
-    if (queue->has_jobs == NULL) {
+    queue->thread_groups = (WorkGroup**) calloc(thpool->num_threads, sizeof(WorkGroup*));
+    if (queue->thread_groups == NULL) {
         return -1;
     }
 
     pthread_mutex_init(&(queue->rwmutex), NULL);
-    bsem_init(queue->has_jobs, 0);
 
     return 0;
 }
@@ -1115,6 +1493,16 @@ static int jobqueue_init(ThPool* thpool) {
 static void jobqueue_clear(ThPool* thpool) {
     WorkGroup* group;
     int size;
+    int i;
+
+    for (i = 0; i < thpool->num_threads; ++i) {
+        while (thpool->jobqueue->thread_groups[i] != NULL) {
+            group = thpool->jobqueue->thread_groups[i];
+            thpool->jobqueue->thread_groups[i] = group->prev;
+            free(group->jobs);
+            free(group);
+        }
+    }
 
     do {
         group = jobqueue_pull(thpool, -1);
@@ -1129,9 +1517,8 @@ static void jobqueue_clear(ThPool* thpool) {
 
     thpool->jobqueue->front = NULL;
     thpool->jobqueue->rear = NULL;
-    bsem_reset(thpool->jobqueue->has_jobs);
     thpool->jobqueue->len = 0;
-    thpool->jobqueue->group_front = NULL;
+    thpool->jobqueue->n_thread_groups = 0;
     thpool->jobqueue->total_time = 0;
     thpool->jobqueue->highest_expected_return = 0;
 }
@@ -1165,24 +1552,27 @@ static void jobqueue_push_internal(JobQueue* queue,
 /**
  * Add (allocated) job to queue
  */
-static void jobqueue_push(JobQueue* queue,
+static void jobqueue_push(ThPool* thpool,
                           Job* newjob) {
+    JobQueue* queue = thpool->jobqueue;
+
     pthread_mutex_lock(&queue->rwmutex);
 
     jobqueue_push_internal(queue, newjob);
 
-    bsem_post(queue->has_jobs);
-
     pthread_mutex_unlock(&queue->rwmutex);
+
+    thpool_post_all(thpool);
 }
 
 
 /**
  * Add (allocated) multiple jobs to queue
  */
-static void jobqueue_multipush(JobQueue* queue,
+static void jobqueue_multipush(ThPool* thpool,
                                Job* newjob[],
                                int nJobs) {
+    JobQueue* queue = thpool->jobqueue;
     int i;
 
     pthread_mutex_lock(&queue->rwmutex);
@@ -1191,9 +1581,9 @@ static void jobqueue_multipush(JobQueue* queue,
         jobqueue_push_internal(queue, newjob[i]);
     }
 
-    bsem_post_all(queue->has_jobs);
-
     pthread_mutex_unlock(&queue->rwmutex);
+
+    thpool_post_all(thpool);
 }
 
 static Job* jobqueue_extract_single(JobQueue* queue) {
@@ -1252,11 +1642,12 @@ static WorkGroup* jobqueue_pull(ThPool* thpool,
     int i;
     JobQueue* queue = thpool->jobqueue;
 
-    if (schedule_strategy == SCHED_STATIC && queue->group_front != NULL) {
-        // STATIC
-        group = queue->group_front;
+    if (id >= 0 && queue->thread_groups[id] != NULL) {
+        // STATIC (work groups can only be executed by the thread they were assigned to)
+        group = queue->thread_groups[id];
 
-        queue->group_front = group->prev;
+        queue->thread_groups[id] = group->prev;
+        queue->n_thread_groups--;
         group->prev = NULL;
 
     } else if (queue->len == 0) {
@@ -1346,10 +1737,6 @@ static WorkGroup* jobqueue_pull(ThPool* thpool,
         }
 
     }
-    /* more than one job in queue -> post it */
-    if (queue->len > 0 || queue->group_front != NULL) {
-        bsem_post(queue->has_jobs);
-    }
 
     return group;
 }
@@ -1358,7 +1745,7 @@ static WorkGroup* jobqueue_pull(ThPool* thpool,
 /* Free all queue resources back to the system */
 static void jobqueue_destroy(ThPool* thpool) {
     jobqueue_clear(thpool);
-    free(thpool->jobqueue->has_jobs);
+    free(thpool->jobqueue->thread_groups);
 }
 
 
@@ -1377,39 +1764,69 @@ static void bsem_init(BSem* bsem, int value) {
     pthread_mutex_init(&(bsem->mutex), NULL);
     pthread_cond_init(&(bsem->cond), NULL);
     bsem->v = value;
+    bsem->parked = 0;
 }
 
 
-/* Reset semaphore to 0 */
-static void bsem_reset(BSem* bsem) {
-    bsem_init(bsem, 0);
+/* Post to at least one thread (the mutex is only used if a thread is blocked) */
+static void bsem_post(BSem* bsem) {
+    __atomic_store_n(&bsem->v, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&bsem->parked, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&bsem->mutex);
+        pthread_cond_signal(&bsem->cond);
+        pthread_mutex_unlock(&bsem->mutex);
+    }
 }
 
 
-/* Post to at least one thread */
-static void bsem_post(BSem* bsem) {
-    pthread_mutex_lock(&bsem->mutex);
-    bsem->v = 1;
-    pthread_cond_signal(&bsem->cond);
-    pthread_mutex_unlock(&bsem->mutex);
+/* Post to the semaphores of all threads in the pool */
+static void thpool_post_all(ThPool* thpool) {
+    int i;
+    for (i = 0; i < thpool->num_threads; ++i) {
+        bsem_post(&thpool->threads[i]->has_jobs);
+    }
 }
 
 
-/* Post to all threads */
-static void bsem_post_all(BSem* bsem) {
-    pthread_mutex_lock(&bsem->mutex);
-    bsem->v = 1;
-    pthread_cond_broadcast(&bsem->cond);
-    pthread_mutex_unlock(&bsem->mutex);
+/* Pause instruction used while actively waiting */
+static void cpu_relax() {
+    if (cppadcg_pool_oversubscribed) {
+        /* another thread might need this CPU to complete the work */
+        sched_yield();
+        return;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
 }
 
 
-/* Wait on semaphore until semaphore has value 0 */
+/* Wait on semaphore until semaphore has value 1 (spins for up to
+ * cppadcg_pool_spin_time before blocking) */
 static void bsem_wait(BSem* bsem) {
+    long long end_time;
+    int i = 0;
+
+    if (cppadcg_pool_spin_time > 0) {
+        end_time = get_monotonic_time_ns() + (long long) (cppadcg_pool_spin_time * 1e9f);
+        while (1) {
+            if (__atomic_load_n(&bsem->v, __ATOMIC_RELAXED) == 1 &&
+                __atomic_exchange_n(&bsem->v, 0, __ATOMIC_SEQ_CST) == 1) {
+                return;
+            }
+            cpu_relax();
+            if ((++i & 63) == 0 && get_monotonic_time_ns() > end_time)
+                break;
+        }
+    }
+
     pthread_mutex_lock(&bsem->mutex);
-    while (bsem->v != 1) {
+    __atomic_add_fetch(&bsem->parked, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_exchange_n(&bsem->v, 0, __ATOMIC_SEQ_CST) != 1) {
         pthread_cond_wait(&bsem->cond, &bsem->mutex);
     }
-    bsem->v = 0;
+    __atomic_sub_fetch(&bsem->parked, 1, __ATOMIC_SEQ_CST);
     pthread_mutex_unlock(&bsem->mutex);
 }
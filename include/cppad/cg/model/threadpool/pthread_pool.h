@@ -27,6 +27,11 @@ enum ScheduleStrategy {SCHED_STATIC = 1,
 enum ElapsedTimeReference {ELAPSED_TIME_AVG,
                            ELAPSED_TIME_MIN};
 
+enum ThreadAffinity {THREAD_AFFINITY_NONE = 0,
+                     THREAD_AFFINITY_CORE = 1,
+                     THREAD_AFFINITY_NUMA_NODE = 2
+                     };
+
 typedef void (*cppadcg_thpool_function_type)(void*);
 
 
@@ -60,6 +65,21 @@ void cppadcg_thpool_set_verbose(int v);
 int cppadcg_thpool_is_verbose();
 
 
+void cppadcg_thpool_set_spin_time(float seconds);
+
+float cppadcg_thpool_get_spin_time();
+
+
+void cppadcg_thpool_set_caller_executes(int e);
+
+int cppadcg_thpool_is_caller_executes();
+
+
+void cppadcg_thpool_set_affinity(enum ThreadAffinity a);
+
+enum ThreadAffinity cppadcg_thpool_get_affinity();
+
+
 void cppadcg_thpool_set_disabled(int disabled);
 
 int cppadcg_thpool_is_disabled();
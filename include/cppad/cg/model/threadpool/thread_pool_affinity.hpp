@@ -0,0 +1,30 @@
+#ifndef CPPAD_CG_THREAD_POOL_AFFINITY_INCLUDED
+#define CPPAD_CG_THREAD_POOL_AFFINITY_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+enum class ThreadPoolAffinity {
+    NONE = 0, // threads can run on any of the available CPUs
+    CORE = 1, // each thread is pinned to a single CPU
+    NUMA_NODE = 2 // each thread is pinned to the CPUs of a NUMA node (consecutive threads share the same node)
+};
+
+}
+}
+
+#endif
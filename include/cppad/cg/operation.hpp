@@ -51,6 +51,7 @@ enum class CGOpCode {
     Erf,                  // erf(variable)
     Exp,                  // exp(variable)
     Expm1,                // expm1(variable)
+    Fma,                  // fma(a, b, c) = a * b + c with a single rounding
     Inv,                  //                             independent variable
     Log,                  // log(variable)
     Log1p,                // log1p(variable)
@@ -116,6 +117,7 @@ inline std::ostream& operator<<(std::ostream& os, const CGOpCode& op) {
             "erf($1)",                // Erf
             "exp($1)",                // Exp
             "expm1($1)",              // Expm1
+            "fma($1, $2, $3)",        // Fma
             "independent()",          // Inv
             "log($1)",                // Log
             "log1p($1)",              // Log1p
@@ -155,7 +155,9 @@ public:
 
         findLoops();
 
+        startingJob("model without loops");
         nonLoopTape = createNewTape();
+        finishedJob();
 
         loopTapes.clear();
         for (size_t l = 0; l < loops_.size(); l++) {
@@ -211,7 +213,9 @@ private:
         /**
          * Determine the equation patterns
          */
+        startingJob("equation patterns");
         findRelatedVariables();
+        finishedJob();
 
         for (EquationPattern<Base>* eq : equations_) {
             for (size_t depIt : eq->dependents) {
@@ -230,6 +234,7 @@ private:
          * Combine related equations in the same loops
          * (equations that share temporary variables)
          ******************************************************************/
+        startingJob("shared temporary variables");
         /**
          * Find and organize relationships
          */
@@ -271,9 +276,12 @@ private:
             equation2Loop_[eq] = loop;
         }
 
+        finishedJob();
+
         /*******************************************************************
          * Attempt to combine loops with shared variables
          ******************************************************************/
+        startingJob("loop merging");
         MaxOps2eq2totalOps2validDepsType maxOps2Eq2totalOps2validDeps;
         Eq2totalOps2validDepsType eq2totalOps2validDeps;
         SmartListPointer<TotalOps2validDepsType> totalOps2validDepsMem;
@@ -470,17 +478,21 @@ private:
             }
         }
 
+        finishedJob();
+
         size_t l_size = loops_.size();
 
         /**
          * assign indexes (k) to temporary variables (non-indexed) used by loops
          */
+        startingJob("loop models");
         for (size_t l = 0; l < l_size; l++) {
             Loop<Base>* loop = loops_[l];
 
             //Generate a local model for the loop
             loop->createLoopModel(dependents_, independents_, dep2Equation_, origTemp2Index_);
         }
+        finishedJob();
 
         /**
          * clean-up evaluation order
@@ -791,47 +803,34 @@ private:
         varColor.adjustSize();
         varColor.fill(0);
 
+        CodeHandlerVector<Base, size_t> nodeHash(*handler_);
+        nodeHash.adjustSize();
+        nodeHash.fill(0);
+
         size_t rSize = relatedDepCandidates_.size();
         for (size_t r = 0; r < rSize; r++) {
             const std::set<size_t>& candidates = relatedDepCandidates_[r];
-            std::set<size_t> used;
-
-            eqCurr_ = nullptr;
-
-            std::set<size_t>::const_iterator itRef;
-            for (itRef = candidates.begin(); itRef != candidates.end(); ++itRef) {
-                size_t iDepRef = *itRef;
-
-                // check if it has already been used
-                if (used.find(iDepRef) != used.end()) {
-                    continue;
-                }
-
-                if (eqCurr_ == nullptr || used.size() > 0) {
-                    eqCurr_ = new EquationPattern<Base>(dependents_[iDepRef], iDepRef);
-                    equations_.push_back(eqCurr_);
-                }
 
-                std::set<size_t>::const_iterator it = itRef;
-                for (++it; it != candidates.end(); ++it) {
-                    size_t iDep = *it;
-                    // check if it has already been used
-                    if (used.find(iDep) != used.end()) {
-                        continue;
-                    }
+            /**
+             * dependents with different structural hashes cannot have the
+             * same pattern (only compare dependents inside each bucket)
+             */
+            std::map<size_t, std::vector<size_t> > buckets;
+            for (size_t iDep : candidates) {
+                buckets[structuralHash(dependents_[iDep], nodeHash)].push_back(iDep);
+            }
 
-                    if (eqCurr_->testAdd(iDep, dependents_[iDep], color_, varColor)) {
-                        used.insert(iDep);
-                    }
-                }
+            size_t eqStart = equations_.size();
 
-                if (eqCurr_->dependents.size() == 1) {
-                    // nothing found :(
-                    delete eqCurr_;
-                    eqCurr_ = nullptr;
-                    equations_.pop_back();
-                }
+            for (const auto& itBucket : buckets) {
+                findRelatedVariables(itBucket.second, varColor);
             }
+
+            // same order as if all candidates were compared with each other
+            std::sort(equations_.begin() + eqStart, equations_.end(),
+                      [](const EquationPattern<Base>* e1, const EquationPattern<Base>* e2) {
+                          return e1->depRefIndex < e2->depRefIndex;
+                      });
         }
 
         /**
@@ -845,6 +844,127 @@ private:
         return equations_;
     }
 
+    /**
+     * Creates equation patterns for a group of dependent variables.
+     *
+     * @param candidates the ordered indexes of dependent variables which
+     *                   might have the same expression pattern
+     * @param varColor used to mark visited nodes
+     */
+    inline void findRelatedVariables(const std::vector<size_t>& candidates,
+                                     CodeHandlerVector<Base, size_t>& varColor) {
+        if (candidates.size() < 2)
+            return; // nothing to compare with
+
+        std::vector<bool> used(candidates.size(), false);
+
+        for (size_t ref = 0; ref < candidates.size(); ref++) {
+            // check if it has already been used
+            if (used[ref]) {
+                continue;
+            }
+
+            size_t iDepRef = candidates[ref];
+            eqCurr_ = new EquationPattern<Base>(dependents_[iDepRef], iDepRef);
+            equations_.push_back(eqCurr_);
+
+            for (size_t c = ref + 1; c < candidates.size(); c++) {
+                // check if it has already been used
+                if (used[c]) {
+                    continue;
+                }
+
+                size_t iDep = candidates[c];
+                if (eqCurr_->testAdd(iDep, dependents_[iDep], color_, varColor)) {
+                    used[c] = true;
+                }
+            }
+
+            if (eqCurr_->dependents.size() == 1) {
+                // nothing found :(
+                delete eqCurr_;
+                eqCurr_ = nullptr;
+                equations_.pop_back();
+            }
+        }
+    }
+
+    /**
+     * Determines a hash for the expression of a dependent variable which
+     * does not depend on the independent variables used by it.
+     * Dependent variables with different hashes can never belong to the
+     * same equation pattern.
+     *
+     * @param dep the dependent variable
+     * @param nodeHash the already determined hashes of the nodes (zero if
+     *                 not determined yet)
+     * @return the hash
+     */
+    inline size_t structuralHash(const CGBase& dep,
+                                 CodeHandlerVector<Base, size_t>& nodeHash) const {
+        if (dep.isParameter()) {
+            return 1;
+        }
+        return structuralHash(dep.getOperationNode(), nodeHash);
+    }
+
+    inline size_t structuralHash(OperationNode<Base>* node,
+                                 CodeHandlerVector<Base, size_t>& nodeHash) const {
+        // aliases are ignored by EquationPattern (except the ones used to mark indexed dependents)
+        while (node->getOperationType() == CGOpCode::Alias) {
+            OperationNode<Base>* arg = node->getArguments()[0].getOperation();
+            if (arg != nullptr && arg->getOperationType() == CGOpCode::Inv) break;
+            node = arg;
+        }
+
+        if (nodeHash[*node] != 0)
+            return nodeHash[*node];
+
+        size_t h = size_t(node->getOperationType()) + 3;
+
+        const std::vector<size_t>& info = node->getInfo();
+        hashCombine(h, info.size());
+        for (size_t e : info) {
+            hashCombine(h, e);
+        }
+
+        const std::vector<Argument<Base> >& args = node->getArguments();
+        hashCombine(h, args.size());
+        for (const Argument<Base>& a : args) {
+            if (a.getOperation() == nullptr) {
+                hashCombine(h, 1); // parameter (values are only compared inside buckets)
+            } else if (a.getOperation()->getOperationType() == CGOpCode::Inv) {
+                hashCombine(h, 2); // any independent variable
+            } else {
+                hashCombine(h, structuralHash(a.getOperation(), nodeHash));
+            }
+        }
+
+        if (h == 0)
+            h = 1; // zero is used for unknown hashes
+
+        nodeHash[*node] = h;
+
+        return h;
+    }
+
+    static inline void hashCombine(size_t& seed,
+                                   size_t value) {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    inline void startingJob(const std::string& jobName) const {
+        JobTimer* timer = handler_->getJobTimer();
+        if (timer != nullptr)
+            timer->startingJob(jobName);
+    }
+
+    inline void finishedJob() const {
+        JobTimer* timer = handler_->getJobTimer();
+        if (timer != nullptr)
+            timer->finishedJob();
+    }
+
     /**
      * Finds nodes which can be shared with other equation patterns
      * 
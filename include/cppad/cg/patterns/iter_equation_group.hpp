@@ -84,6 +84,25 @@ public:
             return; // already evaluated
         }
 
+        CPPADCG_ASSERT_UNKNOWN(model != nullptr);
+        ADFun<CGB>& fun = model->getTape();
+
+        evalHessianSparsity(hessianSparsitySet<std::vector<std::set<size_t> >, CGB>(fun, tapeI));
+    }
+
+    /**
+     * Creates the database of Hessian elements using an already
+     * determined Hessian sparsity of the tape equations in this group
+     * (e.g. determined together with the other groups of the same loop).
+     *
+     * @param tapeSparsity the Hessian sparsity for the sum of the tape
+     *                     equations in tapeI
+     */
+    inline void evalHessianSparsity(std::vector<std::set<size_t> > tapeSparsity) {
+        if (hessSparsity_) {
+            return; // already evaluated
+        }
+
         CPPADCG_ASSERT_UNKNOWN(model != nullptr);
         size_t iterationCount = model->getIterationCount();
 
@@ -91,9 +110,7 @@ public:
         const std::vector<LoopPosition>& nonIndexedIndepIndexes = model->getNonIndexedIndepIndexes();
         const std::vector<LoopPosition>& temporaryIndependents = model->getTemporaryIndependents();
 
-        ADFun<CGB>& fun = model->getTape();
-
-        hessTapeSparsity_ = hessianSparsitySet<std::vector<std::set<size_t> >, CGB>(fun, tapeI);
+        hessTapeSparsity_.swap(tapeSparsity);
 
         /**
          * make a database of the Hessian elements
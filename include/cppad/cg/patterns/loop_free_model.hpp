@@ -126,21 +126,28 @@ public:
             size_t m = fun_->Range();
             size_t n = fun_->Domain();
 
-            // hessian for the original equations
-            std::set<size_t> eqs;
+            // hessian for the original equations and for the temporary
+            // variable equations (a single forward sweep)
+            std::vector<std::set<size_t> > eqs;
             if (mo != 0) {
+                eqs.emplace_back();
                 for (size_t i = 0; i < mo; i++)
-                    eqs.insert(eqs.end(), i);
+                    eqs.back().insert(eqs.back().end(), i);
+            }
+            if (m != mo) {
+                eqs.emplace_back();
+                for (size_t i = mo; i < m; i++)
+                    eqs.back().insert(eqs.back().end(), i);
+            }
 
-                hessTapeOrigEqSparsity_ = hessianSparsitySet<std::vector<std::set<size_t> >, CGB>(*fun_, eqs);
+            std::vector<VectorSet> hess = hessianSparsitySet<VectorSet, CGB>(*fun_, eqs);
+
+            if (mo != 0) {
+                hessTapeOrigEqSparsity_.swap(hess.front());
             }
 
-            // hessian for the temporary variable equations
             if (m != mo) {
-                eqs.clear();
-                for (size_t i = mo; i < m; i++)
-                    eqs.insert(eqs.end(), i);
-                hessTapeTempSparsity_ = hessianSparsitySet<std::vector<std::set<size_t> >, CGB>(*fun_, eqs);
+                hessTapeTempSparsity_.swap(hess.back());
             } else {
                 hessTapeTempSparsity_.resize(n);
             }
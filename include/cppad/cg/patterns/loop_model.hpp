@@ -467,8 +467,15 @@ public:
             size_t n = fun_->Domain();
             hessTapeSparsity_.resize(n);
 
+            // a single forward sweep for all the groups
+            std::vector<std::set<size_t> > groupEqs(equationGroups_.size());
             for (size_t g = 0; g < equationGroups_.size(); g++) {
-                equationGroups_[g].evalHessianSparsity();
+                groupEqs[g] = equationGroups_[g].tapeI;
+            }
+            std::vector<std::vector<std::set<size_t> > > groupHess = hessianSparsitySet<std::vector<std::set<size_t> >, CGB>(*fun_, groupEqs);
+
+            for (size_t g = 0; g < equationGroups_.size(); g++) {
+                equationGroups_[g].evalHessianSparsity(std::move(groupHess[g]));
                 const std::vector<std::set<size_t> >& ghess = equationGroups_[g].getHessianSparsity();
                 for (size_t j = 0; j < n; j++) {
                     hessTapeSparsity_[j].insert(ghess[j].begin(), ghess[j].end());
@@ -116,6 +116,16 @@ inline CG<Base> CodeHandler<Base>::solveFor(const SourceCodePath& path) {
                 rightHs -= CG<Base>(other);
                 break;
             }
+            case CGOpCode::Fma: // a * b + c
+            {
+                if (argIndex == 2) {
+                    rightHs -= CG<Base>(args[0]) * CG<Base>(args[1]);
+                } else {
+                    const Argument<Base>& other = args[argIndex == 0 ? 1 : 0];
+                    rightHs = (rightHs - CG<Base>(args[2])) / CG<Base>(other);
+                }
+                break;
+            }
             case CGOpCode::Alias:
                 // do nothing 
                 break;
@@ -226,6 +236,7 @@ inline bool CodeHandler<Base>::isSolvable(const SourceCodePath& path) const {
             case CGOpCode::Div:
             case CGOpCode::UnMinus:
             case CGOpCode::Add:
+            case CGOpCode::Fma:
             case CGOpCode::Alias:
             case CGOpCode::Sub:
             case CGOpCode::Exp:
@@ -0,0 +1,238 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+/**
+ * Measures the time required by CodeHandler::generateCode() to print the C
+ * source code of a large operation graph with many constants.
+ * The emission steps are also measured separately with the previous
+ * approach (std::ostringstream and std::setprecision for each constant)
+ * and with the current one (LangCCodeWriter and
+ * printShortestFloatingPoint()).
+ * The results are saved in JSON.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cppad/cg/cppadcg.hpp>
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+typedef double Base;
+typedef CG<Base> CGD;
+typedef std::chrono::steady_clock clock_type;
+
+/**
+ * The constants used by the model
+ */
+Base constant(size_t i) {
+    return 0.1 * double(i % 1000) + 1.0 / double(i + 3);
+}
+
+/**
+ * Creates a large operation graph with many temporary variables and
+ * constants.
+ */
+std::vector<CGD> createGraph(CodeHandler<Base>& handler,
+                             size_t n,
+                             size_t m) {
+    std::vector<CGD> x(n);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(m);
+    for (size_t i = 0; i < m; i++) {
+        CGD a = x[i % n] * constant(i) + sin(x[(i + 1) % n]) * constant(i + 1);
+        CGD b = exp(x[(i * 7) % n] / constant(i + 2)) - a * x[(i + 3) % n];
+        y[i] = a * b + pow(x[(i + 5) % n], 2.0) * constant(i + 3);
+    }
+    return y;
+}
+
+double percentile(const std::vector<double>& sorted,
+                  double p) {
+    size_t i = size_t(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+void printJsonStat(std::ostream& out,
+                   const std::string& name,
+                   std::vector<double> times,
+                   bool last) {
+    std::sort(times.begin(), times.end());
+    double mean = 0;
+    for (double t : times)
+        mean += t;
+    mean /= times.size();
+
+    out << "    \"" << name << "\": {"
+            "\"mean\": " << mean << ", "
+            "\"min\": " << times.front() << ", "
+            "\"p50\": " << percentile(times, 0.50) << ", "
+            "\"p90\": " << percentile(times, 0.90) << ", "
+            "\"p99\": " << percentile(times, 0.99) << ", "
+            "\"max\": " << times.back() << "}" << (last ? "\n" : ",\n");
+
+    std::cout << name << ": p50 " << percentile(times, 0.50) << " ms" << std::endl;
+}
+
+double elapsedMs(clock_type::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+/**
+ * Source code generation for the complete graph
+ *
+ * @return the time of each repetition (in milliseconds)
+ */
+std::vector<double> measureGenerateCode(size_t n,
+                                        size_t m,
+                                        size_t nRep,
+                                        size_t& sourceSize) {
+    std::vector<double> times(nRep);
+    for (size_t r = 0; r < nRep; r++) {
+        CodeHandler<Base> handler;
+        std::vector<CGD> y = createGraph(handler, n, m);
+
+        LanguageC<Base> langC("double");
+        LangCDefaultVariableNameGenerator<Base> nameGen;
+        std::ostringstream code;
+
+        clock_type::time_point start = clock_type::now();
+        handler.generateCode(code, langC, y, nameGen);
+        times[r] = elapsedMs(start);
+
+        sourceSize = code.str().size();
+    }
+    return times;
+}
+
+/**
+ * Printing of constants
+ *
+ * @return the time of each repetition (in milliseconds)
+ */
+std::vector<double> measureConstants(size_t m,
+                                     size_t nRep,
+                                     bool stream) {
+    const size_t precision = std::numeric_limits<Base>::digits10;
+    std::vector<double> times(nRep);
+    std::string code;
+    char buf[64];
+
+    for (size_t r = 0; r < nRep; r++) {
+        code.clear();
+        clock_type::time_point start = clock_type::now();
+        for (size_t i = 0; i < 4 * m; i++) {
+            if (stream) {
+                std::ostringstream os;
+                os << std::setprecision(precision) << constant(i);
+                code += os.str();
+            } else {
+                size_t l = printShortestFloatingPoint(constant(i), precision, buf, sizeof(buf));
+                code.append(buf, l);
+            }
+        }
+        times[r] = elapsedMs(start);
+    }
+    return times;
+}
+
+inline void writeTo(const std::ostringstream& body,
+                    std::ostream& out) {
+    out << body.str(); // the previous approach copied the function body
+}
+
+inline void writeTo(const LangCCodeWriter& body,
+                    std::ostream& out) {
+    body.writeTo(out);
+}
+
+/**
+ * Writing of the function body into the output stream
+ *
+ * @return the time of each repetition (in milliseconds)
+ */
+template<class Writer>
+std::vector<double> measureWriter(size_t m,
+                                  size_t nRep) {
+    std::vector<double> times(nRep);
+    for (size_t r = 0; r < nRep; r++) {
+        std::ostringstream out;
+        clock_type::time_point start = clock_type::now();
+        Writer body;
+        for (size_t i = 0; i < 4 * m; i++) {
+            body << "   v[" << i << "] = x[" << (i * 7) % m << "] * v[" << i / 2 << "] + y[" << i % 5 << "];\n";
+        }
+        writeTo(body, out);
+        times[r] = elapsedMs(start);
+    }
+    return times;
+}
+
+size_t parseArgument(int i,
+                     int argc,
+                     char** argv,
+                     size_t defaultValue) {
+    if (argc > i) {
+        return std::strtoul(argv[i], nullptr, 10);
+    }
+    return defaultValue;
+}
+
+}
+
+/**
+ * Usage: speed_code_generation [output.json] [repetitions] [equations]
+ */
+int main(int argc, char **argv) {
+    std::string outFile = argc > 1 ? argv[1] : "speed_code_generation.json";
+    size_t nRep = std::max<size_t>(1, parseArgument(2, argc, argv, 10));
+    size_t m = std::max<size_t>(1, parseArgument(3, argc, argv, 20000));
+    size_t n = std::max<size_t>(6, m / 10);
+
+    size_t sourceSize = 0;
+    std::vector<double> generate = measureGenerateCode(n, m, nRep, sourceSize);
+    std::vector<double> constStream = measureConstants(m, nRep, true);
+    std::vector<double> constShortest = measureConstants(m, nRep, false);
+    std::vector<double> writerStream = measureWriter<std::ostringstream>(m, nRep);
+    std::vector<double> writerBlocks = measureWriter<LangCCodeWriter>(m, nRep);
+
+    std::ofstream out(outFile.c_str());
+    out << "{\n"
+            "  \"independents\": " << n << ",\n"
+            "  \"equations\": " << m << ",\n"
+            "  \"repetitions\": " << nRep << ",\n"
+            "  \"source_size\": " << sourceSize << ",\n"
+            "  \"times_ms\": {\n";
+    printJsonStat(out, "generate_code", generate, false);
+    printJsonStat(out, "constants_stream", constStream, false);
+    printJsonStat(out, "constants_shortest", constShortest, false);
+    printJsonStat(out, "writer_stream", writerStream, false);
+    printJsonStat(out, "writer_blocks", writerBlocks, true);
+    out << "  }\n"
+            "}\n";
+
+    return 0;
+}
@@ -0,0 +1,434 @@
+#ifndef CPPAD_CG_MODEL_SPEED_BENCHMARK_INCLUDED
+#define CPPAD_CG_MODEL_SPEED_BENCHMARK_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include <functional>
+#include <cppad/cg/cppadcg.hpp>
+#include "../patterns/job_speed_listener.hpp"
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Measures the time required to tape, generate, compile and load a model
+ * and the evaluation latency/throughput of every GenericModel entry point.
+ * The results are saved in JSON so that they can be compared between
+ * releases.
+ */
+class ModelSpeedBenchmark {
+public:
+    typedef double Base;
+    typedef CppAD::cg::CG<Base> CGD;
+    typedef CppAD::AD<CGD> ADCGD;
+    typedef std::chrono::steady_clock::duration duration;
+
+    /**
+     * A model to be benchmarked
+     */
+    class Model {
+    public:
+        virtual std::vector<ADCGD> evaluate(const std::vector<ADCGD>& x) = 0;
+
+        /**
+         * Models used through atomic functions (not owned)
+         */
+        virtual std::vector<GenericModel<Base>*> getExternalModels() {
+            return std::vector<GenericModel<Base>*>();
+        }
+
+        inline virtual ~Model() {
+        }
+    };
+
+    /**
+     * Uses a function pointer to define a model
+     */
+    class FunctionModel : public Model {
+    private:
+        std::vector<ADCGD> (*func_)(const std::vector<ADCGD>& x);
+    public:
+
+        inline FunctionModel(std::vector<ADCGD> (*func)(const std::vector<ADCGD>& x)) :
+            func_(func) {
+        }
+
+        virtual std::vector<ADCGD> evaluate(const std::vector<ADCGD>& x) override {
+            return (*func_)(x);
+        }
+    };
+
+protected:
+    std::vector<std::string> compileFlags_;
+    JobSpeedListener listener_;
+    // number of times the model library is created
+    size_t nPrepare_;
+    // number of warm up evaluations (not measured)
+    size_t nWarmUp_;
+    // number of measured evaluations
+    size_t nTimes_;
+    // whether or not loops are generated for compiler vectorization
+    bool vectorizeLoops_;
+    // whether or not vectorized loops use contiguous arrays (structure of arrays)
+    bool packLoopArrays_;
+    // whether or not repeated constants are read from a table
+    bool constantPool_;
+    bool verbose_;
+    // JSON objects with the results of each model
+    std::vector<std::string> results_;
+public:
+
+    inline ModelSpeedBenchmark(bool verbose = false) :
+        nPrepare_(3),
+        nWarmUp_(10),
+        nTimes_(1000),
+        vectorizeLoops_(false),
+        packLoopArrays_(false),
+        constantPool_(false),
+        verbose_(verbose) {
+    }
+
+    inline void setCompileFlags(const std::vector<std::string>& compileFlags) {
+        compileFlags_ = compileFlags;
+    }
+
+    inline void setNumberOfPreparations(size_t nPrepare) {
+        nPrepare_ = std::max<size_t>(1, nPrepare);
+    }
+
+    inline void setNumberOfWarmUpExecutions(size_t nWarmUp) {
+        nWarmUp_ = nWarmUp;
+    }
+
+    inline void setNumberOfExecutions(size_t nTimes) {
+        nTimes_ = std::max<size_t>(1, nTimes);
+    }
+
+    inline void setVectorizeLoops(bool vectorize) {
+        vectorizeLoops_ = vectorize;
+    }
+
+    inline void setPackLoopArrays(bool pack) {
+        packLoopArrays_ = pack;
+    }
+
+    inline void setConstantPool(bool use) {
+        constantPool_ = use;
+    }
+
+    /**
+     * Benchmarks a model.
+     *
+     * @param name the model name (must be a valid C function name)
+     * @param model the model
+     * @param x typical values of the independent variables
+     * @param relatedDepCandidates the related dependent variables used for
+     *                             loop detection (empty for no loops)
+     */
+    inline void measure(const std::string& name,
+                        Model& model,
+                        const std::vector<Base>& x,
+                        const std::vector<std::set<size_t> >& relatedDepCandidates = std::vector<std::set<size_t> >()) {
+        using namespace std::chrono;
+
+        if (verbose_) {
+            std::cout << name << std::endl;
+        }
+
+        std::vector<duration> tape, patterns, srcGen, srcComp, dynLib, total, load;
+
+        std::unique_ptr<ADFun<CGD> > fun;
+        std::unique_ptr<ModelCSourceGen<Base> > sourceGen;
+        std::unique_ptr<ModelLibraryCSourceGen<Base> > libSourceGen;
+        std::unique_ptr<DynamicLib<Base> > dynamicLib;
+        std::unique_ptr<GenericModel<Base> > genModel;
+
+        for (size_t r = 0; r < nPrepare_; r++) {
+            // previous library must be released before it is recreated
+            genModel.reset();
+            dynamicLib.reset();
+            libSourceGen.reset();
+            sourceGen.reset();
+            listener_.reset();
+
+            /**
+             * tape
+             */
+            auto t0 = steady_clock::now();
+            fun.reset(tapeModel(model, x));
+            tape.push_back(steady_clock::now() - t0);
+
+            /**
+             * source generation, compilation and loading
+             */
+            sourceGen.reset(new ModelCSourceGen<Base>(*fun, name));
+            sourceGen->setCreateForwardZero(true);
+            sourceGen->setCreateForwardOne(true);
+            sourceGen->setCreateReverseOne(true);
+            sourceGen->setCreateReverseTwo(true);
+            sourceGen->setCreateSparseJacobian(true);
+            sourceGen->setCreateSparseHessian(true);
+            sourceGen->setTypicalIndependentValues(x);
+            if (!relatedDepCandidates.empty())
+                sourceGen->setRelatedDependents(relatedDepCandidates);
+            sourceGen->setVectorizeLoops(vectorizeLoops_);
+            sourceGen->setPackLoopArrays(packLoopArrays_);
+            sourceGen->setConstantPool(constantPool_);
+
+            libSourceGen.reset(new ModelLibraryCSourceGen<Base>(*sourceGen));
+            libSourceGen->setVerbose(verbose_);
+            libSourceGen->addListener(listener_);
+
+            DynamicModelLibraryProcessor<Base> p(*libSourceGen, "speed_" + name);
+            GccCompiler<Base> compiler;
+            if (!compileFlags_.empty())
+                compiler.setCompileFlags(compileFlags_);
+
+            t0 = steady_clock::now();
+            dynamicLib = p.createDynamicLibrary(compiler);
+            genModel = dynamicLib->model(name);
+            duration elapsed = steady_clock::now() - t0;
+
+            if (genModel.get() == nullptr)
+                throw CGException("Failed to load model '", name, "'");
+
+            if (!relatedDepCandidates.empty())
+                patterns.push_back(listener_.patternDection);
+            srcGen.push_back(listener_.srcCodeGen);
+            srcComp.push_back(listener_.srcCodeComp);
+            dynLib.push_back(listener_.dynLibComp);
+            total.push_back(listener_.totalLibrary);
+            load.push_back(elapsed - listener_.totalLibrary);
+        }
+
+        for (GenericModel<Base>* ext : model.getExternalModels()) {
+            genModel->addExternalModel(*ext);
+        }
+
+        std::ostringstream json;
+        json << "    {\n"
+                "      \"name\": \"" << name << "\",\n"
+                "      \"loops\": " << (relatedDepCandidates.empty() ? "false" : "true") << ",\n"
+                "      \"n\": " << genModel->Domain() << ",\n"
+                "      \"m\": " << genModel->Range() << ",\n"
+                "      \"preparation\": {\n";
+        printJsonStat(json, "tape", tape, false);
+        if (!patterns.empty())
+            printJsonStat(json, "loop_detection", patterns, false);
+        printJsonStat(json, "source_generation", srcGen, false);
+        printJsonStat(json, "compilation", srcComp, false);
+        printJsonStat(json, "dynamic_library_compilation", dynLib, false);
+        printJsonStat(json, "library_creation", total, false);
+        printJsonStat(json, "library_loading", load, true);
+        json << "      },\n"
+                "      \"evaluation\": {\n";
+
+        measureEvaluation(*genModel, x, json);
+
+        json << "      }\n"
+                "    }";
+
+        results_.push_back(json.str());
+    }
+
+    /**
+     * Prints all the results in JSON format
+     */
+    inline void printJson(std::ostream& out) const {
+        out << "{\n"
+                "  \"benchmark\": \"cppadcg_models\",\n"
+                "  \"preparations\": " << nPrepare_ << ",\n"
+                "  \"executions\": " << nTimes_ << ",\n"
+                "  \"models\": [\n";
+        for (size_t i = 0; i < results_.size(); i++) {
+            out << results_[i];
+            if (i + 1 < results_.size()) out << ",";
+            out << "\n";
+        }
+        out << "  ]\n"
+                "}\n";
+    }
+
+protected:
+
+    inline ADFun<CGD>* tapeModel(Model& model,
+                                 const std::vector<Base>& xb) {
+        std::vector<ADCGD> x(xb.size());
+        for (size_t j = 0; j < xb.size(); j++)
+            x[j] = xb[j];
+        CppAD::Independent(x);
+
+        std::vector<ADCGD> y = model.evaluate(x);
+
+        std::unique_ptr<ADFun<CGD> > fun(new ADFun<CGD>());
+        fun->Dependent(y);
+
+        return fun.release();
+    }
+
+    inline void measureEvaluation(GenericModel<Base>& model,
+                                  const std::vector<Base>& x,
+                                  std::ostringstream& json) {
+        const size_t n = model.Domain();
+        const size_t m = model.Range();
+
+        std::vector<std::pair<std::string, std::function<void()> > > calls;
+
+        // zero order
+        std::vector<Base> y(m);
+        if (model.isForwardZeroAvailable()) {
+            calls.emplace_back("forward_zero", [&]() {
+                model.ForwardZero(x, y);
+            });
+        }
+
+        // first order forward (direction of the first independent)
+        std::vector<Base> tx1(2 * n), ty1(2 * m);
+        for (size_t j = 0; j < n; j++) tx1[j * 2] = x[j];
+        tx1[1] = 1.0;
+        if (model.isForwardOneAvailable()) {
+            calls.emplace_back("forward_one", [&]() {
+                model.ForwardOne(ArrayView<const Base>(tx1), ArrayView<Base>(ty1));
+            });
+        }
+
+        // first order reverse (sum of all dependents)
+        std::vector<Base> py1(m, 1.0), px1(n);
+        if (model.isReverseOneAvailable()) {
+            calls.emplace_back("reverse_one", [&]() {
+                model.ReverseOne(ArrayView<const Base>(x), ArrayView<const Base>(y),
+                                 ArrayView<Base>(px1), ArrayView<const Base>(py1));
+            });
+        }
+
+        // second order reverse
+        std::vector<Base> py2(2 * m), px2(2 * n);
+        for (size_t i = 0; i < m; i++) py2[i * 2 + 1] = 1.0;
+        if (model.isReverseTwoAvailable()) {
+            calls.emplace_back("reverse_two", [&]() {
+                model.ReverseTwo(ArrayView<const Base>(tx1), ArrayView<const Base>(ty1),
+                                 ArrayView<Base>(px2), ArrayView<const Base>(py2));
+            });
+        }
+
+        // sparse Jacobian
+        std::vector<Base> jac;
+        const size_t* jacRow;
+        const size_t* jacCol;
+        if (model.isSparseJacobianAvailable()) {
+            std::vector<size_t> rows, cols;
+            model.JacobianSparsity(rows, cols);
+            jac.resize(rows.size());
+            calls.emplace_back("sparse_jacobian", [&]() {
+                model.SparseJacobian(ArrayView<const Base>(x), ArrayView<Base>(jac), &jacRow, &jacCol);
+            });
+        }
+
+        // sparse Hessian
+        std::vector<Base> w(m, 1.0), hess;
+        const size_t* hessRow;
+        const size_t* hessCol;
+        if (model.isSparseHessianAvailable()) {
+            std::vector<size_t> rows, cols;
+            model.HessianSparsity(rows, cols);
+            hess.resize(rows.size());
+            calls.emplace_back("sparse_hessian", [&]() {
+                model.SparseHessian(ArrayView<const Base>(x), ArrayView<const Base>(w), ArrayView<Base>(hess), &hessRow, &hessCol);
+            });
+        }
+
+        for (size_t c = 0; c < calls.size(); c++) {
+            const std::function<void()>& call = calls[c].second;
+
+            for (size_t i = 0; i < nWarmUp_; i++)
+                call();
+
+            // latency of each call
+            std::vector<duration> dt(nTimes_);
+            for (size_t i = 0; i < nTimes_; i++) {
+                auto t0 = std::chrono::steady_clock::now();
+                call();
+                dt[i] = std::chrono::steady_clock::now() - t0;
+            }
+
+            // throughput of consecutive calls
+            auto t0 = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < nTimes_; i++)
+                call();
+            double batch = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+            printJsonStat(json, calls[c].first, dt, c + 1 == calls.size(), nTimes_ / batch);
+        }
+    }
+
+    /**
+     * Prints the statistics of a set of measurements (in seconds)
+     */
+    static inline void printJsonStat(std::ostream& out,
+                                     const std::string& name,
+                                     const std::vector<duration>& dtimes,
+                                     bool last,
+                                     double throughput = -1) {
+        std::vector<double> times(dtimes.size());
+        for (size_t i = 0; i < times.size(); i++)
+            times[i] = std::chrono::duration<double>(dtimes[i]).count();
+        std::sort(times.begin(), times.end());
+
+        double mean = 0;
+        for (double t : times) mean += t;
+        mean /= times.size();
+
+        double var = 0;
+        for (double t : times) var += (t - mean) * (t - mean);
+        var /= times.size();
+
+        OStreamConfigRestore osr(out);
+        out << std::setprecision(9);
+        out << "        \"" << name << "\": {"
+                "\"samples\": " << times.size() << ", "
+                "\"mean\": " << mean << ", "
+                "\"stddev\": " << std::sqrt(var) << ", "
+                "\"min\": " << times.front() << ", "
+                "\"p50\": " << percentile(times, 0.50) << ", "
+                "\"p90\": " << percentile(times, 0.90) << ", "
+                "\"p95\": " << percentile(times, 0.95) << ", "
+                "\"p99\": " << percentile(times, 0.99) << ", "
+                "\"max\": " << times.back();
+        if (throughput >= 0)
+            out << ", \"throughput\": " << throughput;
+        out << "}" << (last ? "" : ",") << "\n";
+    }
+
+    /**
+     * Percentile using linear interpolation between closest ranks
+     *
+     * @param sorted sorted values (must not be empty)
+     * @param p the percentile in [0, 1]
+     */
+    static inline double percentile(const std::vector<double>& sorted,
+                                    double p) {
+        double pos = p * (sorted.size() - 1);
+        size_t i = size_t(pos);
+        if (i + 1 >= sorted.size())
+            return sorted.back();
+        double f = pos - i;
+        return sorted[i] + f * (sorted[i + 1] - sorted[i]);
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,201 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include "model_speed_benchmark.hpp"
+#include "../patterns/plug_flow_collocation.hpp"
+#include "../../../../test/cppad/cg/models/cstr.hpp"
+#include "../../../../test/cppad/cg/models/distillation.hpp"
+#include "../../../../test/cppad/cg/models/tank_battery.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+typedef double Base;
+typedef CG<Base> CGD;
+typedef AD<CGD> ADCGD;
+
+namespace {
+
+const size_t nStages = 8; // distillation column stages
+const size_t nTanks = 6; // tank battery size
+
+std::vector<ADCGD> cstr(const std::vector<ADCGD>& x) {
+    return CstrFunc<CGD>(x);
+}
+
+std::vector<ADCGD> distillation(const std::vector<ADCGD>& x) {
+    return distillationFunc<CGD>(x);
+}
+
+std::vector<ADCGD> tankBattery(const std::vector<ADCGD>& x) {
+    return tankBatteryFunc<CGD>(x);
+}
+
+std::vector<Base> cstrValues() {
+    return std::vector<Base>{0.3, 7.82e3, 304.65, 301.15, 2.3333e-04, 6.6667e-05, 6.2e14, 10080, 2e3, 10e3,
+                             1e-11, 6.6667e-05, 294.15, 294.15, 1000, 4184, -33488, 299.15, 302.65, 7e5,
+                             1203, 3.22, 950.0, 0.48649427192323, 1000, 4184, 0.014, 1e-7};
+}
+
+std::vector<Base> distillationValues() {
+    std::vector<Base> x;
+    for (size_t i = 0; i < nStages; i++) x.push_back(12000 + 100 * i); // mWater
+    for (size_t i = 0; i < nStages; i++) x.push_back(12000 - 100 * i); // mEthanol
+    for (size_t i = 0; i < nStages; i++) x.push_back(360 + i * 2); // T
+    for (size_t i = 0; i < nStages; i++) x.push_back(0.3 + 0.05 * i); // yWater
+    for (size_t i = 0; i < nStages; i++) x.push_back(0.7 - 0.05 * i); // yEthanol
+    for (size_t i = 0; i < nStages - 1; i++) x.push_back(8); // V
+    x.push_back(150e3); // Qc
+    x.push_back(250e3); // Qsteam
+    x.push_back(0.1); // Fdistillate
+    x.push_back(2.5); // reflux
+    x.push_back(4); // Frectifier
+    x.push_back(30); // feed
+    x.push_back(1.01325e5); // P
+    x.push_back(0.7); // xFWater
+    x.push_back(366); // Tfeed
+    return x;
+}
+
+std::vector<std::set<size_t> > distillationRelated() {
+    std::vector<std::set<size_t> > related(6);
+    size_t j = 0;
+    for (size_t i = 0; i < nStages; i++, j++) related[0].insert(j); // mWater
+    for (size_t i = 0; i < nStages; i++, j++) related[1].insert(j); // mEthanol
+    for (size_t i = 0; i < nStages; i++, j++) related[4].insert(j); // T
+    for (size_t i = 0; i < nStages; i++, j++) related[2].insert(j); // yWater
+    for (size_t i = 0; i < nStages; i++, j++) related[3].insert(j); // yEthanol
+    for (size_t i = 0; i < nStages - 1; i++, j++) related[5].insert(j); // V
+    return related;
+}
+
+class PlugFlowBenchModel : public ModelSpeedBenchmark::Model {
+private:
+    size_t nEls_;
+public:
+
+    inline PlugFlowBenchModel(size_t nEls) :
+        nEls_(nEls) {
+    }
+
+    virtual std::vector<ADCGD> evaluate(const std::vector<ADCGD>& x) override {
+        PlugFlowModel<CGD> m;
+        return m.model2(x, nEls_);
+    }
+};
+
+class CollocationBenchModel : public ModelSpeedBenchmark::Model {
+private:
+    size_t repeat_;
+    PlugFlowCollocationModel<CGD> model_;
+public:
+
+    inline CollocationBenchModel(size_t nEls,
+                                 size_t repeat) :
+        repeat_(repeat),
+        model_(nEls) {
+        model_.setTypicalAtomModelValues(PlugFlowModel<CGD>::getTypicalValues(nEls));
+        model_.createAtomicLib();
+    }
+
+    inline std::vector<Base> getTypicalValues() {
+        return model_.getTypicalValues(repeat_);
+    }
+
+    virtual std::vector<ADCGD> evaluate(const std::vector<ADCGD>& x) override {
+        return model_.evaluateModel(x, repeat_);
+    }
+
+    virtual std::vector<GenericModel<Base>*> getExternalModels() override {
+        return std::vector<GenericModel<Base>*>{model_.getGenericModel()};
+    }
+};
+
+size_t parseArgument(int pos, int argc, char **argv, size_t defaultValue) {
+    if (argc > pos) {
+        std::istringstream is(argv[pos]);
+        size_t v;
+        is >> v;
+        return v;
+    }
+    return defaultValue;
+}
+
+}
+
+/**
+ * Usage: speed_models [output.json] [executions] [plug flow elements] [collocation intervals]
+ */
+int main(int argc, char **argv) {
+    std::string outFile = argc > 1 ? argv[1] : "speed_models.json";
+    size_t nExec = parseArgument(2, argc, argv, 1000);
+    size_t nEls = parseArgument(3, argc, argv, 10);
+    size_t nTimeInt = parseArgument(4, argc, argv, 5);
+
+    ModelSpeedBenchmark bench;
+    bench.setNumberOfExecutions(nExec);
+    bench.setCompileFlags({"-O2"});
+
+    ModelSpeedBenchmark::FunctionModel cstrModel(cstr);
+    bench.measure("cstr", cstrModel, cstrValues());
+
+    ModelSpeedBenchmark::FunctionModel distModel(distillation);
+    bench.measure("distillation", distModel, distillationValues());
+    bench.measure("distillationLoops", distModel, distillationValues(), distillationRelated());
+
+    std::vector<Base> xTank(nTanks + 2);
+    for (size_t j = 0; j < xTank.size(); j++)
+        xTank[j] = 0.5 * (j + 1);
+    std::vector<std::set<size_t> > tankRelated(1);
+    for (size_t i = 0; i < nTanks; i++)
+        tankRelated[0].insert(i);
+
+    ModelSpeedBenchmark::FunctionModel tankModel(tankBattery);
+    bench.measure("tankBattery", tankModel, xTank);
+    bench.measure("tankBatteryLoops", tankModel, xTank, tankRelated);
+
+    PlugFlowBenchModel plugFlowModel(nEls);
+    std::vector<Base> xPlugFlow = PlugFlowModel<Base>::getTypicalValues(nEls);
+    bench.measure("plugflow", plugFlowModel, xPlugFlow);
+    bench.measure("plugflowLoops", plugFlowModel, xPlugFlow, PlugFlowModel<Base>::getRelatedCandidates(nEls));
+
+    bench.setConstantPool(true);
+    bench.measure("distillationConstantPool", distModel, distillationValues());
+    bench.measure("plugflowConstantPool", plugFlowModel, xPlugFlow);
+    bench.setConstantPool(false);
+
+    CollocationBenchModel collocationModel(nEls, nTimeInt);
+    size_t m = 3 * PlugFlowModel<Base>::N_EL_STATES * nEls; // equations per time interval
+    std::vector<std::set<size_t> > collocationRelated(m);
+    for (size_t i = 0; i < nTimeInt; i++) {
+        for (size_t ii = 0; ii < m; ii++) {
+            collocationRelated[ii].insert(i * m + ii);
+        }
+    }
+    bench.measure("collocationLoops", collocationModel, collocationModel.getTypicalValues(), collocationRelated);
+
+    bench.setVectorizeLoops(true);
+    bench.setCompileFlags({"-O2", "-fopenmp-simd"});
+    bench.measure("plugflowLoopsSimd", plugFlowModel, xPlugFlow, PlugFlowModel<Base>::getRelatedCandidates(nEls));
+    bench.measure("collocationLoopsSimd", collocationModel, collocationModel.getTypicalValues(), collocationRelated);
+
+    bench.setPackLoopArrays(true);
+    bench.measure("plugflowLoopsSimdSoA", plugFlowModel, xPlugFlow, PlugFlowModel<Base>::getRelatedCandidates(nEls));
+    bench.measure("collocationLoopsSimdSoA", collocationModel, collocationModel.getTypicalValues(), collocationRelated);
+
+    std::ofstream out(outFile);
+    bench.printJson(out);
+    bench.printJson(std::cout);
+}
@@ -0,0 +1,63 @@
+#ifndef CPPAD_CG_PLUG_FLOW_COLLOCATION_INCLUDED
+#define CPPAD_CG_PLUG_FLOW_COLLOCATION_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2013 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include <cppad/cg/cppadcg.hpp>
+#include "../../../../test/cppad/cg/models/collocation.hpp"
+#include "../../../../test/cppad/cg/models/plug_flow.hpp"
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Collocation model using the Plugflow model
+ */
+template<class T>
+class PlugFlowCollocationModel : public CollocationModel<T> {
+protected:
+    size_t nEls_; // number of plugflow discretization elements
+public:
+
+    PlugFlowCollocationModel(size_t nEls) :
+        CollocationModel<T>(PlugFlowModel<AD<double>>::N_EL_STATES * nEls, // ns
+                            PlugFlowModel<AD<double>>::N_CONTROLS, // nm
+                            PlugFlowModel<AD<double>>::N_PAR), // npar
+        nEls_(nEls) {
+    }
+
+protected:
+
+    virtual void atomicFunction(const std::vector<AD<CG<double> > >& x,
+                                std::vector<AD<CG<double> > >& y) override {
+        PlugFlowModel<CG<double> > m;
+        y = m.model2(x, nEls_);
+    }
+
+    virtual void atomicFunction(const std::vector<AD<double> >& x,
+                                std::vector<AD<double> >& y) override {
+        PlugFlowModel<double> m;
+        y = m.model2(x, nEls_);
+    }
+
+    virtual std::string getAtomicLibName() override {
+        return "plugflow";
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -14,8 +14,7 @@
  */
 
 #include "pattern_speed_test.hpp"
-#include "../../../../test/cppad/cg/models/collocation.hpp"
-#include "../../../../test/cppad/cg/models/plug_flow.hpp"
+#include "plug_flow_collocation.hpp"
 
 namespace CppAD {
 namespace cg {
@@ -25,41 +24,6 @@ typedef CppAD::cg::CG<Base> CGD;
 
 using namespace std;
 
-/**
- * Collocation model using the Plugflow model
- */
-template<class T>
-class PlugFlowCollocationModel : public CollocationModel<T> {
-protected:
-    size_t nEls_; // number of plugflow discretization elements
-public:
-
-    PlugFlowCollocationModel(size_t nEls) :
-        CollocationModel<T>(PlugFlowModel<AD<double>>::N_EL_STATES * nEls, // ns
-                            PlugFlowModel<AD<double>>::N_CONTROLS, // nm
-                            PlugFlowModel<AD<double>>::N_PAR), // npar
-        nEls_(nEls) {
-    }
-
-protected:
-
-    virtual void atomicFunction(const std::vector<AD<CG<double> > >& x,
-                                std::vector<AD<CG<double> > >& y) override {
-        PlugFlowModel<CG<double> > m;
-        y = m.model2(x, nEls_);
-    }
-
-    virtual void atomicFunction(const std::vector<AD<double> >& x,
-                                std::vector<AD<double> >& y) override {
-        PlugFlowModel<double> m;
-        y = m.model2(x, nEls_);
-    }
-
-    virtual std::string getAtomicLibName() override {
-        return "plugflow";
-    }
-};
-
 /**
  * Speed test for the collocation model
  */
@@ -0,0 +1,218 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+/**
+ * Measures the time required by the thread pool used in the generated
+ * sources to dispatch jobs and wait for them (per call) for several wait
+ * policies and scheduling strategies.
+ * The results are saved in JSON.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cppad/cg/model/threadpool/pthread_pool.h>
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+/**
+ * Job argument: the amount of work to perform (in nanoseconds)
+ */
+struct JobArg {
+    long long work;
+    volatile unsigned long counter;
+};
+
+void job(void* arg) {
+    JobArg* a = static_cast<JobArg*> (arg);
+    a->counter++;
+    if (a->work > 0) {
+        clock_type::time_point end = clock_type::now() + std::chrono::nanoseconds(a->work);
+        while (clock_type::now() < end) {
+            a->counter++;
+        }
+    }
+}
+
+double percentile(const std::vector<double>& sorted,
+                  double p) {
+    size_t i = size_t(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+void printJsonStat(std::ostream& out,
+                   const std::string& name,
+                   std::vector<double> times,
+                   bool last) {
+    std::sort(times.begin(), times.end());
+    double mean = 0;
+    for (double t : times)
+        mean += t;
+    mean /= times.size();
+
+    out << "        \"" << name << "\": {"
+            "\"mean\": " << mean << ", "
+            "\"min\": " << times.front() << ", "
+            "\"p50\": " << percentile(times, 0.50) << ", "
+            "\"p90\": " << percentile(times, 0.90) << ", "
+            "\"p99\": " << percentile(times, 0.99) << ", "
+            "\"max\": " << times.back() << "}" << (last ? "\n" : ",\n");
+}
+
+const char* strategyName(ScheduleStrategy s) {
+    switch (s) {
+        case SCHED_STATIC:
+            return "static";
+        case SCHED_DYNAMIC:
+            return "dynamic";
+        default:
+            return "guided";
+    }
+}
+
+/**
+ * Evaluates a set of jobs with the thread pool several times.
+ *
+ * @return the time of each call (in microseconds)
+ */
+std::vector<double> measure(std::vector<JobArg>& args,
+                            size_t nCalls,
+                            bool pool) {
+    int nJobs = int(args.size());
+    std::vector<cppadcg_thpool_function_type> functions(nJobs, job);
+    std::vector<void*> argsPtr(nJobs);
+    std::vector<float> refElapsed(nJobs);
+    std::vector<int> order(nJobs);
+    std::vector<int> job2Thread(nJobs, -1);
+    for (int j = 0; j < nJobs; ++j) {
+        argsPtr[j] = &args[j];
+        refElapsed[j] = args[j].work * 1e-9f;
+        order[j] = j;
+    }
+
+    std::vector<double> times(nCalls);
+    for (size_t c = 0; c < nCalls + 10; ++c) { // 10 warm up calls
+        clock_type::time_point start = clock_type::now();
+
+        if (pool) {
+            cppadcg_thpool_add_jobs(functions.data(), argsPtr.data(), refElapsed.data(), nullptr,
+                                    order.data(), job2Thread.data(), nJobs, c == 0);
+            cppadcg_thpool_wait();
+        } else {
+            for (int j = 0; j < nJobs; ++j)
+                job(argsPtr[j]);
+        }
+
+        clock_type::time_point end = clock_type::now();
+        if (c >= 10)
+            times[c - 10] = std::chrono::duration<double, std::micro>(end - start).count();
+    }
+
+    return times;
+}
+
+size_t parseArgument(int i,
+                     int argc,
+                     char** argv,
+                     size_t defaultValue) {
+    if (argc > i) {
+        return std::strtoul(argv[i], nullptr, 10);
+    }
+    return defaultValue;
+}
+
+}
+
+/**
+ * Usage: speed_thread_pool [output.json] [calls] [threads]
+ */
+int main(int argc, char **argv) {
+    std::string outFile = argc > 1 ? argv[1] : "speed_thread_pool.json";
+    size_t nCalls = std::max<size_t>(1, parseArgument(2, argc, argv, 2000));
+    int nThreads = int(std::max<size_t>(1, parseArgument(3, argc, argv, 4)));
+    int nJobs = 4 * nThreads;
+
+    const std::vector<float> spinTimes{0, 20e-6f, 200e-6f}; // seconds
+    const std::vector<long long> totalWork{0, 50000}; // nanoseconds for all jobs
+    const std::vector<ScheduleStrategy> strategies{SCHED_STATIC, SCHED_DYNAMIC, SCHED_GUIDED};
+
+    cppadcg_thpool_set_threads(nThreads);
+    cppadcg_thpool_set_n_time_meas(0);
+
+    std::vector<std::string> results;
+
+    for (long long work : totalWork) {
+        std::vector<JobArg> args(nJobs);
+        for (JobArg& a : args) {
+            a.work = work / nJobs;
+            a.counter = 0;
+        }
+
+        std::vector<double> serial = measure(args, nCalls, false);
+
+        for (ScheduleStrategy strategy : strategies) {
+            for (float spin : spinTimes) {
+                for (int caller = 0; caller < 2; ++caller) {
+                    cppadcg_thpool_set_scheduler_strategy(strategy);
+                    cppadcg_thpool_set_spin_time(spin);
+                    cppadcg_thpool_set_caller_executes(caller);
+
+                    std::vector<double> times = measure(args, nCalls, true);
+
+                    std::ostringstream json;
+                    json << "    {\n"
+                            "      \"work_us\": " << work * 1e-3 << ",\n"
+                            "      \"jobs\": " << nJobs << ",\n"
+                            "      \"strategy\": \"" << strategyName(strategy) << "\",\n"
+                            "      \"spin_time_us\": " << spin * 1e6 << ",\n"
+                            "      \"caller_executes\": " << (caller ? "true" : "false") << ",\n"
+                            "      \"times_us\": {\n";
+                    printJsonStat(json, "serial", serial, false);
+                    printJsonStat(json, "call", times, true);
+                    json << "      }\n"
+                            "    }";
+                    results.push_back(json.str());
+
+                    std::sort(times.begin(), times.end());
+                    std::cout << "work " << work * 1e-3 << " us, " << strategyName(strategy)
+                              << ", spin " << spin * 1e6 << " us, caller executes " << caller
+                              << ": p50 " << percentile(times, 0.5) << " us per call" << std::endl;
+                }
+            }
+        }
+    }
+
+    cppadcg_thpool_shutdown();
+
+    std::ofstream out(outFile.c_str());
+    out << "{\n"
+            "  \"threads\": " << nThreads << ",\n"
+            "  \"calls\": " << nCalls << ",\n"
+            "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        out << results[i] << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n"
+            "}\n";
+
+    return 0;
+}
@@ -37,6 +37,13 @@ protected:
     bool forwardOne = true;
     bool reverseOne = true;
     bool reverseTwo = true;
+    bool directModelCalls = false;
+    /**
+     * the generated sources of the outer model and of the library
+     * (model bridge tests)
+     */
+    std::map<std::string, std::string> _outerModelSources;
+    std::map<std::string, std::string> _librarySources;
 public:
 
     inline CppADCGDynamicAtomicNestedTest(const std::string& modelName,
@@ -629,10 +636,14 @@ private:
         /**
          * generate source code
          */
-        ModelLibraryCSourceGen<double> compDynHelp(compHelp1, compHelp2);
+        ModelLibraryCSourceGenSources compDynHelp(compHelp1, compHelp2);
+        compDynHelp.setDirectModelCalls(directModelCalls);
         std::string folder = std::string("nested_sources_atomiclibmodelbridge_") + (createOuterReverse2 ? "rev2_" : "dir_") + _modelName;
         SaveFilesModelLibraryProcessor<double>::saveLibrarySourcesTo(compDynHelp, folder);
 
+        _outerModelSources = compDynHelp.getModelSources(compHelp2);
+        _librarySources = compDynHelp.getLibrarySources();
+
         /**
          * Create the dynamic library
          * (compile source code)
@@ -650,6 +661,19 @@ private:
         tapeOuterModel(xOuter, xInner, xInnerNorm, eqInnerNorm);
     }
 
+    /**
+     * Provides access to the generated model sources
+     */
+    class ModelLibraryCSourceGenSources : public ModelLibraryCSourceGen<double> {
+    public:
+        template<class... Ms>
+        inline ModelLibraryCSourceGenSources(ModelCSourceGen<double>& headModel, Ms&... rest) :
+            ModelLibraryCSourceGen<double>(headModel, rest...) {
+        }
+
+        using ModelLibraryCSourceGen<double>::getModelSources;
+    };
+
     struct InnerModelStruct {
         CppADCGDynamicAtomicNestedTest& tester;
         const CppAD::vector<Base>& xNorm;
@@ -173,6 +173,31 @@ public:
             ASSERT_TRUE(compareValues<double>(y_pOuter, y_pOrig, epsilonR, epsilonA));
         }
 
+        /**
+         * Test first order forward mode with compressed results
+         */
+        ASSERT_TRUE(modelLib->isSparseForwardOneAvailable());
+        std::vector<size_t> start, elements;
+        modelLib->ForwardOneSparsity(start, elements);
+        ASSERT_EQ(start.size(), n + 1);
+
+        ArrayView<const double> xView(&x[0], n);
+        for (size_t j = 0; j < n; j++) {
+            const size_t idx[1] = {j};
+            const double tx1[1] = {1.0};
+
+            std::vector<double> y_pDense(m);
+            modelLib->ForwardOne(xView, 1, idx, tx1, ArrayView<double>(y_pDense.data(), m));
+
+            std::vector<size_t> y_pIdx(elements.begin() + start[j], elements.begin() + start[j + 1]);
+            std::vector<double> y_pCompressed(y_pIdx.size());
+            modelLib->ForwardOne(xView, 1, idx, tx1, y_pIdx.size(), y_pIdx.data(), y_pCompressed.data());
+
+            for (size_t e = 0; e < y_pIdx.size(); e++) {
+                ASSERT_TRUE(nearEqual(y_pCompressed[e], y_pDense[y_pIdx[e]]));
+            }
+        }
+
         /**
          * Test first order reverse mode
          */
@@ -205,6 +230,29 @@ public:
             ASSERT_TRUE(compareValues<double>(dwOuter, dwOrig, epsilonR, epsilonA));
         }
 
+        /**
+         * Test first order reverse mode with compressed results
+         */
+        ASSERT_TRUE(modelLib->isSparseReverseOneAvailable());
+        modelLib->ReverseOneSparsity(start, elements);
+        ASSERT_EQ(start.size(), m + 1);
+
+        for (size_t i = 0; i < m; i++) {
+            const size_t idx[1] = {i};
+            const double py1[1] = {1.0};
+
+            std::vector<double> dwDense(n);
+            modelLib->ReverseOne(xView, ArrayView<double>(dwDense.data(), n), 1, idx, py1);
+
+            std::vector<size_t> dwIdx(elements.begin() + start[i], elements.begin() + start[i + 1]);
+            std::vector<double> dwCompressed(dwIdx.size());
+            modelLib->ReverseOne(xView, dwIdx.size(), dwIdx.data(), dwCompressed.data(), 1, idx, py1);
+
+            for (size_t e = 0; e < dwIdx.size(); e++) {
+                ASSERT_TRUE(nearEqual(dwCompressed[e], dwDense[dwIdx[e]]));
+            }
+        }
+
         /**
          * Test second order reverse mode
          */
@@ -253,6 +301,47 @@ public:
             }
         }
 
+        /**
+         * Test second order reverse mode with compressed results
+         */
+        ASSERT_TRUE(modelLib->isSparseReverseTwoAvailable());
+        modelLib->ReverseTwoSparsity(start, elements);
+        ASSERT_EQ(start.size(), n + 1);
+
+        std::vector<double> py2(m);
+        for (size_t i = 0; i < m; i++)
+            py2[i] = 1.0 + 0.5 * i;
+        ArrayView<const double> py2View(py2.data(), m);
+
+        for (size_t j = 0; j < n; j++) {
+            // one and two directions (the patterns of both are merged)
+            const size_t idx[2] = {j, (j + 1) % n};
+            const double tx1[2] = {1.0, -0.5};
+
+            for (size_t nnz = 1; nnz <= std::min<size_t>(2, n); nnz++) {
+                std::vector<double> px2Dense(n);
+                modelLib->ReverseTwo(xView, nnz, idx, tx1, ArrayView<double>(px2Dense.data(), n), py2View);
+
+                std::set<size_t> px2Elements;
+                for (size_t e = 0; e < nnz; e++)
+                    px2Elements.insert(elements.begin() + start[idx[e]], elements.begin() + start[idx[e] + 1]);
+                std::vector<size_t> px2Idx(px2Elements.begin(), px2Elements.end());
+
+                std::vector<double> px2Compressed(px2Idx.size());
+                modelLib->ReverseTwo(xView, nnz, idx, tx1, px2Idx.size(), px2Idx.data(), px2Compressed.data(), py2View);
+
+                for (size_t e = 0; e < px2Idx.size(); e++) {
+                    ASSERT_TRUE(nearEqual(px2Compressed[e], px2Dense[px2Idx[e]]));
+                }
+
+                // the remaining elements are structural zeros
+                for (size_t jj = 0; jj < n; jj++) {
+                    if (px2Elements.find(jj) == px2Elements.end())
+                        ASSERT_EQ(px2Dense[jj], 0.0);
+                }
+            }
+        }
+
         /**
          * Jacobian
          */
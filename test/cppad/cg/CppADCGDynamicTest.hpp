@@ -38,6 +38,9 @@ protected:
     MultiThreadingType _multithread;
     bool _multithreadDisabled;
     ThreadPoolScheduleStrategy _multithreadScheduler;
+    ThreadPoolAffinity _multithreadAffinity;
+    size_t _multithreadJobs;
+    bool _sharedHeader;
 public:
 
     inline CppADCGDynamicTest(const std::string& testName,
@@ -52,7 +55,10 @@ public:
         _reverseTwo(true),
         _multithread(MultiThreadingType::NONE),
         _multithreadDisabled(false),
-        _multithreadScheduler(ThreadPoolScheduleStrategy::DYNAMIC) {
+        _multithreadScheduler(ThreadPoolScheduleStrategy::DYNAMIC),
+        _multithreadAffinity(ThreadPoolAffinity::NONE),
+        _multithreadJobs(0),
+        _sharedHeader(false) {
     }
 
     virtual std::vector<ADCGD> model(const std::vector<ADCGD>& ind) = 0;
@@ -118,9 +124,11 @@ public:
         compHelp.setCreateReverseTwo(_reverseTwo);
         compHelp.setMaxAssignmentsPerFunc(maxAssignPerFunc);
         compHelp.setMultiThreading(true);
+        compHelp.setMultiThreadingJobCount(_multithreadJobs);
 
         ModelLibraryCSourceGen<double> compDynHelp(compHelp);
         compDynHelp.setMultiThreading(_multithread);
+        compDynHelp.setSharedHeader(_sharedHeader);
 
         SaveFilesModelLibraryProcessor<double>::saveLibrarySourcesTo(compDynHelp, "sources_" + _name + "_1");
 
@@ -147,6 +155,7 @@ public:
         dynamicLib->setThreadPoolDisabled(_multithreadDisabled);
         dynamicLib->setThreadPoolSchedulerStrategy(_multithreadScheduler);
         dynamicLib->setThreadPoolGuidedMaxWork(0.75);
+        dynamicLib->setThreadPoolAffinity(_multithreadAffinity);
 
         /**
          * test the library
@@ -191,9 +200,11 @@ public:
         compHelp.setCustomSparseHessianElements(hessRow, hessCol);
 
         compHelp.setMultiThreading(true);
+        compHelp.setMultiThreadingJobCount(_multithreadJobs);
 
         ModelLibraryCSourceGen<double> compDynHelp(compHelp);
         compDynHelp.setMultiThreading(_multithread);
+        compDynHelp.setSharedHeader(_sharedHeader);
 
         SaveFilesModelLibraryProcessor<double>::saveLibrarySourcesTo(compDynHelp, "sources_" + _name + "_2");
 
@@ -220,6 +231,7 @@ public:
         dynamicLib->setThreadPoolDisabled(_multithreadDisabled);
         dynamicLib->setThreadPoolSchedulerStrategy(_multithreadScheduler);
         dynamicLib->setThreadPoolGuidedMaxWork(0.75);
+        dynamicLib->setThreadPoolAffinity(_multithreadAffinity);
 
         /**
          * test the library
@@ -0,0 +1,100 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+std::vector<double> createValues() {
+    std::vector<double> values{0.0, -0.0, 1.0, -1.0, 0.1, 0.25, 1e-4, 9.9999e-5, 304.65, -33488,
+                               6.2e14, 1e15, 1e20, 1.0 / 3.0, 2.0 / 3.0, 0.1 + 0.2, 1e-11, 123456789012345.0,
+                               std::numeric_limits<double>::min(), std::numeric_limits<double>::max()};
+    for (size_t i = 1; i < 2000; i++) {
+        double v = std::ldexp(double(i * 7919 % 100003), int(i % 80) - 40) / 997.0;
+        values.push_back(v);
+        values.push_back(-std::round(v * 1000) / 1000);
+    }
+    return values;
+}
+
+}
+
+TEST(CppADCGCodeWriterTest, FloatingPointSameAsStream) {
+    char buf[64];
+
+    for (double v : createValues()) {
+        for (size_t p : {1, 6, 10, 15}) {
+            std::ostringstream os;
+            os << std::setprecision(p) << v;
+            size_t n = printShortestFloatingPoint(v, p, buf, sizeof(buf));
+            ASSERT_EQ(os.str(), std::string(buf, n));
+        }
+
+        float f = float(v);
+        std::ostringstream os;
+        os << std::setprecision(6) << f;
+        size_t n = printShortestFloatingPoint(f, 6, buf, sizeof(buf));
+        ASSERT_EQ(os.str(), std::string(buf, n));
+    }
+}
+
+TEST(CppADCGCodeWriterTest, FloatingPointRoundTrip) {
+    char buf[64];
+
+    size_t p = std::numeric_limits<double>::max_digits10;
+    for (double v : createValues()) {
+        size_t n = printShortestFloatingPoint(v, p, buf, sizeof(buf));
+        ASSERT_EQ(std::strtod(buf, nullptr), v);
+
+        // no shorter representation exists
+        std::ostringstream os;
+        os << std::setprecision(p) << v;
+        ASSERT_LE(n, os.str().size());
+    }
+
+    size_t n = printShortestFloatingPoint(0.1, p, buf, sizeof(buf));
+    ASSERT_EQ(std::string(buf, n), "0.1");
+}
+
+TEST(CppADCGCodeWriterTest, Writer) {
+    LangCCodeWriter code;
+    std::ostringstream ref;
+
+    // several blocks
+    for (size_t i = 0; i < 20000; i++) {
+        code << "   v[" << i << "] = x[" << 2 * i << "] * y;\n";
+        ref << "   v[" << i << "] = x[" << 2 * i << "] * y;\n";
+    }
+    ASSERT_EQ(code.size(), ref.str().size());
+    ASSERT_EQ(code.str(), ref.str());
+
+    std::ostringstream out;
+    code.writeTo(out);
+    ASSERT_EQ(out.str(), ref.str());
+
+    code.str("");
+    ASSERT_EQ(code.size(), 0u);
+    code << "y[0] = " << 1 << ";";
+    ASSERT_EQ(code.str(), "y[0] = 1;");
+}
+
+TEST(CppADCGCodeWriterTest, ArrayNameTable) {
+    LangCArrayNameTable names("&array[", "]");
+    ASSERT_EQ(names[0], "&array[0]");
+    ASSERT_EQ(names[105], "&array[105]");
+    ASSERT_EQ(&names[105], &names[105]);
+}
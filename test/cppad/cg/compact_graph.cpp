@@ -0,0 +1,143 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+typedef CG<double> CGD;
+
+std::string generateSource(CodeHandler<double>& handler,
+                           std::vector<CGD>& y) {
+    LanguageC<double> langC("double");
+    LangCDefaultVariableNameGenerator<double> nameGen;
+    std::ostringstream code;
+    handler.generateCode(code, langC, y, nameGen);
+    return code.str();
+}
+
+}
+
+TEST(CppADCGCompactGraphTest, RoundTrip) {
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(3);
+    handler.makeVariables(x);
+
+    CGD shared = x[0] * x[1];
+
+    std::vector<CGD> y(5);
+    y[0] = shared + 2.0;
+    y[1] = sin(x[2]) * 2.0 - x[0];
+    y[2] = exp(shared) / x[2];
+    y[3] = 3.0;
+    y[4] = x[1];
+
+    CompactGraph<double> graph(x, y);
+
+    ASSERT_EQ(graph.getIndependentCount(), 3u);
+    ASSERT_EQ(graph.getNodeCount(), 9u); // 3 independents, mul, add, sin, mul, sub, exp, div
+    ASSERT_EQ(graph.getConstants().size(), 2u); // 2.0 is only stored once
+
+    // topological order
+    for (uint32_t id = 0; id < graph.getNodeCount(); id++) {
+        for (uint32_t a : graph.getArguments(id)) {
+            if (!graph.isParameter(a))
+                ASSERT_LT(a, id);
+        }
+    }
+
+    const std::vector<uint32_t>& dep = graph.getDependents();
+    ASSERT_TRUE(graph.isParameter(dep[3]));
+    ASSERT_EQ(graph.getParameter(dep[3]), 3.0);
+    ASSERT_EQ(dep[4], 1u);
+
+    // the same source code is generated from the rebuilt graph
+    CodeHandler<double> handler2;
+    std::vector<CGD> x2;
+    std::vector<CGD> y2 = graph.rebuild(handler2, x2);
+
+    ASSERT_EQ(x2.size(), x.size());
+    ASSERT_EQ(y2.size(), y.size());
+    ASSERT_EQ(generateSource(handler2, y2), generateSource(handler, y));
+}
+
+TEST(CppADCGCompactGraphTest, MissingIndependent) {
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(1);
+    y[0] = x[0] * x[1];
+
+    std::vector<CGD> indep(1, x[0]);
+
+    CompactGraph<double> graph;
+    ASSERT_THROW(graph.build(indep, y), CGException);
+}
+
+TEST(CppADCGCompactGraphTest, Print) {
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+
+    CGD sum = x[0] + x[1];
+    std::vector<CGD> y(1);
+    y[0] = CGD(*handler.makePrintNode("sum = ", Argument<double>(*sum.getOperationNode()), "\n"));
+
+    CompactGraph<double> graph(x, y);
+    ASSERT_EQ(graph.getNodeCount(), 4u);
+
+    uint32_t print = graph.getDependents()[0];
+    ASSERT_EQ(graph.getOperationType(print), CGOpCode::Pri);
+    ArrayView<const uint32_t> info = graph.getInfo(print);
+    ASSERT_EQ(info.size(), 2u);
+    ASSERT_EQ(graph.getString(info[0]), "sum = ");
+    ASSERT_EQ(graph.getString(info[1]), "\n");
+
+    CodeHandler<double> handler2;
+    std::vector<CGD> x2;
+    std::vector<CGD> y2 = graph.rebuild(handler2, x2);
+    const OperationNode<double>* node2 = y2[0].getOperationNode();
+    ASSERT_TRUE(node2 != nullptr);
+    ASSERT_EQ(node2->getOperationType(), CGOpCode::Pri);
+    const auto* print2 = static_cast<const PrintOperationNode<double>*> (node2);
+    ASSERT_EQ(print2->getBeforeString(), "sum = ");
+    ASSERT_EQ(print2->getAfterString(), "\n");
+    ASSERT_EQ(node2->getArguments()[0].getOperation()->getOperationType(), CGOpCode::Add);
+}
+
+TEST(CppADCGCompactGraphTest, Memory) {
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(1);
+    y[0] = x[0];
+    for (size_t i = 0; i < 1000; i++)
+        y[0] = y[0] * x[1] + double(i % 10 + 1);
+
+    CompactGraph<double> graph(x, y);
+    graph.shrinkToFit();
+
+    ASSERT_EQ(graph.getNodeCount(), 2002u);
+    ASSERT_EQ(graph.getConstants().size(), 10u);
+    ASSERT_LT(graph.getMemoryUsage(), graph.getNodeCount() * 24);
+}
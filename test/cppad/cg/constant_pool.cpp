@@ -0,0 +1,199 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+typedef CG<double> CGD;
+typedef AD<CGD> ADCG;
+
+std::string generateFunction(const std::string& name,
+                             LangCConstantPool<double>& pool,
+                             double c1,
+                             double c2) {
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(3);
+    y[0] = x[0] * c1 + x[1] * c1;
+    y[1] = x[0] * 0.5 + x[1] * 0.5;
+    y[2] = x[0] * c2 + x[1] * c2 + x[0] * 9.87654321;
+
+    LanguageC<double> langC("double");
+    langC.setConstantPool(&pool);
+    langC.setGenerateFunction(name);
+    LangCDefaultVariableNameGenerator<double> nameGen;
+
+    std::ostringstream code;
+    handler.generateCode(code, langC, y, nameGen);
+    return code.str();
+}
+
+/**
+ * Provides access to the generated sources
+ */
+class ModelCSourceGenPool : public ModelCSourceGen<double> {
+public:
+
+    inline ModelCSourceGenPool(ADFun<CGD>& fun,
+                               size_t nThreads) :
+        ModelCSourceGen<double>(fun, "model") {
+        setCreateForwardZero(true);
+        setCreateReverseTwo(true);
+        setConstantPool(true);
+        setSourceGenerationThreads(nThreads);
+    }
+
+    inline std::map<std::string, std::string> sources() {
+        return getSources(MultiThreadingType::NONE, nullptr);
+    }
+};
+
+std::unique_ptr<ADFun<CGD> > createModel(size_t n) {
+    std::vector<ADCG> x(n);
+    for (size_t j = 0; j < n; j++)
+        x[j] = 0.5 + j;
+    CppAD::Independent(x);
+
+    std::vector<ADCG> y(n - 1);
+    for (size_t i = 0; i < n - 1; i++) {
+        // a different constant for each equation (used several times)
+        double c = 1.2345678 + 0.1111111 * i;
+        y[i] = c * x[i] * x[i + 1] * x[i + 1] + c * sin(x[i]) * x[(i + 3) % n] + 3.4567891 * x[i] * x[i];
+    }
+
+    return std::unique_ptr<ADFun<CGD> >(new ADFun<CGD>(x, y));
+}
+
+}
+
+TEST(CppADCGConstantPoolTest, SharedTable) {
+    // 1.2345678 is only used twice in each function
+    LangCConstantPool<double> pool("model_constants", 3);
+
+    std::string f1 = generateFunction("f1", pool, 1.2345678, 2.3456789);
+    std::string f2 = generateFunction("f2", pool, 1.2345678, 3.4567891);
+
+    // the uses in all the functions are counted
+    ASSERT_EQ(pool.getUses(1.2345678), 4u);
+    ASSERT_EQ(pool.getUses(9.87654321), 2u);
+    ASSERT_EQ(pool.getUses(0.5), 0u); // short literal
+
+    pool.createTable();
+    pool.resolveReferences(f1);
+    pool.resolveReferences(f2);
+
+    // values used several times are only defined once
+    ASSERT_EQ(pool.size(), 1u);
+    ASSERT_EQ(pool.getValues()[0], 1.2345678);
+
+    for (const std::string* f : {&f1, &f2}) {
+        ASSERT_NE(f->find("extern const double model_constants[];"), std::string::npos);
+        ASSERT_NE(f->find("model_constants[0]"), std::string::npos);
+        ASSERT_EQ(f->find("model_constants[1]"), std::string::npos);
+        ASSERT_EQ(f->find("1.2345678"), std::string::npos);
+        ASSERT_NE(f->find("0.5"), std::string::npos); // short literal
+        ASSERT_NE(f->find("9.87654321"), std::string::npos); // not used enough times
+    }
+
+    LanguageC<double> langC("double");
+    std::ostringstream table;
+    langC.printConstantPool(table, pool);
+    ASSERT_EQ(table.str().find("const double model_constants[1] = {"), 0u);
+    ASSERT_NE(table.str().find("1.2345678\n"), std::string::npos);
+}
+
+TEST(CppADCGConstantPoolTest, TableOrder) {
+    // the table does not depend on the order in which the functions are generated
+    LangCConstantPool<double> pool1("model_constants");
+    std::string f1 = generateFunction("f1", pool1, 1.2345678, 2.3456789);
+    std::string f2 = generateFunction("f2", pool1, 3.4567891, 1.2345678);
+    pool1.createTable();
+    pool1.resolveReferences(f1);
+    pool1.resolveReferences(f2);
+
+    LangCConstantPool<double> pool2("model_constants");
+    std::string f2b = generateFunction("f2", pool2, 3.4567891, 1.2345678);
+    std::string f1b = generateFunction("f1", pool2, 1.2345678, 2.3456789);
+    pool2.createTable();
+    pool2.resolveReferences(f1b);
+    pool2.resolveReferences(f2b);
+
+    ASSERT_EQ(pool1.size(), 4u);
+    ASSERT_EQ(pool2.getValues(), pool1.getValues());
+    ASSERT_EQ(f1b, f1);
+    ASSERT_EQ(f2b, f2);
+}
+
+TEST(CppADCGConstantPoolTest, NoFunction) {
+    // the table is only used when a function is created
+    LangCConstantPool<double> pool("model_constants");
+
+    CodeHandler<double> handler;
+    std::vector<CGD> x(1);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(1);
+    y[0] = x[0] * 1.2345678 + 1.2345678;
+
+    LanguageC<double> langC("double");
+    langC.setConstantPool(&pool);
+    LangCDefaultVariableNameGenerator<double> nameGen;
+
+    std::ostringstream code;
+    handler.generateCode(code, langC, y, nameGen);
+
+    ASSERT_EQ(pool.getUses(1.2345678), 0u);
+    pool.createTable();
+    ASSERT_TRUE(pool.empty());
+    ASSERT_NE(code.str().find("1.2345678"), std::string::npos);
+}
+
+TEST(CppADCGConstantPoolTest, ParallelSourceGeneration) {
+    std::unique_ptr<ADFun<CGD> > fun = createModel(20);
+
+    ModelCSourceGenPool twoThreads(*fun, 2);
+    std::map<std::string, std::string> ref = twoThreads.sources();
+
+    ModelCSourceGenPool parallel(*fun, 4);
+    std::map<std::string, std::string> src = parallel.sources();
+
+    // the table and the functions which use it do not depend on the thread timing
+    ASSERT_TRUE(ref.find("model_constants.c") != ref.end());
+    ASSERT_EQ(src.size(), ref.size());
+    bool pooled = false;
+    for (const auto& it : ref) {
+        ASSERT_TRUE(src.find(it.first) != src.end()) << it.first;
+        ASSERT_EQ(src.at(it.first), it.second) << it.first;
+        if (it.first.find("reverse_two") != std::string::npos && it.second.find("model_constants[") != std::string::npos)
+            pooled = true;
+    }
+    ASSERT_TRUE(pooled);
+
+    // a single table for all the functions of the model
+    const std::string& table = src.at("model_constants.c");
+    ASSERT_EQ(table.find("const double "), 0u);
+    ASSERT_EQ(table.find("const double ", 1), std::string::npos);
+    ASSERT_EQ(table.find("1.2345678,"), table.rfind("1.2345678,"));
+
+    // repeated generation
+    ModelCSourceGenPool parallel2(*fun, 4);
+    ASSERT_EQ(parallel2.sources(), src);
+}
@@ -0,0 +1,125 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGIndexReductionTest.hpp"
+#include <cppad/cg/dae_index_reduction/structural_analysis.hpp>
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+/**
+ * Two independent subsystems:
+ *   e0(v0) = 0, e1(v0, v1, v2) = 0, e2(v1, v2) = 0
+ *   e3(v3) = 0, e4(v4) = 0
+ */
+std::vector<std::set<size_t> > createSystem() {
+    std::vector<std::set<size_t> > eqs(5);
+    eqs[0] = {0};
+    eqs[1] = {0, 1, 2};
+    eqs[2] = {1, 2};
+    eqs[3] = {3};
+    eqs[4] = {4};
+    return eqs;
+}
+
+}
+
+TEST_F(IndexReductionTest, StructuralAnalysisMatching) {
+    // the greedy assignment (e0 -> v0) must be replaced by an augmenting path
+    std::vector<std::set<size_t> > eqs(2);
+    eqs[0] = {0, 1};
+    eqs[1] = {0};
+
+    StructuralAnalysis sa(2, eqs);
+    ASSERT_EQ(sa.match(), 2u);
+    ASSERT_EQ(sa.getEquationAssignment(), (std::vector<size_t>{1, 0}));
+    ASSERT_EQ(sa.getVariableAssignment(), (std::vector<size_t>{1, 0}));
+
+    // structurally singular
+    eqs[0] = {0};
+    StructuralAnalysis singular(2, eqs);
+    ASSERT_EQ(singular.match(), 1u);
+    ASSERT_EQ(singular.getVariableAssignment()[1], StructuralAnalysis::unassigned());
+}
+
+TEST_F(IndexReductionTest, StructuralAnalysisBLT) {
+    StructuralAnalysis sa(5, createSystem());
+    ASSERT_EQ(sa.match(), 5u);
+
+    std::vector<std::vector<size_t> > blocks = sa.bltDecomposition();
+    ASSERT_EQ(blocks.size(), 4u);
+    ASSERT_EQ(blocks[0], (std::vector<size_t>{0}));
+    ASSERT_EQ(blocks[1], (std::vector<size_t>{1, 2}));
+    ASSERT_EQ(blocks[2], (std::vector<size_t>{3}));
+    ASSERT_EQ(blocks[3], (std::vector<size_t>{4}));
+}
+
+TEST_F(IndexReductionTest, StructuralAnalysisUnderdetermined) {
+    /**
+     * e0(v0) = 0 and e1(v0, v1) = 0 only depend on variables assigned to
+     * them, while e2(v1, v2, v3) = 0 and e3(v3, v4) = 0 have one extra
+     * variable
+     */
+    std::vector<std::set<size_t> > eqs(4);
+    eqs[0] = {0};
+    eqs[1] = {0, 1};
+    eqs[2] = {1, 2, 3};
+    eqs[3] = {3, 4};
+
+    StructuralAnalysis sa(6, eqs);
+    ASSERT_EQ(sa.match(), 4u);
+
+    std::vector<size_t> underEqs, underVars;
+    sa.underdeterminedPart(underEqs, underVars);
+    ASSERT_EQ(underEqs, (std::vector<size_t>{2, 3}));
+    ASSERT_EQ(underVars, (std::vector<size_t>{2, 3, 4}));
+
+    StructuralAnalysis square = sa.subsystem({0, 1}, {0, 1});
+    ASSERT_EQ(square.getEquationCount(), 2u);
+    ASSERT_EQ(square.getVariableCount(), 2u);
+    ASSERT_EQ(square.match(), 2u);
+
+    std::vector<std::vector<size_t> > blocks = square.bltDecomposition();
+    ASSERT_EQ(blocks.size(), 2u);
+    ASSERT_EQ(blocks[0], (std::vector<size_t>{0}));
+    ASSERT_EQ(blocks[1], (std::vector<size_t>{1}));
+
+    // variables outside the subsystem are ignored
+    StructuralAnalysis under = sa.subsystem(underEqs, underVars);
+    ASSERT_EQ(under.match(), 2u);
+    std::vector<std::vector<size_t> > compEqs, compVars;
+    under.connectedComponents(compEqs, compVars);
+    ASSERT_EQ(compEqs.size(), 1u);
+    ASSERT_EQ(compVars[0], (std::vector<size_t>{0, 1, 2}));
+}
+
+TEST_F(IndexReductionTest, StructuralAnalysisComponents) {
+    // CSR input with an unused variable (v5)
+    StructuralAnalysis sa(6,
+                          std::vector<size_t>{0, 1, 4, 6, 7, 8},
+                          std::vector<size_t>{0, 0, 1, 2, 1, 2, 3, 4});
+
+    std::vector<std::vector<size_t> > eqs, vars;
+    sa.connectedComponents(eqs, vars);
+
+    ASSERT_EQ(eqs.size(), 3u);
+    ASSERT_EQ(eqs[0], (std::vector<size_t>{0, 1, 2}));
+    ASSERT_EQ(vars[0], (std::vector<size_t>{0, 1, 2}));
+    ASSERT_EQ(eqs[1], (std::vector<size_t>{3}));
+    ASSERT_EQ(vars[1], (std::vector<size_t>{3}));
+    ASSERT_EQ(eqs[2], (std::vector<size_t>{4}));
+    ASSERT_EQ(vars[2], (std::vector<size_t>{4}));
+}
@@ -0,0 +1,128 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include <cppad/cg/cppadcg.hpp>
+#include <gtest/gtest.h>
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+typedef std::vector<std::set<size_t> > VectorSet;
+
+std::unique_ptr<ADFun<double> > createTape() {
+    std::vector<AD<double> > x(5, 1.0);
+    CppAD::Independent(x);
+
+    std::vector<AD<double> > y(4);
+    y[0] = x[0] * x[1] + exp(x[2]);
+    y[1] = sin(x[3]) * x[4];
+    y[2] = x[1] / x[2] + x[4] * x[4];
+    y[3] = 2.0 * x[0];
+
+    return std::unique_ptr<ADFun<double> >(new ADFun<double>(x, y));
+}
+
+/**
+ * dense boolean sweeps (reference values)
+ */
+std::vector<bool> hessianDenseSweeps(ADFun<double>& fun,
+                                     const std::set<size_t>& eqs) {
+    size_t m = fun.Range();
+    size_t n = fun.Domain();
+
+    std::vector<bool> r(n * n, false);
+    for (size_t j = 0; j < n; j++)
+        r[j * n + j] = true;
+    fun.ForSparseJac(n, r);
+
+    std::vector<bool> s(m, false);
+    for (size_t i : eqs)
+        s[i] = true;
+    return fun.RevSparseHes(n, s);
+}
+
+}
+
+TEST(CppADCGSparsityTest, Jacobian) {
+    std::unique_ptr<ADFun<double> > fun = createTape();
+    size_t m = fun->Range();
+    size_t n = fun->Domain();
+
+    std::vector<bool> r(n * n, false);
+    for (size_t j = 0; j < n; j++)
+        r[j * n + j] = true;
+    std::vector<bool> jacRef = fun->ForSparseJac(n, r);
+
+    ASSERT_EQ(jacobianForwardSparsity<std::vector<bool> >(*fun), jacRef);
+    ASSERT_EQ(jacobianReverseSparsity<std::vector<bool> >(*fun), jacRef);
+    ASSERT_EQ(jacobianSparsity<std::vector<bool> >(*fun), jacRef);
+    ASSERT_EQ(jacRef.size(), m * n);
+}
+
+TEST(CppADCGSparsityTest, Hessian) {
+    std::unique_ptr<ADFun<double> > fun = createTape();
+    size_t m = fun->Range();
+
+    std::set<size_t> all;
+    for (size_t i = 0; i < m; i++)
+        all.insert(i);
+
+    ASSERT_EQ(hessianSparsity<std::vector<bool> >(*fun), hessianDenseSweeps(*fun, all));
+
+    for (size_t i = 0; i < m; i++) {
+        ASSERT_EQ(hessianSparsity<std::vector<bool> >(*fun, i), hessianDenseSweeps(*fun,{i}));
+    }
+}
+
+TEST(CppADCGSparsityTest, HessianGroups) {
+    std::unique_ptr<ADFun<double> > fun = createTape();
+    size_t n = fun->Domain();
+
+    std::vector<std::set<size_t> > groups{{0, 1}, {2}, {}, {1, 3}};
+    std::vector<VectorSet> hess = hessianSparsitySet<VectorSet>(*fun, groups);
+    ASSERT_EQ(hess.size(), groups.size());
+
+    for (size_t g = 0; g < groups.size(); g++) {
+        ASSERT_EQ(sparsitySetToBool<std::vector<bool> >(hess[g], n), hessianDenseSweeps(*fun, groups[g]));
+    }
+}
+
+TEST(CppADCGSparsityTest, HessianByEquation) {
+    std::unique_ptr<ADFun<double> > fun = createTape();
+    size_t m = fun->Range();
+    size_t n = fun->Domain();
+
+    std::vector<std::map<size_t, std::set<size_t> > > hess = hessianSparsityByEquation(*fun);
+    ASSERT_EQ(hess.size(), m);
+
+    for (size_t i = 0; i < m; i++) {
+        VectorSet hessi(n);
+        for (const auto& it : hess[i])
+            hessi[it.first] = it.second;
+        ASSERT_EQ(sparsitySetToBool<std::vector<bool> >(hessi, n), hessianDenseSweeps(*fun,{i}));
+    }
+
+    // only some variables
+    std::set<size_t> vars{0, 1, 4};
+    hess = hessianSparsityByEquation(*fun, vars);
+    ASSERT_EQ(hess[0].size(), 2u); // (0, 1) and (1, 0)
+    ASSERT_EQ(hess[1].size(), 0u); // (3, 4) is ignored
+    ASSERT_EQ(hess[2].size(), 1u); // (4, 4)
+    ASSERT_EQ(hess[2].at(4), std::set<size_t>{4});
+    ASSERT_TRUE(hess[3].empty());
+}
@@ -0,0 +1,84 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+TEST(CppADCGFunctionSplitTest, Calibrate) {
+    FunctionSplitCostModel ref(0.04, 3e-6, 1.3);
+
+    std::vector<size_t> assign{100, 1000, 5000, 20000, 50000};
+    std::vector<double> times(assign.size());
+    for (size_t k = 0; k < assign.size(); k++)
+        times[k] = ref.estimateCompileTime(assign[k]);
+
+    FunctionSplitCostModel model = FunctionSplitCostModel::calibrate(assign, times);
+
+    ASSERT_NEAR(model.getExponent(), ref.getExponent(), 1e-6);
+    ASSERT_NEAR(model.getPerFunction(), ref.getPerFunction(), 1e-6);
+    for (size_t k = 0; k < assign.size(); k++)
+        ASSERT_NEAR(model.estimateCompileTime(assign[k]), times[k], 1e-6 * times[k]);
+}
+
+TEST(CppADCGFunctionSplitTest, CostModelSplit) {
+    const size_t maxAssign = 40;
+
+    CodeHandler<double> handler;
+
+    std::vector<CG<double> > x(2);
+    handler.makeVariables(x);
+
+    std::vector<CG<double> > y;
+    CG<double> t = x[0];
+    for (size_t k = 0; k < 200; k++) {
+        t = t * x[1] + sin(t); // used twice (temporary variable)
+        if (k % 10 == 9)
+            y.push_back(t + x[0]);
+    }
+
+    LanguageC<double> langC("double");
+    LangCDefaultVariableNameGenerator<double> nameGen;
+
+    std::map<std::string, std::string> sources;
+    std::map<std::string, std::vector<FunctionSplitInfo> > report;
+    FunctionSplitCostModel model;
+
+    langC.setGenerateFunction("model");
+    langC.setMaxAssigmentsPerFunction(maxAssign, &sources);
+    langC.setFunctionSplitCostModel(&model, &report);
+
+    std::ostringstream code;
+    handler.generateCode(code, langC, y, nameGen);
+
+    ASSERT_EQ(report.size(), 1u);
+    const std::vector<FunctionSplitInfo>& splits = report["model"];
+    ASSERT_GT(splits.size(), 1u);
+    ASSERT_EQ(sources.size(), splits.size() + 1); // wrapper function + local functions
+
+    ASSERT_EQ(splits.front().begin, 0u);
+    ASSERT_EQ(splits.front().spilledIn, 0u);
+    ASSERT_EQ(splits.back().spilledOut, 0u);
+    for (size_t f = 0; f < splits.size(); f++) {
+        ASSERT_LE(splits[f].assignments, maxAssign);
+        ASSERT_GT(splits[f].compileTime, 0.0);
+        if (f > 0) {
+            ASSERT_EQ(splits[f].begin, splits[f - 1].end);
+            ASSERT_EQ(splits[f].spilledIn, splits[f - 1].spilledOut);
+            // only the values of the last iteration should cross boundaries
+            ASSERT_LE(splits[f].spilledIn, 2u);
+        }
+    }
+}
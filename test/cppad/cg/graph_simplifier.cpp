@@ -0,0 +1,272 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+typedef CG<double> CGD;
+
+/**
+ * Evaluates the dependent variables using the independent variable values
+ */
+std::vector<double> evaluate(CodeHandler<double>& handler,
+                             const std::vector<CGD>& y,
+                             const std::vector<double>& x) {
+    std::vector<AD<double> > ax(x.begin(), x.end());
+
+    Evaluator<double, double> evaluator(handler);
+    std::vector<AD<double> > ay = evaluator.evaluate(ax, y);
+
+    std::vector<double> values(ay.size());
+    for (size_t i = 0; i < ay.size(); i++)
+        values[i] = CppAD::Value(CppAD::Var2Par(ay[i]));
+    return values;
+}
+
+size_t countOperations(const OperationNode<double>& node,
+                       CGOpCode op,
+                       std::set<const OperationNode<double>*>& visited) {
+    if (!visited.insert(&node).second)
+        return 0;
+
+    size_t count = node.getOperationType() == op ? 1 : 0;
+    for (const auto& a : node.getArguments()) {
+        if (a.getOperation() != nullptr)
+            count += countOperations(*a.getOperation(), op, visited);
+    }
+    return count;
+}
+
+size_t countOperations(std::vector<CGD>& y,
+                       CGOpCode op) {
+    std::set<const OperationNode<double>*> visited;
+    size_t count = 0;
+    for (const CGD& yi : y) {
+        if (yi.getOperationNode() != nullptr)
+            count += countOperations(*yi.getOperationNode(), op, visited);
+    }
+    return count;
+}
+
+size_t chainDepth(const OperationNode<double>& node) {
+    size_t depth = 0;
+    for (const auto& a : node.getArguments()) {
+        if (a.getOperation() != nullptr)
+            depth = std::max(depth, chainDepth(*a.getOperation()));
+    }
+    return depth + 1;
+}
+
+}
+
+TEST(CppADCGGraphSimplifierTest, Strict) {
+    CodeHandler<double> handler;
+
+    std::vector<double> xv{1.7, -0.3};
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(4);
+    y[0] = pow(x[0], 2.0) + pow(x[1], -1.0);
+    y[1] = x[0] / 4.0 + x[1] / 3.0;
+    y[2] = pow(x[0], 3.0) * x[1] + 1.0;
+    y[3] = -(-(x[0] * x[1]) + exp(x[1]));
+
+    std::vector<double> ref = evaluate(handler, y, xv);
+
+    GraphSimplifier<double> simplifier(FloatingPointStrictness::Strict);
+    ASSERT_GT(simplifier.simplify(handler, y), 0u);
+
+    ASSERT_EQ(countOperations(y, CGOpCode::Pow), 1u); // pow(x0, 3) is only lowered if relaxed
+    ASSERT_EQ(countOperations(y, CGOpCode::Div), 2u); // 1 / x1 and x1 / 3
+    ASSERT_EQ(countOperations(y, CGOpCode::Fma), 0u);
+
+    // exact rewrites
+    std::vector<double> val = evaluate(handler, y, xv);
+    for (size_t i = 0; i < y.size(); i++)
+        ASSERT_EQ(val[i], ref[i]);
+}
+
+TEST(CppADCGGraphSimplifierTest, Contract) {
+    CodeHandler<double> handler;
+
+    std::vector<double> xv{1.7, -0.3, 2.9};
+    std::vector<CGD> x(3);
+    handler.makeVariables(x);
+
+    CGD shared = x[1] * x[2];
+
+    std::vector<CGD> y(4);
+    y[0] = x[0] * x[1] + x[2];
+    y[1] = x[2] - x[0] * x[1];
+    y[2] = x[0] * x[1] - 2.0;
+    y[3] = shared + x[0] + shared * 2.0; // shared product cannot be fused
+
+    std::vector<double> ref = evaluate(handler, y, xv);
+
+    GraphSimplifier<double> simplifier(FloatingPointStrictness::Contract);
+    simplifier.simplify(handler, y);
+
+    for (size_t i = 0; i < 3; i++)
+        ASSERT_EQ(y[i].getOperationNode()->getOperationType(), CGOpCode::Fma);
+    ASSERT_EQ(countOperations(y, CGOpCode::Fma), 4u); // (x1*x2*2 + (x1*x2 + x0)) is also fused
+    ASSERT_GE(countOperations(y, CGOpCode::Mul), 1u); // shared product
+
+    std::vector<double> val = evaluate(handler, y, xv);
+    for (size_t i = 0; i < y.size(); i++)
+        ASSERT_NEAR(val[i], ref[i], 1e-14);
+
+    // source code
+    LanguageC<double> langC("double");
+    LangCDefaultVariableNameGenerator<double> nameGen;
+    std::ostringstream code;
+    handler.generateCode(code, langC, y, nameGen);
+    ASSERT_NE(code.str().find("fma(x[0], x[1], x[2])"), std::string::npos);
+}
+
+TEST(CppADCGGraphSimplifierTest, Relaxed) {
+    CodeHandler<double> handler;
+
+    std::vector<double> xv{1.7, 0.3, 2.9, 0.8};
+    std::vector<CGD> x(4);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(5);
+    y[0] = pow(x[0], 5.0) + pow(x[1], -3.0);
+    y[1] = pow(x[2], 0.5) * pow(x[3], 2.5) / pow(x[0], -0.5);
+    y[2] = x[0] / x[3] + x[1] / x[3] + x[2] / 7.0;
+    CGD sum = x[0];
+    for (size_t k = 0; k < 15; k++)
+        sum = sum + x[k % 4] * double(k + 1);
+    y[3] = sum;
+    CGD prod = x[0];
+    for (size_t k = 1; k < 8; k++)
+        prod = prod * x[k % 4];
+    y[4] = prod;
+
+    std::vector<double> ref = evaluate(handler, y, xv);
+
+    GraphSimplifier<double> simplifier(FloatingPointStrictness::Relaxed);
+    simplifier.setFma(false);
+    simplifier.simplify(handler, y);
+
+    ASSERT_EQ(countOperations(y, CGOpCode::Pow), 0u);
+    ASSERT_EQ(countOperations(y, CGOpCode::Div), 4u); // 1 / x1^3, 1 / x3, 1 / sqrt(x0), (...) / (1 / sqrt(x0))
+    ASSERT_LE(chainDepth(*y[3].getOperationNode()), 6u); // balanced (16 terms)
+    ASSERT_LE(chainDepth(*y[4].getOperationNode()), 4u); // balanced (8 factors)
+
+    std::vector<double> val = evaluate(handler, y, xv);
+    for (size_t i = 0; i < y.size(); i++)
+        ASSERT_NEAR(val[i], ref[i], 1e-12 * std::abs(ref[i]));
+}
+
+TEST(CppADCGGraphSimplifierTest, SolveFma) {
+    CodeHandler<double> handler;
+
+    std::vector<double> xv{1.7, -0.3, 2.9};
+    std::vector<CGD> x(3);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(3);
+    y[0] = x[0] * x[1] + x[2];
+    y[1] = x[2] * 4.0 + x[1];
+    y[2] = x[0] * x[1] + x[0] - 2.0; // two occurrences of x0
+
+    GraphSimplifier<double> simplifier(FloatingPointStrictness::Contract);
+    simplifier.simplify(handler, y);
+    ASSERT_EQ(countOperations(y, CGOpCode::Fma), 3u); // one for each equation
+
+    // solve y[i] == 0
+    std::vector<CGD> sol(3);
+    sol[0] = handler.solveFor(*y[0].getOperationNode(), *x[0].getOperationNode());
+    sol[1] = handler.solveFor(*y[1].getOperationNode(), *x[2].getOperationNode());
+    sol[2] = handler.solveFor(*y[2].getOperationNode(), *x[0].getOperationNode());
+
+    std::vector<double> val = evaluate(handler, sol, xv);
+    ASSERT_NEAR(val[0], -xv[2] / xv[1], 1e-12);
+    ASSERT_NEAR(val[1], -xv[1] / 4.0, 1e-12);
+    ASSERT_NEAR(val[2], 2.0 / (xv[1] + 1.0), 1e-12);
+}
+
+TEST(CppADCGGraphSimplifierTest, CountOperations) {
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(3);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(2);
+    y[0] = x[0] * x[1] + x[2];
+    y[1] = x[1] * x[2] - 2.0;
+
+    GraphSimplifier<double> simplifier(FloatingPointStrictness::Contract);
+    handler.setGraphSimplifier(&simplifier);
+
+    size_t nNodes = handler.getManagedNodesCount();
+    size_t ops = handler.countOperations(y);
+    ASSERT_EQ(ops, 2u); // two fma
+
+    // the graph was not changed
+    ASSERT_EQ(handler.getManagedNodesCount(), nNodes);
+    ASSERT_EQ(countOperations(y, CGOpCode::Fma), 0u);
+    ASSERT_EQ(countOperations(y, CGOpCode::Mul), 2u);
+    ASSERT_EQ(y[0].getOperationNode()->getOperationType(), CGOpCode::Add);
+    ASSERT_EQ(y[1].getOperationNode()->getOperationType(), CGOpCode::Sub);
+
+    LanguageC<double> langC("double");
+    LangCDefaultVariableNameGenerator<double> nameGen;
+    std::ostringstream code;
+    handler.generateCode(code, langC, y, nameGen);
+    ASSERT_EQ(handler.getOperationCount(), ops);
+}
+
+TEST(CppADCGGraphSimplifierTest, EvaluateFma) {
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(3);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(1);
+    y[0] = x[0] * x[1] + x[2];
+
+    GraphSimplifier<double> simplifier(FloatingPointStrictness::Contract);
+    simplifier.simplify(handler, y);
+    ASSERT_EQ(y[0].getOperationNode()->getOperationType(), CGOpCode::Fma);
+
+    // (1 + e) * (1 - e) - 1 is only exact with a single rounding
+    double e = std::ldexp(1.0, -30);
+    std::vector<double> xv{1.0 + e, 1.0 - e, -1.0};
+
+    // new graph
+    CodeHandler<double> handler2;
+    std::vector<CGD> x2(3);
+    handler2.makeVariables(x2);
+    for (size_t j = 0; j < x2.size(); j++)
+        x2[j].setValue(xv[j]);
+
+    Evaluator<double, double, CGD> evaluator(handler);
+    std::vector<CGD> y2 = evaluator.evaluate(x2, y);
+    ASSERT_EQ(y2[0].getOperationNode()->getOperationType(), CGOpCode::Fma);
+    ASSERT_EQ(y2[0].getValue(), -e * e);
+
+    // constants
+    std::vector<CGD> xp(xv.begin(), xv.end());
+    Evaluator<double, double, CGD> evaluatorP(handler);
+    std::vector<CGD> yp = evaluatorP.evaluate(xp, y);
+    ASSERT_TRUE(yp[0].isParameter());
+    ASSERT_EQ(yp[0].getValue(), -e * e);
+}
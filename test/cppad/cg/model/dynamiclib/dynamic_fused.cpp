@@ -0,0 +1,121 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+typedef CG<double> CGD;
+typedef AD<CGD> ADCGD;
+
+std::unique_ptr<ADFun<CGD> > createTape() {
+    std::vector<ADCGD> x(4);
+    for (size_t j = 0; j < x.size(); j++)
+        x[j] = 1.0 + j;
+    CppAD::Independent(x);
+
+    std::vector<ADCGD> y(3);
+    y[0] = x[0] * x[1] + exp(x[2]);
+    y[1] = sin(x[1]) * x[3] + x[0] * x[0];
+    y[2] = x[2] / x[3] + 2.0 * x[1];
+
+    return std::unique_ptr<ADFun<CGD> >(new ADFun<CGD>(x, y));
+}
+
+void testFused(JacobianADMode mode,
+               bool customElements,
+               const std::string& libName) {
+    std::unique_ptr<ADFun<CGD> > fun = createTape();
+
+    ModelCSourceGen<double> model(*fun, "model");
+    model.setJacobianADMode(mode);
+    model.setCreateForwardZero(true);
+    model.setCreateSparseJacobian(true);
+    model.setCreateSparseHessian(true);
+    model.setCreateForwardZeroSparseJacobian(true);
+    model.setCreateLagrangianSparseHessian(true);
+    if (customElements) {
+        // (1, 2) and (3, 0) are structural zeros
+        model.setCustomSparseJacobianElements({2, 0, 1, 1, 0, 2}, {3, 1, 2, 0, 2, 1});
+        model.setCustomSparseHessianElements({0, 1, 3, 2, 3}, {1, 3, 3, 3, 0});
+    }
+
+    ModelLibraryCSourceGen<double> libSrc(model);
+
+    DynamicModelLibraryProcessor<double> p(libSrc, libName);
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    std::unique_ptr<DynamicLib<double> > lib = p.createDynamicLibrary(compiler);
+    std::unique_ptr<GenericModel<double> > m = lib->model("model");
+    ASSERT_TRUE(m->isForwardZeroSparseJacobianAvailable());
+    ASSERT_TRUE(m->isLagrangianSparseHessianAvailable());
+
+    std::vector<double> x{0.5, 1.5, 2.5, 3.5};
+    std::vector<double> w{0.7, -1.2, 2.1};
+
+    // reference values from the separate functions
+    std::vector<double> yRef = m->ForwardZero(x);
+    std::vector<double> jacRef, hessRef;
+    std::vector<size_t> rows, cols, hrows, hcols;
+    m->SparseJacobian(x, jacRef, rows, cols);
+    m->SparseHessian(x, w, hessRef, hrows, hcols);
+
+    std::vector<double> y(3), jac(jacRef.size());
+    m->ForwardZeroSparseJacobian(x, y, jac);
+    for (size_t i = 0; i < y.size(); i++)
+        ASSERT_NEAR(y[i], yRef[i], 1e-12);
+    for (size_t e = 0; e < jac.size(); e++)
+        ASSERT_NEAR(jac[e], jacRef[e], 1e-12) << e;
+
+    double lag;
+    std::vector<double> grad(4), hess(hessRef.size());
+    m->LagrangianSparseHessian(x, w, lag, grad, hess);
+
+    double lagRef = 0;
+    for (size_t i = 0; i < 3; i++)
+        lagRef += w[i] * yRef[i];
+    ASSERT_NEAR(lag, lagRef, 1e-12);
+
+    // gradient from the full Jacobian
+    std::vector<double> fullJac = m->SparseJacobian(x);
+    for (size_t j = 0; j < 4; j++) {
+        double g = 0;
+        for (size_t i = 0; i < 3; i++)
+            g += w[i] * fullJac[i * 4 + j];
+        ASSERT_NEAR(grad[j], g, 1e-12) << j;
+    }
+
+    for (size_t e = 0; e < hess.size(); e++)
+        ASSERT_NEAR(hess[e], hessRef[e], 1e-12) << e;
+}
+
+}
+
+TEST(CppADCGFusedEvaluationTest, Forward) {
+    testFused(JacobianADMode::Forward, false, "cppad_cg_fused_for");
+}
+
+TEST(CppADCGFusedEvaluationTest, Reverse) {
+    testFused(JacobianADMode::Reverse, false, "cppad_cg_fused_rev");
+}
+
+TEST(CppADCGFusedEvaluationTest, CustomElements) {
+    testFused(JacobianADMode::Forward, true, "cppad_cg_fused_custom");
+    testFused(JacobianADMode::Reverse, true, "cppad_cg_fused_custom");
+}
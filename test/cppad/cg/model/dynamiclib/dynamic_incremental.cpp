@@ -0,0 +1,242 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include <sys/stat.h>
+
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+typedef CG<double> CGD;
+typedef AD<CGD> ADCGD;
+
+std::unique_ptr<ADFun<CGD> > createTape(double coefficient) {
+    std::vector<ADCGD> x(2);
+    x[0] = 1.0;
+    x[1] = 2.0;
+    CppAD::Independent(x);
+
+    std::vector<ADCGD> y(2);
+    y[0] = coefficient * x[0] * x[1];
+    y[1] = sin(x[0]) + x[1] / coefficient;
+
+    return std::unique_ptr<ADFun<CGD> >(new ADFun<CGD>(x, y));
+}
+
+/**
+ * the last modification time of a file (in nanoseconds)
+ */
+long long modificationTime(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return -1;
+    return static_cast<long long> (st.st_mtim.tv_sec) * 1000000000ll + st.st_mtim.tv_nsec;
+}
+
+std::map<std::string, long long> modificationTimes(const ModelLibraryBuildManifest& manifest,
+                                                   const std::string& entry) {
+    std::map<std::string, long long> times;
+    for (const std::string& o : manifest.find(entry)->objectFiles)
+        times[o] = modificationTime(o);
+    return times;
+}
+
+/**
+ * Creates a library with two models where the second model uses a
+ * different coefficient in each build.
+ */
+ModelLibraryBuildManifest build(double coefficient,
+                                std::vector<double>& y) {
+    std::unique_ptr<ADFun<CGD> > funA = createTape(2.0);
+    std::unique_ptr<ADFun<CGD> > funB = createTape(coefficient);
+
+    ModelCSourceGen<double> modelA(*funA, "modelA");
+    modelA.setCreateForwardZero(true);
+    modelA.setCreateSparseJacobian(true);
+
+    ModelCSourceGen<double> modelB(*funB, "modelB");
+    modelB.setCreateForwardZero(true);
+    modelB.setCreateSparseJacobian(true);
+
+    ModelLibraryCSourceGen<double> libSrc(modelA, modelB);
+
+    DynamicModelLibraryProcessor<double> p(libSrc, "cppad_cg_incremental");
+    p.setIncrementalBuild(true);
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    std::unique_ptr<DynamicLib<double> > lib = p.createDynamicLibrary(compiler);
+
+    std::vector<double> x{1.0, 2.0};
+    y = lib->model("modelB")->ForwardZero(x);
+
+    ModelLibraryBuildManifest manifest;
+    manifest.read("cppad_cg_incremental" + system::SystemInfo<>::DYNAMIC_LIB_EXTENSION + ".manifest");
+    return manifest;
+}
+
+/**
+ * Provides access to the library sources
+ */
+class DynamicModelLibraryProcessorSources : public DynamicModelLibraryProcessor<double> {
+public:
+    using DynamicModelLibraryProcessor<double>::DynamicModelLibraryProcessor;
+
+    inline const std::map<std::string, std::string>& librarySources() {
+        return getLibrarySources();
+    }
+};
+
+void atomicModel(const std::vector<AD<double> >& ax,
+                 std::vector<AD<double> >& ay) {
+    ay[0] = ax[0] * ax[1];
+    ay[1] = exp(ax[0]);
+}
+
+/**
+ * Creates a library with a model which uses an atomic function and a
+ * model without atomic functions where direct calls between models are
+ * enabled.
+ *
+ * @param directModelCalls the source with the direct model calls
+ */
+ModelLibraryBuildManifest buildWithAtomics(std::string& directModelCalls) {
+    std::vector<AD<double> > ax{1.0, 2.0};
+    std::vector<AD<double> > ay(2);
+    checkpoint<double> atomic("atomicModel", atomicModel, ax, ay);
+
+    std::vector<double> x{1.0, 2.0};
+    CGAtomicFun<double> cgAtomic(atomic, x, true);
+
+    std::vector<ADCGD> u{1.0, 2.0};
+    CppAD::Independent(u);
+    std::vector<ADCGD> z(2);
+    cgAtomic(u, z);
+    z[1] += u[1];
+    ADFun<CGD> funA(u, z);
+
+    std::unique_ptr<ADFun<CGD> > funB = createTape(2.0);
+
+    ModelCSourceGen<double> modelA(funA, "modelAtomic");
+    modelA.setCreateForwardZero(true);
+    modelA.setCreateForwardOne(true);
+    modelA.setCreateReverseOne(true);
+
+    ModelCSourceGen<double> modelB(*funB, "modelB");
+    modelB.setCreateForwardZero(true);
+    modelB.setCreateForwardOne(true);
+    modelB.setCreateReverseOne(true);
+
+    ModelLibraryCSourceGen<double> libSrc(modelA, modelB);
+    libSrc.setDirectModelCalls(true);
+
+    DynamicModelLibraryProcessorSources p(libSrc, "cppad_cg_incremental_atomic");
+    p.setIncrementalBuild(true);
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    std::unique_ptr<DynamicLib<double> > lib = p.createDynamicLibrary(compiler);
+
+    std::unique_ptr<GenericModel<double> > model = lib->model("modelAtomic");
+    model->addAtomicFunction(atomic);
+    std::vector<double> y = model->ForwardZero(x);
+    EXPECT_NEAR(y[0], x[0] * x[1], 1e-10);
+    EXPECT_NEAR(y[1], std::exp(x[0]) + x[1], 1e-10);
+
+    directModelCalls = p.librarySources().at(ModelLibraryCSourceGen<double>::FILE_DIRECT_MODEL_CALLS + ".c");
+
+    ModelLibraryBuildManifest manifest;
+    manifest.read("cppad_cg_incremental_atomic" + system::SystemInfo<>::DYNAMIC_LIB_EXTENSION + ".manifest");
+    return manifest;
+}
+
+}
+
+TEST(CppADCGIncrementalBuildTest, Manifest) {
+    ModelLibraryBuildManifest manifest;
+    manifest.setConfiguration("0123456789abcdef");
+    manifest.add("modelA", "00000000000000aa", {"objs/modelA/modelA_forward_zero.c.o", "objs/modelA/a b.c.o"}, {"atomic 2", "atomic1"});
+    manifest.add("_library", "00000000000000bb", {});
+    manifest.write("cppad_cg_test.manifest");
+
+    ModelLibraryBuildManifest loaded;
+    ASSERT_TRUE(loaded.read("cppad_cg_test.manifest"));
+    ASSERT_EQ(loaded.getConfiguration(), manifest.getConfiguration());
+    ASSERT_EQ(loaded.getEntries().size(), 2u);
+    ASSERT_EQ(loaded.find("modelA")->fingerprint, "00000000000000aa");
+    ASSERT_EQ(loaded.find("modelA")->objectFiles, manifest.find("modelA")->objectFiles);
+    ASSERT_EQ(loaded.find("modelA")->atomicFunctions, std::vector<std::string>({"atomic 2", "atomic1"}));
+    ASSERT_TRUE(loaded.find("_library")->objectFiles.empty());
+    ASSERT_TRUE(loaded.find("_library")->atomicFunctions.empty());
+    ASSERT_TRUE(loaded.find("modelB") == nullptr);
+
+    // object files do not exist
+    ASSERT_FALSE(loaded.isUpToDate("modelA", "00000000000000aa", "0123456789abcdef"));
+    ASSERT_TRUE(loaded.isUpToDate("_library", "00000000000000bb", "0123456789abcdef"));
+    ASSERT_FALSE(loaded.isUpToDate("_library", "00000000000000bb", "0123456789abcdee"));
+
+    ASSERT_FALSE(loaded.read("cppad_cg_test_missing.manifest"));
+    ASSERT_TRUE(loaded.getEntries().empty());
+
+    remove("cppad_cg_test.manifest");
+}
+
+TEST(CppADCGIncrementalBuildTest, OnlyChangedModels) {
+    std::vector<double> y;
+
+    ModelLibraryBuildManifest m1 = build(3.0, y);
+    ASSERT_NEAR(y[0], 3.0 * 2.0, 1e-10);
+    ASSERT_EQ(m1.getEntries().size(), 4u); // modelA, modelB, _library, _custom
+    std::map<std::string, long long> timesA = modificationTimes(m1, "modelA");
+    std::map<std::string, long long> timesB = modificationTimes(m1, "modelB");
+
+    // same tapes: nothing is recompiled
+    ModelLibraryBuildManifest m2 = build(3.0, y);
+    ASSERT_EQ(m2.find("modelA")->fingerprint, m1.find("modelA")->fingerprint);
+    ASSERT_EQ(m2.find("modelB")->fingerprint, m1.find("modelB")->fingerprint);
+    ASSERT_EQ(modificationTimes(m2, "modelA"), timesA);
+    ASSERT_EQ(modificationTimes(m2, "modelB"), timesB);
+
+    // only modelB changes
+    ModelLibraryBuildManifest m3 = build(5.0, y);
+    ASSERT_NEAR(y[0], 5.0 * 2.0, 1e-10);
+    ASSERT_EQ(m3.find("modelA")->fingerprint, m1.find("modelA")->fingerprint);
+    ASSERT_NE(m3.find("modelB")->fingerprint, m1.find("modelB")->fingerprint);
+    ASSERT_EQ(modificationTimes(m3, "modelA"), timesA);
+    ASSERT_NE(modificationTimes(m3, "modelB"), timesB);
+}
+
+TEST(CppADCGIncrementalBuildTest, ModelWithAtomics) {
+    std::string direct1;
+    ModelLibraryBuildManifest m1 = buildWithAtomics(direct1);
+    ASSERT_EQ(m1.find("modelAtomic")->atomicFunctions, std::vector<std::string>({"atomicModel"}));
+    ASSERT_TRUE(m1.find("modelB")->atomicFunctions.empty());
+
+    // the model with atomic functions cannot be called directly
+    ASSERT_EQ(direct1.find("modelAtomic_forward_zero(in, out, atomicFun)"), std::string::npos);
+    ASSERT_NE(direct1.find("modelB_forward_zero(in, out, atomicFun)"), std::string::npos);
+
+    // the models are not generated again but their atomic functions are still known
+    std::map<std::string, long long> times = modificationTimes(m1, "modelAtomic");
+    std::string direct2;
+    ModelLibraryBuildManifest m2 = buildWithAtomics(direct2);
+    ASSERT_EQ(modificationTimes(m2, "modelAtomic"), times);
+    ASSERT_EQ(m2.find("modelAtomic")->atomicFunctions, m1.find("modelAtomic")->atomicFunctions);
+    ASSERT_EQ(direct2, direct1);
+    ASSERT_EQ(m2.find("_library")->fingerprint, m1.find("_library")->fingerprint);
+}
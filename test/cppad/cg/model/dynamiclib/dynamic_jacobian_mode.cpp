@@ -0,0 +1,222 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+typedef CG<double> CGD;
+typedef AD<CGD> ADCGD;
+
+/**
+ * Provides access to the selected Jacobian mode
+ */
+class ModelCSourceGenModeTest : public ModelCSourceGen<double> {
+public:
+
+    ModelCSourceGenModeTest(ADFun<CGD>& fun,
+                            const std::string& model) :
+        ModelCSourceGen<double>(fun, model) {
+    }
+
+    JacobianADMode selectedMode() {
+        return getSparseJacobianADMode();
+    }
+
+    size_t countOperations(JacobianADMode mode) {
+        determineJacobianSparsity();
+        return countSparseJacobianOperations(mode);
+    }
+
+    std::set<size_t> reverseRows() {
+        determineJacobianSparsity();
+        return determineBidirectionalReverseRows();
+    }
+};
+
+/**
+ * A model with a single dense equation, a single dense column and many
+ * simple equations (the number of rows and columns is the same).
+ */
+template<class T>
+std::vector<T> modelEquations(const std::vector<T>& x) {
+    size_t n = x.size();
+    std::vector<T> y(n);
+    y[0] = 0;
+    for (size_t j = 0; j < n; j++)
+        y[0] += x[j] * exp(x[(j + 1) % n]);
+    for (size_t i = 1; i < n; i++)
+        y[i] = x[i] * 2.0 + sin(x[0]) * i;
+    return y;
+}
+
+/**
+ * A model with blocks of 4 variables where each block has a dense
+ * equation and simple equations.
+ */
+template<class T>
+std::vector<T> blockEquations(const std::vector<T>& x) {
+    size_t n = x.size();
+    std::vector<T> y(n);
+    for (size_t b = 0; b < n; b += 4) {
+        y[b] = 0;
+        for (size_t j = b; j < b + 4; j++)
+            y[b] += x[j] * x[j];
+        for (size_t i = b + 1; i < b + 4; i++)
+            y[i] = x[i] * x[b];
+    }
+    return y;
+}
+
+std::unique_ptr<ADFun<CGD> > createTape(size_t n) {
+    std::vector<ADCGD> x(n);
+    for (size_t j = 0; j < n; j++)
+        x[j] = 1.0 + j;
+    CppAD::Independent(x);
+
+    std::vector<ADCGD> y = modelEquations(x);
+
+    return std::unique_ptr<ADFun<CGD> >(new ADFun<CGD>(x, y));
+}
+
+void testJacobian(ModelCSourceGen<double>& model,
+                  const std::string& libName,
+                  size_t n) {
+    ModelLibraryCSourceGen<double> libSrc(model);
+
+    DynamicModelLibraryProcessor<double> p(libSrc, libName);
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    std::unique_ptr<DynamicLib<double> > lib = p.createDynamicLibrary(compiler);
+    std::unique_ptr<GenericModel<double> > m = lib->model("model");
+
+    std::vector<double> x(n);
+    for (size_t j = 0; j < n; j++)
+        x[j] = 0.1 * (j + 1);
+
+    std::vector<AD<double> > ax(x.begin(), x.end());
+    CppAD::Independent(ax);
+    std::vector<AD<double> > ay = modelEquations(ax);
+    ADFun<double> funD(ax, ay);
+    std::vector<double> jacRef = funD.Jacobian(x);
+
+    std::vector<double> jac;
+    std::vector<size_t> rows, cols;
+    m->SparseJacobian(x, jac, rows, cols);
+    ASSERT_EQ(jac.size(), 3 * n - 2);
+    for (size_t e = 0; e < jac.size(); e++)
+        ASSERT_NEAR(jac[e], jacRef[rows[e] * n + cols[e]], 1e-10) << e;
+}
+
+}
+
+TEST(CppADCGJacobianModeTest, Cheapest) {
+    const size_t n = 10;
+    std::unique_ptr<ADFun<CGD> > fun = createTape(n);
+
+    ModelCSourceGenModeTest model(*fun, "model");
+    model.setCreateSparseJacobian(true);
+    model.setJacobianADMode(JacobianADMode::Cheapest);
+
+    size_t forwardOps = model.countOperations(JacobianADMode::Forward);
+    size_t reverseOps = model.countOperations(JacobianADMode::Reverse);
+    size_t bidirOps = model.countOperations(JacobianADMode::Bidirectional);
+    ASSERT_GT(forwardOps, 0u);
+    ASSERT_GT(reverseOps, 0u);
+    ASSERT_GT(bidirOps, 0u);
+
+    JacobianADMode mode = model.selectedMode();
+    if (mode == JacobianADMode::Forward) {
+        ASSERT_LE(forwardOps, reverseOps);
+        ASSERT_LE(forwardOps, bidirOps);
+    } else if (mode == JacobianADMode::Reverse) {
+        ASSERT_LT(reverseOps, forwardOps);
+        ASSERT_LE(reverseOps, bidirOps);
+    } else {
+        ASSERT_TRUE(mode == JacobianADMode::Bidirectional);
+        ASSERT_LT(bidirOps, forwardOps);
+        ASSERT_LT(bidirOps, reverseOps);
+    }
+
+    testJacobian(model, "cppad_cg_jac_mode", n);
+}
+
+TEST(CppADCGJacobianModeTest, Bidirectional) {
+    const size_t n = 10;
+    std::unique_ptr<ADFun<CGD> > fun = createTape(n);
+
+    ModelCSourceGenModeTest model(*fun, "model");
+    model.setCreateSparseJacobian(true);
+    model.setJacobianADMode(JacobianADMode::Bidirectional);
+
+    // only the dense row uses the reverse mode
+    ASSERT_EQ(model.reverseRows(), std::set<size_t>{0});
+    ASSERT_TRUE(model.selectedMode() == JacobianADMode::Bidirectional);
+
+    testJacobian(model, "cppad_cg_jac_bidir", n);
+}
+
+TEST(CppADCGJacobianModeTest, BidirectionalColoredRows) {
+    const size_t n = 12;
+    std::vector<ADCGD> x(n);
+    for (size_t j = 0; j < n; j++)
+        x[j] = 1.0 + j;
+    CppAD::Independent(x);
+    std::vector<ADCGD> y = blockEquations(x);
+    ADFun<CGD> fun(x, y);
+
+    ModelCSourceGenModeTest model(fun, "model");
+    model.setCreateSparseJacobian(true);
+    model.setJacobianADMode(JacobianADMode::Bidirectional);
+
+    /**
+     * the dense rows do not share columns: a single reverse sweep plus two
+     * forward sweeps instead of four forward sweeps
+     */
+    ASSERT_EQ(model.reverseRows(), (std::set<size_t>{0, 4, 8}));
+}
+
+TEST(CppADCGJacobianModeTest, OperationCount) {
+    auto createGraph = [](CodeHandler<double>& handler) {
+        std::vector<CGD> x(3);
+        handler.makeVariables(x);
+
+        CGD shared = x[0] * x[1];
+        std::vector<CGD> y(3);
+        y[0] = shared + x[2];
+        y[1] = exp(shared);
+        y[2] = x[1];
+        return y;
+    };
+
+    // counting without generating source code
+    CodeHandler<double> handler1;
+    std::vector<CGD> y1 = createGraph(handler1);
+    size_t ops = handler1.countOperations(y1);
+    ASSERT_EQ(ops, 3u); // mul, add, exp
+
+    // the same value as the one determined while generating source code
+    CodeHandler<double> handler2;
+    std::vector<CGD> y2 = createGraph(handler2);
+    LanguageC<double> langC("double");
+    LangCDefaultVariableNameGenerator<double> nameGen;
+    std::ostringstream code;
+    handler2.generateCode(code, langC, y2, nameGen);
+    ASSERT_EQ(handler2.getOperationCount(), ops);
+}
@@ -0,0 +1,136 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+typedef CG<double> CGD;
+typedef AD<CGD> ADCGD;
+
+/**
+ * Provides access to the model sources
+ */
+class ModelLibraryCSourceGenShared : public ModelLibraryCSourceGen<double> {
+public:
+
+    inline ModelLibraryCSourceGenShared(ModelCSourceGen<double>& model) :
+        ModelLibraryCSourceGen<double>(model) {
+    }
+
+    inline std::map<std::string, std::string> modelSources(ModelCSourceGen<double>& model) {
+        return getModelSources(model);
+    }
+};
+
+std::unique_ptr<ADFun<CGD> > createTape() {
+    std::vector<ADCGD> x(3);
+    for (size_t j = 0; j < x.size(); j++)
+        x[j] = 1.0 + j;
+    CppAD::Independent(x);
+
+    std::vector<ADCGD> y(2);
+    y[0] = x[0] * x[1] + exp(x[2]);
+    y[1] = sin(x[0]) / x[2];
+
+    return std::unique_ptr<ADFun<CGD> >(new ADFun<CGD>(x, y));
+}
+
+}
+
+TEST(CppADCGSharedHeaderTest, Sources) {
+    std::unique_ptr<ADFun<CGD> > fun = createTape();
+
+    ModelCSourceGen<double> model(*fun, "model");
+    model.setCreateForwardZero(true);
+    model.setCreateSparseJacobian(true);
+    model.setCreateSparseHessian(true);
+
+    ModelLibraryCSourceGenShared libSrc(model);
+    ASSERT_TRUE(libSrc.getSharedHeader().empty());
+    libSrc.setSharedHeader(true);
+
+    const std::string header = libSrc.getSharedHeader();
+    ASSERT_NE(header.find(LanguageC<double>::ATOMICFUN_STRUCT_DEFINITION), std::string::npos);
+    ASSERT_NE(header.find("#include <math.h>"), std::string::npos);
+
+    const std::string include = "#include \"" + ModelLibraryCSourceGen<double>::FILE_SHARED_HEADER + "\"\n";
+
+    std::map<std::string, std::string> sources = libSrc.modelSources(model);
+    ASSERT_FALSE(sources.empty());
+    size_t nIncludes = 0;
+    for (const auto& it : sources) {
+        const std::string& src = it.second;
+        ASSERT_EQ(src.find("struct LangCAtomicFun {"), std::string::npos) << it.first;
+        ASSERT_EQ(src.find("#include <math.h>"), std::string::npos) << it.first;
+        if (src.compare(0, include.size(), include) == 0)
+            nIncludes++;
+        else
+            ASSERT_EQ(src.find(include), std::string::npos) << it.first; // only as the first line
+    }
+    ASSERT_GT(nIncludes, 0u);
+
+    // the sources were already generated with the shared header
+    libSrc.setSharedHeader(false);
+    ASSERT_THROW(libSrc.modelSources(model), CGException);
+
+    // the sources of a model without the shared header
+    ModelCSourceGen<double> model2(*fun, "model");
+    model2.setCreateForwardZero(true);
+    model2.setCreateSparseJacobian(true);
+    model2.setCreateSparseHessian(true);
+
+    ModelLibraryCSourceGenShared libSrc2(model2);
+    std::map<std::string, std::string> original = libSrc2.modelSources(model2);
+    ASSERT_EQ(original.size(), sources.size());
+    ASSERT_NE(original.at("model_forward_zero.c").find("struct LangCAtomicFun {"), std::string::npos);
+    ASSERT_EQ(original.at("model_forward_zero.c").find(include), std::string::npos);
+}
+
+TEST(CppADCGSharedHeaderTest, DynamicLibrary) {
+    std::unique_ptr<ADFun<CGD> > fun = createTape();
+
+    ModelCSourceGen<double> model(*fun, "model");
+    model.setCreateForwardZero(true);
+    model.setCreateSparseJacobian(true);
+    model.setCreateSparseHessian(true);
+
+    ModelLibraryCSourceGen<double> libSrc(model);
+    libSrc.setSharedHeader(true);
+
+    DynamicModelLibraryProcessor<double> p(libSrc, "cppad_cg_shared_header");
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    std::unique_ptr<DynamicLib<double> > lib = p.createDynamicLibrary(compiler);
+    std::unique_ptr<GenericModel<double> > m = lib->model("model");
+
+    std::vector<double> x{0.5, 1.5, 2.5};
+    std::vector<double> y = m->ForwardZero(x);
+    ASSERT_NEAR(y[0], x[0] * x[1] + std::exp(x[2]), 1e-12);
+    ASSERT_NEAR(y[1], std::sin(x[0]) / x[2], 1e-12);
+
+    std::vector<double> jac;
+    std::vector<size_t> rows, cols;
+    m->SparseJacobian(x, jac, rows, cols);
+    ASSERT_EQ(jac.size(), 5u);
+
+    // the shared header was removed
+    ASSERT_FALSE(system::isFile(system::createPath(compiler.getTemporaryFolder(),
+                                                   ModelLibraryCSourceGen<double>::FILE_SHARED_HEADER)));
+}
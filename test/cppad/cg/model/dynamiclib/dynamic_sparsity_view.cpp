@@ -0,0 +1,161 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+typedef CG<double> CGD;
+typedef AD<CGD> ADCGD;
+
+std::unique_ptr<ADFun<CGD> > createTape() {
+    std::vector<ADCGD> x(4);
+    for (size_t j = 0; j < x.size(); j++)
+        x[j] = 1.0 + j;
+    CppAD::Independent(x);
+
+    std::vector<ADCGD> y(3);
+    y[0] = x[0] * x[3];
+    y[1] = sin(x[1]) + x[2] * x[2];
+    y[2] = x[3] / x[0];
+
+    return std::unique_ptr<ADFun<CGD> >(new ADFun<CGD>(x, y));
+}
+
+}
+
+TEST(CppADCGSparsityViewTest, CsrFromUnorderedCoo) {
+    const unsigned long rows[] = {2, 0, 2, 1, 0};
+    const unsigned long cols[] = {1, 3, 0, 2, 0};
+
+    CooSparsityView coo(3, 4, rows, cols, 5);
+    ASSERT_FALSE(coo.isRowOrdered());
+
+    CsrSparsity csr;
+    csr.build(coo);
+    CsrSparsityView v = csr.view();
+    ASSERT_EQ(v.getRowCount(), 3u);
+    ASSERT_EQ(v.nnz(), 5u);
+    ASSERT_EQ(std::vector<size_t>(v.start().begin(), v.start().end()), std::vector<size_t>({0, 2, 3, 5}));
+
+    // same elements (stable order within each row)
+    ASSERT_EQ(std::vector<unsigned long>(v.cols().begin(), v.cols().end()), std::vector<unsigned long>({3, 0, 2, 1, 0}));
+    for (size_t i = 0; i < v.getRowCount(); i++) {
+        for (size_t k = v.start()[i]; k < v.start()[i + 1]; k++) {
+            ASSERT_EQ(rows[v.position(k)], i);
+            ASSERT_EQ(cols[v.position(k)], v.cols()[k]);
+        }
+    }
+    ASSERT_EQ(v.rowCols(1).size(), 1u);
+    ASSERT_EQ(v.rowCols(1)[0], 2u);
+
+    // ordered rows: the column indexes are not copied
+    const unsigned long rows2[] = {0, 0, 2};
+    const unsigned long cols2[] = {1, 3, 0};
+    csr.build(CooSparsityView(3, 4, rows2, cols2, 3));
+    v = csr.view();
+    ASSERT_EQ(v.cols().data(), cols2);
+    ASSERT_EQ(v.position(2), 2u);
+    ASSERT_EQ(v.rowCols(1).size(), 0u);
+}
+
+TEST(CppADCGSparsityViewTest, DynamicLibrary) {
+    std::unique_ptr<ADFun<CGD> > fun = createTape();
+
+    ModelCSourceGen<double> model(*fun, "model");
+    model.setCreateForwardZero(true);
+    model.setCreateSparseJacobian(true);
+    model.setCreateSparseHessian(true);
+    model.setCreateHessianSparsityByEquation(true);
+
+    ModelLibraryCSourceGen<double> libSrc(model);
+
+    DynamicModelLibraryProcessor<double> p(libSrc, "cppad_cg_sparsity_view");
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    std::unique_ptr<DynamicLib<double> > lib = p.createDynamicLibrary(compiler);
+    std::unique_ptr<GenericModel<double> > m = lib->model("model");
+
+    // Jacobian
+    std::vector<size_t> rows, cols;
+    m->JacobianSparsity(rows, cols);
+
+    ArrayView<const unsigned long> rowsView, colsView;
+    m->JacobianSparsity(rowsView, colsView);
+    ASSERT_EQ(std::vector<size_t>(rowsView.begin(), rowsView.end()), rows);
+    ASSERT_EQ(std::vector<size_t>(colsView.begin(), colsView.end()), cols);
+
+    CooSparsityView coo = m->JacobianSparsityCoo();
+    ASSERT_EQ(coo.rows().data(), rowsView.data()); // no copies
+    ASSERT_EQ(coo.getRowCount(), 3u);
+    ASSERT_EQ(coo.getColumnCount(), 4u);
+
+    std::vector<std::set<size_t> > jacSet = m->JacobianSparsitySet();
+    CsrSparsityView csr = m->JacobianSparsityCsr();
+    ASSERT_EQ(csr.nnz(), rows.size());
+    ASSERT_EQ(csr.getRowCount(), jacSet.size());
+    for (size_t i = 0; i < jacSet.size(); i++) {
+        ArrayView<const unsigned long> c = csr.rowCols(i);
+        ASSERT_EQ(std::set<size_t>(c.begin(), c.end()), jacSet[i]);
+    }
+    ASSERT_EQ(m->JacobianSparsityCsr().start().data(), csr.start().data()); // created once
+
+    // the CSR positions map into the compressed Jacobian values
+    std::vector<double> x{0.5, 1.5, 2.5, 3.5};
+    std::vector<double> jac;
+    m->SparseJacobian(x, jac, rows, cols);
+    for (size_t i = 0; i < csr.getRowCount(); i++) {
+        for (size_t k = csr.start()[i]; k < csr.start()[i + 1]; k++) {
+            size_t e = csr.position(k);
+            ASSERT_EQ(rows[e], i);
+            ASSERT_EQ(cols[e], csr.cols()[k]);
+        }
+    }
+
+    // Hessian
+    std::vector<size_t> hrows, hcols;
+    m->HessianSparsity(hrows, hcols);
+    CooSparsityView hcoo = m->HessianSparsityCoo();
+    ASSERT_EQ(std::vector<size_t>(hcoo.rows().begin(), hcoo.rows().end()), hrows);
+    ASSERT_EQ(std::vector<size_t>(hcoo.cols().begin(), hcoo.cols().end()), hcols);
+    ASSERT_EQ(m->HessianSparsityCsr().nnz(), hrows.size());
+
+    for (size_t i = 0; i < 3; i++) {
+        std::vector<std::set<size_t> > hessSet = m->HessianSparsitySet(i);
+        CsrSparsityView hcsr = m->HessianSparsityCsr(i);
+        ASSERT_EQ(hcsr.getRowCount(), 4u);
+        for (size_t j = 0; j < 4; j++) {
+            ArrayView<const unsigned long> c = hcsr.rowCols(j);
+            ASSERT_EQ(std::set<size_t>(c.begin(), c.end()), hessSet[j]);
+        }
+    }
+
+    // dependency propagation in ForwardZero uses the CSR pattern
+    CppAD::vector<bool> vx(4), vy(3);
+    vx[0] = false;
+    vx[1] = true;
+    vx[2] = false;
+    vx[3] = false;
+    vy[0] = vy[1] = vy[2] = false;
+    std::vector<double> ty(3);
+    m->ForwardZero(vx, vy, x, ty);
+    ASSERT_FALSE(vy[0]);
+    ASSERT_TRUE(vy[1]);
+    ASSERT_FALSE(vy[2]);
+}
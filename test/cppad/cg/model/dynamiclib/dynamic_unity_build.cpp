@@ -0,0 +1,174 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+typedef CG<double> CGD;
+typedef AD<CGD> ADCGD;
+
+/**
+ * Provides access to the model sources
+ */
+class ModelLibraryCSourceGenUnity : public ModelLibraryCSourceGen<double> {
+public:
+
+    inline ModelLibraryCSourceGenUnity(ModelCSourceGen<double>& model) :
+        ModelLibraryCSourceGen<double>(model) {
+    }
+
+    inline std::map<std::string, std::string> modelSources(ModelCSourceGen<double>& model) {
+        return getModelSources(model);
+    }
+
+    using ModelLibraryCSourceGen<double>::findStaticSymbols;
+};
+
+std::unique_ptr<ADFun<CGD> > createTape() {
+    std::vector<ADCGD> x(4);
+    for (size_t j = 0; j < x.size(); j++)
+        x[j] = 1.0 + j;
+    CppAD::Independent(x);
+
+    std::vector<ADCGD> y(3);
+    y[0] = x[0] * x[1] + exp(x[2]);
+    y[1] = sin(x[0]) / x[2] + x[3] * x[3];
+    y[2] = x[1] * x[2] * x[3];
+
+    return std::unique_ptr<ADFun<CGD> >(new ADFun<CGD>(x, y));
+}
+
+void setOptions(ModelCSourceGen<double>& model) {
+    model.setCreateForwardZero(true);
+    model.setCreateSparseJacobian(true);
+    model.setCreateSparseHessian(true);
+    model.setCreateForwardOne(true);
+    model.setCreateReverseOne(true);
+    model.setCreateReverseTwo(true);
+}
+
+}
+
+TEST(CppADCGUnityBuildTest, StaticSymbols) {
+    std::vector<std::string> s = ModelLibraryCSourceGenUnity::findStaticSymbols(
+            "static void f(double x) {\n"
+            "  static int notFileScope = 0;\n"
+            "}\n"
+            "static const double values[3] = {1, 2, 3};\n"
+            "static inline int g (int i);\n"
+            "static int counter;\n"
+            "int global = 0;\n");
+    ASSERT_EQ(s, std::vector<std::string>({"f", "values", "g", "counter"}));
+}
+
+TEST(CppADCGUnityBuildTest, Sources) {
+    std::unique_ptr<ADFun<CGD> > fun = createTape();
+
+    // the sources of a model without unity files
+    ModelCSourceGen<double> model0(*fun, "model");
+    setOptions(model0);
+
+    ModelLibraryCSourceGenUnity libSrc0(model0);
+    const std::map<std::string, std::string> original = libSrc0.modelSources(model0);
+    ASSERT_GT(original.size(), 3u);
+
+    ModelCSourceGen<double> model(*fun, "model");
+    setOptions(model);
+
+    ModelLibraryCSourceGenUnity libSrc(model);
+    libSrc.setUnityUnits(3);
+    ASSERT_EQ(libSrc.getUnityUnits(), 3u);
+    std::map<std::string, std::string> units = libSrc.modelSources(model);
+    ASSERT_EQ(units.size(), 3u);
+
+    // all the files are used once
+    for (const auto& it : original) {
+        size_t n = 0;
+        for (const auto& u : units) {
+            if (u.second.find("#line 1 \"" + it.first + "\"\n") != std::string::npos)
+                n++;
+        }
+        ASSERT_EQ(n, 1u) << it.first;
+    }
+
+    for (const auto& u : units) {
+        ASSERT_EQ(u.first.compare(0, 11, "model_unity"), 0) << u.first;
+        // the shared declarations are only included once
+        const std::string& src = u.second;
+        size_t pos = src.find("struct LangCAtomicFun {");
+        ASSERT_NE(pos, std::string::npos) << u.first;
+        ASSERT_EQ(src.find("struct LangCAtomicFun {", pos + 1), std::string::npos) << u.first;
+    }
+
+    // deterministic
+    ASSERT_EQ(libSrc.modelSources(model), units);
+
+    // more units than files
+    libSrc.setUnityUnits(1000);
+    ASSERT_EQ(libSrc.modelSources(model).size(), original.size());
+
+    // shared header
+    libSrc.setUnityUnits(2);
+    libSrc.setSharedHeader(true);
+    const std::string include = "#include \"" + ModelLibraryCSourceGen<double>::FILE_SHARED_HEADER + "\"\n";
+    units = libSrc.modelSources(model);
+    ASSERT_EQ(units.size(), 2u);
+    for (const auto& u : units) {
+        ASSERT_EQ(u.second.compare(0, include.size(), include), 0) << u.first;
+        ASSERT_EQ(u.second.find(include, 1), std::string::npos) << u.first;
+        ASSERT_EQ(u.second.find("struct LangCAtomicFun {"), std::string::npos) << u.first;
+    }
+}
+
+TEST(CppADCGUnityBuildTest, DynamicLibrary) {
+    std::unique_ptr<ADFun<CGD> > fun = createTape();
+
+    ModelCSourceGen<double> model(*fun, "model");
+    setOptions(model);
+    model.setMultiThreading(true);
+
+    ModelLibraryCSourceGen<double> libSrc(model);
+    libSrc.setMultiThreading(MultiThreadingType::PTHREADS);
+    libSrc.setUnityUnits(2);
+
+    DynamicModelLibraryProcessor<double> p(libSrc, "cppad_cg_unity_build");
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+    compiler.setCompileThreads(2);
+    ASSERT_EQ(compiler.getCompileThreads(), 2u);
+
+    std::unique_ptr<DynamicLib<double> > lib = p.createDynamicLibrary(compiler);
+    std::unique_ptr<GenericModel<double> > m = lib->model("model");
+
+    std::vector<double> x{0.5, 1.5, 2.5, 3.5};
+    std::vector<double> y = m->ForwardZero(x);
+    ASSERT_NEAR(y[0], x[0] * x[1] + std::exp(x[2]), 1e-12);
+    ASSERT_NEAR(y[1], std::sin(x[0]) / x[2] + x[3] * x[3], 1e-12);
+    ASSERT_NEAR(y[2], x[1] * x[2] * x[3], 1e-12);
+
+    std::vector<double> jac;
+    std::vector<size_t> rows, cols;
+    m->SparseJacobian(x, jac, rows, cols);
+    ASSERT_EQ(jac.size(), 9u);
+
+    std::vector<double> w{1.0, 2.0, 3.0};
+    std::vector<double> hess;
+    m->SparseHessian(x, w, hess, rows, cols);
+    ASSERT_FALSE(hess.empty());
+}
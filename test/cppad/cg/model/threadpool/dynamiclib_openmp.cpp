@@ -13,6 +13,7 @@
  * Author: Joao Leal
  */
 #include "CppADCGDynamicTest.hpp"
+#include <omp.h>
 
 namespace CppAD {
 namespace cg {
@@ -53,6 +54,64 @@ public:
         return y;
     }
 
+    /**
+     * Creates a library with a multithreaded sparse Jacobian and sparse
+     * Hessian
+     */
+    std::unique_ptr<DynamicLib<double> > createLibrary(ADFun<CGD>& fun,
+                                                       const std::string& libName) {
+        ModelCSourceGen<double> compHelp(fun, _name + "omp");
+        compHelp.setCreateSparseJacobian(true);
+        compHelp.setCreateSparseHessian(true);
+        compHelp.setCreateReverseOne(true);
+        compHelp.setCreateReverseTwo(true);
+        compHelp.setMultiThreading(true);
+
+        ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+        compDynHelp.setMultiThreading(MultiThreadingType::OPENMP);
+
+        DynamicModelLibraryProcessor<double> p(compDynHelp, libName);
+        GccCompiler<double> compiler;
+        prepareTestCompilerFlags(compiler);
+        compiler.addCompileFlag("-fopenmp");
+        compiler.addCompileFlag("-pthread");
+        compiler.addCompileLibFlag("-fopenmp");
+
+#ifdef CPPAD_CG_SYSTEM_LINUX
+        // this is required because the OpenMP implementation in GCC causes a segmentation fault on dlclose
+        p.getOptions()["dlOpenMode"] = std::to_string(RTLD_NOW | RTLD_NODELETE);
+#endif
+
+        std::unique_ptr<DynamicLib<double> > dynamicLib = p.createDynamicLibrary(compiler);
+        dynamicLib->setThreadPoolVerbose(this->verbose_);
+        dynamicLib->setThreadNumber(2);
+        return dynamicLib;
+    }
+
+    /**
+     * Determines the sparse Jacobian and the sparse Hessian with CppAD
+     */
+    void sparseReference(ADFun<CGD>& fun,
+                         const std::vector<double>& w,
+                         const std::vector<size_t>& jacRow, const std::vector<size_t>& jacCol,
+                         const std::vector<size_t>& hessRow, const std::vector<size_t>& hessCol,
+                         std::vector<double>& jac,
+                         std::vector<double>& hess) {
+        size_t n = fun.Domain();
+        std::vector<CGD> x2(x.begin(), x.end());
+        std::vector<CGD> w2(w.begin(), w.end());
+
+        std::vector<CGD> jacDense = fun.Jacobian(x2);
+        jac.resize(jacRow.size());
+        for (size_t e = 0; e < jacRow.size(); e++)
+            jac[e] = jacDense[jacRow[e] * n + jacCol[e]].getValue();
+
+        std::vector<CGD> hessDense = fun.Hessian(x2, w2);
+        hess.resize(hessRow.size());
+        for (size_t e = 0; e < hessRow.size(); e++)
+            hess[e] = hessDense[hessRow[e] * n + hessCol[e]].getValue();
+    }
+
 };
 
 } // END cg namespace
@@ -146,4 +205,131 @@ TEST_F(CppADCGOpenMPTest, DynamicCustomElements) {
     this->_denseHessian = false;
 
     this->testDynamicCustomElements(u, x, jacRow, jacCol, hessRow, hessCol);
-}
\ No newline at end of file
+}
+
+TEST_F(CppADCGOpenMPTest, NestedParallelRegion) {
+    std::vector<ADCGD> ux(u.size());
+    for (size_t j = 0; j < ux.size(); j++)
+        ux[j] = x[j];
+    CppAD::Independent(ux);
+    std::vector<ADCGD> uy = model(ux);
+    ADFun<CG<double> > fun(ux, uy);
+
+    std::vector<double> w(uy.size(), 1.0);
+
+    std::unique_ptr<DynamicLib<double> > lib = createLibrary(fun, "cppad_cg_openmp_nested");
+
+    std::vector<size_t> jacRow, jacCol, hessRow, hessCol;
+    std::vector<double> jac, hess;
+    std::unique_ptr<GenericModel<double> > compiled = lib->model(_name + "omp");
+    compiled->SparseJacobian(x, jac, jacRow, jacCol);
+    compiled->SparseHessian(x, w, hess, hessRow, hessCol);
+
+    std::vector<double> jacRef, hessRef;
+    sparseReference(fun, w, jacRow, jacCol, hessRow, hessCol, jacRef, hessRef);
+
+    // models hold evaluation buffers: one for each thread
+    const int nThreads = 2;
+    std::vector<std::unique_ptr<GenericModel<double> > > models(nThreads);
+    for (auto& m : models) {
+        m = lib->model(_name + "omp");
+        ASSERT_TRUE(m != nullptr);
+    }
+
+    for (auto s : {ThreadPoolScheduleStrategy::STATIC, ThreadPoolScheduleStrategy::DYNAMIC, ThreadPoolScheduleStrategy::GUIDED}) {
+        lib->setThreadPoolSchedulerStrategy(s);
+
+        // called outside a parallel region
+        ASSERT_TRUE(compareValues<double>(compiled->SparseJacobian(x), jacRef));
+        ASSERT_TRUE(compareValues<double>(compiled->SparseHessian(x, w), hessRef));
+
+        // called by every thread of an enclosing parallel region
+        std::vector<std::vector<double> > jacs(nThreads), hessians(nThreads);
+        std::vector<int> inParallel(nThreads, 0);
+
+#pragma omp parallel num_threads(nThreads)
+        {
+            int t = omp_get_thread_num();
+            inParallel[t] = omp_in_parallel();
+            jacs[t] = models[t]->SparseJacobian(x);
+            hessians[t] = models[t]->SparseHessian(x, w);
+        }
+
+        for (int t = 0; t < nThreads; t++) {
+            ASSERT_EQ(inParallel[t], 1);
+            ASSERT_TRUE(compareValues<double>(jacs[t], jacRef));
+            ASSERT_TRUE(compareValues<double>(hessians[t], hessRef));
+        }
+    }
+}
+
+TEST_F(CppADCGOpenMPTest, TimeMeasurements) {
+    std::vector<ADCGD> ux(u.size());
+    for (size_t j = 0; j < ux.size(); j++)
+        ux[j] = x[j];
+    CppAD::Independent(ux);
+    std::vector<ADCGD> uy = model(ux);
+    ADFun<CG<double> > fun(ux, uy);
+
+    std::unique_ptr<DynamicLib<double> > lib = createLibrary(fun, "cppad_cg_openmp_meas");
+    std::unique_ptr<GenericModel<double> > compiled = lib->model(_name + "omp");
+    lib->setThreadPoolSchedulerStrategy(ThreadPoolScheduleStrategy::DYNAMIC);
+    lib->setThreadPoolVerbose(true); // the new job order is only printed in verbose mode
+
+    auto countUpdates = [](const std::string& out) {
+        size_t n = 0;
+        for (size_t pos = out.find("new order ("); pos != std::string::npos; pos = out.find("new order (", pos + 1))
+            n++;
+        return n;
+    };
+
+    const std::string& jacFunction = ModelCSourceGen<double>::FUNCTION_SPARSE_REVERSE_ONE;
+    ThreadPoolJobProfile profile0 = compiled->getThreadPoolJobProfile();
+    ASSERT_TRUE(profile0.find(jacFunction) != nullptr);
+
+    // no measurements: the order and the reference times are not changed
+    lib->setThreadPoolNumberOfTimeMeas(0);
+    testing::internal::CaptureStdout();
+    for (size_t r = 0; r < 5; r++)
+        compiled->SparseJacobian(x);
+    std::string out = testing::internal::GetCapturedStdout();
+
+    ASSERT_EQ(countUpdates(out), 0u);
+    const std::vector<ThreadPoolJobProfile::Job>& jobs0 = *profile0.find(jacFunction);
+    const std::vector<ThreadPoolJobProfile::Job>& jobs1 = *compiled->getThreadPoolJobProfile().find(jacFunction);
+    ASSERT_EQ(jobs1.size(), jobs0.size());
+    for (size_t j = 0; j < jobs0.size(); j++)
+        ASSERT_EQ(jobs1[j].elapsed, jobs0[j].elapsed);
+
+    // the order is updated by the first nMeas calls
+    const unsigned int nMeas = 3;
+    lib->setThreadPoolNumberOfTimeMeas(nMeas);
+    testing::internal::CaptureStdout();
+    for (size_t r = 0; r < 5; r++)
+        compiled->SparseJacobian(x);
+    out = testing::internal::GetCapturedStdout();
+
+    ASSERT_EQ(countUpdates(out), size_t(nMeas));
+
+    // the last order starts with the jobs with the longest reference time
+    ThreadPoolJobProfile profile = compiled->getThreadPoolJobProfile();
+    const std::vector<ThreadPoolJobProfile::Job>& jobs = *profile.find(jacFunction);
+    std::vector<int> order(jobs.size(), -1);
+    std::istringstream lines(out.substr(out.rfind("new order (")));
+    std::string line;
+    std::getline(lines, line);
+    for (size_t j = 0; j < jobs.size() && std::getline(lines, line); j++) {
+        int id, pos;
+        ASSERT_EQ(sscanf(line.c_str(), " job id: %i order: %i", &id, &pos), 2);
+        ASSERT_LT(size_t(id), jobs.size());
+        order[id] = pos;
+    }
+
+    for (size_t a = 0; a < jobs.size(); a++) {
+        ASSERT_GE(order[a], 0);
+        for (size_t b = 0; b < jobs.size(); b++) {
+            if (jobs[a].elapsed > jobs[b].elapsed)
+                ASSERT_LT(order[a], order[b]);
+        }
+    }
+}
@@ -53,6 +53,37 @@ public:
         return y;
     }
 
+    /**
+     * Creates a library with a multithreaded sparse Jacobian and sparse
+     * Hessian
+     */
+    std::unique_ptr<DynamicLib<double> > createLibrary(ADFun<CGD>& fun,
+                                                       const ThreadPoolJobProfile& profile,
+                                                       size_t nJobs,
+                                                       const std::string& libName) {
+        ModelCSourceGen<double> compHelp(fun, _name + "profile");
+        compHelp.setCreateSparseJacobian(true);
+        compHelp.setCreateSparseHessian(true);
+        compHelp.setCreateReverseOne(true);
+        compHelp.setCreateReverseTwo(true);
+        compHelp.setMultiThreading(true);
+        compHelp.setMultiThreadingJobCount(nJobs);
+        compHelp.setThreadPoolJobProfile(profile);
+
+        ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+        compDynHelp.setMultiThreading(MultiThreadingType::PTHREADS);
+
+        DynamicModelLibraryProcessor<double> p(compDynHelp, libName);
+        GccCompiler<double> compiler;
+        prepareTestCompilerFlags(compiler);
+        compiler.addCompileFlag("-pthread");
+
+        std::unique_ptr<DynamicLib<double> > dynamicLib = p.createDynamicLibrary(compiler);
+        dynamicLib->setThreadPoolVerbose(this->verbose_);
+        dynamicLib->setThreadNumber(2);
+        return dynamicLib;
+    }
+
 };
 
 } // END cg namespace
@@ -109,6 +140,19 @@ TEST_F(CppADCGThreadPoolTest, StaticFullVars) {
     this->testDynamicFull(u, x, 1000);
 }
 
+TEST_F(CppADCGThreadPoolTest, StaticPinnedFullVars) {
+    this->_multithreadDisabled = false;
+    this->_multithreadScheduler = ThreadPoolScheduleStrategy::STATIC;
+    this->_multithreadAffinity = ThreadPoolAffinity::NUMA_NODE;
+
+    this->_reverseOne = true;
+    this->_reverseTwo = true;
+    this->_denseJacobian = false;
+    this->_denseHessian = false;
+
+    this->testDynamicFull(u, x, 1000);
+}
+
 TEST_F(CppADCGThreadPoolTest, DynamicCustomElements) {
     this->_multithreadScheduler = ThreadPoolScheduleStrategy::DYNAMIC;
 
@@ -132,4 +176,109 @@ TEST_F(CppADCGThreadPoolTest, DynamicCustomElements) {
     this->_denseHessian = false;
 
     this->testDynamicCustomElements(u, x, jacRow, jacCol, hessRow, hessCol);
-}
\ No newline at end of file
+}
+
+TEST_F(CppADCGThreadPoolTest, SharedHeaderFullVars) {
+    this->_multithreadDisabled = false;
+    this->_multithreadScheduler = ThreadPoolScheduleStrategy::DYNAMIC;
+    this->_sharedHeader = true;
+
+    this->_reverseOne = true;
+    this->_reverseTwo = true;
+    this->_denseJacobian = false;
+    this->_denseHessian = false;
+
+    this->testDynamicFull(u, x, 1000);
+}
+
+TEST_F(CppADCGThreadPoolTest, GroupedJobsFullVars) {
+    this->_multithreadDisabled = false;
+    this->_multithreadScheduler = ThreadPoolScheduleStrategy::DYNAMIC;
+    this->_multithreadJobs = 2;
+
+    this->_reverseOne = true;
+    this->_reverseTwo = true;
+    this->_denseJacobian = false;
+    this->_denseHessian = false;
+
+    this->testDynamicFull(u, x, 1000);
+}
+
+TEST_F(CppADCGThreadPoolTest, GroupedJobsCustomElements) {
+    this->_multithreadScheduler = ThreadPoolScheduleStrategy::GUIDED;
+    this->_multithreadJobs = 2;
+
+    std::vector<size_t> jacRow{0, 1, 1, 3, 5};
+    std::vector<size_t> jacCol{0, 0, 2, 4, 6};
+
+    std::vector<size_t> hessRow{0, 2, 6};
+    std::vector<size_t> hessCol{0, 1, 6};
+
+    this->_reverseOne = true;
+    this->_reverseTwo = true;
+    this->_denseJacobian = false;
+    this->_denseHessian = false;
+
+    this->testDynamicCustomElements(u, x, jacRow, jacCol, hessRow, hessCol);
+}
+
+TEST_F(CppADCGThreadPoolTest, JobProfile) {
+    std::vector<ADCGD> ux(u.size());
+    for (size_t j = 0; j < ux.size(); j++)
+        ux[j] = x[j];
+    CppAD::Independent(ux);
+    std::vector<ADCGD> uy = model(ux);
+    ADFun<CG<double> > fun(ux, uy);
+
+    std::vector<double> w(uy.size(), 1.0);
+
+    std::vector<double> jac0, hess0;
+    ThreadPoolJobProfile profile;
+    {
+        std::unique_ptr<DynamicLib<double> > lib = createLibrary(fun, ThreadPoolJobProfile(), 0, "cppad_cg_profile1");
+        std::unique_ptr<GenericModel<double> > compiled = lib->model(_name + "profile");
+
+        for (size_t r = 0; r < 20; r++) {
+            jac0 = compiled->SparseJacobian(x);
+            hess0 = compiled->SparseHessian(x, w);
+        }
+
+        profile = compiled->getThreadPoolJobProfile();
+    }
+
+    // a job for each Jacobian row and for each Hessian row
+    const std::vector<ThreadPoolJobProfile::Job>* jacJobs = profile.find(ModelCSourceGen<double>::FUNCTION_SPARSE_REVERSE_ONE);
+    ASSERT_TRUE(jacJobs != nullptr);
+    ASSERT_EQ(jacJobs->size(), 6u);
+    for (size_t i = 0; i < jacJobs->size(); i++) {
+        ASSERT_EQ((*jacJobs)[i].keys, std::vector<size_t>{i});
+        ASSERT_GE((*jacJobs)[i].elapsed, 0);
+    }
+    ASSERT_TRUE(profile.find(ModelCSourceGen<double>::FUNCTION_SPARSE_REVERSE_TWO) != nullptr);
+
+    profile.write("cppad_cg_profile.txt");
+    ThreadPoolJobProfile loaded;
+    ASSERT_TRUE(loaded.read("cppad_cg_profile.txt"));
+    ASSERT_EQ(loaded.getFunctions().size(), profile.getFunctions().size());
+    ASSERT_EQ(loaded.find(ModelCSourceGen<double>::FUNCTION_SPARSE_REVERSE_ONE)->size(), 6u);
+    remove("cppad_cg_profile.txt");
+
+    // the profile guides how the rows are grouped
+    std::unique_ptr<DynamicLib<double> > lib = createLibrary(fun, loaded, 2, "cppad_cg_profile2");
+    std::unique_ptr<GenericModel<double> > compiled = lib->model(_name + "profile");
+
+    std::vector<double> jac = compiled->SparseJacobian(x);
+    std::vector<double> hess = compiled->SparseHessian(x, w);
+    ASSERT_TRUE(compareValues<double>(jac, jac0));
+    ASSERT_TRUE(compareValues<double>(hess, hess0));
+
+    ThreadPoolJobProfile profile2 = compiled->getThreadPoolJobProfile();
+    jacJobs = profile2.find(ModelCSourceGen<double>::FUNCTION_SPARSE_REVERSE_ONE);
+    ASSERT_TRUE(jacJobs != nullptr);
+    ASSERT_EQ(jacJobs->size(), 2u);
+
+    std::set<size_t> rows;
+    for (const auto& job : *jacJobs)
+        rows.insert(job.keys.begin(), job.keys.end());
+    ASSERT_EQ(rows.size(), 6u);
+}
@@ -14,6 +14,7 @@
  */
 #include <stdlib.h>
 #include <math.h>
+#include <pthread.h>
 #include <cppad/cg/model/threadpool/pthread_pool.h>
 #include "CppADCGTest.hpp"
 
@@ -251,4 +252,146 @@ TEST_F(PThreadPoolTest, StaticJac) {
     pooldynamic_sparse_jacobian(in.data(), out.data(), atomicFun); // reuse previous work group schedule
 
     ASSERT_TRUE(compareValues(jac, out0));
-}
\ No newline at end of file
+}
+TEST_F(PThreadPoolTest, WaitPolicies) {
+    const float spinTimes[] = {0, 20e-6f};
+
+    for (float spin : spinTimes) {
+        for (int caller = 0; caller < 2; ++caller) {
+            for (ScheduleStrategy s : {SCHED_STATIC, SCHED_DYNAMIC, SCHED_GUIDED}) {
+                cppadcg_thpool_set_spin_time(spin);
+                cppadcg_thpool_set_caller_executes(caller);
+                cppadcg_thpool_set_scheduler_strategy(s);
+                ASSERT_EQ(cppadcg_thpool_get_spin_time(), spin);
+                ASSERT_EQ(cppadcg_thpool_is_caller_executes(), caller);
+
+                std::fill(out0.begin(), out0.end(), 0.0);
+                for (int i = 0; i < 10; ++i) {
+                    pooldynamic_sparse_jacobian(in.data(), out.data(), atomicFun);
+                }
+
+                ASSERT_TRUE(compareValues(jac, out0));
+            }
+        }
+    }
+
+    cppadcg_thpool_set_spin_time(20e-6f);
+    cppadcg_thpool_set_caller_executes(1);
+}
+
+namespace {
+
+const int N_STABLE_JOBS = 8;
+pthread_t stableJobThreads[N_STABLE_JOBS];
+
+void stableJob(void* arg) {
+    int j = *static_cast<int*> (arg);
+    stableJobThreads[j] = pthread_self();
+}
+
+}
+
+TEST_F(PThreadPoolTest, StaticStableMapping) {
+    cppadcg_thpool_set_threads(4);
+    cppadcg_thpool_set_affinity(THREAD_AFFINITY_CORE);
+    cppadcg_thpool_set_scheduler_strategy(SCHED_STATIC);
+    ASSERT_EQ(cppadcg_thpool_get_affinity(), THREAD_AFFINITY_CORE);
+
+    cppadcg_thpool_function_type functions[N_STABLE_JOBS];
+    int ids[N_STABLE_JOBS];
+    void* args[N_STABLE_JOBS];
+    float refElapsed[N_STABLE_JOBS];
+    int order[N_STABLE_JOBS];
+    int job2Thread[N_STABLE_JOBS];
+    for (int j = 0; j < N_STABLE_JOBS; ++j) {
+        functions[j] = stableJob;
+        ids[j] = j;
+        args[j] = &ids[j];
+        refElapsed[j] = 0; // no timing information
+        order[j] = j;
+        job2Thread[j] = -1;
+    }
+
+    std::vector<pthread_t> first;
+    for (int call = 0; call < 5; ++call) {
+        cppadcg_thpool_add_jobs(functions, args, refElapsed, nullptr, order, job2Thread, N_STABLE_JOBS, call == 0);
+        cppadcg_thpool_wait();
+
+        for (int j = 0; j < N_STABLE_JOBS; ++j) {
+            ASSERT_TRUE(job2Thread[j] >= 0 && job2Thread[j] < 4);
+        }
+
+        if (call == 0) {
+            first.assign(stableJobThreads, stableJobThreads + N_STABLE_JOBS);
+        } else {
+            for (int j = 0; j < N_STABLE_JOBS; ++j) {
+                ASSERT_TRUE(pthread_equal(first[j], stableJobThreads[j]));
+            }
+        }
+    }
+
+    // jobs with the same thread were executed by the same pthread
+    for (int j = 1; j < N_STABLE_JOBS; ++j) {
+        ASSERT_EQ(job2Thread[j] == job2Thread[0], bool(pthread_equal(first[j], first[0])));
+    }
+
+    cppadcg_thpool_set_affinity(THREAD_AFFINITY_NONE);
+    cppadcg_thpool_set_threads(2);
+}
+
+namespace {
+
+const int N_ORDER_JOBS = 6;
+int orderJobsExecuted[N_ORDER_JOBS];
+int nOrderJobsExecuted = 0;
+
+void orderJob(void* arg) {
+    // only one thread executes jobs
+    orderJobsExecuted[nOrderJobsExecuted++] = *static_cast<int*> (arg);
+}
+
+}
+
+TEST_F(PThreadPoolTest, JobOrder) {
+    cppadcg_thpool_set_threads(1);
+    cppadcg_thpool_set_caller_executes(0);
+    cppadcg_thpool_set_scheduler_strategy(SCHED_DYNAMIC);
+
+    cppadcg_thpool_function_type functions[N_ORDER_JOBS];
+    int ids[N_ORDER_JOBS];
+    void* args[N_ORDER_JOBS];
+    float refElapsed[N_ORDER_JOBS];
+    const float elapsed[N_ORDER_JOBS] = {1e-3f, 5e-3f, 2e-3f, 6e-3f, 3e-3f, 4e-3f};
+    int order[N_ORDER_JOBS] = {3, 0, 5, 1, 4, 2}; // the position of each job
+    for (int j = 0; j < N_ORDER_JOBS; ++j) {
+        functions[j] = orderJob;
+        ids[j] = j;
+        args[j] = &ids[j];
+        refElapsed[j] = 0;
+    }
+
+    nOrderJobsExecuted = 0;
+    cppadcg_thpool_add_jobs(functions, args, refElapsed, nullptr, order, nullptr, N_ORDER_JOBS, 1);
+    cppadcg_thpool_wait();
+
+    ASSERT_EQ(nOrderJobsExecuted, N_ORDER_JOBS);
+    for (int j = 0; j < N_ORDER_JOBS; ++j) {
+        ASSERT_EQ(orderJobsExecuted[order[j]], j);
+    }
+
+    // the longest jobs start first
+    cppadcg_thpool_update_order(refElapsed, 0, elapsed, order, N_ORDER_JOBS);
+
+    nOrderJobsExecuted = 0;
+    cppadcg_thpool_add_jobs(functions, args, refElapsed, nullptr, order, nullptr, N_ORDER_JOBS, 1);
+    cppadcg_thpool_wait();
+
+    const int expected[N_ORDER_JOBS] = {3, 1, 5, 4, 2, 0};
+    ASSERT_EQ(nOrderJobsExecuted, N_ORDER_JOBS);
+    for (int i = 0; i < N_ORDER_JOBS; ++i) {
+        ASSERT_EQ(orderJobsExecuted[i], expected[i]);
+    }
+
+    cppadcg_thpool_set_caller_executes(1);
+    cppadcg_thpool_set_threads(2);
+}
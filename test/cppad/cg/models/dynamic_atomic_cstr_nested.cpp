@@ -232,6 +232,39 @@ TEST_F(CppADCGDynamicAtomicCstrNestedTest, AtomicLibModelBridge) {
     this->testAtomicLibModelBridge(xOuter, xInner, xNorm, eqNorm, 1e-14, 1e-13);
 }
 
+TEST_F(CppADCGDynamicAtomicCstrNestedTest, AtomicLibModelBridgeDirectCalls) {
+    this->directModelCalls = true;
+    this->testAtomicLibModelBridge(xOuter, xInner, xNorm, eqNorm, 1e-14, 1e-13);
+
+    /**
+     * the outer model must call the inner model without LangCAtomicFun
+     */
+    const std::string& inner = _modelName;
+    bool directForward = false;
+    bool directReverse = false;
+    for (const auto& it : _outerModelSources) {
+        const std::string& source = it.second;
+        ASSERT_EQ(source.find("atomicFun.forward("), std::string::npos) << it.first;
+        ASSERT_EQ(source.find("atomicFun.reverse("), std::string::npos) << it.first;
+        directForward |= source.find(inner + "_" + LanguageC<double>::ATOMIC_DIRECT_FORWARD + "(atomicFun, ") != std::string::npos;
+        directReverse |= source.find(inner + "_" + LanguageC<double>::ATOMIC_DIRECT_REVERSE + "(atomicFun, ") != std::string::npos;
+    }
+    ASSERT_TRUE(directForward);
+    ASSERT_TRUE(directReverse);
+
+    /**
+     * the direct calls must use the functions of the inner model
+     * (not only the fallback to the external function)
+     */
+    auto itDirect = _librarySources.find(ModelLibraryCSourceGen<double>::FILE_DIRECT_MODEL_CALLS + ".c");
+    ASSERT_TRUE(itDirect != _librarySources.end());
+    const std::string& direct = itDirect->second;
+    ASSERT_NE(direct.find(inner + "_" + ModelCSourceGen<double>::FUNCTION_FORWAD_ZERO + "(in, out, atomicFun);"), std::string::npos);
+    ASSERT_NE(direct.find(inner + "_" + ModelCSourceGen<double>::FUNCTION_SPARSE_FORWARD_ONE + "(j, in, out, atomicFun)"), std::string::npos);
+    ASSERT_NE(direct.find(inner + "_" + ModelCSourceGen<double>::FUNCTION_SPARSE_REVERSE_ONE + "(i, in, out, atomicFun)"), std::string::npos);
+    ASSERT_NE(direct.find(inner + "_" + ModelCSourceGen<double>::FUNCTION_SPARSE_REVERSE_TWO + "(i, in, out, atomicFun)"), std::string::npos);
+}
+
 TEST_F(CppADCGDynamicAtomicCstrNestedTest, AtomicLibModelBridgeCustomRev2) {
     this->testAtomicLibModelBridgeCustom(xOuter, xInner, xNorm, eqNorm,
                                          jacInner, hessInner,
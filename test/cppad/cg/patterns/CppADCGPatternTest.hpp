@@ -21,6 +21,19 @@
 namespace CppAD {
 namespace cg {
 
+/**
+ * Provides access to the generated model sources
+ */
+class CppADCGPatternLibraryCSourceGen : public ModelLibraryCSourceGen<double> {
+public:
+
+    inline CppADCGPatternLibraryCSourceGen(ModelCSourceGen<double>& model) :
+        ModelLibraryCSourceGen<double>(model) {
+    }
+
+    using ModelLibraryCSourceGen<double>::getModelSources;
+};
+
 class CppADCGPatternTest : public CppADCGTest {
 public:
     typedef double Base;
@@ -31,6 +44,8 @@ protected:
     bool testZeroOrder_;
     bool testJacobian_;
     bool testHessian_;
+    bool vectorizeLoops_;
+    bool packLoopArrays_;
     std::vector<Base> xNorm_;
     std::vector<Base> eqNorm_;
     std::vector<atomic_base<Base>*> atoms_;
@@ -40,6 +55,8 @@ protected:
     Base hessianEpsilonR_;
     std::vector<std::set<size_t> > customJacSparsity_;
     std::vector<std::set<size_t> > customHessSparsity_;
+    // the sources of the models with loops created by testSourceCodeGen()
+    std::vector<std::string> loopSources_;
 private:
     std::unique_ptr<DefaultPatternTestModel<CG<Base> > > modelMem_;
 public:
@@ -50,6 +67,8 @@ public:
         testZeroOrder_(true),
         testJacobian_(true),
         testHessian_(true),
+        vectorizeLoops_(false),
+        packLoopArrays_(false),
         epsilonA_(std::numeric_limits<Base>::epsilon() * 1e2),
         epsilonR_(std::numeric_limits<Base>::epsilon() * 1e2),
         hessianEpsilonA_(std::numeric_limits<Base>::epsilon() * 1e2),
@@ -184,6 +203,38 @@ public:
 
     }
 
+    /**
+     * Counts the loops marked with '#pragma omp simd' in the sources of
+     * the models with loops
+     *
+     * @param bodyText only count the loops whose body contains this text
+     */
+    size_t countSimdLoops(const std::string& bodyText = "") const {
+        const std::string pragma = "#pragma omp simd";
+        size_t n = 0;
+        for (const std::string& src : loopSources_) {
+            for (size_t p = src.find(pragma); p != std::string::npos; p = src.find(pragma, p + 1)) {
+                // the body of the for loop after the directive
+                size_t start = src.find('{', p);
+                if (start == std::string::npos)
+                    continue;
+                size_t end = start;
+                size_t depth = 0;
+                for (; end < src.size(); end++) {
+                    if (src[end] == '{') {
+                        depth++;
+                    } else if (src[end] == '}' && --depth == 0) {
+                        break;
+                    }
+                }
+                if (bodyText.empty() || src.substr(start, end - start).find(bodyText) != std::string::npos) {
+                    n++;
+                }
+            }
+        }
+        return n;
+    }
+
     ADFun<CGD>* tapeModel(size_t repeat,
                           const std::vector<Base>& xb) {
         /**
@@ -400,6 +451,8 @@ public:
         compHelpL.setRelatedDependents(relatedDepCandidates);
         compHelpL.setTypicalIndependentValues(xTypical);
         compHelpL.setParameterPrecision(std::numeric_limits<Base>::digits10 + 4);
+        compHelpL.setVectorizeLoops(vectorizeLoops_);
+        compHelpL.setPackLoopArrays(packLoopArrays_);
 
         if (!customJacSparsity_.empty())
             compHelpL.setCustomSparseJacobianElements(customJacSparsity_);
@@ -409,16 +462,20 @@ public:
 
         GccCompiler<double> compiler;
         prepareTestCompilerFlags(compiler);
+        if (vectorizeLoops_)
+            compiler.addCompileFlag("-fopenmp-simd");
         compiler.setSourcesFolder("sources_" + libBaseName);
         compiler.setSaveToDiskFirst(true);
 
-        ModelLibraryCSourceGen<double> compDynHelpL(compHelpL);
+        CppADCGPatternLibraryCSourceGen compDynHelpL(compHelpL);
         compDynHelpL.setVerbose(this->verbose_);
 
         //SaveFilesModelLibraryProcessor<double>::saveLibrarySourcesTo(compDynHelpL, "sources_" + libBaseName);
 
         DynamicModelLibraryProcessor<double> p(compDynHelpL, libBaseName + "Loops");
         std::unique_ptr<DynamicLib<double> > dynamicLibL = p.createDynamicLibrary(compiler);
+        for (const auto& it : compDynHelpL.getModelSources(compHelpL))
+            loopSources_.push_back(it.second);
         std::unique_ptr<GenericModel<double> > modelL;
         if (loadModels) {
             modelL = dynamicLibL->model(libBaseName + "Loops");
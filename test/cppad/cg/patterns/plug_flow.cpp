@@ -93,4 +93,21 @@ TEST_F(CppADCGPatternPlugFlowTest, plugflow) {
     this->useCustomSparsity_ = true;
 
     this->test(nEls);
-}
\ No newline at end of file
+}
+
+/**
+ * @test test vectorized loops whose strided values are packed into
+ *       contiguous arrays (structure of arrays) for the plug flow model
+ */
+TEST_F(CppADCGPatternPlugFlowTest, plugflowPacked) {
+    modelName += "Packed";
+
+    this->useCustomSparsity_ = true;
+    this->vectorizeLoops_ = true;
+    this->packLoopArrays_ = true;
+
+    this->test(nEls);
+
+    // the strided elements are copied to/from packed arrays used by vectorized loops
+    ASSERT_GT(countSimdLoops("_soa"), 0u);
+}
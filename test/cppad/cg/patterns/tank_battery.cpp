@@ -83,4 +83,22 @@ TEST_F(CppADCGPatternTankBatTest, tankBattery) {
      * test
      */
     this->test(6);
-}
\ No newline at end of file
+}
+
+/**
+ * @test test the generation of vectorizable loops (with independent
+ *       iterations) for the tank battery model
+ */
+TEST_F(CppADCGPatternTankBatTest, tankBatteryVectorized) {
+    modelName += "Vectorized";
+
+    useCustomSparsity_ = true;
+    vectorizeLoops_ = true;
+
+    /**
+     * test
+     */
+    this->test(6);
+
+    ASSERT_GT(countSimdLoops(), 0u);
+}
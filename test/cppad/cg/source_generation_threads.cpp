@@ -0,0 +1,175 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2017 Ciengis
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+typedef CG<double> CGD;
+typedef AD<CGD> ADCG;
+
+/**
+ * Provides access to the generated sources
+ */
+class ModelCSourceGenThreads : public ModelCSourceGen<double> {
+public:
+
+    inline ModelCSourceGenThreads(ADFun<CGD>& fun,
+                                  size_t nThreads) :
+        ModelCSourceGen<double>(fun, "model") {
+        setCreateForwardZero(true);
+        setCreateReverseTwo(true);
+        setSourceGenerationThreads(nThreads);
+    }
+
+    inline std::map<std::string, std::string> sources() {
+        return getSources(MultiThreadingType::NONE, nullptr);
+    }
+};
+
+template<class T>
+std::vector<T> model(const std::vector<T>& x) {
+    size_t n = x.size();
+    std::vector<T> y(n - 1);
+    for (size_t i = 0; i < n - 1; i++) {
+        y[i] = x[i] * x[i + 1] + sin(x[i]) * exp(x[(i + 3) % n]);
+        if (i % 3 == 0)
+            y[i] += x[0] / x[i + 1];
+    }
+    return y;
+}
+
+std::vector<double> createValues(size_t n) {
+    std::vector<double> x(n);
+    for (size_t j = 0; j < n; j++)
+        x[j] = 0.5 + j;
+    return x;
+}
+
+std::unique_ptr<ADFun<CGD> > createModel(size_t n) {
+    std::vector<double> xv = createValues(n);
+    std::vector<ADCG> x(xv.begin(), xv.end());
+    CppAD::Independent(x);
+
+    std::vector<ADCG> y = model(x);
+
+    return std::unique_ptr<ADFun<CGD> >(new ADFun<CGD>(x, y));
+}
+
+/**
+ * Compiles the model using a given number of threads to generate the
+ * source code
+ */
+std::unique_ptr<DynamicLib<double> > compileModel(ADFun<CGD>& fun,
+                                                  size_t nThreads) {
+    ModelCSourceGenThreads modelSrc(fun, nThreads);
+    ModelLibraryCSourceGen<double> libSrc(modelSrc);
+
+    DynamicModelLibraryProcessor<double> p(libSrc, "cppad_cg_rev2_threads" + std::to_string(nThreads));
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    return p.createDynamicLibrary(compiler);
+}
+
+}
+
+class CppADCGSourceGenerationThreadsTest : public CppADCGTest {
+};
+
+TEST_F(CppADCGSourceGenerationThreadsTest, SameSourcesReverseTwo) {
+    std::unique_ptr<ADFun<CGD> > fun = createModel(20);
+
+    ModelCSourceGenThreads sequential(*fun, 1);
+    std::map<std::string, std::string> seq = sequential.sources();
+
+    ModelCSourceGenThreads twoThreads(*fun, 2);
+    std::map<std::string, std::string> ref = twoThreads.sources();
+    ASSERT_EQ(ref.size(), seq.size()); // same functions
+
+    ModelCSourceGenThreads parallel(*fun, 4);
+    ASSERT_EQ(parallel.getSourceGenerationThreads(), 4u);
+    std::map<std::string, std::string> src = parallel.sources();
+
+    // CppAD must be back in sequential mode
+    ASSERT_FALSE(thread_alloc::in_parallel());
+    ASSERT_EQ(thread_alloc::num_threads(), 1u);
+
+    ASSERT_EQ(src.size(), ref.size());
+    for (const auto& it : ref) {
+        ASSERT_TRUE(src.find(it.first) != src.end()) << it.first;
+        ASSERT_EQ(src.at(it.first), it.second) << it.first;
+    }
+}
+
+/**
+ * @test the sequential generation uses a single graph for all the Hessian
+ *       elements while the parallel generation uses one graph per
+ *       independent variable: the operations are different but the
+ *       Hessian values must be the same
+ */
+TEST_F(CppADCGSourceGenerationThreadsTest, SameValuesReverseTwo) {
+    const size_t n = 20;
+    std::unique_ptr<ADFun<CGD> > fun = createModel(n);
+
+    std::unique_ptr<DynamicLib<double> > libSeq = compileModel(*fun, 1);
+    std::unique_ptr<DynamicLib<double> > libPar = compileModel(*fun, 4);
+    std::unique_ptr<GenericModel<double> > seq = libSeq->model("model");
+    std::unique_ptr<GenericModel<double> > par = libPar->model("model");
+
+    // reference values from CppAD
+    std::vector<AD<double> > ax(n);
+    for (size_t j = 0; j < n; j++)
+        ax[j] = 1.0;
+    CppAD::Independent(ax);
+    std::vector<AD<double> > ay = model(ax);
+    ADFun<double> funD(ax, ay);
+
+    std::vector<double> x = createValues(n);
+    for (size_t j = 0; j < n; j++)
+        x[j] = 0.1 + 0.05 * j; // different from the values used to tape
+
+    std::vector<double> py(n - 1);
+    for (size_t i = 0; i < n - 1; i++)
+        py[i] = 1.0 + 0.25 * i;
+
+    std::vector<double> pxSeq(n), pxPar(n);
+    std::vector<double> dir(n), pyD(2 * (n - 1), 0.0);
+    for (size_t i = 0; i < n - 1; i++)
+        pyD[2 * i + 1] = py[i];
+
+    double tx1 = 1.0;
+    for (size_t j = 0; j < n; j++) {
+        seq->ReverseTwo(x, 1, &j, &tx1, pxSeq, py);
+        par->ReverseTwo(x, 1, &j, &tx1, pxPar, py);
+
+        std::fill(dir.begin(), dir.end(), 0.0);
+        dir[j] = 1.0;
+        funD.Forward(0, x);
+        funD.Forward(1, dir);
+        std::vector<double> pxD = funD.Reverse(2, pyD);
+
+        std::vector<double> ref(n);
+        for (size_t k = 0; k < n; k++)
+            ref[k] = pxD[k * 2];
+
+        ASSERT_TRUE(compareValues(pxSeq, ref)) << "column " << j;
+        ASSERT_TRUE(compareValues(pxPar, ref)) << "column " << j;
+        ASSERT_TRUE(compareValues(pxPar, pxSeq)) << "column " << j;
+    }
+}